@@ -366,19 +366,15 @@ int main(int argc, const char **argv)
     sId.buildFrom(Id);
 
     // Matrice d'interaction, Hessien, erreur,...
-    vpMatrix Lsd;      // matrice d'interaction a la position desiree
     vpMatrix Hsd;      // hessien a la position desiree
     vpMatrix H;        // Hessien utilise pour le levenberg-Marquartd
     vpColVector error; // Erreur I-I*
+    vpColVector Ltde;  // L^T (I-I*)
 
-    // Compute the interaction matrix
-    // link the variation of image intensity to camera motion
-
-    // here it is computed at the desired position
-    sId.interaction(Lsd);
-
-    // Compute the Hessian H = L^TL
-    Hsd = Lsd.AtA();
+    // Compute the Hessian H = L^TL where L is the interaction matrix that
+    // links the variation of image intensity to camera motion. Here it is
+    // computed at the desired position, without building L
+    sId.interactionAtA(Hsd);
 
     // Compute the Hessian diagonal for the Levenberg-Marquartd
     // optimization process
@@ -454,7 +450,8 @@ int main(int argc, const char **argv)
           H = ((mu * diagHsd) + Hsd).inverseByLU();
         }
         //	compute the control law
-        e = H * Lsd.t() * error;
+        sId.interactionAtb(error, Ltde);
+        e = H * Ltde;
 
         v = -lambda * e;
       }
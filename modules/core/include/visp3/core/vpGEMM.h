@@ -144,183 +144,49 @@ inline void GEMMsize<7>(const vpArray2D<double> &A, const vpArray2D<double> &B,
   Bcols = B.getRows();
 }
 
-template <unsigned int>
-inline void GEMM1(const unsigned int & /*Arows*/, const unsigned int & /*Brows*/, const unsigned int & /*Bcols*/,
-                  const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,
-                  vpArray2D<double> & /*D*/)
-{
-}
-
-template <>
-inline void GEMM1<0>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[n][c] * alpha;
-      D[r][c] = sum;
-    }
-}
-
-template <>
-inline void GEMM1<1>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[n][c] * alpha;
-      D[r][c] = sum;
-    }
-}
-
-template <>
-inline void GEMM1<2>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[c][n] * alpha;
-      D[r][c] = sum;
-    }
-}
-
-template <>
-inline void GEMM1<3>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[c][n] * alpha;
-      D[r][c] = sum;
-    }
-}
-
-template <unsigned int>
-inline void GEMM2(const unsigned int & /*Arows*/, const unsigned int & /*Brows*/, const unsigned int & /*Bcols*/,
-                  const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,
-                  const vpArray2D<double> & /*C*/, const double & /*beta*/, vpArray2D<double> & /*D*/)
-{
-}
-
-template <>
-inline void GEMM2<0>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[n][c] * alpha;
-      D[r][c] = sum + C[r][c] * beta;
-    }
-}
+/*!
+  Built-in general matrix product C = alpha*op(A)*op(B) + beta*C, where op(X)
+  is X or X^T, used by vpMatrix and vpGEMM() when ViSP is not built with an
+  external BLAS library.
 
-template <>
-inline void GEMM2<1>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[n][c] * alpha;
-      D[r][c] = sum + C[r][c] * beta;
-    }
-}
+  The product is cache-blocked and register-tiled, uses SSE2 or NEON
+  instructions when available and is parallelized with OpenMP for large
+  matrices. Small products are computed with plain loops.
 
-template <>
-inline void GEMM2<2>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[c][n] * alpha;
-      D[r][c] = sum + C[r][c] * beta;
-    }
-}
+  \param transA, transB : If true, use the transpose of A (resp. B).
+  \param M, N, K : op(A) is M x K, op(B) is K x N and C is M x N.
+  \param alpha, beta : Scalars.
+  \param A, B, C : Row-major matrices with lda, ldb and ldc elements between two rows.
+  When beta is 0, C is not read and may be uninitialized.
 
-template <>
-inline void GEMM2<3>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[c][n] * alpha;
-      D[r][c] = sum + C[r][c] * beta;
-    }
-}
+  \relates vpArray2D
+*/
+VISP_EXPORT void vpGEMMKernel(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K, double alpha,
+                              const double *A, unsigned int lda, const double *B, unsigned int ldb, double beta,
+                              double *C, unsigned int ldc);
 
-template <>
-inline void GEMM2<4>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[n][c] * alpha;
-      D[r][c] = sum + C[c][r] * beta;
-    }
-}
+/*!
+  Built-in symmetric rank-k update C = alpha*op(A)*op(A)^T + beta*C, where
+  op(A) is the N x K matrix A (transA false, C = A*A^T) or A^T (transA true,
+  C = A^T*A). Only the upper triangle is computed, then copied into the lower
+  one, so that C must be symmetric when beta is not 0.
 
-template <>
-inline void GEMM2<5>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[n][c] * alpha;
-      D[r][c] = sum + C[c][r] * beta;
-    }
-}
+  \relates vpArray2D
+  \sa vpGEMMKernel()
+*/
+VISP_EXPORT void vpSYRKKernel(bool transA, unsigned int N, unsigned int K, double alpha, const double *A,
+                              unsigned int lda, double beta, double *C, unsigned int ldc);
 
-template <>
-inline void GEMM2<6>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[r][n] * B[c][n] * alpha;
-      D[r][c] = sum + C[c][r] * beta;
-    }
-}
+/*!
+  Built-in matrix-vector product y = alpha*op(A)*x + beta*y, where A is an
+  M x N row-major matrix with lda elements between two rows. The size of x and
+  y is N and M (transA false) or M and N (transA true).
 
-template <>
-inline void GEMM2<7>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols,
-                     const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
-                     const vpArray2D<double> &C, const double &beta, vpArray2D<double> &D)
-{
-  for (unsigned int r = 0; r < Arows; r++)
-    for (unsigned int c = 0; c < Bcols; c++) {
-      double sum = 0;
-      for (unsigned int n = 0; n < Brows; n++)
-        sum += A[n][r] * B[c][n] * alpha;
-      D[r][c] = sum + C[c][r] * beta;
-    }
-}
+  \relates vpArray2D
+  \sa vpGEMMKernel()
+*/
+VISP_EXPORT void vpGEMVKernel(bool transA, unsigned int M, unsigned int N, double alpha, const double *A,
+                              unsigned int lda, const double *x, double beta, double *y);
 
 template <unsigned int T>
 inline void vpTGEMM(const vpArray2D<double> &A, const vpArray2D<double> &B, const double &alpha,
@@ -346,14 +212,28 @@ inline void vpTGEMM(const vpArray2D<double> &A, const vpArray2D<double> &B, cons
   }
 
   if (C.getRows() != 0 && C.getCols() != 0) {
-    if ((Arows != C.getRows()) || (Bcols != C.getCols())) {
+    const unsigned int Crows = (T & VP_GEMM_C_T) ? C.getCols() : C.getRows();
+    const unsigned int Ccols = (T & VP_GEMM_C_T) ? C.getRows() : C.getCols();
+    if ((Arows != Crows) || (Bcols != Ccols)) {
       throw(vpException(vpException::dimensionError, "In vpGEMM, cannot add resulting (%dx%d) matrix to (%dx%d) matrix",
-                        Arows, Bcols, C.getRows(), C.getCols()));
+                        Arows, Bcols, Crows, Ccols));
     }
 
-    GEMM2<T>(Arows, Brows, Bcols, A, B, alpha, C, beta, D);
+    // D = beta*op(C), then D += alpha*op(A)*op(B)
+    if (T & VP_GEMM_C_T) {
+      for (unsigned int r = 0; r < Arows; r++)
+        for (unsigned int c = 0; c < Bcols; c++)
+          D[r][c] = beta * C[c][r];
+    } else {
+      for (unsigned int r = 0; r < Arows; r++)
+        for (unsigned int c = 0; c < Bcols; c++)
+          D[r][c] = beta * C[r][c];
+    }
+    vpGEMMKernel((T & VP_GEMM_A_T) != 0, (T & VP_GEMM_B_T) != 0, Arows, Bcols, Brows, alpha, A.data, A.getCols(),
+                 B.data, B.getCols(), 1.0, D.data, Bcols);
   } else {
-    GEMM1<T>(Arows, Brows, Bcols, A, B, alpha, D);
+    vpGEMMKernel((T & VP_GEMM_A_T) != 0, (T & VP_GEMM_B_T) != 0, Arows, Bcols, Brows, alpha, A.data, A.getCols(),
+                 B.data, B.getCols(), 0.0, D.data, Bcols);
   }
 }
 
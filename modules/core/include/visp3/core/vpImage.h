@@ -347,6 +347,7 @@ private:
   unsigned int width;   ///! number of columns
   unsigned int height;  ///! number of rows
   Type **row;           ///! points the row pointer array
+  bool hasOwnership;    ///! false if bitmap points to an external memory
 };
 
 template <class Type> std::ostream &operator<<(std::ostream &s, const vpImage<Type> &I)
@@ -670,7 +671,9 @@ template <class Type> void vpImage<Type>::init(unsigned int h, unsigned int w)
   if ((h != this->height) || (w != this->width)) {
     if (bitmap != NULL) {
       vpDEBUG_TRACE(10, "Destruction bitmap[]");
-      delete[] bitmap;
+      if (hasOwnership) {
+        delete[] bitmap;
+      }
       bitmap = NULL;
     }
   }
@@ -680,8 +683,10 @@ template <class Type> void vpImage<Type>::init(unsigned int h, unsigned int w)
 
   npixels = width * height;
 
-  if (bitmap == NULL)
+  if (bitmap == NULL) {
     bitmap = new Type[npixels];
+    hasOwnership = true;
+  }
 
   if (bitmap == NULL) {
     throw(vpException(vpException::memoryAllocationError, "cannot allocate bitmap "));
@@ -706,7 +711,10 @@ template <class Type> void vpImage<Type>::init(unsigned int h, unsigned int w)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied,
-  otherwise the data are copied.
+  otherwise the data are copied. When the address is copied, the image does
+  not own the memory: it is never freed by the image and has to remain valid
+  while the image is used. A resize() to another size then allocates a new
+  bitmap owned by the image.
 
   \exception vpException::memoryAllocationError
 */
@@ -721,9 +729,12 @@ void vpImage<Type>::init(Type *const array, const unsigned int h, const unsigned
   }
 
   // Delete bitmap if copyData==false, otherwise only if the dimension differs
-  if ((copyData && ((h != this->height) || (w != this->width))) || !copyData) {
+  // or if the bitmap is not owned
+  if (!copyData || !hasOwnership || (h != this->height) || (w != this->width)) {
     if (bitmap != NULL) {
-      delete[] bitmap;
+      if (hasOwnership) {
+        delete[] bitmap;
+      }
       bitmap = NULL;
     }
   }
@@ -732,6 +743,7 @@ void vpImage<Type>::init(Type *const array, const unsigned int h, const unsigned
   this->height = h;
 
   npixels = width * height;
+  hasOwnership = copyData;
 
   if (copyData) {
     if (bitmap == NULL)
@@ -779,7 +791,7 @@ void vpImage<Type>::init(Type *const array, const unsigned int h, const unsigned
 */
 template <class Type>
 vpImage<Type>::vpImage(unsigned int h, unsigned int w)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(h, w, 0);
 }
@@ -803,7 +815,7 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w)
 */
 template <class Type>
 vpImage<Type>::vpImage(unsigned int h, unsigned int w, Type value)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(h, w, value);
 }
@@ -817,7 +829,10 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w, Type value)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied,
-  otherwise the data are copied.
+  otherwise the data are copied. When the address is copied, the image does
+  not own the memory: it is never freed by the image and has to remain valid
+  while the image is used. A resize() to another size then allocates a new
+  bitmap owned by the image.
 
   \return MEMORY_FAULT if memory allocation is impossible, else OK
 
@@ -825,7 +840,7 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w, Type value)
 */
 template <class Type>
 vpImage<Type>::vpImage(Type *const array, const unsigned int h, const unsigned int w, const bool copyData)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   init(array, h, w, copyData);
 }
@@ -839,7 +854,8 @@ vpImage<Type>::vpImage(Type *const array, const unsigned int h, const unsigned i
 
   \sa vpImage::resize(height, width) for memory allocation
 */
-template <class Type> vpImage<Type>::vpImage() : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+template <class Type>
+vpImage<Type>::vpImage() : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
 }
 
@@ -899,7 +915,9 @@ template <class Type> void vpImage<Type>::destroy()
   if (bitmap != NULL) {
     //  vpERROR_TRACE("Deallocate bitmap memory %p",bitmap);
     //    vpDEBUG_TRACE(20,"Deallocate bitmap memory %p",bitmap);
-    delete[] bitmap;
+    if (hasOwnership) {
+      delete[] bitmap;
+    }
     bitmap = NULL;
   }
 
@@ -923,7 +941,8 @@ template <class Type> vpImage<Type>::~vpImage() { destroy(); }
   Copy constructor
 */
 template <class Type>
-vpImage<Type>::vpImage(const vpImage<Type> &I) : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+vpImage<Type>::vpImage(const vpImage<Type> &I)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), hasOwnership(true)
 {
   resize(I.getHeight(), I.getWidth());
   memcpy(bitmap, I.bitmap, I.npixels * sizeof(Type));
@@ -935,7 +954,8 @@ vpImage<Type>::vpImage(const vpImage<Type> &I) : bitmap(NULL), display(NULL), np
 */
 template <class Type>
 vpImage<Type>::vpImage(vpImage<Type> &&I)
-  : bitmap(I.bitmap), display(I.display), npixels(I.npixels), width(I.width), height(I.height), row(I.row)
+  : bitmap(I.bitmap), display(I.display), npixels(I.npixels), width(I.width), height(I.height), row(I.row),
+    hasOwnership(I.hasOwnership)
 {
   I.bitmap = NULL;
   I.display = NULL;
@@ -943,6 +963,7 @@ vpImage<Type>::vpImage(vpImage<Type> &&I)
   I.width = 0;
   I.height = 0;
   I.row = NULL;
+  I.hasOwnership = true;
 }
 #endif
 
@@ -1973,6 +1994,7 @@ template <class Type> void swap(vpImage<Type> &first, vpImage<Type> &second)
   swap(first.width, second.width);
   swap(first.height, second.height);
   swap(first.row, second.row);
+  swap(first.hasOwnership, second.hasOwnership);
 }
 
 #endif
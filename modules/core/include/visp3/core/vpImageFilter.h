@@ -62,6 +62,21 @@
 
   \brief  Various image filter, convolution, etc...
 
+  The separable filters (filterX(), filterY(), gaussianBlur(), getGradX(),
+  getGradY(), sepFilter()...) process the interior of the image with SSE2 or
+  NEON instructions when available, and the rows are distributed over
+  several threads when OpenMP is enabled. The results are the same as with
+  the per-pixel functions, like filterX(const vpImage<unsigned char> &,
+  unsigned int, unsigned int, const double *, unsigned int).
+
+  These filters also exist in single precision, with a vpImage<float> output
+  image and float kernels, see for instance gaussianBlur(const
+  vpImage<unsigned char> &, vpImage<float> &, unsigned int, double, bool).
+  Twice more pixels are then processed by each SIMD instruction and the
+  memory footprint is halved, which is worth it when the double precision is
+  not needed, for instance to compute the image gradients used by a tracker.
+  The precision of an image is thus chosen through the type of the output
+  image given to these functions.
 */
 class VISP_EXPORT vpImageFilter
 {
@@ -162,9 +177,13 @@ public:
 
   static void sepFilter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
                         const vpColVector &kernelV);
+  static void sepFilter(const vpImage<unsigned char> &I, vpImage<float> &If, const vpColVector &kernelH,
+                        const vpColVector &kernelV);
 
   static void filter(const vpImage<unsigned char> &I, vpImage<double> &GI, const double *filter, unsigned int size);
   static void filter(const vpImage<double> &I, vpImage<double> &GI, const double *filter, unsigned int size);
+  static void filter(const vpImage<unsigned char> &I, vpImage<float> &GI, const float *filter, unsigned int size);
+  static void filter(const vpImage<float> &I, vpImage<float> &GI, const float *filter, unsigned int size);
 
   static inline unsigned char filterGaussXPyramidal(const vpImage<unsigned char> &I, unsigned int i, unsigned int j)
   {
@@ -179,6 +198,8 @@ public:
 
   static void filterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
+  static void filterX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
 
   static inline double filterX(const vpImage<unsigned char> &I, unsigned int r, unsigned int c, const double *filter,
                                unsigned int size)
@@ -272,6 +293,8 @@ public:
 
   static void filterY(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void filterY(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
+  static void filterY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
   static inline double filterY(const vpImage<unsigned char> &I, unsigned int r, unsigned int c, const double *filter,
                                unsigned int size)
   {
@@ -366,6 +389,10 @@ public:
                            double sigma = 0., bool normalize = true);
   static void gaussianBlur(const vpImage<double> &I, vpImage<double> &GI, unsigned int size = 7, double sigma = 0.,
                            bool normalize = true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<float> &GI, unsigned int size = 7,
+                           double sigma = 0., bool normalize = true);
+  static void gaussianBlur(const vpImage<float> &I, vpImage<float> &GI, unsigned int size = 7, double sigma = 0.,
+                           bool normalize = true);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -391,21 +418,31 @@ public:
 
   static void getGaussianKernel(double *filter, unsigned int size, double sigma = 0., bool normalize = true);
   static void getGaussianDerivativeKernel(double *filter, unsigned int size, double sigma = 0., bool normalize = true);
+  static void getGaussianKernel(float *filter, unsigned int size, double sigma = 0., bool normalize = true);
+  static void getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma = 0., bool normalize = true);
 
   // fonction renvoyant le gradient en X de l'image I pour traitement
   // pyramidal => dimension /2
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx);
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
   static void getGradX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
+  static void getGradX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size);
   static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel, unsigned int size);
+  static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size);
 
   // fonction renvoyant le gradient en Y de l'image I
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy);
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter, unsigned int size);
   static void getGradY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
+  static void getGradY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size);
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel, unsigned int size);
+  static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size);
 
   static double getSobelKernelX(double *filter, unsigned int size);
   static double getSobelKernelY(double *filter, unsigned int size);
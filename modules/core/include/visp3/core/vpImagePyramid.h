@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image pyramid with reusable levels.
+ *
+ *****************************************************************************/
+
+#ifndef vpImagePyramid_h
+#define vpImagePyramid_h
+
+/*!
+  \file vpImagePyramid.h
+  \brief Image pyramid with reusable levels.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpImagePyramid
+
+  \ingroup group_core_image
+
+  \brief Pyramid of grey level images whose levels are kept from one frame to
+  the other.
+
+  Level 0 is the input image, which is referenced and not copied. Each other
+  level is half the size of the previous one, obtained either with
+  vpImageFilter::getGaussPyramidal() (vpImagePyramid::GAUSSIAN_PYRAMID) or
+  by keeping one pixel out of two (vpImagePyramid::SUBSAMPLED_PYRAMID). The
+  level buffers are only reallocated when the image size changes.
+
+  The levels that are used can be given as a vector of booleans, like the
+  scales of vpMbEdgeTracker. The levels of a subsampled pyramid that are not
+  used are then not computed, each used level being directly subsampled from
+  the closest level below. The levels of a Gaussian pyramid are computed from
+  the previous one, so all the levels below the last used one are computed.
+
+  When several trackers process the same frame, the pyramid can be built once
+  and passed to each of them. The optional frame stamp given to build()
+  avoids to compute the pyramid again for a frame that was already
+  processed:
+  \code
+  vpImagePyramid pyramid(vpImagePyramid::GAUSSIAN_PYRAMID);
+  for (unsigned int frame = 0; ; frame++) {
+    g.acquire(I);
+    pyramid.build(I, 3, frame);
+    tracker1.track(pyramid);
+    tracker2.track(pyramid);
+  }
+  \endcode
+
+  \warning The input image must remain valid and unchanged as long as the
+  pyramid is used.
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  /*! Method used to compute a level from the previous one. */
+  typedef enum {
+    GAUSSIAN_PYRAMID,  /*!< Gaussian filtering then subsampling, see vpImageFilter::getGaussPyramidal(). */
+    SUBSAMPLED_PYRAMID /*!< Subsampling without filtering. */
+  } vpImagePyramidType;
+
+  explicit vpImagePyramid(const vpImagePyramidType &type = GAUSSIAN_PYRAMID);
+
+  void build(const vpImage<unsigned char> &I, const unsigned int nbLevels);
+  void build(const vpImage<unsigned char> &I, const unsigned int nbLevels, const unsigned long frameStamp);
+  void build(const vpImage<unsigned char> &I, const std::vector<bool> &levels);
+  void build(const vpImage<unsigned char> &I, const std::vector<bool> &levels, const unsigned long frameStamp);
+  void clear();
+
+  /*!
+    Return the frame stamp given to the last call to
+    build(const vpImage<unsigned char> &, const unsigned int, const unsigned long).
+  */
+  inline unsigned long getFrameStamp() const { return m_frameStamp; }
+  const vpImage<unsigned char> &getLevel(const unsigned int level) const;
+  /*!
+    Return the number of levels of the pyramid. When the pyramid is built
+    with a vector of used levels, some of them may not be computed, see
+    isLevelBuilt().
+  */
+  inline unsigned int getNbLevels() const { return m_nbLevels; }
+  //! Return the method used to compute the levels.
+  inline vpImagePyramidType getType() const { return m_type; }
+  //! Return true if the level \e level is computed and can be accessed with getLevel().
+  inline bool isLevelBuilt(const unsigned int level) const { return level < m_nbLevels && m_isBuilt[level]; }
+  bool isUpToDate(const unsigned long frameStamp, const unsigned int nbLevels) const;
+  bool isUpToDate(const unsigned long frameStamp, const std::vector<bool> &levels) const;
+
+  //! Return the pyramid level \e level, see getLevel().
+  inline const vpImage<unsigned char> &operator[](const unsigned int level) const { return getLevel(level); }
+
+private:
+  void buildLevels(const std::vector<bool> &levels);
+  void reset(const vpImage<unsigned char> &I);
+
+  //! Input image, used as level 0
+  const vpImage<unsigned char> *m_I;
+  //! Levels 1 to m_nbLevels-1, the first element is not used
+  std::vector<vpImage<unsigned char> > m_levels;
+  //! True for the levels that are computed
+  std::vector<bool> m_isBuilt;
+  //! Intermediate image of the Gaussian filtering
+  vpImage<unsigned char> m_buffer;
+  unsigned long m_frameStamp;
+  bool m_hasFrameStamp;
+  unsigned int m_nbLevels;
+  vpImagePyramidType m_type;
+};
+
+#endif
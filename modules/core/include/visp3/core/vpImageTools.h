@@ -147,6 +147,9 @@ public:
   static void templateMatching(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
                                vpImage<double> &I_score, const unsigned int step_u, const unsigned int step_v,
                                const bool useOptimized = true);
+  static void templateMatching(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
+                               vpImage<float> &I_score, const unsigned int step_u, const unsigned int step_v,
+                               const bool useOptimized = true);
 
   template <class Type>
   static void undistort(const vpImage<Type> &I, const vpCameraParameters &cam, vpImage<Type> &newI);
@@ -177,6 +180,13 @@ private:
   static double normalizedCorrelation(const vpImage<double> &I1, const vpImage<double> &I2, const vpImage<double> &II,
                                       const vpImage<double> &IIsq, const vpImage<double> &II_tpl,
                                       const vpImage<double> &IIsq_tpl, const unsigned int i0, const unsigned int j0);
+  static double normalizedCorrelation(const vpImage<float> &I1, const vpImage<float> &I2, const vpImage<double> &II,
+                                      const vpImage<double> &IIsq, const vpImage<double> &II_tpl,
+                                      const vpImage<double> &IIsq_tpl, const unsigned int i0, const unsigned int j0);
+
+  template <class Type>
+  static void templateMatchingIntegral(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
+                                       vpImage<Type> &I_score, const unsigned int step_u, const unsigned int step_v);
 
   template <class Type>
   static void resizeBicubic(const vpImage<Type> &I, vpImage<Type> &Ires, const unsigned int i, const unsigned int j,
@@ -0,0 +1,127 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Read-only file mapped in memory.
+ *
+ *****************************************************************************/
+
+#ifndef vpMemoryMappedFile_h
+#define vpMemoryMappedFile_h
+
+/*!
+  \file vpMemoryMappedFile.h
+  \brief File mapped in memory.
+ */
+
+#include <stddef.h>
+#include <string>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpMemoryMappedFile
+  \ingroup group_core_files_io
+  \brief File mapped in memory.
+
+  The content of the file is mapped in the address space of the process with
+  mmap() on Unix and with a file mapping object on Windows. The pages are
+  loaded on demand and are shared through the page cache between the
+  processes that map the same file. The mapping is private: the content can
+  be modified in memory (the modified pages are then copied), but the file is
+  never modified.
+
+  On the platforms without memory mapping (Universal Windows Platform), the
+  file is read in a buffer, so that the class can be used in the same way.
+
+  The first byte of the mapping is aligned on a page boundary, so that data
+  stored at aligned offsets in the file can be used in place.
+
+  \code
+#include <visp3/core/vpMemoryMappedFile.h>
+
+int main()
+{
+  vpMemoryMappedFile file("data.bin");
+  const unsigned char *data = file.getData();
+  for (size_t i = 0; i < file.getSize(); i++) {
+    // ... use data[i]
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpMemoryMappedFile
+{
+public:
+  vpMemoryMappedFile();
+  explicit vpMemoryMappedFile(const std::string &filename);
+  ~vpMemoryMappedFile();
+
+  void close();
+
+  /*!
+    Get a pointer to the content of the file.
+
+    \return Pointer to the first byte, NULL if no file is mapped or if the
+    file is empty.
+  */
+  inline unsigned char *getData() const { return m_data; }
+  /*!
+    Get the size of the mapped file.
+
+    \return The size in bytes.
+  */
+  inline size_t getSize() const { return m_size; }
+  /*!
+    Check if a file is opened.
+
+    \return True if a file is opened.
+  */
+  inline bool isOpen() const { return m_isOpen; }
+
+  void open(const std::string &filename);
+  void swap(vpMemoryMappedFile &file);
+
+private:
+  // A mapping cannot be shared between two instances
+  vpMemoryMappedFile(const vpMemoryMappedFile &);
+  vpMemoryMappedFile &operator=(const vpMemoryMappedFile &);
+
+  //! Pointer to the content of the file.
+  unsigned char *m_data;
+  //! True if m_data is a buffer allocated with new[] instead of a mapping.
+  bool m_isBuffer;
+  //! True if a file is opened.
+  bool m_isOpen;
+  //! Size of the file.
+  size_t m_size;
+};
+
+#endif
@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Exception raised by the tasks of an OpenMP parallel loop.
+ *
+ *****************************************************************************/
+
+#ifndef __vpParallelTaskException_h_
+#define __vpParallelTaskException_h_
+
+#include <exception>
+#include <string>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \class vpParallelTaskException
+
+  \ingroup group_core_threading
+
+  An exception must not leave an OpenMP parallel region. Each task of the
+  parallel loop catches its exception and gives it to capture(), and the
+  exception raised by the first task (in the sequential order) is thrown
+  again by rethrow() once all the tasks are done. The exceptions that are
+  not vpException are thrown again as vpException::fatalError.
+
+  \code
+  vpParallelTaskException exception("Unknown exception in the tasks");
+#pragma omp parallel for
+  for (int i = 0; i < nbTasks; i++) {
+    try {
+      task(i);
+    } catch (...) {
+      exception.capture(i);
+    }
+  }
+  exception.rethrow();
+  \endcode
+*/
+class vpParallelTaskException
+{
+public:
+  /*!
+    \param unknownMessage : Message of the exception thrown again when a
+    task raises an exception which is neither a vpException nor a
+    std::exception.
+  */
+  explicit vpParallelTaskException(const std::string &unknownMessage = "Unknown exception in parallel task")
+    : m_exception(vpException::fatalError, unknownMessage), m_unknownMessage(unknownMessage), m_index(-1)
+  {
+  }
+
+  /*!
+    Keep the exception being handled if it is raised by the first task so
+    far. Must be called from a catch block.
+
+    \param index : Index of the task in the sequential order.
+  */
+  void capture(const int index)
+  {
+    vpException exception(vpException::fatalError, m_unknownMessage);
+    try {
+      throw;
+    } catch (const vpException &e) {
+      exception = e;
+    } catch (const std::exception &e) {
+      exception = vpException(vpException::fatalError, e.what());
+    } catch (...) {
+    }
+
+#if defined(_OPENMP)
+#pragma omp critical(vpParallelTaskException)
+#endif
+    {
+      if (m_index < 0 || index < m_index) {
+        m_exception = exception;
+        m_index = index;
+      }
+    }
+  }
+
+  //! Throw again the exception of the first task that failed, if any.
+  void rethrow() const
+  {
+    if (m_index >= 0) {
+      throw m_exception;
+    }
+  }
+
+private:
+  vpException m_exception;
+  std::string m_unknownMessage;
+  int m_index;
+};
+
+#endif
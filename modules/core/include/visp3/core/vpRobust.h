@@ -76,8 +76,6 @@ private:
   double sig_prev;
   //!
   unsigned int it;
-  //! Vairiable used in swap method
-  double swap;
   //! Size of the containers
   unsigned int size;
 
@@ -180,16 +178,7 @@ private:
 
   /** @name Sort function  */
   //@{
-  //! Swap two value
-  void exch(double &A, double &B)
-  {
-    swap = A;
-    A = B;
-    B = swap;
-  }
-  //! Sort function using partition method
-  int partition(vpColVector &a, int l, int r);
-  //! Sort the vector and select a value in the sorted vector
+  //! Partially sort the vector and select a value in the sorted vector
   double select(vpColVector &a, int l, int r, int k);
   //@}
 };
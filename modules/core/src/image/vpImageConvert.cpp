@@ -43,8 +43,10 @@
   \brief Convert image types
 */
 
+#include <algorithm>
 #include <map>
 #include <sstream>
+#include <vector>
 
 // image
 #include <visp3/core/vpCPUFeatures.h>
@@ -70,6 +72,293 @@ int vpImageConvert::vpCgb[256];
 int vpImageConvert::vpCgr[256];
 int vpImageConvert::vpCbb[256];
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Below this number of pixels the conversions are done by a single thread
+const unsigned int nbPixelsMinParallel = 256 * 256;
+// Number of pairs of pixels of a packed YUV 4:2:2 buffer converted at once by a thread
+const unsigned int nbPairsPerBand = 4096;
+
+// Same clamping than the scalar conversions
+inline unsigned char saturate(const int val) { return (unsigned char)(val < 0 ? 0 : (val > 255 ? 255 : val)); }
+
+/*
+  Terms added to the luma to get R, G, B from the chroma of a pair of pixels:
+  - yuyv == true: coefficients used by YUYVToRGBa()
+  - yuyv == false: coefficients used by YUV422ToRGBa(), YUV420ToRGBa()...
+*/
+template <bool yuyv> inline void chromaToRGB(const int u, const int v, int &r_off, int &g_off, int &b_off)
+{
+  if (yuyv) {
+    b_off = ((u - 128) * 454) >> 8;
+    r_off = ((v - 128) * 359) >> 8;
+    g_off = -(((u - 128) * 88 + (v - 128) * 183) >> 8);
+  } else {
+    const int U = (int)((u - 128) * 0.354);
+    const int V = (int)((v - 128) * 0.707);
+    r_off = 2 * V;
+    g_off = -U - V;
+    b_off = 5 * U;
+  }
+}
+
+template <unsigned int nbChannels>
+inline void writePixel(const int y, const int r_off, const int g_off, const int b_off, unsigned char *const dst)
+{
+  dst[0] = saturate(y + r_off);
+  dst[1] = saturate(y + g_off);
+  dst[2] = saturate(y + b_off);
+  if (nbChannels == 4) {
+    dst[3] = vpRGBa::alpha_default;
+  }
+}
+
+#if VISP_HAVE_SSE2
+/*
+  Vectorized version of chromaToRGB() and writePixel() for 16 pixels, y_lo
+  and y_hi containing the luma of the pixels 0-7 and 8-15, u and v the chroma
+  of the 8 pairs of pixels, as 16-bit integers. The integer operations give
+  exactly the same results than the scalar code:
+  - (x * 454) >> 8 == mulhi(x << 7, 908) and (x * 359) >> 8 == mulhi(x << 7, 718)
+  - (int)(x * 0.354) == sign(x) * ((|x| << 5) * 725 >> 16) and
+    (int)(x * 0.707) == sign(x) * ((|x| << 8) * 181 >> 16) for x in [-128, 127]
+*/
+template <bool yuyv>
+inline void yuvToRGB(const __m128i &y_lo, const __m128i &y_hi, const __m128i &u, const __m128i &v, __m128i &r,
+                     __m128i &g, __m128i &b)
+{
+  const __m128i v_zero = _mm_setzero_si128();
+  const __m128i du = _mm_sub_epi16(u, _mm_set1_epi16(128));
+  const __m128i dv = _mm_sub_epi16(v, _mm_set1_epi16(128));
+  __m128i r_off, g_off, b_off;
+
+  if (yuyv) {
+    b_off = _mm_mulhi_epi16(_mm_slli_epi16(du, 7), _mm_set1_epi16(908));
+    r_off = _mm_mulhi_epi16(_mm_slli_epi16(dv, 7), _mm_set1_epi16(718));
+
+    const __m128i v_coeffs = _mm_set1_epi32((183 << 16) | 88);
+    const __m128i cg_lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(du, dv), v_coeffs), 8);
+    const __m128i cg_hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(du, dv), v_coeffs), 8);
+    g_off = _mm_sub_epi16(v_zero, _mm_packs_epi32(cg_lo, cg_hi));
+  } else {
+    const __m128i sign_u = _mm_srai_epi16(du, 15);
+    const __m128i abs_u = _mm_sub_epi16(_mm_xor_si128(du, sign_u), sign_u);
+    const __m128i U = _mm_sub_epi16(
+        _mm_xor_si128(_mm_mulhi_epu16(_mm_slli_epi16(abs_u, 5), _mm_set1_epi16(725)), sign_u), sign_u);
+
+    const __m128i sign_v = _mm_srai_epi16(dv, 15);
+    const __m128i abs_v = _mm_sub_epi16(_mm_xor_si128(dv, sign_v), sign_v);
+    const __m128i V = _mm_sub_epi16(
+        _mm_xor_si128(_mm_mulhi_epu16(_mm_slli_epi16(abs_v, 8), _mm_set1_epi16(181)), sign_v), sign_v);
+
+    r_off = _mm_add_epi16(V, V);
+    g_off = _mm_sub_epi16(_mm_sub_epi16(v_zero, U), V);
+    b_off = _mm_add_epi16(_mm_slli_epi16(U, 2), U);
+  }
+
+  // Each chroma is shared by two consecutive pixels
+  r = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(r_off, r_off)),
+                       _mm_add_epi16(y_hi, _mm_unpackhi_epi16(r_off, r_off)));
+  g = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(g_off, g_off)),
+                       _mm_add_epi16(y_hi, _mm_unpackhi_epi16(g_off, g_off)));
+  b = _mm_packus_epi16(_mm_add_epi16(y_lo, _mm_unpacklo_epi16(b_off, b_off)),
+                       _mm_add_epi16(y_hi, _mm_unpackhi_epi16(b_off, b_off)));
+}
+
+// Interleave 16 pixels
+inline void storeRGBa(const __m128i &r, const __m128i &g, const __m128i &b, const __m128i &a, unsigned char *const dst)
+{
+  const __m128i rg_lo = _mm_unpacklo_epi8(r, g), rg_hi = _mm_unpackhi_epi8(r, g);
+  const __m128i ba_lo = _mm_unpacklo_epi8(b, a), ba_hi = _mm_unpackhi_epi8(b, a);
+  _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+  _mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+}
+
+template <unsigned int nbChannels>
+inline void storePixels(const __m128i &r, const __m128i &g, const __m128i &b, unsigned char *const dst)
+{
+  if (nbChannels == 4) {
+    storeRGBa(r, g, b, _mm_set1_epi8((char)vpRGBa::alpha_default), dst);
+  } else {
+    unsigned char r_[16], g_[16], b_[16];
+    _mm_storeu_si128((__m128i *)r_, r);
+    _mm_storeu_si128((__m128i *)g_, g);
+    _mm_storeu_si128((__m128i *)b_, b);
+    for (unsigned int k = 0; k < 16; k++) {
+      dst[3 * k] = r_[k];
+      dst[3 * k + 1] = g_[k];
+      dst[3 * k + 2] = b_[k];
+    }
+  }
+}
+#endif
+
+/*
+  Convert nbPairs pairs of pixels of a packed YUV 4:2:2 buffer, either YUYV
+  (y0 u01 y1 v01) with the coefficients of YUYVToRGBa() when yuyv is true, or
+  UYVY (u01 y0 v01 y1) with the coefficients of YUV422ToRGBa() otherwise.
+*/
+template <bool yuyv, unsigned int nbChannels>
+void convertPackedYUV422(const unsigned char *src, unsigned char *dst, const unsigned int nbPairs, const bool useSIMD)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (useSIMD) {
+    const __m128i v_mask = _mm_set1_epi16(0x00FF);
+    __m128i r, g, b;
+    for (; i + 8 <= nbPairs; i += 8, src += 32, dst += 16 * nbChannels) {
+      const __m128i v0 = _mm_loadu_si128((const __m128i *)src);
+      const __m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+      const __m128i y_lo = yuyv ? _mm_and_si128(v0, v_mask) : _mm_srli_epi16(v0, 8);
+      const __m128i y_hi = yuyv ? _mm_and_si128(v1, v_mask) : _mm_srli_epi16(v1, 8);
+      // u0 v0 u1 v1 ... u7 v7
+      const __m128i uv = yuyv ? _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8))
+                              : _mm_packus_epi16(_mm_and_si128(v0, v_mask), _mm_and_si128(v1, v_mask));
+
+      yuvToRGB<yuyv>(y_lo, y_hi, _mm_and_si128(uv, v_mask), _mm_srli_epi16(uv, 8), r, g, b);
+      storePixels<nbChannels>(r, g, b, dst);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  int r_off, g_off, b_off;
+  for (; i < nbPairs; i++, src += 4, dst += 2 * nbChannels) {
+    const int y0 = yuyv ? src[0] : src[1];
+    const int y1 = yuyv ? src[2] : src[3];
+    chromaToRGB<yuyv>(yuyv ? src[1] : src[0], yuyv ? src[3] : src[2], r_off, g_off, b_off);
+    writePixel<nbChannels>(y0, r_off, g_off, b_off, dst);
+    writePixel<nbChannels>(y1, r_off, g_off, b_off, dst + nbChannels);
+  }
+}
+
+// Split the packed buffer in bands converted in parallel
+template <bool yuyv, unsigned int nbChannels>
+void convertPackedYUV422(const unsigned char *const src, unsigned char *const dst, const unsigned int nbPairs)
+{
+  const bool useSIMD = vpCPUFeatures::checkSSE2();
+  const int nbBands = (int)((nbPairs + nbPairsPerBand - 1) / nbPairsPerBand);
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (2 * nbPairs >= nbPixelsMinParallel)
+#endif
+  for (int band = 0; band < nbBands; band++) {
+    const unsigned int first = (unsigned int)band * nbPairsPerBand;
+    convertPackedYUV422<yuyv, nbChannels>(src + 4 * (size_t)first, dst + 2 * nbChannels * (size_t)first,
+                                          std::min(nbPairsPerBand, nbPairs - first), useSIMD);
+  }
+}
+
+/*
+  Convert nbPairs pairs of pixels from planar buffers, with one chroma for
+  two consecutive pixels, with the coefficients of YUV420ToRGBa().
+*/
+template <unsigned int nbChannels>
+void convertPlanarYUV(const unsigned char *y, const unsigned char *u, const unsigned char *v, unsigned char *dst,
+                      const unsigned int nbPairs, const bool useSIMD)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (useSIMD) {
+    const __m128i v_zero = _mm_setzero_si128();
+    __m128i r, g, b;
+    for (; i + 8 <= nbPairs; i += 8, y += 16, u += 8, v += 8, dst += 16 * nbChannels) {
+      const __m128i v_y = _mm_loadu_si128((const __m128i *)y);
+      yuvToRGB<false>(_mm_unpacklo_epi8(v_y, v_zero), _mm_unpackhi_epi8(v_y, v_zero),
+                      _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)u), v_zero),
+                      _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)v), v_zero), r, g, b);
+      storePixels<nbChannels>(r, g, b, dst);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  int r_off, g_off, b_off;
+  for (; i < nbPairs; i++, y += 2, u++, v++, dst += 2 * nbChannels) {
+    chromaToRGB<false>(*u, *v, r_off, g_off, b_off);
+    writePixel<nbChannels>(y[0], r_off, g_off, b_off, dst);
+    writePixel<nbChannels>(y[1], r_off, g_off, b_off, dst + nbChannels);
+  }
+}
+
+// YUV 4:2:0 planar image, each chroma being shared by a 2x2 block of pixels
+template <unsigned int nbChannels>
+void convertYUV420(const unsigned char *const yuv, const unsigned char *const iU, const unsigned char *const iV,
+                   unsigned char *const dst, const unsigned int width, const unsigned int height)
+{
+  const bool useSIMD = vpCPUFeatures::checkSSE2();
+  const unsigned int half_width = width / 2;
+  const int nbRowPairs = (int)(height / 2);
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (width * height >= nbPixelsMinParallel)
+#endif
+  for (int i = 0; i < nbRowPairs; i++) {
+    const unsigned char *const y = yuv + 2 * (size_t)i * width;
+    const unsigned char *const u = iU + (size_t)i * half_width;
+    const unsigned char *const v = iV + (size_t)i * half_width;
+    unsigned char *const d = dst + 2 * (size_t)i * width * nbChannels;
+    convertPlanarYUV<nbChannels>(y, u, v, d, half_width, useSIMD);
+    convertPlanarYUV<nbChannels>(y + width, u, v, d + width * nbChannels, half_width, useSIMD);
+  }
+}
+
+// YUV 4:1:1 (u y0 y1 v y2 y3), the groups of 4 pixels are unpacked to use convertPlanarYUV()
+template <unsigned int nbChannels>
+void convertYUV411(const unsigned char *const yuv, unsigned char *const dst, const unsigned int size)
+{
+  const bool useSIMD = vpCPUFeatures::checkSSE2();
+  const unsigned int nbGroups = size / 4;
+  const unsigned int nbGroupsPerBlock = 4;
+  const int nbBlocks = (int)((nbGroups + nbGroupsPerBlock - 1) / nbGroupsPerBlock);
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (size >= nbPixelsMinParallel)
+#endif
+  for (int block = 0; block < nbBlocks; block++) {
+    const unsigned int first = (unsigned int)block * nbGroupsPerBlock;
+    const unsigned int n = std::min(nbGroupsPerBlock, nbGroups - first);
+    const unsigned char *src = yuv + 6 * (size_t)first;
+    unsigned char y[4 * nbGroupsPerBlock], u[2 * nbGroupsPerBlock], v[2 * nbGroupsPerBlock];
+    for (unsigned int k = 0; k < n; k++, src += 6) {
+      u[2 * k] = u[2 * k + 1] = src[0];
+      y[4 * k] = src[1];
+      y[4 * k + 1] = src[2];
+      v[2 * k] = v[2 * k + 1] = src[3];
+      y[4 * k + 2] = src[4];
+      y[4 * k + 3] = src[5];
+    }
+    convertPlanarYUV<nbChannels>(y, u, v, dst + 4 * nbChannels * (size_t)first, 2 * n, useSIMD);
+  }
+}
+
+// dst[i] = src[2 * i + offset], with offset equal to 0 or 1
+template <unsigned int offset>
+void extractEveryOtherByte(const unsigned char *src, unsigned char *dst, const unsigned int size)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128i v_mask = _mm_set1_epi16(0x00FF);
+    for (; i + 16 <= size; i += 16, src += 32, dst += 16) {
+      const __m128i v0 = _mm_loadu_si128((const __m128i *)src);
+      const __m128i v1 = _mm_loadu_si128((const __m128i *)(src + 16));
+      _mm_storeu_si128((__m128i *)dst, offset == 0 ? _mm_packus_epi16(_mm_and_si128(v0, v_mask),
+                                                                      _mm_and_si128(v1, v_mask))
+                                                   : _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8)));
+    }
+  }
+#endif
+
+  for (; i < size; i++, src += 2) {
+    *dst++ = src[offset];
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Convert a vpImage\<unsigned char\> to a vpImage\<vpRGBa\>.
   Tha alpha component is set to vpRGBa::alpha_default.
@@ -201,8 +490,8 @@ void vpImageConvert::convert(const vpImage<unsigned char> &src, vpImage<double>
 void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba)
 {
   dest_rgba.resize(src_depth.getHeight(), src_depth.getWidth());
-  static uint32_t histogram[0x10000];
-  memset(histogram, 0, sizeof(histogram));
+  // Not static to be thread-safe
+  std::vector<uint32_t> histogram(0x10000, 0);
 
   for (unsigned int i = 0; i < src_depth.getSize(); ++i)
     ++histogram[src_depth.bitmap[i]];
@@ -210,7 +499,11 @@ void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vp
     histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the
                                       // indices in [1,0xFFFF]
 
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i) {
+  const int size = (int)src_depth.getSize();
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (src_depth.getSize() >= nbPixelsMinParallel)
+#endif
+  for (int i = 0; i < size; ++i) {
     uint16_t d = src_depth.bitmap[i];
     if (d) {
       int f = (int)(histogram[d] * 255 / histogram[0xFFFF]); // 0-255 based on histogram location
@@ -236,8 +529,8 @@ void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vp
 void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth)
 {
   dest_depth.resize(src_depth.getHeight(), src_depth.getWidth());
-  static uint32_t histogram2[0x10000];
-  memset(histogram2, 0, sizeof(histogram2));
+  // Not static to be thread-safe
+  std::vector<uint32_t> histogram2(0x10000, 0);
 
   for (unsigned int i = 0; i < src_depth.getSize(); ++i)
     ++histogram2[src_depth.bitmap[i]];
@@ -245,7 +538,11 @@ void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vp
     histogram2[i] += histogram2[i - 1]; // Build a cumulative histogram for
                                         // the indices in [1,0xFFFF]
 
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i) {
+  const int size = (int)src_depth.getSize();
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (src_depth.getSize() >= nbPixelsMinParallel)
+#endif
+  for (int i = 0; i < size; ++i) {
     uint16_t d = src_depth.bitmap[i];
     if (d) {
       int f = (int)(histogram2[d] * 255 / histogram2[0xFFFF]); // 0-255 based on histogram location
@@ -978,11 +1275,12 @@ int main()
 void vpImageConvert::convert(const yarp::sig::ImageOf<yarp::sig::PixelMono> *src, vpImage<unsigned char> &dest,
                              const bool copyData)
 {
-  dest.resize(src->height(), src->width());
-  if (copyData)
+  if (copyData) {
+    dest.resize(src->height(), src->width());
     memcpy(dest.bitmap, src->getRawImage(), src->height() * src->width() * sizeof(yarp::sig::PixelMono));
-  else
-    dest.bitmap = src->getRawImage();
+  } else {
+    dest.init(src->getRawImage(), src->height(), src->width(), false);
+  }
 }
 
 /*!
@@ -1072,11 +1370,12 @@ int main()
 void vpImageConvert::convert(const yarp::sig::ImageOf<yarp::sig::PixelRgba> *src, vpImage<vpRGBa> &dest,
                              const bool copyData)
 {
-  dest.resize(src->height(), src->width());
-  if (copyData)
+  if (copyData) {
+    dest.resize(src->height(), src->width());
     memcpy(dest.bitmap, src->getRawImage(), src->height() * src->width() * sizeof(yarp::sig::PixelRgba));
-  else
-    dest.bitmap = static_cast<vpRGBa *>(src->getRawImage());
+  } else {
+    dest.init(reinterpret_cast<vpRGBa *>(src->getRawImage()), src->height(), src->width(), false);
+  }
 }
 
 /*!
@@ -1195,50 +1494,7 @@ void vpImageConvert::convert(const yarp::sig::ImageOf<yarp::sig::PixelRgb> *src,
 */
 void vpImageConvert::YUYVToRGBa(unsigned char *yuyv, unsigned char *rgba, unsigned int width, unsigned int height)
 {
-  unsigned char *s;
-  unsigned char *d;
-  int w, h;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = vpRGBa::alpha_default;
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = vpRGBa::alpha_default;
-    }
-  }
+  convertPackedYUV422<true, 4>(yuyv, rgba, height * (width >> 1));
 }
 
 /*!
@@ -1250,48 +1506,7 @@ void vpImageConvert::YUYVToRGBa(unsigned char *yuyv, unsigned char *rgba, unsign
 */
 void vpImageConvert::YUYVToRGB(unsigned char *yuyv, unsigned char *rgb, unsigned int width, unsigned int height)
 {
-  unsigned char *s;
-  unsigned char *d;
-  int h, w;
-  int r, g, b, cr, cg, cb, y1, y2;
-
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgb;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
-
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
-
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-    }
-  }
+  convertPackedYUV422<true, 3>(yuyv, rgb, height * (width >> 1));
 }
 /*!
 
@@ -1302,13 +1517,7 @@ void vpImageConvert::YUYVToRGB(unsigned char *yuyv, unsigned char *rgb, unsigned
 */
 void vpImageConvert::YUYVToGrey(unsigned char *yuyv, unsigned char *grey, unsigned int size)
 {
-  unsigned int i = 0, j = 0;
-
-  while (j < size * 2) {
-    grey[i++] = yuyv[j];
-    grey[i++] = yuyv[j + 2];
-    j += 4;
-  }
+  extractEveryOtherByte<0>(yuyv, grey, size);
 }
 
 /*!
@@ -1319,798 +1528,101 @@ void vpImageConvert::YUYVToGrey(unsigned char *yuyv, unsigned char *grey, unsign
 */
 void vpImageConvert::YUV411ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int size)
 {
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGBa()" << std::endl;
-  for (unsigned int i = size / 4; i; i--) {
-    int U = (int)((*yuv++ - 128) * 0.354);
-    int U5 = 5 * U;
-    int Y0 = *yuv++;
-    int Y1 = *yuv++;
-    int V = (int)((*yuv++ - 128) * 0.707);
-    int V2 = 2 * V;
-    int Y2 = *yuv++;
-    int Y3 = *yuv++;
-    int UV = -U - V;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    int R = Y0 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    int G = Y0 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    int B = Y0 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
+  convertYUV411<4>(yuv, rgba, size);
+}
 
-    B = Y2 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
+/*!
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGBa images.
+  Destination rgba memory area has to be allocated before.
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
+  The alpha component of the converted image is set to vpRGBa::alpha_default.
 
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
+  \sa YUYVToRGBa()
+*/
+void vpImageConvert::YUV422ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int size)
+{
+  convertPackedYUV422<false, 4>(yuv, rgba, size / 2);
+}
 
-    G = Y3 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
+/*!
 
-    B = Y3 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
+Convert YUV411 into Grey
+yuv411 : u y1 y2 v y3 y4
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
-  }
-#else
-  // tres tres lent ....
+*/
+void vpImageConvert::YUV411ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size)
+{
   unsigned int i = 0, j = 0;
-  unsigned char r, g, b;
-  while (j < numpixels * 3 / 2) {
-
-    YUVToRGB(yuv[j + 1], yuv[j], yuv[j + 3], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
-    i += 4;
-
-    YUVToRGB(yuv[j + 2], yuv[j], yuv[j + 3], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
-    i += 4;
-
-    YUVToRGB(yuv[j + 4], yuv[j], yuv[j + 3], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
-    i += 4;
+  while (j < size * 3 / 2) {
+    grey[i] = yuv[j + 1];
+    grey[i + 1] = yuv[j + 2];
+    grey[i + 2] = yuv[j + 4];
+    grey[i + 3] = yuv[j + 5];
 
-    YUVToRGB(yuv[j + 5], yuv[j], yuv[j + 3], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
     i += 4;
 
     j += 6;
   }
-#endif
 }
 
 /*!
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGBa images.
-  Destination rgba memory area has to be allocated before.
 
-  The alpha component of the converted image is set to vpRGBa::alpha_default.
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
+  Destination rgb memory area has to be allocated before.
+
+  \sa YUYVToRGB()
 
-  \sa YUYVToRGBa()
 */
-void vpImageConvert::YUV422ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int size)
+void vpImageConvert::YUV422ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int size)
 {
+  convertPackedYUV422<false, 3>(yuv, rgb, size / 2);
+}
 
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGBa()" << std::endl;
-  for (unsigned int i = size / 2; i; i--) {
-    int U = (int)((*yuv++ - 128) * 0.354);
-    int U5 = 5 * U;
-    int Y0 = *yuv++;
-    int V = (int)((*yuv++ - 128) * 0.707);
-    int V2 = 2 * V;
-    int Y1 = *yuv++;
-    int UV = -U - V;
+/*!
 
-    //---
-    int R = Y0 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
+  Destination grey memory area has to be allocated before.
 
-    int G = Y0 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
+  \sa YUYVToGrey()
 
-    int B = Y0 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
+*/
+void vpImageConvert::YUV422ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size)
+{
+  extractEveryOtherByte<1>(yuv, grey, size);
+}
 
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
+/*!
 
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = vpRGBa::alpha_default;
-  }
-
-#else
-  // tres tres lent ....
-  unsigned int i = 0, j = 0;
-  unsigned char r, g, b;
-
-  while (j < size * 2) {
-
-    YUVToRGB(yuv[j + 1], yuv[j], yuv[j + 2], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
-    i += 4;
-
-    YUVToRGB(yuv[j + 3], yuv[j], yuv[j + 2], r, g, b);
-    rgba[i] = r;
-    rgba[i + 1] = g;
-    rgba[i + 2] = b;
-    rgba[i + 3] = vpRGBa::alpha_default;
-    i += 4;
-    j += 4;
-  }
-#endif
-}
-
-/*!
-
-Convert YUV411 into Grey
-yuv411 : u y1 y2 v y3 y4
-
-*/
-void vpImageConvert::YUV411ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size)
-{
-  unsigned int i = 0, j = 0;
-  while (j < size * 3 / 2) {
-    grey[i] = yuv[j + 1];
-    grey[i + 1] = yuv[j + 2];
-    grey[i + 2] = yuv[j + 4];
-    grey[i + 3] = yuv[j + 5];
-
-    i += 4;
-
-    j += 6;
-  }
-}
-
-/*!
-
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
-  Destination rgb memory area has to be allocated before.
-
-  \sa YUYVToRGB()
-
-*/
-void vpImageConvert::YUV422ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int size)
-{
-#if 1
-  //  std::cout << "call optimized convertYUV422ToRGB()" << std::endl;
-  for (unsigned int i = size / 2; i; i--) {
-    int U = (int)((*yuv++ - 128) * 0.354);
-    int U5 = 5 * U;
-    int Y0 = *yuv++;
-    int V = (int)((*yuv++ - 128) * 0.707);
-    int V2 = 2 * V;
-    int Y1 = *yuv++;
-    int UV = -U - V;
-
-    //---
-    int R = Y0 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    int G = Y0 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    int B = Y0 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-  }
-
-#else
-  // tres tres lent ....
-  unsigned int i = 0, j = 0;
-  unsigned char r, g, b;
-
-  while (j < size * 2) {
-
-    YUVToRGB(yuv[j + 1], yuv[j], yuv[j + 2], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-
-    YUVToRGB(yuv[j + 3], yuv[j], yuv[j + 2], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-    j += 4;
-  }
-#endif
-}
-
-/*!
-
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
-  Destination grey memory area has to be allocated before.
-
-  \sa YUYVToGrey()
-
-*/
-void vpImageConvert::YUV422ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size)
-{
-  unsigned int i = 0, j = 0;
-
-  while (j < size * 2) {
-    grey[i++] = yuv[j + 1];
-    grey[i++] = yuv[j + 3];
-    j += 4;
-  }
-}
-
-/*!
-
-Convert YUV411 into RGB
-yuv411 : u y1 y2 v y3 y4
+Convert YUV411 into RGB
+yuv411 : u y1 y2 v y3 y4
 
 */
 void vpImageConvert::YUV411ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int size)
 {
-#if 1
-  //  std::cout << "call optimized ConvertYUV411ToRGB()" << std::endl;
-  for (unsigned int i = size / 4; i; i--) {
-    int U = (int)((*yuv++ - 128) * 0.354);
-    int U5 = 5 * U;
-    int Y0 = *yuv++;
-    int Y1 = *yuv++;
-    int V = (int)((*yuv++ - 128) * 0.707);
-    int V2 = 2 * V;
-    int Y2 = *yuv++;
-    int Y3 = *yuv++;
-    int UV = -U - V;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    int R = Y0 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    int G = Y0 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    int B = Y0 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0)
-      R = 255;
-    else if (R < 0)
-      R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0)
-      G = 255;
-    else if (G < 0)
-      G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0)
-      B = 255;
-    else if (B < 0)
-      B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-  }
-#else
-  // tres tres lent ....
-
-  unsigned int i = 0, j = 0;
-  unsigned char r, g, b;
-
-  while (j < size * 3 / 2) {
-    YUVToRGB(yuv[j + 1], yuv[j], yuv[j + 3], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-
-    YUVToRGB(yuv[j + 2], yuv[j], yuv[j + 3], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-
-    YUVToRGB(yuv[j + 4], yuv[j], yuv[j + 3], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-
-    YUVToRGB(yuv[j + 5], yuv[j], yuv[j + 3], r, g, b);
-    rgb[i] = r;
-    rgb[i + 1] = g;
-    rgb[i + 2] = b;
-    i += 3;
-    // TRACE("r= %d g=%d b=%d", r, g, b);
-
-    j += 6;
-  }
-#endif
+  convertYUV411<3>(yuv, rgb, size);
 }
 
 /*!
 
   Convert YUV420 [Y(NxM), U(N/2xM/2), V(N/2xM/2)] image into RGBa image.
 
-  The alpha component of the converted image is set to vpRGBa::alpha_default.
-
-*/
-void vpImageConvert::YUV420ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
-{
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iU = yuv + size;
-  unsigned char *iV = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba + 4 * width - 7;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
-
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba - 4 * width + 1;
-    }
-    yuv += width;
-    rgba += 4 * width;
-  }
-}
-/*!
-
-  Convert YUV420 [Y(NxM), U(N/2xM/2), V(N/2xM/2)] image into RGB image.
-
-*/
-void vpImageConvert::YUV420ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
-{
-  //  std::cout << "call optimized ConvertYUV420ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iU = yuv + size;
-  unsigned char *iV = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb + 3 * width - 5;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
+  The alpha component of the converted image is set to vpRGBa::alpha_default.
 
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
+*/
+void vpImageConvert::YUV420ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+{
+  const unsigned int size = width * height;
+  convertYUV420<4>(yuv, yuv + size, yuv + 5 * size / 4, rgba, width, height);
+}
+/*!
 
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
+  Convert YUV420 [Y(NxM), U(N/2xM/2), V(N/2xM/2)] image into RGB image.
 
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb - 3 * width + 1;
-    }
-    yuv += width;
-    rgb += 3 * width;
-  }
+*/
+void vpImageConvert::YUV420ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
+{
+  const unsigned int size = width * height;
+  convertYUV420<3>(yuv, yuv + size, yuv + 5 * size / 4, rgb, width, height);
 }
 
 /*!
@@ -2120,9 +1632,7 @@ void vpImageConvert::YUV420ToRGB(unsigned char *yuv, unsigned char *rgb, unsigne
 */
 void vpImageConvert::YUV420ToGrey(unsigned char *yuv, unsigned char *grey, unsigned int size)
 {
-  for (unsigned int i = 0; i < size; i++) {
-    *grey++ = *yuv++;
-  }
+  memcpy(grey, yuv, size);
 }
 /*!
 
@@ -2235,258 +1745,18 @@ void vpImageConvert::YUV444ToGrey(unsigned char *yuv, unsigned char *grey, unsig
 */
 void vpImageConvert::YV12ToRGBa(unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iV = yuv + size;
-  unsigned char *iU = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = 0;
-      rgba = rgba + 4 * width - 7;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba++ = vpRGBa::alpha_default;
-
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgba++ = (unsigned char)R;
-      *rgba++ = (unsigned char)G;
-      *rgba++ = (unsigned char)B;
-      *rgba = vpRGBa::alpha_default;
-      rgba = rgba - 4 * width + 1;
-    }
-    yuv += width;
-    rgba += 4 * width;
-  }
+  const unsigned int size = width * height;
+  convertYUV420<4>(yuv, yuv + 5 * size / 4, yuv + size, rgba, width, height);
 }
 /*!
 
   Convert YV12 [Y(NxM), V(N/2xM/2), U(N/2xM/2)] image into RGB image.
 
 */
-void vpImageConvert::YV12ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int height, unsigned int width)
+void vpImageConvert::YV12ToRGB(unsigned char *yuv, unsigned char *rgb, unsigned int width, unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width * height;
-  unsigned char *iV = yuv + size;
-  unsigned char *iU = yuv + 5 * size / 4;
-  for (unsigned int i = 0; i < height / 2; i++) {
-    for (unsigned int j = 0; j < width / 2; j++) {
-      U = (int)((*iU++ - 128) * 0.354);
-      U5 = 5 * U;
-      V = (int)((*iV++ - 128) * 0.707);
-      V2 = 2 * V;
-      UV = -U - V;
-      Y0 = *yuv++;
-      Y1 = *yuv;
-      yuv = yuv + width - 1;
-      Y2 = *yuv++;
-      Y3 = *yuv;
-      yuv = yuv - width + 1;
-
-      // Original equations
-      // R = Y           + 1.402 V
-      // G = Y - 0.344 U - 0.714 V
-      // B = Y + 1.772 U
-      R = Y0 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y0 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y0 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y1 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y1 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y1 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb + 3 * width - 5;
-
-      //---
-      R = Y2 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y2 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y2 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb++ = (unsigned char)B;
-
-      //---
-      R = Y3 + V2;
-      if ((R >> 8) > 0)
-        R = 255;
-      else if (R < 0)
-        R = 0;
-
-      G = Y3 + UV;
-      if ((G >> 8) > 0)
-        G = 255;
-      else if (G < 0)
-        G = 0;
-
-      B = Y3 + U5;
-      if ((B >> 8) > 0)
-        B = 255;
-      else if (B < 0)
-        B = 0;
-
-      *rgb++ = (unsigned char)R;
-      *rgb++ = (unsigned char)G;
-      *rgb = (unsigned char)B;
-      rgb = rgb - 3 * width + 1;
-    }
-    yuv += width;
-    rgb += 3 * width;
-  }
+  const unsigned int size = width * height;
+  convertYUV420<3>(yuv, yuv + 5 * size / 4, yuv + size, rgb, width, height);
 }
 
 /*!
@@ -4345,24 +3615,22 @@ void vpImageConvert::split(const vpImage<vpRGBa> &src, vpImage<unsigned char> *p
 
       input = (unsigned char *)src.bitmap + j;
       i = 0;
-#if 1               // optimization
-      if (n >= 4) { /* boucle deroulee lsize fois    */
-        n -= 3;
-        for (; i < n; i += 4) {
-          *dst = *input;
-          input += 4;
-          dst++;
-          *dst = *input;
-          input += 4;
-          dst++;
-          *dst = *input;
-          input += 4;
-          dst++;
-          *dst = *input;
-          input += 4;
-          dst++;
+#if VISP_HAVE_SSE2
+      if (vpCPUFeatures::checkSSE2()) {
+        const __m128i v_mask = _mm_set1_epi32(0xFF);
+        const __m128i v_shift = _mm_cvtsi32_si128(8 * (int)j);
+        const unsigned char *ptr = (const unsigned char *)src.bitmap;
+        for (; i + 16 <= n; i += 16, ptr += 64, dst += 16) {
+          const __m128i v0 = _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i *)ptr), v_shift), v_mask);
+          const __m128i v1 =
+              _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i *)(ptr + 16)), v_shift), v_mask);
+          const __m128i v2 =
+              _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i *)(ptr + 32)), v_shift), v_mask);
+          const __m128i v3 =
+              _mm_and_si128(_mm_srl_epi32(_mm_loadu_si128((const __m128i *)(ptr + 48)), v_shift), v_mask);
+          _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3)));
         }
-        n += 3;
+        input += 4 * i;
       }
 #endif
       for (; i < n; i++) {
@@ -4414,7 +3682,19 @@ void vpImageConvert::merge(const vpImage<unsigned char> *R, const vpImage<unsign
     RGBa.resize(height, width);
 
     unsigned int size = width * height;
-    for (unsigned int i = 0; i < size; i++) {
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    if (R != NULL && G != NULL && B != NULL && a != NULL && vpCPUFeatures::checkSSE2()) {
+      unsigned char *dst = (unsigned char *)RGBa.bitmap;
+      for (; i + 16 <= size; i += 16, dst += 64) {
+        storeRGBa(_mm_loadu_si128((const __m128i *)(R->bitmap + i)),
+                  _mm_loadu_si128((const __m128i *)(G->bitmap + i)),
+                  _mm_loadu_si128((const __m128i *)(B->bitmap + i)),
+                  _mm_loadu_si128((const __m128i *)(a->bitmap + i)), dst);
+      }
+    }
+#endif
+    for (; i < size; i++) {
       if (R != NULL) {
         RGBa.bitmap[i].R = R->bitmap[i];
       }
@@ -4448,13 +3728,8 @@ void vpImageConvert::merge(const vpImage<unsigned char> *R, const vpImage<unsign
 */
 void vpImageConvert::MONO16ToGrey(unsigned char *grey16, unsigned char *grey, unsigned int size)
 {
-  int i = (((int)size) << 1) - 1;
-  int j = (int)size - 1;
-
-  while (i >= 0) {
-    int y = grey16[i--];
-    grey[j--] = static_cast<unsigned char>((y + (grey16[i--] << 8)) >> 8);
-  }
+  // Keep the most significant byte, the forward order allows an in-place conversion
+  extractEveryOtherByte<0>(grey16, grey, size);
 }
 
 /*!
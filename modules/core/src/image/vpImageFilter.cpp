@@ -36,6 +36,9 @@
  *
  *****************************************************************************/
 
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpImageFilter.h>
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
@@ -46,6 +49,612 @@
 #include <cv.h>
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined __ARM_NEON && defined __aarch64__
+#include <arm_neon.h>
+#define VISP_HAVE_NEON 1
+#endif
+
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON
+#define VISP_HAVE_SIMD 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Below this number of pixels the rows are filtered by a single thread
+const unsigned int nbPixelsMinParallel = 128 * 128;
+
+bool checkSIMD()
+{
+#if VISP_HAVE_SSE2
+  return vpCPUFeatures::checkSSE2();
+#elif VISP_HAVE_NEON
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if VISP_HAVE_SIMD
+/*
+  Packed floating point operations, such that the kernels below are written
+  once for double and float images. A register holds nbLanes values.
+*/
+template <class Type> struct SIMDVector;
+
+#if VISP_HAVE_SSE2
+// 8 signed 16-bit integers
+typedef __m128i SIMDInt16;
+
+// Load 8 pixels and widen them to 16-bit integers
+inline SIMDInt16 loadU8(const unsigned char *const ptr)
+{
+  return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ptr), _mm_setzero_si128());
+}
+inline SIMDInt16 addInt16(const SIMDInt16 &a, const SIMDInt16 &b) { return _mm_add_epi16(a, b); }
+inline SIMDInt16 subInt16(const SIMDInt16 &a, const SIMDInt16 &b) { return _mm_sub_epi16(a, b); }
+
+template <> struct SIMDVector<double> {
+  typedef __m128d Reg;
+  static const unsigned int nbLanes = 2;
+
+  static inline Reg zero() { return _mm_setzero_pd(); }
+  static inline Reg set1(const double val) { return _mm_set1_pd(val); }
+  static inline Reg load(const double *const ptr) { return _mm_loadu_pd(ptr); }
+  static inline void store(double *const ptr, const Reg &a) { _mm_storeu_pd(ptr, a); }
+  static inline Reg add(const Reg &a, const Reg &b) { return _mm_add_pd(a, b); }
+  static inline Reg sub(const Reg &a, const Reg &b) { return _mm_sub_pd(a, b); }
+  static inline Reg mul(const Reg &a, const Reg &b) { return _mm_mul_pd(a, b); }
+
+  // Convert 8 signed 16-bit integers into 4 registers
+  static inline void convert(const SIMDInt16 &v, Reg *const r)
+  {
+    const __m128i v_lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    const __m128i v_hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    r[0] = _mm_cvtepi32_pd(v_lo);
+    r[1] = _mm_cvtepi32_pd(_mm_srli_si128(v_lo, 8));
+    r[2] = _mm_cvtepi32_pd(v_hi);
+    r[3] = _mm_cvtepi32_pd(_mm_srli_si128(v_hi, 8));
+  }
+};
+
+template <> struct SIMDVector<float> {
+  typedef __m128 Reg;
+  static const unsigned int nbLanes = 4;
+
+  static inline Reg zero() { return _mm_setzero_ps(); }
+  static inline Reg set1(const float val) { return _mm_set1_ps(val); }
+  static inline Reg load(const float *const ptr) { return _mm_loadu_ps(ptr); }
+  static inline void store(float *const ptr, const Reg &a) { _mm_storeu_ps(ptr, a); }
+  static inline Reg add(const Reg &a, const Reg &b) { return _mm_add_ps(a, b); }
+  static inline Reg sub(const Reg &a, const Reg &b) { return _mm_sub_ps(a, b); }
+  static inline Reg mul(const Reg &a, const Reg &b) { return _mm_mul_ps(a, b); }
+
+  // Convert 8 signed 16-bit integers into 2 registers
+  static inline void convert(const SIMDInt16 &v, Reg *const r)
+  {
+    r[0] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+    r[1] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+  }
+};
+#else
+typedef int16x8_t SIMDInt16;
+
+inline SIMDInt16 loadU8(const unsigned char *const ptr) { return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ptr))); }
+inline SIMDInt16 addInt16(const SIMDInt16 &a, const SIMDInt16 &b) { return vaddq_s16(a, b); }
+inline SIMDInt16 subInt16(const SIMDInt16 &a, const SIMDInt16 &b) { return vsubq_s16(a, b); }
+
+template <> struct SIMDVector<double> {
+  typedef float64x2_t Reg;
+  static const unsigned int nbLanes = 2;
+
+  static inline Reg zero() { return vdupq_n_f64(0.0); }
+  static inline Reg set1(const double val) { return vdupq_n_f64(val); }
+  static inline Reg load(const double *const ptr) { return vld1q_f64(ptr); }
+  static inline void store(double *const ptr, const Reg &a) { vst1q_f64(ptr, a); }
+  static inline Reg add(const Reg &a, const Reg &b) { return vaddq_f64(a, b); }
+  static inline Reg sub(const Reg &a, const Reg &b) { return vsubq_f64(a, b); }
+  static inline Reg mul(const Reg &a, const Reg &b) { return vmulq_f64(a, b); }
+
+  static inline void convert(const SIMDInt16 &v, Reg *const r)
+  {
+    const int32x4_t v_lo = vmovl_s16(vget_low_s16(v));
+    const int32x4_t v_hi = vmovl_s16(vget_high_s16(v));
+    r[0] = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v_lo)));
+    r[1] = vcvtq_f64_s64(vmovl_s32(vget_high_s32(v_lo)));
+    r[2] = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v_hi)));
+    r[3] = vcvtq_f64_s64(vmovl_s32(vget_high_s32(v_hi)));
+  }
+};
+
+template <> struct SIMDVector<float> {
+  typedef float32x4_t Reg;
+  static const unsigned int nbLanes = 4;
+
+  static inline Reg zero() { return vdupq_n_f32(0.0f); }
+  static inline Reg set1(const float val) { return vdupq_n_f32(val); }
+  static inline Reg load(const float *const ptr) { return vld1q_f32(ptr); }
+  static inline void store(float *const ptr, const Reg &a) { vst1q_f32(ptr, a); }
+  static inline Reg add(const Reg &a, const Reg &b) { return vaddq_f32(a, b); }
+  static inline Reg sub(const Reg &a, const Reg &b) { return vsubq_f32(a, b); }
+  static inline Reg mul(const Reg &a, const Reg &b) { return vmulq_f32(a, b); }
+
+  static inline void convert(const SIMDInt16 &v, Reg *const r)
+  {
+    r[0] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+    r[1] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+  }
+};
+#endif
+#endif // VISP_HAVE_SIMD
+
+/*
+  Filter the columns [half_size, width - half_size) of a row with a kernel of
+  (size + 1) / 2 coefficients:
+  - derivative == false: dst[j] = sum_k filter[k] (src[j+k] + src[j-k]) + filter[0] src[j]
+  - derivative == true: dst[j] = sum_k filter[k] (src[j+k] - src[j-k])
+  The vectorized and the scalar code perform the same operations in the same
+  order, thus the results are identical.
+*/
+template <bool derivative, class Type>
+void filterRowInterior(const Type *const src, Type *const dst, const unsigned int width, const Type *const filter,
+                       const unsigned int size, const bool useSIMD)
+{
+  const unsigned int half_size = (size - 1) / 2;
+  if (width < 2 * half_size) {
+    return;
+  }
+
+  const unsigned int end = width - half_size;
+  unsigned int j = half_size;
+
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    typedef SIMDVector<Type> V;
+    for (; j + V::nbLanes <= end; j += V::nbLanes) {
+      typename V::Reg v_result = V::zero();
+      for (unsigned int k = 1; k <= half_size; k++) {
+        const typename V::Reg v_next = V::load(src + j + k);
+        const typename V::Reg v_prev = V::load(src + j - k);
+        v_result = V::add(v_result, V::mul(V::set1(filter[k]), derivative ? V::sub(v_next, v_prev)
+                                                                          : V::add(v_next, v_prev)));
+      }
+      if (!derivative) {
+        v_result = V::add(v_result, V::mul(V::set1(filter[0]), V::load(src + j)));
+      }
+      V::store(dst + j, v_result);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  for (; j < end; j++) {
+    Type result = 0;
+    for (unsigned int k = 1; k <= half_size; k++) {
+      result += filter[k] * (derivative ? src[j + k] - src[j - k] : src[j + k] + src[j - k]);
+    }
+    dst[j] = derivative ? result : result + filter[0] * src[j];
+  }
+}
+
+/*
+  Filter all the columns of the row i, that must be at least half_size pixels
+  away from the top and bottom borders, along the vertical direction. Same
+  kernels than filterRowInterior().
+*/
+template <bool derivative, class Type>
+void filterColumns(const vpImage<Type> &I, const unsigned int i, Type *const dst, const Type *const filter,
+                   const unsigned int size, const bool useSIMD)
+{
+  const unsigned int half_size = (size - 1) / 2;
+  const unsigned int width = I.getWidth();
+  unsigned int j = 0;
+
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    typedef SIMDVector<Type> V;
+    for (; j + V::nbLanes <= width; j += V::nbLanes) {
+      typename V::Reg v_result = V::zero();
+      for (unsigned int k = 1; k <= half_size; k++) {
+        const typename V::Reg v_next = V::load(I[i + k] + j);
+        const typename V::Reg v_prev = V::load(I[i - k] + j);
+        v_result = V::add(v_result, V::mul(V::set1(filter[k]), derivative ? V::sub(v_next, v_prev)
+                                                                          : V::add(v_next, v_prev)));
+      }
+      if (!derivative) {
+        v_result = V::add(v_result, V::mul(V::set1(filter[0]), V::load(I[i] + j)));
+      }
+      V::store(dst + j, v_result);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  for (; j < width; j++) {
+    Type result = 0;
+    for (unsigned int k = 1; k <= half_size; k++) {
+      result += filter[k] * (derivative ? I[i + k][j] - I[i - k][j] : I[i + k][j] + I[i - k][j]);
+    }
+    dst[j] = derivative ? result : result + filter[0] * I[i][j];
+  }
+}
+
+/*
+  Same as above for an unsigned char image. The sums and differences of two
+  pixels are computed on integers, as in the scalar code, and 8 columns are
+  processed at once.
+*/
+template <bool derivative, class Type>
+void filterColumns(const vpImage<unsigned char> &I, const unsigned int i, Type *const dst, const Type *const filter,
+                   const unsigned int size, const bool useSIMD)
+{
+  const unsigned int half_size = (size - 1) / 2;
+  const unsigned int width = I.getWidth();
+  unsigned int j = 0;
+
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    typedef SIMDVector<Type> V;
+    const unsigned int nbRegs = 8 / V::nbLanes;
+    typename V::Reg v_pair[4], v_result[4];
+    for (; j + 8 <= width; j += 8) {
+      for (unsigned int n = 0; n < nbRegs; n++) {
+        v_result[n] = V::zero();
+      }
+      for (unsigned int k = 1; k <= half_size; k++) {
+        const SIMDInt16 v_next = loadU8(I[i + k] + j);
+        const SIMDInt16 v_prev = loadU8(I[i - k] + j);
+        V::convert(derivative ? subInt16(v_next, v_prev) : addInt16(v_next, v_prev), v_pair);
+
+        const typename V::Reg v_filter = V::set1(filter[k]);
+        for (unsigned int n = 0; n < nbRegs; n++) {
+          v_result[n] = V::add(v_result[n], V::mul(v_filter, v_pair[n]));
+        }
+      }
+      if (!derivative) {
+        V::convert(loadU8(I[i] + j), v_pair);
+
+        const typename V::Reg v_filter = V::set1(filter[0]);
+        for (unsigned int n = 0; n < nbRegs; n++) {
+          v_result[n] = V::add(v_result[n], V::mul(v_filter, v_pair[n]));
+        }
+      }
+      for (unsigned int n = 0; n < nbRegs; n++) {
+        V::store(dst + j + V::nbLanes * n, v_result[n]);
+      }
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  for (; j < width; j++) {
+    Type result = 0;
+    for (unsigned int k = 1; k <= half_size; k++) {
+      result += filter[k] * (derivative ? I[i + k][j] - I[i - k][j] : I[i + k][j] + I[i - k][j]);
+    }
+    dst[j] = derivative ? result : result + filter[0] * I[i][j];
+  }
+}
+
+/*
+  Correlation of the columns [half_size, width - half_size) of a row with a
+  non symmetric kernel of size coefficients: dst[j] = sum_a kernel[a] src[j + half_size - a].
+*/
+template <class Type>
+void correlateRowInterior(const Type *const src, Type *const dst, const unsigned int width, const Type *const kernel,
+                          const unsigned int size, const unsigned int half_size, const bool useSIMD)
+{
+  if (width < 2 * half_size) {
+    return;
+  }
+
+  const unsigned int end = width - half_size;
+  unsigned int j = half_size;
+
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    typedef SIMDVector<Type> V;
+    for (; j + V::nbLanes <= end; j += V::nbLanes) {
+      typename V::Reg v_result = V::zero();
+      for (unsigned int a = 0; a < size; a++) {
+        v_result = V::add(v_result, V::mul(V::set1(kernel[a]), V::load(src + j + half_size - a)));
+      }
+      V::store(dst + j, v_result);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  for (; j < end; j++) {
+    Type conv = 0;
+    for (unsigned int a = 0; a < size; a++) {
+      conv += kernel[a] * src[j + half_size - a];
+    }
+    dst[j] = conv;
+  }
+}
+
+/*
+  Correlation of all the columns of the row i along the vertical direction
+  with a non symmetric kernel: dst[j] = sum_a kernel[a] I[i + half_size - a][j].
+*/
+template <class Type>
+void correlateColumns(const vpImage<Type> &I, const unsigned int i, Type *const dst, const Type *const kernel,
+                      const unsigned int size, const unsigned int half_size, const bool useSIMD)
+{
+  const unsigned int width = I.getWidth();
+  unsigned int j = 0;
+
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    typedef SIMDVector<Type> V;
+    for (; j + V::nbLanes <= width; j += V::nbLanes) {
+      typename V::Reg v_result = V::zero();
+      for (unsigned int a = 0; a < size; a++) {
+        v_result = V::add(v_result, V::mul(V::set1(kernel[a]), V::load(I[i + half_size - a] + j)));
+      }
+      V::store(dst + j, v_result);
+    }
+  }
+#else
+  (void)useSIMD;
+#endif
+
+  for (; j < width; j++) {
+    Type conv = 0;
+    for (unsigned int a = 0; a < size; a++) {
+      conv += kernel[a] * I[i + half_size - a][j];
+    }
+    dst[j] = conv;
+  }
+}
+
+// Copy a row of an unsigned char image into a floating point buffer
+template <class Type>
+inline const Type *convertRow(const vpImage<unsigned char> &I, const unsigned int i, std::vector<Type> &row)
+{
+  const unsigned char *const src = I[i];
+  for (unsigned int j = 0; j < I.getWidth(); j++) {
+    row[j] = src[j];
+  }
+
+  return row.empty() ? NULL : &row[0];
+}
+
+template <class Type>
+inline const Type *convertRow(const vpImage<Type> &I, const unsigned int i, std::vector<Type> &)
+{
+  return I[i];
+}
+
+/*
+  Borders handled by symmetry, same formulas than
+  vpImageFilter::filterXLeftBorder() and co. for any output type.
+*/
+template <class ImageType, class Type>
+Type filterXLeftBorderImpl(const vpImage<ImageType> &I, const unsigned int r, const unsigned int c,
+                           const Type *const filter, const unsigned int size)
+{
+  Type result = 0;
+  for (unsigned int i = 1; i <= (size - 1) / 2; i++) {
+    if (c > i)
+      result += filter[i] * (I[r][c + i] + I[r][c - i]);
+    else
+      result += filter[i] * (I[r][c + i] + I[r][i - c]);
+  }
+  return result + filter[0] * I[r][c];
+}
+
+template <class ImageType, class Type>
+Type filterXRightBorderImpl(const vpImage<ImageType> &I, const unsigned int r, const unsigned int c,
+                            const Type *const filter, const unsigned int size)
+{
+  Type result = 0;
+  for (unsigned int i = 1; i <= (size - 1) / 2; i++) {
+    if (c + i < I.getWidth())
+      result += filter[i] * (I[r][c + i] + I[r][c - i]);
+    else
+      result += filter[i] * (I[r][2 * I.getWidth() - c - i - 1] + I[r][c - i]);
+  }
+  return result + filter[0] * I[r][c];
+}
+
+template <class ImageType, class Type>
+Type filterYTopBorderImpl(const vpImage<ImageType> &I, const unsigned int r, const unsigned int c,
+                          const Type *const filter, const unsigned int size)
+{
+  Type result = 0;
+  for (unsigned int i = 1; i <= (size - 1) / 2; i++) {
+    if (r > i)
+      result += filter[i] * (I[r + i][c] + I[r - i][c]);
+    else
+      result += filter[i] * (I[r + i][c] + I[i - r][c]);
+  }
+  return result + filter[0] * I[r][c];
+}
+
+template <class ImageType, class Type>
+Type filterYBottomBorderImpl(const vpImage<ImageType> &I, const unsigned int r, const unsigned int c,
+                             const Type *const filter, const unsigned int size)
+{
+  Type result = 0;
+  for (unsigned int i = 1; i <= (size - 1) / 2; i++) {
+    if (r + i < I.getHeight())
+      result += filter[i] * (I[r + i][c] + I[r - i][c]);
+    else
+      result += filter[i] * (I[2 * I.getHeight() - r - i - 1][c] + I[r - i][c]);
+  }
+  return result + filter[0] * I[r][c];
+}
+
+// Filter a row along the horizontal direction, borders are handled by symmetry
+template <class ImageType, class Type>
+void filterXRow(const vpImage<ImageType> &I, const unsigned int i, std::vector<Type> &row, Type *const dst,
+                const Type *const filter, const unsigned int size, const bool useSIMD)
+{
+  const unsigned int half_size = (size - 1) / 2;
+  for (unsigned int j = 0; j < half_size; j++) {
+    dst[j] = filterXLeftBorderImpl(I, i, j, filter, size);
+  }
+
+  filterRowInterior<false>(convertRow(I, i, row), dst, I.getWidth(), filter, size, useSIMD);
+
+  for (unsigned int j = I.getWidth() - half_size; j < I.getWidth(); j++) {
+    dst[j] = filterXRightBorderImpl(I, i, j, filter, size);
+  }
+}
+
+template <class ImageType, class Type>
+void filterXImpl(const vpImage<ImageType> &I, vpImage<Type> &dIx, const Type *const filter, const unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+
+  const bool useSIMD = checkSIMD();
+  const int height = (int)I.getHeight();
+#if defined _OPENMP
+#pragma omp parallel if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  {
+    std::vector<Type> row(I.getWidth());
+#if defined _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < height; i++) {
+      filterXRow(I, (unsigned int)i, row, dIx[i], filter, size, useSIMD);
+    }
+  }
+}
+
+// Filter along the vertical direction, borders are handled by symmetry
+template <class ImageType, class Type>
+void filterYImpl(const vpImage<ImageType> &I, vpImage<Type> &dIy, const Type *const filter, const unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth());
+
+  const bool useSIMD = checkSIMD();
+  const unsigned int half_size = (size - 1) / 2;
+  const int height = (int)I.getHeight();
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  for (int i = 0; i < height; i++) {
+    const unsigned int r = (unsigned int)i;
+    if (r >= I.getHeight() - half_size) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        dIy[r][j] = filterYBottomBorderImpl(I, r, j, filter, size);
+      }
+    } else if (r < half_size) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        dIy[r][j] = filterYTopBorderImpl(I, r, j, filter, size);
+      }
+    } else {
+      filterColumns<false>(I, r, dIy[r], filter, size, useSIMD);
+    }
+  }
+}
+
+// Derivative along the horizontal direction, the borders are set to 0
+template <class ImageType, class Type>
+void getGradXImpl(const vpImage<ImageType> &I, vpImage<Type> &dIx, const Type *const filter, const unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+
+  const bool useSIMD = checkSIMD();
+  const unsigned int half_size = (size - 1) / 2;
+  const int height = (int)I.getHeight();
+#if defined _OPENMP
+#pragma omp parallel if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  {
+    std::vector<Type> row(I.getWidth());
+#if defined _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < height; i++) {
+      const unsigned int r = (unsigned int)i;
+      for (unsigned int j = 0; j < half_size; j++) {
+        dIx[r][j] = 0;
+      }
+
+      filterRowInterior<true>(convertRow(I, r, row), dIx[r], I.getWidth(), filter, size, useSIMD);
+
+      for (unsigned int j = I.getWidth() - half_size; j < I.getWidth(); j++) {
+        dIx[r][j] = 0;
+      }
+    }
+  }
+}
+
+// Derivative along the vertical direction, the borders are set to 0
+template <class ImageType, class Type>
+void getGradYImpl(const vpImage<ImageType> &I, vpImage<Type> &dIy, const Type *const filter, const unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth());
+
+  const bool useSIMD = checkSIMD();
+  const unsigned int half_size = (size - 1) / 2;
+  const int height = (int)I.getHeight();
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  for (int i = 0; i < height; i++) {
+    const unsigned int r = (unsigned int)i;
+    if (r < half_size || r >= I.getHeight() - half_size) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        dIy[r][j] = 0;
+      }
+    } else {
+      filterColumns<true>(I, r, dIy[r], filter, size, useSIMD);
+    }
+  }
+}
+
+// Separable correlation, only the pixels fully covered by the kernels are computed
+template <class Type>
+void sepFilterImpl(const vpImage<unsigned char> &I, vpImage<Type> &If, const Type *const kernelH,
+                   const unsigned int sizeH, const Type *const kernelV, const unsigned int sizeV)
+{
+  const unsigned int half_size = sizeH / 2;
+
+  If.resize(I.getHeight(), I.getWidth(), 0);
+  vpImage<Type> I_filter(I.getHeight(), I.getWidth(), 0);
+
+  const bool useSIMD = checkSIMD();
+  const int height = (int)I.getHeight();
+#if defined _OPENMP
+#pragma omp parallel if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  {
+    std::vector<Type> row(I.getWidth());
+#if defined _OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < height; i++) {
+      correlateRowInterior(convertRow(I, (unsigned int)i, row), I_filter[i], I.getWidth(), kernelH, sizeH, half_size,
+                           useSIMD);
+    }
+  }
+
+  const int end = (int)I.getHeight() - (int)half_size;
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (I.getSize() >= nbPixelsMinParallel)
+#endif
+  for (int i = (int)half_size; i < end; i++) {
+    correlateColumns(I_filter, (unsigned int)i, If[i], kernelV, sizeV, half_size, useSIMD);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Apply a filter to an image.
   \param I : Image to filter
@@ -224,33 +833,35 @@ void vpImageFilter::filter(const vpImage<double> &I, vpImage<double> &Iu, vpImag
 void vpImageFilter::sepFilter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
                               const vpColVector &kernelV)
 {
-  unsigned int size = kernelH.size();
-  unsigned int half_size = size / 2;
+  sepFilterImpl(I, If, kernelH.data, kernelH.size(), kernelV.data, kernelV.size());
+}
 
-  If.resize(I.getHeight(), I.getWidth(), 0.0);
-  vpImage<double> I_filter(I.getHeight(), I.getWidth(), 0.0);
+/*!
+  Apply a filter to an image using two separable kernels, the computations
+  being done in single precision.
 
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = half_size; j < I.getWidth() - half_size; j++) {
-      double conv = 0.0;
-      for (unsigned int a = 0; a < kernelH.size(); a++) {
-        conv += kernelH[a] * I[i][j + half_size - a];
-      }
+  \param I : Image to filter
+  \param If : Filtered image.
+  \param kernelH : Separable kernel (performed first).
+  \param kernelV : Separable kernel (performed last).
+  \note Only pixels in the input image fully covered by the kernel are
+  considered.
 
-      I_filter[i][j] = conv;
-    }
+  \sa sepFilter(const vpImage<unsigned char> &, vpImage<double> &, const vpColVector &, const vpColVector &)
+*/
+void vpImageFilter::sepFilter(const vpImage<unsigned char> &I, vpImage<float> &If, const vpColVector &kernelH,
+                              const vpColVector &kernelV)
+{
+  std::vector<float> kernelH_float(kernelH.size()), kernelV_float(kernelV.size());
+  for (unsigned int i = 0; i < kernelH.size(); i++) {
+    kernelH_float[i] = (float)kernelH[i];
   }
-
-  for (unsigned int i = half_size; i < I.getHeight() - half_size; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      double conv = 0.0;
-      for (unsigned int a = 0; a < kernelV.size(); a++) {
-        conv += kernelV[a] * I_filter[i + half_size - a][j];
-      }
-
-      If[i][j] = conv;
-    }
+  for (unsigned int i = 0; i < kernelV.size(); i++) {
+    kernelV_float[i] = (float)kernelV[i];
   }
+
+  sepFilterImpl(I, If, kernelH_float.empty() ? NULL : &kernelH_float[0], kernelH.size(),
+                kernelV_float.empty() ? NULL : &kernelV_float[0], kernelV.size());
 }
 
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
@@ -343,79 +954,61 @@ void vpImageFilter::filter(const vpImage<double> &I, vpImage<double> &GI, const
   GIx.destroy();
 }
 
+/*!
+  Apply a separable filter, the computations being done in single precision.
+ */
+void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<float> &GI, const float *filter, unsigned int size)
+{
+  vpImage<float> GIx;
+  filterX(I, GIx, filter, size);
+  filterY(GIx, GI, filter, size);
+}
+
+/*!
+  Apply a separable filter, the computations being done in single precision.
+ */
+void vpImageFilter::filter(const vpImage<float> &I, vpImage<float> &GI, const float *filter, unsigned int size)
+{
+  vpImage<float> GIx;
+  filterX(I, GIx, filter, size);
+  filterY(GIx, GI, filter, size);
+}
+
 void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                             unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  filterXImpl(I, dIx, filter, size);
 }
 void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  filterXImpl(I, dIx, filter, size);
 }
 void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
                             unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  filterYImpl(I, dIy, filter, size);
 }
 void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  filterYImpl(I, dIy, filter, size);
+}
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                            unsigned int size)
+{
+  filterXImpl(I, dIx, filter, size);
+}
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size)
+{
+  filterXImpl(I, dIx, filter, size);
+}
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                            unsigned int size)
+{
+  filterYImpl(I, dIy, filter, size);
+}
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size)
+{
+  filterYImpl(I, dIy, filter, size);
 }
 
 /*!
@@ -464,6 +1057,47 @@ void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double> &GI,
   delete[] fg;
 }
 
+/*!
+  Apply a Gaussian blur to an image, the computations being done in single
+  precision. This is faster than gaussianBlur(const vpImage<unsigned char> &,
+  vpImage<double> &, unsigned int, double, bool) since twice more pixels are
+  processed by each SIMD instruction and the memory traffic is halved.
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or
+  negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter
+  coefficients or not.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<float> &GI, unsigned int size, double sigma,
+                                 bool normalize)
+{
+  float *fg = new float[(size + 1) / 2];
+  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize);
+  vpImageFilter::filter(I, GI, fg, size);
+  delete[] fg;
+}
+
+/*!
+  Apply a Gaussian blur to a float image.
+  \param I : Input float image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or
+  negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter
+  coefficients or not.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<float> &I, vpImage<float> &GI, unsigned int size, double sigma,
+                                 bool normalize)
+{
+  float *fg = new float[(size + 1) / 2];
+  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize);
+  vpImageFilter::filter(I, GI, fg, size);
+  delete[] fg;
+}
+
 /*!
   Return the coefficients of a Gaussian filter.
 
@@ -543,6 +1177,41 @@ void vpImageFilter::getGaussianDerivativeKernel(double *filter, unsigned int siz
   }
 }
 
+/*!
+  Return the coefficients of a Gaussian filter in single precision. They are
+  computed in double precision, see getGaussianKernel(double *, unsigned int,
+  double, bool), and then rounded.
+*/
+void vpImageFilter::getGaussianKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  if (size % 2 != 1)
+    throw(vpImageException(vpImageException::incorrectInitializationError, "Bad Gaussian filter size"));
+
+  std::vector<double> filter_double((size + 1) / 2);
+  getGaussianKernel(&filter_double[0], size, sigma, normalize);
+  for (size_t i = 0; i < filter_double.size(); i++) {
+    filter[i] = (float)filter_double[i];
+  }
+}
+
+/*!
+  Return the coefficients of a Gaussian derivative filter in single
+  precision. They are computed in double precision, see
+  getGaussianDerivativeKernel(double *, unsigned int, double, bool), and then
+  rounded.
+*/
+void vpImageFilter::getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  if (size % 2 != 1)
+    throw(vpImageException(vpImageException::incorrectInitializationError, "Bad Gaussian filter size"));
+
+  std::vector<double> filter_double((size + 1) / 2);
+  getGaussianDerivativeKernel(&filter_double[0], size, sigma, normalize);
+  for (size_t i = 0; i < filter_double.size(); i++) {
+    filter[i] = (float)filter_double[i];
+  }
+}
+
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx)
 {
   dIx.resize(I.getHeight(), I.getWidth());
@@ -584,80 +1253,42 @@ void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &d
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                              unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  getGradXImpl(I, dIx, filter, size);
 }
 void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  // dIx=0;
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  getGradXImpl(I, dIx, filter, size);
 }
 
 void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
                              unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
+  getGradYImpl(I, dIy, filter, size);
 }
 
 void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  // dIy=0;
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
+  getGradYImpl(I, dIy, filter, size);
+}
+
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                             unsigned int size)
+{
+  getGradXImpl(I, dIx, filter, size);
+}
+void vpImageFilter::getGradX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size)
+{
+  getGradXImpl(I, dIx, filter, size);
+}
+
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                             unsigned int size)
+{
+  getGradYImpl(I, dIy, filter, size);
+}
+void vpImageFilter::getGradY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size)
+{
+  getGradYImpl(I, dIy, filter, size);
 }
 
 /*!
@@ -696,6 +1327,44 @@ void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<dou
   vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
 }
 
+/*!
+   Compute the gradient along X after applying a gaussian filter along Y, the
+   computations being done in single precision.
+   \param I : Input image
+   \param dIx : Gradient along X.
+   \param gaussianKernel : Gaussian kernel which values should be computed
+   using vpImageFilter::getGaussianKernel().
+   \param gaussianDerivativeKernel : Gaussian derivative kernel which values
+   should be computed using vpImageFilter::getGaussianDerivativeKernel().
+   \param size : Size of the Gaussian and Gaussian derivative kernels.
+ */
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImage<float> GIy;
+  vpImageFilter::filterY(I, GIy, gaussianKernel, size);
+  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size);
+}
+
+/*!
+   Compute the gradient along Y after applying a gaussian filter along X, the
+   computations being done in single precision.
+   \param I : Input image
+   \param dIy : Gradient along Y.
+   \param gaussianKernel : Gaussian kernel which values should be computed
+   using vpImageFilter::getGaussianKernel().
+   \param gaussianDerivativeKernel : Gaussian derivative kernel which values
+   should be computed using vpImageFilter::getGaussianDerivativeKernel().
+   \param size : Size of the Gaussian and Gaussian derivative kernels.
+ */
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImage<float> GIx;
+  vpImageFilter::filterX(I, GIx, gaussianKernel, size);
+  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
+}
+
 // operation pour pyramide gaussienne
 void vpImageFilter::getGaussPyramidal(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI)
 {
@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Image pyramid with reusable levels.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+
+/*!
+  Create an empty pyramid.
+
+  \param type : Method used to compute a level from the previous one.
+*/
+vpImagePyramid::vpImagePyramid(const vpImagePyramidType &type)
+  : m_I(NULL), m_levels(), m_isBuilt(), m_buffer(), m_frameStamp(0), m_hasFrameStamp(false), m_nbLevels(0),
+    m_type(type)
+{
+}
+
+/*!
+  Build the pyramid of \e I. The pyramid is always computed, and the frame
+  stamp is invalidated.
+
+  \param I : Input image, used as level 0. It is not copied and must remain
+  valid as long as the pyramid is used.
+  \param nbLevels : Number of levels, including level 0.
+
+  \exception vpException::badValue : If \e nbLevels is 0.
+  \exception vpException::dimensionError : If \e I is too small to build
+  \e nbLevels levels.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const unsigned int nbLevels)
+{
+  build(I, std::vector<bool>(nbLevels, true));
+}
+
+/*!
+  Build the pyramid of the frame \e frameStamp. If the pyramid was already
+  built for this frame and from the same image, the existing levels are kept
+  and only the missing ones are computed.
+
+  \param I : Input image, used as level 0. It is not copied and must remain
+  valid as long as the pyramid is used.
+  \param nbLevels : Number of levels, including level 0.
+  \param frameStamp : Identifier of the frame, for example the frame index.
+
+  \exception vpException::badValue : If \e nbLevels is 0.
+  \exception vpException::dimensionError : If \e I is too small to build
+  \e nbLevels levels.
+
+  \sa isUpToDate()
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const unsigned int nbLevels,
+                           const unsigned long frameStamp)
+{
+  build(I, std::vector<bool>(nbLevels, true), frameStamp);
+}
+
+/*!
+  Build the levels of the pyramid of \e I that are used. The pyramid is
+  always computed, and the frame stamp is invalidated.
+
+  \param I : Input image, used as level 0. It is not copied and must remain
+  valid as long as the pyramid is used.
+  \param levels : The pyramid has levels.size() levels, the level \e l being
+  computed if levels[l] is true. Level 0 is always available.
+
+  \exception vpException::badValue : If \e levels is empty.
+  \exception vpException::dimensionError : If \e I is too small to build
+  the used levels.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const std::vector<bool> &levels)
+{
+  if (levels.empty()) {
+    throw vpException(vpException::badValue, "An image pyramid must have at least one level");
+  }
+
+  m_hasFrameStamp = false;
+  reset(I);
+  buildLevels(levels);
+}
+
+/*!
+  Build the levels of the pyramid of the frame \e frameStamp that are used.
+  If the pyramid was already built for this frame and from the same image,
+  the existing levels are kept and only the missing ones are computed.
+
+  \param I : Input image, used as level 0. It is not copied and must remain
+  valid as long as the pyramid is used.
+  \param levels : The pyramid has levels.size() levels, the level \e l being
+  computed if levels[l] is true. Level 0 is always available.
+  \param frameStamp : Identifier of the frame, for example the frame index.
+
+  \exception vpException::badValue : If \e levels is empty.
+  \exception vpException::dimensionError : If \e I is too small to build
+  the used levels.
+
+  \sa isUpToDate()
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const std::vector<bool> &levels,
+                           const unsigned long frameStamp)
+{
+  if (levels.empty()) {
+    throw vpException(vpException::badValue, "An image pyramid must have at least one level");
+  }
+
+  if (!m_hasFrameStamp || m_frameStamp != frameStamp || m_I != &I) {
+    reset(I);
+  }
+
+  // Invalidated while the levels are computed in case of exception
+  m_hasFrameStamp = false;
+  buildLevels(levels);
+  m_frameStamp = frameStamp;
+  m_hasFrameStamp = true;
+}
+
+/*!
+  Compute the used levels that are not already computed.
+*/
+void vpImagePyramid::buildLevels(const std::vector<bool> &levels)
+{
+  const unsigned int nbLevels = (unsigned int)levels.size();
+  if (nbLevels > m_levels.size()) {
+    m_levels.resize(nbLevels);
+  }
+  if (nbLevels > m_isBuilt.size()) {
+    m_isBuilt.resize(nbLevels, false);
+  }
+
+  // A level of a Gaussian pyramid is computed from the previous one
+  unsigned int lastLevel = 0;
+  for (unsigned int l = 1; l < nbLevels; l++) {
+    if (levels[l]) {
+      lastLevel = l;
+    }
+  }
+
+  for (unsigned int l = 1; l <= lastLevel; l++) {
+    if (m_isBuilt[l] || (m_type == SUBSAMPLED_PYRAMID && !levels[l])) {
+      continue;
+    }
+
+    vpImage<unsigned char> &level = m_levels[l];
+    if (m_type == GAUSSIAN_PYRAMID) {
+      const vpImage<unsigned char> &prev = (l == 1) ? *m_I : m_levels[l - 1];
+      if (prev.getHeight() < 2 || prev.getWidth() < 2) {
+        throw vpException(vpException::dimensionError, "Cannot build %d pyramid levels from a %dx%d image", nbLevels,
+                          m_I->getWidth(), m_I->getHeight());
+      }
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+      vpImageFilter::getGaussPyramidal(prev, level);
+#else
+      // Same as vpImageFilter::getGaussPyramidal() without allocating the intermediate image
+      vpImageFilter::getGaussXPyramidal(prev, m_buffer);
+      vpImageFilter::getGaussYPyramidal(m_buffer, level);
+#endif
+    } else {
+      // Subsampled from the closest computed level, which gives the same
+      // pixels than subsampling every level in turn
+      unsigned int prevLevel = l - 1;
+      while (prevLevel > 0 && !m_isBuilt[prevLevel]) {
+        prevLevel--;
+      }
+      const vpImage<unsigned char> &prev = (prevLevel == 0) ? *m_I : m_levels[prevLevel];
+      const unsigned int shift = l - prevLevel;
+      if ((prev.getHeight() >> shift) == 0 || (prev.getWidth() >> shift) == 0) {
+        throw vpException(vpException::dimensionError, "Cannot build %d pyramid levels from a %dx%d image", nbLevels,
+                          m_I->getWidth(), m_I->getHeight());
+      }
+
+      level.resize(prev.getHeight() >> shift, prev.getWidth() >> shift);
+      for (unsigned int i = 0; i < level.getHeight(); i++) {
+        const unsigned char *src = prev[i << shift];
+        unsigned char *dst = level[i];
+        for (unsigned int j = 0; j < level.getWidth(); j++) {
+          dst[j] = src[j << shift];
+        }
+      }
+    }
+
+    m_isBuilt[l] = true;
+  }
+
+  if (nbLevels > m_nbLevels) {
+    m_nbLevels = nbLevels;
+  }
+}
+
+/*!
+  Forget the input image and the frame stamp. The level buffers are kept to
+  be reused by the next call to build().
+*/
+void vpImagePyramid::clear()
+{
+  m_I = NULL;
+  m_hasFrameStamp = false;
+  m_nbLevels = 0;
+  m_isBuilt.assign(m_isBuilt.size(), false);
+}
+
+/*!
+  Return the pyramid level \e level. Level 0 is the input image.
+
+  \exception vpException::dimensionError : If the level is not built.
+*/
+const vpImage<unsigned char> &vpImagePyramid::getLevel(const unsigned int level) const
+{
+  if (!isLevelBuilt(level)) {
+    throw vpException(vpException::dimensionError, "Pyramid level %d is not built, the pyramid has %d levels", level,
+                      m_nbLevels);
+  }
+
+  return (level == 0) ? *m_I : m_levels[level];
+}
+
+/*!
+  Return true if the pyramid was built with the frame stamp \e frameStamp and
+  has at least \e nbLevels computed levels.
+*/
+bool vpImagePyramid::isUpToDate(const unsigned long frameStamp, const unsigned int nbLevels) const
+{
+  return isUpToDate(frameStamp, std::vector<bool>(nbLevels, true));
+}
+
+/*!
+  Return true if the pyramid was built with the frame stamp \e frameStamp and
+  if the levels \e l such that levels[l] is true are computed.
+*/
+bool vpImagePyramid::isUpToDate(const unsigned long frameStamp, const std::vector<bool> &levels) const
+{
+  if (!m_hasFrameStamp || m_frameStamp != frameStamp) {
+    return false;
+  }
+
+  for (unsigned int l = 0; l < levels.size(); l++) {
+    if (levels[l] && !isLevelBuilt(l)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+  Use \e I as level 0, the other levels being not computed.
+*/
+void vpImagePyramid::reset(const vpImage<unsigned char> &I)
+{
+  m_I = &I;
+  m_nbLevels = 1;
+  m_isBuilt.assign(std::max(m_isBuilt.size(), (size_t)1), false);
+  m_isBuilt[0] = true;
+}
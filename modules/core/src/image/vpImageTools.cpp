@@ -571,85 +571,138 @@ void vpImageTools::extract(const vpImage<unsigned char> &Src, vpImage<double> &D
   }
 }
 
-/*!
-  Match a template image into another image using zero-mean normalized cross-correlation:
-
-  \f$\frac{\sum_{u^{'},v^{'}} (I(u+u^{'},v+v^{'})-\bar{I}_{u^{'},v^{'}})
-(T(u^{'},v^{'})-\bar{T}_{u^{'},v^{'}})}{\sqrt{\sum_{u^{'},v^{'}}
-(I(u+u^{'},v+v^{'})-\bar{I}_{u^{'},v^{'}})^2
-\sum_{u^{'},v^{'}}(T(u^{'},v^{'})-\bar{T}_{u^{'},v^{'}})^2}}\f$
-  \param I : Input image.
-  \param I_tpl : Template image.
-  \param I_score : Output template matching score.
-  \param step_u : Step in u-direction to speed-up the computation.
-  \param step_v : Step in v-direction to speed-up the computation.
-  \param useOptimized : Use optimized version (SSE, OpenMP, integral images, ...) if true and available.
-*/
-void vpImageTools::templateMatching(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
-                                    vpImage<double> &I_score, const unsigned int step_u, const unsigned int step_v,
-                                    const bool useOptimized)
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+bool checkTemplateMatchingInputs(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl)
 {
   if (I.getSize() == 0) {
     std::cerr << "Error, input image is empty." << std::endl;
-    return;
+    return false;
   }
 
   if (I_tpl.getSize() == 0) {
     std::cerr << "Error, template image is empty." << std::endl;
-    return;
+    return false;
   }
 
   if (I_tpl.getHeight() > I.getHeight() || I_tpl.getWidth() > I.getWidth()) {
     std::cerr << "Error, template image is bigger than input image." << std::endl;
-    return;
+    return false;
   }
 
-  vpImage<double> I_double, I_tpl_double;
-  vpImageConvert::convert(I, I_double);
-  vpImageConvert::convert(I_tpl, I_tpl_double);
+  return true;
+}
+
+// Denominator of the zero-mean normalized cross-correlation computed from the integral images
+double normalizedCorrelationNorm(const vpImage<double> &II, const vpImage<double> &IIsq,
+                                 const vpImage<double> &II_tpl, const vpImage<double> &IIsq_tpl,
+                                 const unsigned int height_tpl, const unsigned int width_tpl, const unsigned int i0,
+                                 const unsigned int j0)
+{
+  const unsigned int size_tpl = height_tpl * width_tpl;
+  const double sum1 =
+      (II[i0 + height_tpl][j0 + width_tpl] + II[i0][j0] - II[i0][j0 + width_tpl] - II[i0 + height_tpl][j0]);
+  const double sum2 = (II_tpl[height_tpl][width_tpl] + II_tpl[0][0] - II_tpl[0][width_tpl] - II_tpl[height_tpl][0]);
+
+  double a2 = ((IIsq[i0 + height_tpl][j0 + width_tpl] + IIsq[i0][j0] - IIsq[i0][j0 + width_tpl] -
+                IIsq[i0 + height_tpl][j0]) -
+               (1.0 / size_tpl) * vpMath::sqr(sum1));
+
+  double b2 = ((IIsq_tpl[height_tpl][width_tpl] + IIsq_tpl[0][0] - IIsq_tpl[0][width_tpl] - IIsq_tpl[height_tpl][0]) -
+               (1.0 / size_tpl) * vpMath::sqr(sum2));
+  return sqrt(a2 * b2);
+}
+}
+
+/*
+  Zero-mean normalized cross-correlation computed with the integral images,
+  the product between the image and the template being done with Type
+  (double or float) precision.
+*/
+template <class Type>
+void vpImageTools::templateMatchingIntegral(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
+                                            vpImage<Type> &I_score, const unsigned int step_u,
+                                            const unsigned int step_v)
+{
+  vpImage<Type> I_real, I_tpl_real;
+  vpImageConvert::convert(I, I_real);
+  vpImageConvert::convert(I_tpl, I_tpl_real);
 
   const unsigned int height_tpl = I_tpl.getHeight(), width_tpl = I_tpl.getWidth();
-  I_score.resize(I.getHeight() - height_tpl, I.getWidth() - width_tpl, 0.0);
 
-  if (useOptimized) {
-    vpImage<double> II, IIsq;
-    integralImage(I, II, IIsq);
+  vpImage<double> II, IIsq;
+  integralImage(I, II, IIsq);
 
-    vpImage<double> II_tpl, IIsq_tpl;
-    integralImage(I_tpl, II_tpl, IIsq_tpl);
+  vpImage<double> II_tpl, IIsq_tpl;
+  integralImage(I_tpl, II_tpl, IIsq_tpl);
 
-    // zero-mean template image
-    const double sum2 = (II_tpl[height_tpl][width_tpl] + II_tpl[0][0] - II_tpl[0][width_tpl] - II_tpl[height_tpl][0]);
-    const double mean2 = sum2 / I_tpl.getSize();
-    for (unsigned int cpt = 0; cpt < I_tpl_double.getSize(); cpt++) {
-      I_tpl_double.bitmap[cpt] -= mean2;
-    }
+  // zero-mean template image
+  const double sum2 = (II_tpl[height_tpl][width_tpl] + II_tpl[0][0] - II_tpl[0][width_tpl] - II_tpl[height_tpl][0]);
+  const double mean2 = sum2 / I_tpl.getSize();
+  for (unsigned int cpt = 0; cpt < I_tpl_real.getSize(); cpt++) {
+    I_tpl_real.bitmap[cpt] = (Type)(I_tpl_real.bitmap[cpt] - mean2);
+  }
 
 #if defined _OPENMP && _OPENMP >= 200711 // OpenMP 3.1
 #pragma omp parallel for schedule(dynamic)
-    for (unsigned int i = 0; i < I.getHeight() - height_tpl; i += step_v) {
-      for (unsigned int j = 0; j < I.getWidth() - width_tpl; j += step_u) {
-        I_score[i][j] = normalizedCorrelation(I_double, I_tpl_double, II, IIsq, II_tpl, IIsq_tpl, i, j);
-      }
+  for (unsigned int i = 0; i < I.getHeight() - height_tpl; i += step_v) {
+    for (unsigned int j = 0; j < I.getWidth() - width_tpl; j += step_u) {
+      I_score[i][j] = (Type)normalizedCorrelation(I_real, I_tpl_real, II, IIsq, II_tpl, IIsq_tpl, i, j);
     }
+  }
 #else
-    // error C3016: 'i': index variable in OpenMP 'for' statement must have signed integral type
-    int end = (int)((I.getHeight() - height_tpl) / step_v) + 1;
-    std::vector<unsigned int> vec_step_v((size_t)end);
-    for (unsigned int cpt = 0, idx = 0; cpt < I.getHeight() - height_tpl; cpt += step_v, idx++) {
-      vec_step_v[(size_t)idx] = cpt;
-    }
+  // error C3016: 'i': index variable in OpenMP 'for' statement must have signed integral type
+  int end = (int)((I.getHeight() - height_tpl) / step_v) + 1;
+  std::vector<unsigned int> vec_step_v((size_t)end);
+  for (unsigned int cpt = 0, idx = 0; cpt < I.getHeight() - height_tpl; cpt += step_v, idx++) {
+    vec_step_v[(size_t)idx] = cpt;
+  }
 #if defined _OPENMP // only to disable warning: ignoring #pragma omp parallel [-Wunknown-pragmas]
 #pragma omp parallel for schedule(dynamic)
 #endif
-    for (int cpt = 0; cpt < end; cpt++) {
-      for (unsigned int j = 0; j < I.getWidth() - width_tpl; j += step_u) {
-        I_score[vec_step_v[cpt]][j] =
-            normalizedCorrelation(I_double, I_tpl_double, II, IIsq, II_tpl, IIsq_tpl, vec_step_v[cpt], j);
-      }
+  for (int cpt = 0; cpt < end; cpt++) {
+    for (unsigned int j = 0; j < I.getWidth() - width_tpl; j += step_u) {
+      I_score[vec_step_v[cpt]][j] =
+          (Type)normalizedCorrelation(I_real, I_tpl_real, II, IIsq, II_tpl, IIsq_tpl, vec_step_v[cpt], j);
     }
+  }
 #endif
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Match a template image into another image using zero-mean normalized cross-correlation:
+
+  \f$\frac{\sum_{u^{'},v^{'}} (I(u+u^{'},v+v^{'})-\bar{I}_{u^{'},v^{'}})
+(T(u^{'},v^{'})-\bar{T}_{u^{'},v^{'}})}{\sqrt{\sum_{u^{'},v^{'}}
+(I(u+u^{'},v+v^{'})-\bar{I}_{u^{'},v^{'}})^2
+\sum_{u^{'},v^{'}}(T(u^{'},v^{'})-\bar{T}_{u^{'},v^{'}})^2}}\f$
+  \param I : Input image.
+  \param I_tpl : Template image.
+  \param I_score : Output template matching score.
+  \param step_u : Step in u-direction to speed-up the computation.
+  \param step_v : Step in v-direction to speed-up the computation.
+  \param useOptimized : Use optimized version (SSE, OpenMP, integral images, ...) if true and available.
+*/
+void vpImageTools::templateMatching(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
+                                    vpImage<double> &I_score, const unsigned int step_u, const unsigned int step_v,
+                                    const bool useOptimized)
+{
+  if (!checkTemplateMatchingInputs(I, I_tpl)) {
+    return;
+  }
+
+  const unsigned int height_tpl = I_tpl.getHeight(), width_tpl = I_tpl.getWidth();
+  I_score.resize(I.getHeight() - height_tpl, I.getWidth() - width_tpl, 0.0);
+
+  if (useOptimized) {
+    templateMatchingIntegral(I, I_tpl, I_score, step_u, step_v);
   } else {
+    vpImage<double> I_double, I_tpl_double;
+    vpImageConvert::convert(I, I_double);
+    vpImageConvert::convert(I_tpl, I_tpl_double);
+
     vpImage<double> I_cur;
 
     for (unsigned int i = 0; i < I.getHeight() - height_tpl; i += step_v) {
@@ -663,6 +716,46 @@ void vpImageTools::templateMatching(const vpImage<unsigned char> &I, const vpIma
   }
 }
 
+/*!
+  Match a template image into another image using zero-mean normalized
+  cross-correlation, see templateMatching(const vpImage<unsigned char> &,
+  const vpImage<unsigned char> &, vpImage<double> &, const unsigned int, const
+  unsigned int, const bool).
+
+  With the optimized version, the products between the image and the template
+  are computed in single precision, four pixels at once with SSE2, while the
+  integral images are still computed in double precision since a float cannot
+  represent exactly the sums of large images.
+
+  \param I : Input image.
+  \param I_tpl : Template image.
+  \param I_score : Output template matching score.
+  \param step_u : Step in u-direction to speed-up the computation.
+  \param step_v : Step in v-direction to speed-up the computation.
+  \param useOptimized : Use optimized version (SSE, OpenMP, integral images, ...) if true and available.
+*/
+void vpImageTools::templateMatching(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_tpl,
+                                    vpImage<float> &I_score, const unsigned int step_u, const unsigned int step_v,
+                                    const bool useOptimized)
+{
+  if (!checkTemplateMatchingInputs(I, I_tpl)) {
+    return;
+  }
+
+  if (useOptimized) {
+    I_score.resize(I.getHeight() - I_tpl.getHeight(), I.getWidth() - I_tpl.getWidth(), 0.0f);
+    templateMatchingIntegral(I, I_tpl, I_score, step_u, step_v);
+  } else {
+    vpImage<double> I_score_double;
+    templateMatching(I, I_tpl, I_score_double, step_u, step_v, false);
+
+    I_score.resize(I_score_double.getHeight(), I_score_double.getWidth());
+    for (unsigned int cpt = 0; cpt < I_score_double.getSize(); cpt++) {
+      I_score.bitmap[cpt] = (float)I_score_double.bitmap[cpt];
+    }
+  }
+}
+
 // Reference:
 // http://blog.demofox.org/2015/08/15/resizing-images-with-bicubic-interpolation/
 // t is a value that goes from 0 to 1 to interpolate in a C1 continuous way
@@ -706,7 +799,7 @@ double vpImageTools::normalizedCorrelation(const vpImage<double> &I1, const vpIm
         v_ab = _mm_add_pd(v_ab, _mm_mul_pd(v1, v2));
       }
 
-      for (; j < I2.getWidth(); j++) {
+      for (; j < I2.getWidth(); j++, ptr_I2++) {
         ab += (I1[i0 + i][j0 + j]) * I2[i][j];
       }
     }
@@ -730,17 +823,56 @@ double vpImageTools::normalizedCorrelation(const vpImage<double> &I1, const vpIm
     }
   }
 
-  const unsigned int height_tpl = I2.getHeight(), width_tpl = I2.getWidth();
-  const double sum1 =
-      (II[i0 + height_tpl][j0 + width_tpl] + II[i0][j0] - II[i0][j0 + width_tpl] - II[i0 + height_tpl][j0]);
-  const double sum2 = (II_tpl[height_tpl][width_tpl] + II_tpl[0][0] - II_tpl[0][width_tpl] - II_tpl[height_tpl][0]);
+  return ab / normalizedCorrelationNorm(II, IIsq, II_tpl, IIsq_tpl, I2.getHeight(), I2.getWidth(), i0, j0);
+}
 
-  double a2 = ((IIsq[i0 + I2.getHeight()][j0 + I2.getWidth()] + IIsq[i0][j0] - IIsq[i0][j0 + I2.getWidth()] -
-                IIsq[i0 + I2.getHeight()][j0]) -
-               (1.0 / I2.getSize()) * vpMath::sqr(sum1));
+double vpImageTools::normalizedCorrelation(const vpImage<float> &I1, const vpImage<float> &I2,
+                                           const vpImage<double> &II, const vpImage<double> &IIsq,
+                                           const vpImage<double> &II_tpl, const vpImage<double> &IIsq_tpl,
+                                           const unsigned int i0, const unsigned int j0)
+{
+  // The products are accumulated in single precision along a row, and the
+  // sums of the rows in double precision
+  double ab = 0.0;
+#if VISP_HAVE_SSE2
+  bool use_sse_version = true;
+  if (vpCPUFeatures::checkSSE2() && I2.getWidth() >= 4) {
+    const float *ptr_I2 = I2.bitmap;
 
-  double b2 = ((IIsq_tpl[I2.getHeight()][I2.getWidth()] + IIsq_tpl[0][0] - IIsq_tpl[0][I2.getWidth()] -
-                IIsq_tpl[I2.getHeight()][0]) -
-               (1.0 / I2.getSize()) * vpMath::sqr(sum2));
-  return ab / sqrt(a2 * b2);
+    for (unsigned int i = 0; i < I2.getHeight(); i++) {
+      const float *ptr_I1 = &I1.bitmap[(i0 + i) * I1.getWidth() + j0];
+      __m128 v_ab = _mm_setzero_ps();
+      unsigned int j = 0;
+
+      for (; j <= I2.getWidth() - 4; j += 4, ptr_I1 += 4, ptr_I2 += 4) {
+        v_ab = _mm_add_ps(v_ab, _mm_mul_ps(_mm_loadu_ps(ptr_I1), _mm_loadu_ps(ptr_I2)));
+      }
+
+      float v_res_ab[4];
+      _mm_storeu_ps(v_res_ab, v_ab);
+      float ab_row = (v_res_ab[0] + v_res_ab[1]) + (v_res_ab[2] + v_res_ab[3]);
+
+      for (; j < I2.getWidth(); j++, ptr_I1++, ptr_I2++) {
+        ab_row += (*ptr_I1) * (*ptr_I2);
+      }
+      ab += ab_row;
+    }
+  } else {
+    use_sse_version = false;
+  }
+#else
+  bool use_sse_version = false;
+#endif
+
+  if (!use_sse_version) {
+    for (unsigned int i = 0; i < I2.getHeight(); i++) {
+      float ab_row = 0.0f;
+      for (unsigned int j = 0; j < I2.getWidth(); j++) {
+        ab_row += (I1[i0 + i][j0 + j]) * I2[i][j];
+      }
+      ab += ab_row;
+    }
+  }
+
+  return ab / normalizedCorrelationNorm(II, IIsq, II_tpl, IIsq_tpl, I2.getHeight(), I2.getWidth(), i0, j0);
 }
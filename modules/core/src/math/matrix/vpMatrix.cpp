@@ -62,6 +62,7 @@
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpGEMM.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpTranslationVector.h>
@@ -449,21 +450,7 @@ void vpMatrix::AAt(vpMatrix &B) const
     B.resize(rowNum, rowNum, false, false);
 
   // compute A*A^T
-  for (unsigned int i = 0; i < rowNum; i++) {
-    for (unsigned int j = i; j < rowNum; j++) {
-      double *pi = rowPtrs[i]; // row i
-      double *pj = rowPtrs[j]; // row j
-
-      // sum (row i .* row j)
-      double ssum = 0;
-      for (unsigned int k = 0; k < colNum; k++)
-        ssum += *(pi++) * *(pj++);
-
-      B[i][j] = ssum; // upper triangle
-      if (i != j)
-        B[j][i] = ssum; // lower triangle
-    }
-  }
+  vpSYRKKernel(false, rowNum, colNum, 1.0, data, colNum, 0.0, B.data, rowNum);
 }
 
 /*!
@@ -490,29 +477,7 @@ void vpMatrix::AtA(vpMatrix &B) const
 
   vpMatrix::blas_dgemm(transa, transb, colNum, colNum, rowNum, alpha, data, colNum, data, colNum, beta, B.data, colNum);
 #else
-  unsigned int i, j, k;
-  double s;
-  double *ptr;
-  for (i = 0; i < colNum; i++) {
-    double *Bi = B[i];
-    for (j = 0; j < i; j++) {
-      ptr = data;
-      s = 0;
-      for (k = 0; k < rowNum; k++) {
-        s += (*(ptr + i)) * (*(ptr + j));
-        ptr += colNum;
-      }
-      *Bi++ = s;
-      B[j][i] = s;
-    }
-    ptr = data;
-    s = 0;
-    for (k = 0; k < rowNum; k++) {
-      s += (*(ptr + i)) * (*(ptr + i));
-      ptr += colNum;
-    }
-    *Bi = s;
-  }
+  vpSYRKKernel(true, colNum, rowNum, 1.0, data, colNum, 0.0, B.data, colNum);
 #endif
 }
 
@@ -780,13 +745,7 @@ void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVe
 
   vpMatrix::blas_dgemv(trans, A.colNum, A.rowNum, alpha, A.data, A.colNum, v.data, incr, beta, w.data, incr);
 #else
-  w = 0.0;
-  for (unsigned int j = 0; j < A.colNum; j++) {
-    double vj = v[j]; // optimization em 5/12/2006
-    for (unsigned int i = 0; i < A.rowNum; i++) {
-      w[i] += A.rowPtrs[i][j] * vj;
-    }
-  }
+  vpGEMVKernel(false, A.rowNum, A.colNum, 1.0, A.data, A.colNum, v.data, 0.0, w.data);
 #endif
 }
 
@@ -821,21 +780,8 @@ void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
   vpMatrix::blas_dgemm(trans, trans, B.colNum, A.rowNum, A.colNum, alpha, B.data, B.colNum, A.data, A.colNum, beta,
                        C.data, B.colNum);
 #else
-  // 5/12/06 some "very" simple optimization to avoid indexation
-  unsigned int BcolNum = B.colNum;
-  unsigned int BrowNum = B.rowNum;
-  unsigned int i, j, k;
-  double **BrowPtrs = B.rowPtrs;
-  for (i = 0; i < A.rowNum; i++) {
-    double *rowptri = A.rowPtrs[i];
-    double *ci = C[i];
-    for (j = 0; j < BcolNum; j++) {
-      double s = 0;
-      for (k = 0; k < BrowNum; k++)
-        s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
-    }
-  }
+  vpGEMMKernel(false, false, A.rowNum, B.colNum, A.colNum, 1.0, A.data, A.colNum, B.data, B.colNum, 0.0, C.data,
+               B.colNum);
 #endif
 }
 
@@ -33,9 +33,32 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpConfig.h>
+#include <visp3/core/vpGEMM.h>
 #include <visp3/core/vpMatrix.h>
 
+#if defined _OPENMP
+#include <omp.h>
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined __ARM_NEON && defined __aarch64__
+#include <arm_neon.h>
+#define VISP_HAVE_NEON 1
+#endif
+
+#if VISP_HAVE_SSE2 || VISP_HAVE_NEON
+#define VISP_HAVE_SIMD 1
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
@@ -66,10 +89,451 @@ void vpMatrix::blas_dgemv(char trans, const int M_, const int N_, double alpha,
   dgemv_(&trans, &M, &N, &alpha, a_data, &lda, x_data, &incx, &beta, y_data, &incy);
 }
 
+#endif
+
+/*
+  Built-in kernels used when no external BLAS is available. Matrices are
+  stored row-major and ldx is the number of elements between two rows.
+
+  The product is computed by blocks (Goto's scheme): a KC x NC panel of op(B)
+  and an MC x KC block of op(A) are copied into contiguous buffers (packing),
+  then a micro-kernel accumulates an MR x NR tile of C in registers.
+*/
+namespace
+{
+// Register tile of the micro-kernel
+const unsigned int MR = 4;
+const unsigned int NR = 4;
+// Cache blocking: an MC x KC block of op(A) stays in L2, a KC x NR sliver of op(B) in L1
+const unsigned int MC = 128;
+const unsigned int KC = 256;
+const unsigned int NC = 4096;
+// Below this number of multiply-adds, packing costs more than it saves
+const double nbOpsMinBlocked = 24. * 24. * 24.;
+// Below this number of multiply-adds the product is computed by a single thread
+const double nbOpsMinParallel = 128. * 128. * 128.;
+// Below this number of matrix elements the matrix-vector product is computed by a single thread
+const double nbElementsMinParallel = 256. * 256.;
+// Columns of y updated by a thread in the transposed matrix-vector product
+const unsigned int nbColsPerBand = 512;
+// Up to this number of columns, A^T A is accumulated row after row without packing
+const unsigned int maxColsRowAccumulation = 8;
+
+bool checkSIMD()
+{
+#if VISP_HAVE_SSE2
+  return vpCPUFeatures::checkSSE2();
+#elif VISP_HAVE_NEON
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if VISP_HAVE_SIMD
+#if VISP_HAVE_SSE2
+typedef __m128d vpPackedDouble;
+inline vpPackedDouble vpLoad(const double *p) { return _mm_loadu_pd(p); }
+inline void vpStore(double *p, const vpPackedDouble &v) { _mm_storeu_pd(p, v); }
+inline vpPackedDouble vpSet1(double v) { return _mm_set1_pd(v); }
+inline vpPackedDouble vpZero() { return _mm_setzero_pd(); }
+inline vpPackedDouble vpMulAdd(const vpPackedDouble &acc, const vpPackedDouble &a, const vpPackedDouble &b)
+{
+  return _mm_add_pd(acc, _mm_mul_pd(a, b));
+}
+#else
+typedef float64x2_t vpPackedDouble;
+inline vpPackedDouble vpLoad(const double *p) { return vld1q_f64(p); }
+inline void vpStore(double *p, const vpPackedDouble &v) { vst1q_f64(p, v); }
+inline vpPackedDouble vpSet1(double v) { return vdupq_n_f64(v); }
+inline vpPackedDouble vpZero() { return vdupq_n_f64(0.); }
+inline vpPackedDouble vpMulAdd(const vpPackedDouble &acc, const vpPackedDouble &a, const vpPackedDouble &b)
+{
+  return vfmaq_f64(acc, a, b);
+}
+#endif
+
+// AB = Ap * Bp where Ap is an MR x kc sliver and Bp a kc x NR sliver, both packed
+void microKernelSIMD(unsigned int kc, const double *Ap, const double *Bp, double *AB)
+{
+  vpPackedDouble c00 = vpZero(), c01 = vpZero(), c10 = vpZero(), c11 = vpZero();
+  vpPackedDouble c20 = vpZero(), c21 = vpZero(), c30 = vpZero(), c31 = vpZero();
+  for (unsigned int p = 0; p < kc; p++, Ap += MR, Bp += NR) {
+    const vpPackedDouble b0 = vpLoad(Bp), b1 = vpLoad(Bp + 2);
+    vpPackedDouble a = vpSet1(Ap[0]);
+    c00 = vpMulAdd(c00, a, b0);
+    c01 = vpMulAdd(c01, a, b1);
+    a = vpSet1(Ap[1]);
+    c10 = vpMulAdd(c10, a, b0);
+    c11 = vpMulAdd(c11, a, b1);
+    a = vpSet1(Ap[2]);
+    c20 = vpMulAdd(c20, a, b0);
+    c21 = vpMulAdd(c21, a, b1);
+    a = vpSet1(Ap[3]);
+    c30 = vpMulAdd(c30, a, b0);
+    c31 = vpMulAdd(c31, a, b1);
+  }
+  vpStore(AB, c00);
+  vpStore(AB + 2, c01);
+  vpStore(AB + 4, c10);
+  vpStore(AB + 6, c11);
+  vpStore(AB + 8, c20);
+  vpStore(AB + 10, c21);
+  vpStore(AB + 12, c30);
+  vpStore(AB + 14, c31);
+}
+
+double dotSIMD(const double *a, const double *b, unsigned int n)
+{
+  vpPackedDouble s0 = vpZero(), s1 = vpZero();
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 = vpMulAdd(s0, vpLoad(a + i), vpLoad(b + i));
+    s1 = vpMulAdd(s1, vpLoad(a + i + 2), vpLoad(b + i + 2));
+  }
+  double s[4];
+  vpStore(s, s0);
+  vpStore(s + 2, s1);
+  double sum = (s[0] + s[2]) + (s[1] + s[3]);
+  for (; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+// y[0:n] += alpha * x[0:n]
+void axpySIMD(double alpha, const double *x, double *y, unsigned int n)
+{
+  const vpPackedDouble a = vpSet1(alpha);
+  unsigned int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vpStore(y + i, vpMulAdd(vpLoad(y + i), a, vpLoad(x + i)));
+    vpStore(y + i + 2, vpMulAdd(vpLoad(y + i + 2), a, vpLoad(x + i + 2)));
+  }
+  for (; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+#endif // VISP_HAVE_SIMD
+
+// Element (i, j) of op(X)
+inline double element(const double *X, unsigned int ldx, bool trans, unsigned int i, unsigned int j)
+{
+  return trans ? X[j * ldx + i] : X[i * ldx + j];
+}
+
+// C = beta * C, without reading C when beta is 0 since it may be uninitialized
+void scale(unsigned int M, unsigned int N, double beta, double *C, unsigned int ldc)
+{
+  if (beta == 1.) {
+    return;
+  }
+  for (unsigned int i = 0; i < M; i++) {
+    double *c = C + i * ldc;
+    if (beta == 0.) {
+      std::fill(c, c + N, 0.);
+    } else {
+      for (unsigned int j = 0; j < N; j++) {
+        c[j] *= beta;
+      }
+    }
+  }
+}
+
+// Copies the block [i0, i0+mc) x [p0, p0+kc) of op(A) as slivers of MR rows, column after column, padded with zeros
+void packA(const double *A, unsigned int lda, bool transA, unsigned int i0, unsigned int mc, unsigned int p0,
+           unsigned int kc, double *Ap)
+{
+  for (unsigned int i = 0; i < mc; i += MR) {
+    const unsigned int mr = std::min(MR, mc - i);
+    for (unsigned int p = 0; p < kc; p++, Ap += MR) {
+      unsigned int r = 0;
+      for (; r < mr; r++) {
+        Ap[r] = element(A, lda, transA, i0 + i + r, p0 + p);
+      }
+      for (; r < MR; r++) {
+        Ap[r] = 0.;
+      }
+    }
+  }
+}
+
+// Copies the panel [p0, p0+kc) x [j0, j0+nc) of op(B) as slivers of NR columns, row after row, padded with zeros
+void packB(const double *B, unsigned int ldb, bool transB, unsigned int p0, unsigned int kc, unsigned int j0,
+           unsigned int nc, double *Bp)
+{
+  for (unsigned int j = 0; j < nc; j += NR) {
+    const unsigned int nr = std::min(NR, nc - j);
+    for (unsigned int p = 0; p < kc; p++, Bp += NR) {
+      unsigned int c = 0;
+      for (; c < nr; c++) {
+        Bp[c] = element(B, ldb, transB, p0 + p, j0 + j + c);
+      }
+      for (; c < NR; c++) {
+        Bp[c] = 0.;
+      }
+    }
+  }
+}
+
+// C[0:mr, 0:nr] += alpha * Ap * Bp
+void microKernel(unsigned int kc, const double *Ap, const double *Bp, double alpha, double *C, unsigned int ldc,
+                 unsigned int mr, unsigned int nr, bool useSIMD)
+{
+  double AB[MR * NR];
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    microKernelSIMD(kc, Ap, Bp, AB);
+  } else
 #else
-// Work arround to avoid warning LNK4221: This object file does not define any
-// previously undefined public symbols
-void dummy_vpMatrix_blas(){};
+  (void)useSIMD;
 #endif
+  {
+    std::fill(AB, AB + MR * NR, 0.);
+    for (unsigned int p = 0; p < kc; p++, Ap += MR, Bp += NR) {
+      for (unsigned int r = 0; r < MR; r++) {
+        for (unsigned int c = 0; c < NR; c++) {
+          AB[r * NR + c] += Ap[r] * Bp[c];
+        }
+      }
+    }
+  }
+
+  for (unsigned int r = 0; r < mr; r++) {
+    for (unsigned int c = 0; c < nr; c++) {
+      C[r * ldc + c] += alpha * AB[r * NR + c];
+    }
+  }
+}
+
+/*
+  C += alpha * op(A) * op(B) where op(A) is M x K and op(B) is K x N. When
+  upper is true the product is symmetric and only the tiles that intersect
+  the upper triangle of C are computed.
+*/
+void gemm(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K, double alpha, const double *A,
+          unsigned int lda, const double *B, unsigned int ldb, double *C, unsigned int ldc, bool upper)
+{
+  if (M == 0 || N == 0 || K == 0 || alpha == 0.) {
+    return;
+  }
+
+  const double nbOps = (double)M * N * K;
+  if (nbOps < nbOpsMinBlocked) {
+    for (unsigned int i = 0; i < M; i++) {
+      double *c = C + i * ldc;
+      const unsigned int jBegin = upper ? i : 0;
+      for (unsigned int p = 0; p < K; p++) {
+        const double a = alpha * element(A, lda, transA, i, p);
+        for (unsigned int j = jBegin; j < N; j++) {
+          c[j] += a * element(B, ldb, transB, p, j);
+        }
+      }
+    }
+    return;
+  }
+
+  const bool useSIMD = checkSIMD();
+  const unsigned int nbBlocksM = (M + MC - 1) / MC;
+  int nbThreads = 1;
+#if defined _OPENMP
+  if (nbOps >= nbOpsMinParallel) {
+    nbThreads = std::min(omp_get_max_threads(), (int)nbBlocksM);
+  }
+#endif
+  std::vector<double> Bp(KC * std::min(NC, (N + NR - 1) / NR * NR));
+  std::vector<double> Ap(nbThreads * MC * KC);
+
+  for (unsigned int jc = 0; jc < N; jc += NC) {
+    const unsigned int nc = std::min(NC, N - jc);
+    for (unsigned int pc = 0; pc < K; pc += KC) {
+      const unsigned int kc = std::min(KC, K - pc);
+      packB(B, ldb, transB, pc, kc, jc, nc, &Bp[0]);
+
+#if defined _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nbThreads) if (nbThreads > 1)
+#endif
+      for (int ib = 0; ib < (int)nbBlocksM; ib++) {
+        const unsigned int ic = ib * MC, mc = std::min(MC, M - ic);
+        // The whole block is below the diagonal
+        if (upper && jc + nc <= ic) {
+          continue;
+        }
+        int thread = 0;
+#if defined _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *ap = &Ap[thread * MC * KC];
+        packA(A, lda, transA, ic, mc, pc, kc, ap);
+
+        for (unsigned int j = 0; j < nc; j += NR) {
+          const unsigned int nr = std::min(NR, nc - j);
+          for (unsigned int i = 0; i < mc; i += MR) {
+            if (upper && jc + j + nr <= ic + i) {
+              continue;
+            }
+            microKernel(kc, ap + i * kc, &Bp[j * kc], alpha, C + (ic + i) * ldc + jc + j, ldc,
+                        std::min(MR, mc - i), nr, useSIMD);
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+  C += alpha * A^T * A for a tall and skinny A with N columns. The upper
+  triangle of the N x N product is kept in registers and each row of A is
+  read once, which is faster than packing A for such shapes (for example the
+  interaction matrix of a tracking task, with 6 columns).
+*/
+template <unsigned int N>
+void syrkRowAccumulation(unsigned int K, double alpha, const double *A, unsigned int lda, double *C, unsigned int ldc)
+{
+  double acc[N][N];
+  for (unsigned int i = 0; i < N; i++) {
+    for (unsigned int j = 0; j < N; j++) {
+      acc[i][j] = 0.;
+    }
+  }
+
+  for (unsigned int k = 0; k < K; k++, A += lda) {
+    for (unsigned int i = 0; i < N; i++) {
+      const double a = A[i];
+      for (unsigned int j = i; j < N; j++) {
+        acc[i][j] += a * A[j];
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < N; i++) {
+    for (unsigned int j = i; j < N; j++) {
+      C[i * ldc + j] += alpha * acc[i][j];
+    }
+  }
+}
+
+// Returns false if N is too large for syrkRowAccumulation()
+bool syrkRowAccumulation(unsigned int N, unsigned int K, double alpha, const double *A, unsigned int lda, double *C,
+                         unsigned int ldc)
+{
+  switch (N) {
+  case 1:
+    syrkRowAccumulation<1>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 2:
+    syrkRowAccumulation<2>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 3:
+    syrkRowAccumulation<3>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 4:
+    syrkRowAccumulation<4>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 5:
+    syrkRowAccumulation<5>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 6:
+    syrkRowAccumulation<6>(K, alpha, A, lda, C, ldc);
+    return true;
+  case 7:
+    syrkRowAccumulation<7>(K, alpha, A, lda, C, ldc);
+    return true;
+  case maxColsRowAccumulation:
+    syrkRowAccumulation<maxColsRowAccumulation>(K, alpha, A, lda, C, ldc);
+    return true;
+  default:
+    return false;
+  }
+}
+
+double dot(const double *a, const double *b, unsigned int n, bool useSIMD)
+{
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    return dotSIMD(a, b, n);
+  }
+#else
+  (void)useSIMD;
+#endif
+  double sum = 0.;
+  for (unsigned int i = 0; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+void axpy(double alpha, const double *x, double *y, unsigned int n, bool useSIMD)
+{
+#if VISP_HAVE_SIMD
+  if (useSIMD) {
+    axpySIMD(alpha, x, y, n);
+    return;
+  }
+#else
+  (void)useSIMD;
+#endif
+  for (unsigned int i = 0; i < n; i++) {
+    y[i] += alpha * x[i];
+  }
+}
+}
+
+void vpGEMMKernel(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K, double alpha,
+                  const double *A, unsigned int lda, const double *B, unsigned int ldb, double beta, double *C,
+                  unsigned int ldc)
+{
+  scale(M, N, beta, C, ldc);
+  gemm(transA, transB, M, N, K, alpha, A, lda, B, ldb, C, ldc, false);
+}
+
+void vpSYRKKernel(bool transA, unsigned int N, unsigned int K, double alpha, const double *A, unsigned int lda,
+                  double beta, double *C, unsigned int ldc)
+{
+  scale(N, N, beta, C, ldc);
+  if (!transA || alpha == 0. || !syrkRowAccumulation(N, K, alpha, A, lda, C, ldc)) {
+    gemm(transA, !transA, N, N, K, alpha, A, lda, A, lda, C, ldc, true);
+  }
+
+  // Copy the upper triangle into the lower one
+  for (unsigned int i = 1; i < N; i++) {
+    for (unsigned int j = 0; j < i; j++) {
+      C[i * ldc + j] = C[j * ldc + i];
+    }
+  }
+}
+
+void vpGEMVKernel(bool transA, unsigned int M, unsigned int N, double alpha, const double *A, unsigned int lda,
+                  const double *x, double beta, double *y)
+{
+  const bool useSIMD = checkSIMD();
+#if defined _OPENMP
+  const bool parallel = (double)M * N >= nbElementsMinParallel;
+#endif
+
+  if (!transA) {
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (parallel)
+#endif
+    for (int i = 0; i < (int)M; i++) {
+      const double d = alpha * dot(A + i * lda, x, N, useSIMD);
+      y[i] = (beta == 0.) ? d : d + beta * y[i];
+    }
+    return;
+  }
+
+  // y = alpha * A^T * x + beta * y, computed as a sum of scaled rows of A by bands of columns
+  scale(1, N, beta, y, N);
+  const int nbBands = (int)((N + nbColsPerBand - 1) / nbColsPerBand);
+#if defined _OPENMP
+#pragma omp parallel for schedule(static) if (parallel && nbBands > 1)
+#endif
+  for (int band = 0; band < nbBands; band++) {
+    const unsigned int j0 = band * nbColsPerBand, n = std::min(nbColsPerBand, N - j0);
+    for (unsigned int i = 0; i < M; i++) {
+      axpy(alpha * x[i], A + i * lda + j0, y + j0, n, useSIMD);
+    }
+  }
+}
 
 #endif // #ifndef DOXYGEN_SHOULD_SKIP_THIS
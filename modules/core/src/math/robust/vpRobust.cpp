@@ -45,17 +45,51 @@
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpMath.h>
 
-#include <cmath>  // std::fabs
-#include <limits> // numeric_limits
+#include <algorithm> // std::nth_element
+#include <cmath>     // std::fabs
+#include <limits>    // numeric_limits
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <visp3/core/vpRobust.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 #define vpITMAX 100
 #define vpEPS 3.0e-7
 #define vpCST 1
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+#if VISP_HAVE_SSE2
+inline __m128d abs_pd(const __m128d &x)
+{
+  static const __m128d sign_mask = _mm_set1_pd(-0.); // -0. = 1 << 63
+  return _mm_andnot_pd(sign_mask, x);
+}
+#endif
+
+// y[i] = |x[i] - med|
+void absDiff(const double *x, double med, unsigned int n, double *y)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  const __m128d med_128 = _mm_set1_pd(med);
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, abs_pd(_mm_sub_pd(_mm_loadu_pd(x + i), med_128)));
+  }
+#endif
+  for (; i < n; i++) {
+    y[i] = std::fabs(x[i] - med);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 // ===================================================================
 /*!
   \brief Constructor.
@@ -63,7 +97,7 @@
 
 */
 vpRobust::vpRobust(unsigned int n_data)
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
+  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), size(n_data)
 {
   vpCDEBUG(2) << "vpRobust constructor reached" << std::endl;
 
@@ -77,7 +111,7 @@ vpRobust::vpRobust(unsigned int n_data)
   Default constructor.
 */
 vpRobust::vpRobust()
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
+  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), size(0)
 {
 }
 
@@ -97,7 +131,6 @@ vpRobust &vpRobust::operator=(const vpRobust &other)
   NoiseThreshold = other.NoiseThreshold;
   sig_prev = other.sig_prev;
   it = other.it;
-  swap = other.swap;
   size = other.size;
   return *this;
 }
@@ -114,7 +147,6 @@ vpRobust &vpRobust::operator=(const vpRobust &&other)
   NoiseThreshold = std::move(other.NoiseThreshold);
   sig_prev = std::move(other.sig_prev);
   it = std::move(other.it);
-  swap = std::move(other.swap);
   size = std::move(other.size);
   return *this;
 }
@@ -183,6 +215,9 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   // resize vector only if the size of residue vector has changed
   unsigned int n_data = residues.getRows();
   resize(n_data);
+  if (normres.getRows() != n_data) {
+    normres.resize(n_data, false);
+  }
 
   sorted_residues = residues;
 
@@ -193,10 +228,9 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   // residualMedian = med ;
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++) {
-    normres[i] = (fabs(residues[i] - med));
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
-  }
+  absDiff(residues.data, med, n_data, normres.data);
+  // The partially sorted residues hold the same values, hence the same median
+  sorted_normres = normres;
 
   // Calculate MAD
   normmedian = select(sorted_normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
@@ -235,12 +269,9 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
   double normmedian = 0; // Normalized median
   double sigma = 0;      // Standard Deviation
 
-  unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data);
-
-  // compute median with the residues vector, return all_normres which are the
+  // compute median with the residues vector, return normres which are the
   // normalized all_residues vector.
-  normmedian = computeNormalizedMedian(all_normres, residues, all_residues, weights);
+  normmedian = computeNormalizedMedian(normres, residues, all_residues, weights);
 
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826 * normmedian; // Median Absolute Deviation
@@ -253,17 +284,17 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method, const vpColVector
 
   switch (method) {
   case TUKEY: {
-    psiTukey(sigma, all_normres, weights);
+    psiTukey(sigma, normres, weights);
 
     vpCDEBUG(2) << "Tukey's function computed" << std::endl;
     break;
   }
   case CAUCHY: {
-    psiCauchy(sigma, all_normres, weights);
+    psiCauchy(sigma, normres, weights);
     break;
   }
   case HUBER: {
-    psiHuber(sigma, all_normres, weights);
+    psiHuber(sigma, normres, weights);
     break;
   }
   };
@@ -280,26 +311,20 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVe
 
   // resize vector only if the size of residue vector has changed
   resize(n_data);
+  if (all_normres.getRows() != n_all_data) {
+    all_normres.resize(n_all_data, false);
+  }
 
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-
-  // all_normres.resize(n_all_data); // Normalized Residue
-  // vpColVector sorted_normres(n_data); // Normalized Residue
-  // vpColVector sorted_residues = residues;
-  // vpColVector sorted_residues;
-
+  // Only the first n_data elements of the containers are used below, so that
+  // they are not reallocated when the number of rejected residues changes
   unsigned int index = 0;
   for (unsigned int j = 0; j < n_data; j++) {
     // if(weights[j]!=0)
     if (std::fabs(weights[j]) > std::numeric_limits<double>::epsilon()) {
-      no_null_weight_residues[index] = residues[j];
+      sorted_residues[index] = residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data, no_null_weight_residues.data, index * sizeof(double));
   n_data = index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
@@ -311,15 +336,9 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres, const vpColVe
   unsigned int ind_med = (unsigned int)(ceil(n_data / 2.0)) - 1;
   med = select(sorted_residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
 
-  unsigned int i;
   // Normalize residues
-  for (i = 0; i < n_all_data; i++) {
-    all_normres[i] = (fabs(all_residues[i] - med));
-  }
-
-  for (i = 0; i < n_data; i++) {
-    sorted_normres[i] = (fabs(sorted_residues[i] - med));
-  }
+  absDiff(all_residues.data, med, n_all_data, all_normres.data);
+  absDiff(sorted_residues.data, med, n_data, sorted_normres.data);
   // MAD calculated only on first iteration
 
   // normmedian = Median(normres, weights);
@@ -345,7 +364,6 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
   double sigma = 0; // Standard Deviation
 
   unsigned int n_data = residues.getRows();
-  vpColVector norm_res(n_data); // Normalized Residue
   vpColVector w(n_data);
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data << std::endl;
@@ -355,14 +373,16 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
   med = select(residues, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/);
 
   // Normalize residues
-  for (unsigned int i = 0; i < n_data; i++)
-    norm_res[i] = (fabs(residues[i] - med));
+  if (normres.getRows() != n_data) {
+    normres.resize(n_data, false);
+  }
+  absDiff(residues.data, med, n_data, normres.data);
 
   // Check for various methods.
   // For Huber compute Simultaneous scale estimate
   // For Others use MAD calculated on first iteration
   if (it == 0) {
-    double normmedian = select(norm_res, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/); // Normalized Median
+    double normmedian = select(normres, 0, (int)n_data - 1, (int)ind_med /*(int)n_data/2*/); // Normalized Median
     // 1.48 keeps scale estimate consistent for a normal probability dist.
     sigma = 1.4826 * normmedian; // Median Absolute Deviation
   } else {
@@ -378,7 +398,7 @@ vpColVector vpRobust::simultMEstimator(vpColVector &residues)
 
   vpCDEBUG(2) << "MAD and C computed" << std::endl;
 
-  psiHuber(sigma, norm_res, w);
+  psiHuber(sigma, normres, w);
 
   sig_prev = sigma;
 
@@ -536,8 +556,28 @@ void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector &weights)
 
   unsigned int n_data = x.getRows();
   double cst_const = vpCST * 4.6851;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  // sig == 0 only if NoiseThreshold == 0, this case is handled below
+  if (std::fabs(sig) > std::numeric_limits<double>::epsilon()) {
+    const __m128d sig_128 = _mm_set1_pd(sig);
+    const __m128d cst_128 = _mm_set1_pd(cst_const);
+    const __m128d eps_128 = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+    const __m128d one_128 = _mm_set1_pd(1.0);
+    for (; i + 2 <= n_data; i += 2) {
+      __m128d xi_sig = _mm_div_pd(_mm_loadu_pd(x.data + i), sig_128);
+      __m128d w = _mm_loadu_pd(weights.data + i);
+      __m128d inlier =
+          _mm_and_pd(_mm_cmple_pd(abs_pd(xi_sig), cst_128), _mm_cmpgt_pd(abs_pd(w), eps_128));
+      __m128d u = _mm_div_pd(xi_sig, cst_128);
+      u = _mm_sub_pd(one_128, _mm_mul_pd(u, u));
+      _mm_storeu_pd(weights.data + i, _mm_and_pd(inlier, _mm_mul_pd(u, u)));
+    }
+  }
+#endif
 
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     // if(sig==0 && weights[i]!=0)
     if (std::fabs(sig) <= std::numeric_limits<double>::epsilon() &&
         std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
@@ -569,8 +609,25 @@ void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 {
   double c = 1.2107; // 1.345;
   unsigned int n_data = x.getRows();
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  const __m128d sig_128 = _mm_set1_pd(sig);
+  const __m128d c_128 = _mm_set1_pd(c);
+  const __m128d eps_128 = _mm_set1_pd(std::numeric_limits<double>::epsilon());
+  const __m128d one_128 = _mm_set1_pd(1.0);
+  for (; i + 2 <= n_data; i += 2) {
+    __m128d w = _mm_loadu_pd(weights.data + i);
+    __m128d abs_xi_sig = abs_pd(_mm_div_pd(_mm_loadu_pd(x.data + i), sig_128));
+    __m128d in_c = _mm_cmple_pd(abs_xi_sig, c_128);
+    __m128d w_new = _mm_or_pd(_mm_and_pd(in_c, one_128), _mm_andnot_pd(in_c, _mm_div_pd(c_128, abs_xi_sig)));
+    // The null weights are kept
+    __m128d update = _mm_cmpgt_pd(abs_pd(w), eps_128);
+    _mm_storeu_pd(weights.data + i, _mm_or_pd(_mm_and_pd(update, w_new), _mm_andnot_pd(update, w)));
+  }
+#endif
 
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     // if(weights[i]!=0)
     if (std::fabs(weights[i]) > std::numeric_limits<double>::epsilon()) {
       double xi_sig = x[i] / sig;
@@ -594,9 +651,19 @@ void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
 {
   unsigned int n_data = x.getRows();
   double const_sig = 2.3849 * sig;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  const __m128d const_sig_128 = _mm_set1_pd(const_sig);
+  const __m128d one_128 = _mm_set1_pd(1.0);
+  for (; i + 2 <= n_data; i += 2) {
+    __m128d u = _mm_div_pd(_mm_loadu_pd(x.data + i), const_sig_128);
+    _mm_storeu_pd(weights.data + i, _mm_div_pd(one_128, _mm_add_pd(one_128, _mm_mul_pd(u, u))));
+  }
+#endif
 
   // Calculate Cauchy's equation
-  for (unsigned int i = 0; i < n_data; i++) {
+  for (; i < n_data; i++) {
     weights[i] = 1 / (1 + vpMath::sqr(x[i] / (const_sig)));
 
     // If one coordinate is an outlier the other is too!
@@ -615,33 +682,13 @@ void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
 }
 
 /*!
-  \brief partition function
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
-*/
-int vpRobust::partition(vpColVector &a, int l, int r)
-{
-  int i = l - 1;
-  int j = r;
-  double v = a[(unsigned int)r];
-
-  for (;;) {
-    while (a[(unsigned int)++i] < v)
-      ;
-    while (v < a[(unsigned int)--j])
-      if (j == l)
-        break;
-    if (i >= j)
-      break;
-    exch(a[(unsigned int)i], a[(unsigned int)j]);
-  }
-  exch(a[(unsigned int)i], a[(unsigned int)r]);
-  return i;
-}
+  \brief Partially sort a part of a vector and select a value of this new
+  vector.
+
+  The selection is done with std::nth_element(), that runs in linear time
+  (introselect). After the call, the values before (resp. after) the selected
+  one are lower (resp. greater) or equal.
 
-/*!
-  \brief sort a part of a vector and select a value of this new vector
   \param a : vector to be sorted
   \param l : first value to be considered
   \param r : last value to be considered
@@ -649,12 +696,8 @@ int vpRobust::partition(vpColVector &a, int l, int r)
 */
 double vpRobust::select(vpColVector &a, int l, int r, int k)
 {
-  while (r > l) {
-    int i = partition(a, l, r);
-    if (i >= k)
-      r = i - 1;
-    if (i <= k)
-      l = i + 1;
+  if (r > l) {
+    std::nth_element(a.data + l, a.data + k, a.data + r + 1);
   }
   return a[(unsigned int)k];
 }
@@ -0,0 +1,205 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Read-only file mapped in memory.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpMemoryMappedFile.cpp
+  \brief File mapped in memory.
+*/
+
+#include <algorithm>
+#include <fstream>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpMemoryMappedFile.h>
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VISP_HAVE_MMAP 1
+#elif defined(_WIN32) && !defined(WINRT)
+#include <windows.h>
+#define VISP_HAVE_WIN32_FILE_MAPPING 1
+#endif
+
+/*!
+  Default constructor. No file is opened.
+*/
+vpMemoryMappedFile::vpMemoryMappedFile() : m_data(NULL), m_isBuffer(false), m_isOpen(false), m_size(0) {}
+
+/*!
+  Map a file in memory.
+
+  \param filename : Path of the file.
+
+  \exception vpException::ioError : If the file cannot be opened or
+  mapped.
+*/
+vpMemoryMappedFile::vpMemoryMappedFile(const std::string &filename)
+  : m_data(NULL), m_isBuffer(false), m_isOpen(false), m_size(0)
+{
+  open(filename);
+}
+
+/*!
+  Destructor that unmaps the file.
+*/
+vpMemoryMappedFile::~vpMemoryMappedFile() { close(); }
+
+/*!
+  Unmap the file. The pointers previously returned by getData() are no
+  longer valid.
+*/
+void vpMemoryMappedFile::close()
+{
+  if (m_data != NULL) {
+    if (m_isBuffer) {
+      delete[] m_data;
+    } else {
+#if defined(VISP_HAVE_MMAP)
+      munmap(m_data, m_size);
+#elif defined(VISP_HAVE_WIN32_FILE_MAPPING)
+      UnmapViewOfFile(m_data);
+#endif
+    }
+  }
+
+  m_data = NULL;
+  m_isBuffer = false;
+  m_isOpen = false;
+  m_size = 0;
+}
+
+/*!
+  Map a file in memory. A previously mapped file is unmapped.
+
+  \param filename : Path of the file.
+
+  \exception vpException::ioError : If the file cannot be opened or
+  mapped.
+*/
+void vpMemoryMappedFile::open(const std::string &filename)
+{
+  close();
+
+#if defined(VISP_HAVE_MMAP)
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw vpException(vpException::ioError, "Cannot open the file: %s", filename.c_str());
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw vpException(vpException::ioError, "Cannot get the size of the file: %s", filename.c_str());
+  }
+
+  m_size = (size_t)st.st_size;
+  if (m_size > 0) {
+    // Private writable mapping: the pages are shared until they are modified
+    void *data = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      m_size = 0;
+      throw vpException(vpException::ioError, "Cannot map the file: %s", filename.c_str());
+    }
+    m_data = static_cast<unsigned char *>(data);
+  }
+  // The mapping remains valid after closing the file descriptor
+  ::close(fd);
+#elif defined(VISP_HAVE_WIN32_FILE_MAPPING)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw vpException(vpException::ioError, "Cannot open the file: %s", filename.c_str());
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    throw vpException(vpException::ioError, "Cannot get the size of the file: %s", filename.c_str());
+  }
+
+  m_size = (size_t)size.QuadPart;
+  if (m_size > 0) {
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    void *data = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : NULL;
+    if (mapping != NULL) {
+      // The view keeps a reference to the mapping object
+      CloseHandle(mapping);
+    }
+    if (data == NULL) {
+      CloseHandle(file);
+      m_size = 0;
+      throw vpException(vpException::ioError, "Cannot map the file: %s", filename.c_str());
+    }
+    m_data = static_cast<unsigned char *>(data);
+  }
+  CloseHandle(file);
+#else
+  std::ifstream file(filename.c_str(), std::ifstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot open the file: %s", filename.c_str());
+  }
+
+  file.seekg(0, std::ios::end);
+  m_size = (size_t)file.tellg();
+  file.seekg(0, std::ios::beg);
+  if (m_size > 0) {
+    m_data = new unsigned char[m_size];
+    m_isBuffer = true;
+    if (!file.read(reinterpret_cast<char *>(m_data), (std::streamsize)m_size)) {
+      close();
+      throw vpException(vpException::ioError, "Cannot read the file: %s", filename.c_str());
+    }
+  }
+#endif
+
+  m_isOpen = true;
+}
+
+/*!
+  Exchange the mappings of two instances.
+
+  \param file : Instance to exchange with.
+*/
+void vpMemoryMappedFile::swap(vpMemoryMappedFile &file)
+{
+  std::swap(m_data, file.m_data);
+  std::swap(m_isBuffer, file.m_isBuffer);
+  std::swap(m_isOpen, file.m_isOpen);
+  std::swap(m_size, file.m_size);
+}
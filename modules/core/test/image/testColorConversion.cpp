@@ -0,0 +1,257 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test YUV color conversions.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testColorConversion.cpp
+
+  \brief Test that the optimized YUV conversions of vpImageConvert give
+  exactly the same results than the per-pixel formulas, and compare their
+  computation times.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+unsigned char clamp(int val) { return (unsigned char)(val < 0 ? 0 : (val > 255 ? 255 : val)); }
+
+void yuvToRGB(int y, int u, int v, unsigned char *dst, unsigned int nbChannels)
+{
+  int U = (int)((u - 128) * 0.354);
+  int V = (int)((v - 128) * 0.707);
+  dst[0] = clamp(y + 2 * V);
+  dst[1] = clamp(y - U - V);
+  dst[2] = clamp(y + 5 * U);
+  if (nbChannels == 4) {
+    dst[3] = vpRGBa::alpha_default;
+  }
+}
+
+void referenceYUYV(const unsigned char *src, unsigned char *dst, unsigned int nbPixels, unsigned int nbChannels)
+{
+  for (unsigned int i = 0; i < nbPixels / 2; i++, src += 4) {
+    int cb = ((src[1] - 128) * 454) >> 8;
+    int cr = ((src[3] - 128) * 359) >> 8;
+    int cg = ((src[1] - 128) * 88 + (src[3] - 128) * 183) >> 8;
+    for (unsigned int k = 0; k < 2; k++, dst += nbChannels) {
+      int y = src[2 * k];
+      dst[0] = clamp(y + cr);
+      dst[1] = clamp(y - cg);
+      dst[2] = clamp(y + cb);
+      if (nbChannels == 4) {
+        dst[3] = vpRGBa::alpha_default;
+      }
+    }
+  }
+}
+
+void referenceYUV422(const unsigned char *src, unsigned char *dst, unsigned int nbPixels, unsigned int nbChannels)
+{
+  for (unsigned int i = 0; i < nbPixels / 2; i++, src += 4, dst += 2 * nbChannels) {
+    yuvToRGB(src[1], src[0], src[2], dst, nbChannels);
+    yuvToRGB(src[3], src[0], src[2], dst + nbChannels, nbChannels);
+  }
+}
+
+void referenceYUV411(const unsigned char *src, unsigned char *dst, unsigned int nbPixels, unsigned int nbChannels)
+{
+  for (unsigned int i = 0; i < nbPixels / 4; i++, src += 6) {
+    const int y[4] = {src[1], src[2], src[4], src[5]};
+    for (unsigned int k = 0; k < 4; k++, dst += nbChannels) {
+      yuvToRGB(y[k], src[0], src[3], dst, nbChannels);
+    }
+  }
+}
+
+void referenceYUV420(const unsigned char *yuv, const unsigned char *iU, const unsigned char *iV, unsigned char *dst,
+                     unsigned int width, unsigned int height, unsigned int nbChannels)
+{
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const unsigned int c = (i / 2) * (width / 2) + j / 2;
+      yuvToRGB(yuv[i * width + j], iU[c], iV[c], dst + (i * width + j) * nbChannels, nbChannels);
+    }
+  }
+}
+
+bool check(const std::vector<unsigned char> &res, const std::vector<unsigned char> &ref, const std::string &name)
+{
+  if (res != ref) {
+    std::cerr << "Difference between " << name << "() and the reference conversion!" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testSize(unsigned int width, unsigned int height, vpUniRand &rand)
+{
+  const unsigned int size = width * height;
+  std::vector<unsigned char> src(2 * size);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = (unsigned char)(256 * rand());
+  }
+
+  std::vector<unsigned char> res(4 * size), ref(4 * size);
+  bool success = true;
+  for (unsigned int nbChannels = 3; nbChannels <= 4; nbChannels++) {
+    const bool rgba = nbChannels == 4;
+
+    std::fill(res.begin(), res.end(), 0);
+    std::fill(ref.begin(), ref.end(), 0);
+    referenceYUYV(&src[0], &ref[0], size, nbChannels);
+    rgba ? vpImageConvert::YUYVToRGBa(&src[0], &res[0], width, height)
+         : vpImageConvert::YUYVToRGB(&src[0], &res[0], width, height);
+    success = check(res, ref, rgba ? "YUYVToRGBa" : "YUYVToRGB") && success;
+
+    referenceYUV422(&src[0], &ref[0], size, nbChannels);
+    rgba ? vpImageConvert::YUV422ToRGBa(&src[0], &res[0], size) : vpImageConvert::YUV422ToRGB(&src[0], &res[0], size);
+    success = check(res, ref, rgba ? "YUV422ToRGBa" : "YUV422ToRGB") && success;
+
+    referenceYUV411(&src[0], &ref[0], size, nbChannels);
+    rgba ? vpImageConvert::YUV411ToRGBa(&src[0], &res[0], size) : vpImageConvert::YUV411ToRGB(&src[0], &res[0], size);
+    success = check(res, ref, rgba ? "YUV411ToRGBa" : "YUV411ToRGB") && success;
+
+    const unsigned char *iU = &src[size], *iV = &src[5 * size / 4];
+    referenceYUV420(&src[0], iU, iV, &ref[0], width, height, nbChannels);
+    rgba ? vpImageConvert::YUV420ToRGBa(&src[0], &res[0], width, height)
+         : vpImageConvert::YUV420ToRGB(&src[0], &res[0], width, height);
+    success = check(res, ref, rgba ? "YUV420ToRGBa" : "YUV420ToRGB") && success;
+
+    referenceYUV420(&src[0], iV, iU, &ref[0], width, height, nbChannels);
+    rgba ? vpImageConvert::YV12ToRGBa(&src[0], &res[0], width, height)
+         : vpImageConvert::YV12ToRGB(&src[0], &res[0], width, height);
+    success = check(res, ref, rgba ? "YV12ToRGBa" : "YV12ToRGB") && success;
+  }
+
+  std::vector<unsigned char> grey(size), grey_ref(size);
+  for (unsigned int i = 0; i < size; i++) {
+    grey_ref[i] = src[2 * i];
+  }
+  vpImageConvert::YUYVToGrey(&src[0], &grey[0], size);
+  success = check(grey, grey_ref, "YUYVToGrey") && success;
+  vpImageConvert::MONO16ToGrey(&src[0], &grey[0], size);
+  success = check(grey, grey_ref, "MONO16ToGrey") && success;
+
+  for (unsigned int i = 0; i < size; i++) {
+    grey_ref[i] = src[2 * i + 1];
+  }
+  vpImageConvert::YUV422ToGrey(&src[0], &grey[0], size);
+  success = check(grey, grey_ref, "YUV422ToGrey") && success;
+
+  // Split and merge back
+  vpImage<vpRGBa> I(height, width), I_merge;
+  memcpy((unsigned char *)I.bitmap, &src[0], 4 * (size / 2));
+  vpImage<unsigned char> channels[4];
+  vpImageConvert::split(I, &channels[0], &channels[1], &channels[2], &channels[3]);
+  for (unsigned int i = 0; i < size; i++) {
+    const unsigned char *pixel = (const unsigned char *)&I.bitmap[i];
+    for (unsigned int c = 0; c < 4; c++) {
+      if (channels[c].bitmap[i] != pixel[c]) {
+        std::cerr << "Difference between split() and the reference!" << std::endl;
+        return false;
+      }
+    }
+  }
+  vpImageConvert::merge(&channels[0], &channels[1], &channels[2], &channels[3], I_merge);
+  if (I_merge != I) {
+    std::cerr << "Difference between merge() and the original image!" << std::endl;
+    return false;
+  }
+
+  return success;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+    // Sizes that are not a multiple of the vector length to test the scalar tails
+    const unsigned int sizes[][2] = {{2, 2}, {6, 4}, {38, 6}, {642, 482}, {1920, 1080}};
+    for (unsigned int k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+      if (!testSize(sizes[k][0], sizes[k][1], rand)) {
+        std::cerr << "Failed for " << sizes[k][0] << "x" << sizes[k][1] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    const unsigned int width = 1920, height = 1080, size = width * height, nbIterations = 20;
+    std::vector<unsigned char> src(2 * size), dst(4 * size);
+    for (size_t i = 0; i < src.size(); i++) {
+      src[i] = (unsigned char)(256 * rand());
+    }
+
+    double t_reference = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      referenceYUYV(&src[0], &dst[0], size, 4);
+    }
+    t_reference = (vpTime::measureTimeMs() - t_reference) / nbIterations;
+    double t_optim = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      vpImageConvert::YUYVToRGBa(&src[0], &dst[0], width, height);
+    }
+    t_optim = (vpTime::measureTimeMs() - t_optim) / nbIterations;
+    std::cout << "YUYVToRGBa " << width << "x" << height << ": reference=" << t_reference
+              << " ms ; optimized=" << t_optim << " ms ; speed-up=" << t_reference / t_optim << std::endl;
+
+    t_reference = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      referenceYUV420(&src[0], &src[size], &src[5 * size / 4], &dst[0], width, height, 4);
+    }
+    t_reference = (vpTime::measureTimeMs() - t_reference) / nbIterations;
+    t_optim = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      vpImageConvert::YUV420ToRGBa(&src[0], &dst[0], width, height);
+    }
+    t_optim = (vpTime::measureTimeMs() - t_optim) / nbIterations;
+    std::cout << "YUV420ToRGBa " << width << "x" << height << ": reference=" << t_reference
+              << " ms ; optimized=" << t_optim << " ms ; speed-up=" << t_reference / t_optim << std::endl;
+
+    std::cout << "The optimized YUV conversions give the same results than the reference ones." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
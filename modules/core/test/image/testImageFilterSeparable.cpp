@@ -0,0 +1,434 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test separable image filtering.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageFilterSeparable.cpp
+
+  \brief Test that the optimized separable filters of vpImageFilter give the
+  same results than the per-pixel filtering functions, and that their single
+  precision versions are close to the double precision ones.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+template <class Type>
+void referenceFilterX(const vpImage<Type> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+    }
+    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+    }
+    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
+      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+    }
+  }
+}
+
+template <class Type>
+void referenceFilterY(const vpImage<Type> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+    }
+  }
+  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+    }
+  }
+  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+    }
+  }
+}
+
+template <class Type>
+void referenceGradX(const vpImage<Type> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth(), 0.0);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
+    }
+  }
+}
+
+template <class Type>
+void referenceGradY(const vpImage<Type> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth(), 0.0);
+  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
+    }
+  }
+}
+
+void referenceSepFilter(const vpImage<unsigned char> &I, vpImage<double> &If, const vpColVector &kernelH,
+                        const vpColVector &kernelV)
+{
+  unsigned int half_size = kernelH.size() / 2;
+
+  If.resize(I.getHeight(), I.getWidth(), 0.0);
+  vpImage<double> I_filter(I.getHeight(), I.getWidth(), 0.0);
+
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = half_size; j < I.getWidth() - half_size; j++) {
+      double conv = 0.0;
+      for (unsigned int a = 0; a < kernelH.size(); a++) {
+        conv += kernelH[a] * I[i][j + half_size - a];
+      }
+      I_filter[i][j] = conv;
+    }
+  }
+
+  for (unsigned int i = half_size; i < I.getHeight() - half_size; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double conv = 0.0;
+      for (unsigned int a = 0; a < kernelV.size(); a++) {
+        conv += kernelV[a] * I_filter[i + half_size - a][j];
+      }
+      If[i][j] = conv;
+    }
+  }
+}
+
+// Results must be strictly identical, hence the exact comparison of the floating point values
+bool isEqual(const vpImage<double> &I1, const vpImage<double> &I2, const std::string &name)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    std::cerr << name << ": the image sizes differ!" << std::endl;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < I1.getHeight(); i++) {
+    for (unsigned int j = 0; j < I1.getWidth(); j++) {
+      if (I1[i][j] != I2[i][j]) {
+        std::cerr << name << ": difference at (" << i << ", " << j << "): " << I1[i][j] << " != " << I2[i][j]
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+// Single precision results are compared with the double precision ones, relatively to the image range
+bool isClose(const vpImage<double> &I1, const vpImage<float> &I2, const std::string &name)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    std::cerr << name << ": the image sizes differ!" << std::endl;
+    return false;
+  }
+
+  double max_abs = 1.0;
+  for (unsigned int i = 0; i < I1.getSize(); i++) {
+    max_abs = std::max(max_abs, std::fabs(I1.bitmap[i]));
+  }
+
+  for (unsigned int i = 0; i < I1.getHeight(); i++) {
+    for (unsigned int j = 0; j < I1.getWidth(); j++) {
+      if (std::fabs(I1[i][j] - I2[i][j]) > 1e-5 * max_abs) {
+        std::cerr << name << ": difference at (" << i << ", " << j << "): " << I1[i][j] << " != " << I2[i][j]
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool testSize(unsigned int height, unsigned int width, unsigned int size, vpUniRand &rand, bool verbose)
+{
+  vpImage<unsigned char> I(height, width);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)(255 * rand());
+  }
+  vpImage<double> I_double;
+  vpImageConvert::convert(I, I_double);
+
+  std::vector<double> gaussian((size + 1) / 2), derivative((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&gaussian[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&derivative[0], size);
+
+  vpImage<double> I_ref, I_filtered;
+  double t_ref = 0, t = 0, t_start = 0;
+  bool ok = true;
+
+  // Horizontal and vertical Gaussian filtering
+  t_start = vpTime::measureTimeMs();
+  referenceFilterX(I, I_ref, &gaussian[0], size);
+  t_ref += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::filterX(I, I_filtered, &gaussian[0], size);
+  t += vpTime::measureTimeMs() - t_start;
+  ok = isEqual(I_ref, I_filtered, "filterX uchar") && ok;
+
+  referenceFilterX(I_double, I_ref, &gaussian[0], size);
+  vpImageFilter::filterX(I_double, I_filtered, &gaussian[0], size);
+  ok = isEqual(I_ref, I_filtered, "filterX double") && ok;
+
+  t_start = vpTime::measureTimeMs();
+  referenceFilterY(I, I_ref, &gaussian[0], size);
+  t_ref += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::filterY(I, I_filtered, &gaussian[0], size);
+  t += vpTime::measureTimeMs() - t_start;
+  ok = isEqual(I_ref, I_filtered, "filterY uchar") && ok;
+
+  referenceFilterY(I_double, I_ref, &gaussian[0], size);
+  vpImageFilter::filterY(I_double, I_filtered, &gaussian[0], size);
+  ok = isEqual(I_ref, I_filtered, "filterY double") && ok;
+
+  // Gaussian blur
+  vpImage<double> I_tmp;
+  referenceFilterX(I, I_tmp, &gaussian[0], size);
+  referenceFilterY(I_tmp, I_ref, &gaussian[0], size);
+  vpImageFilter::gaussianBlur(I, I_filtered, size);
+  ok = isEqual(I_ref, I_filtered, "gaussianBlur") && ok;
+
+  // Derivatives
+  t_start = vpTime::measureTimeMs();
+  referenceGradX(I, I_ref, &derivative[0], size);
+  t_ref += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradX(I, I_filtered, &derivative[0], size);
+  t += vpTime::measureTimeMs() - t_start;
+  ok = isEqual(I_ref, I_filtered, "getGradX uchar") && ok;
+
+  referenceGradX(I_double, I_ref, &derivative[0], size);
+  vpImageFilter::getGradX(I_double, I_filtered, &derivative[0], size);
+  ok = isEqual(I_ref, I_filtered, "getGradX double") && ok;
+
+  t_start = vpTime::measureTimeMs();
+  referenceGradY(I, I_ref, &derivative[0], size);
+  t_ref += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradY(I, I_filtered, &derivative[0], size);
+  t += vpTime::measureTimeMs() - t_start;
+  ok = isEqual(I_ref, I_filtered, "getGradY uchar") && ok;
+
+  referenceGradY(I_double, I_ref, &derivative[0], size);
+  vpImageFilter::getGradY(I_double, I_filtered, &derivative[0], size);
+  ok = isEqual(I_ref, I_filtered, "getGradY double") && ok;
+
+  referenceFilterY(I, I_tmp, &gaussian[0], size);
+  referenceGradX(I_tmp, I_ref, &derivative[0], size);
+  vpImageFilter::getGradXGauss2D(I, I_filtered, &gaussian[0], &derivative[0], size);
+  ok = isEqual(I_ref, I_filtered, "getGradXGauss2D") && ok;
+
+  referenceFilterX(I, I_tmp, &gaussian[0], size);
+  referenceGradY(I_tmp, I_ref, &derivative[0], size);
+  vpImageFilter::getGradYGauss2D(I, I_filtered, &gaussian[0], &derivative[0], size);
+  ok = isEqual(I_ref, I_filtered, "getGradYGauss2D") && ok;
+
+  // Separable filter with non symmetric kernels
+  vpColVector kernelH(size), kernelV(size);
+  for (unsigned int i = 0; i < size; i++) {
+    kernelH[i] = 2 * rand() - 1;
+    kernelV[i] = 2 * rand() - 1;
+  }
+  t_start = vpTime::measureTimeMs();
+  referenceSepFilter(I, I_ref, kernelH, kernelV);
+  t_ref += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::sepFilter(I, I_filtered, kernelH, kernelV);
+  t += vpTime::measureTimeMs() - t_start;
+  ok = isEqual(I_ref, I_filtered, "sepFilter") && ok;
+
+  if (verbose) {
+    std::cout << height << "x" << width << " kernel size " << size << ": t_reference=" << t_ref
+              << " ms ; t_optimized=" << t << " ms ; ratio=" << t_ref / t << std::endl;
+  }
+
+  return ok;
+}
+
+bool testSizeFloat(unsigned int height, unsigned int width, unsigned int size, vpUniRand &rand, bool verbose)
+{
+  vpImage<unsigned char> I(height, width);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)(255 * rand());
+  }
+  vpImage<double> I_double;
+  vpImage<float> I_float;
+  vpImageConvert::convert(I, I_double);
+  vpImageConvert::convert(I, I_float);
+
+  std::vector<double> gaussian((size + 1) / 2), derivative((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&gaussian[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&derivative[0], size);
+  std::vector<float> gaussian_float((size + 1) / 2), derivative_float((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&gaussian_float[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&derivative_float[0], size);
+
+  vpImage<double> I_ref;
+  vpImage<float> I_filtered;
+  double t_double = 0, t_float = 0, t_start = 0;
+  bool ok = true;
+
+  vpImageFilter::filterX(I, I_ref, &gaussian[0], size);
+  vpImageFilter::filterX(I, I_filtered, &gaussian_float[0], size);
+  ok = isClose(I_ref, I_filtered, "filterX uchar float") && ok;
+
+  vpImageFilter::filterX(I_float, I_filtered, &gaussian_float[0], size);
+  ok = isClose(I_ref, I_filtered, "filterX float") && ok;
+
+  vpImageFilter::filterY(I, I_ref, &gaussian[0], size);
+  vpImageFilter::filterY(I, I_filtered, &gaussian_float[0], size);
+  ok = isClose(I_ref, I_filtered, "filterY uchar float") && ok;
+
+  vpImageFilter::filterY(I_float, I_filtered, &gaussian_float[0], size);
+  ok = isClose(I_ref, I_filtered, "filterY float") && ok;
+
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::gaussianBlur(I, I_ref, size);
+  t_double += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::gaussianBlur(I, I_filtered, size);
+  t_float += vpTime::measureTimeMs() - t_start;
+  ok = isClose(I_ref, I_filtered, "gaussianBlur uchar float") && ok;
+
+  vpImageFilter::gaussianBlur(I_float, I_filtered, size);
+  ok = isClose(I_ref, I_filtered, "gaussianBlur float") && ok;
+
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradX(I, I_ref, &derivative[0], size);
+  t_double += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradX(I, I_filtered, &derivative_float[0], size);
+  t_float += vpTime::measureTimeMs() - t_start;
+  ok = isClose(I_ref, I_filtered, "getGradX uchar float") && ok;
+
+  vpImageFilter::getGradX(I_float, I_filtered, &derivative_float[0], size);
+  ok = isClose(I_ref, I_filtered, "getGradX float") && ok;
+
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradY(I, I_ref, &derivative[0], size);
+  t_double += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::getGradY(I, I_filtered, &derivative_float[0], size);
+  t_float += vpTime::measureTimeMs() - t_start;
+  ok = isClose(I_ref, I_filtered, "getGradY uchar float") && ok;
+
+  vpImageFilter::getGradY(I_float, I_filtered, &derivative_float[0], size);
+  ok = isClose(I_ref, I_filtered, "getGradY float") && ok;
+
+  vpImageFilter::getGradXGauss2D(I, I_ref, &gaussian[0], &derivative[0], size);
+  vpImageFilter::getGradXGauss2D(I, I_filtered, &gaussian_float[0], &derivative_float[0], size);
+  ok = isClose(I_ref, I_filtered, "getGradXGauss2D float") && ok;
+
+  vpImageFilter::getGradYGauss2D(I, I_ref, &gaussian[0], &derivative[0], size);
+  vpImageFilter::getGradYGauss2D(I, I_filtered, &gaussian_float[0], &derivative_float[0], size);
+  ok = isClose(I_ref, I_filtered, "getGradYGauss2D float") && ok;
+
+  vpColVector kernelH(size), kernelV(size);
+  for (unsigned int i = 0; i < size; i++) {
+    kernelH[i] = 2 * rand() - 1;
+    kernelV[i] = 2 * rand() - 1;
+  }
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::sepFilter(I, I_ref, kernelH, kernelV);
+  t_double += vpTime::measureTimeMs() - t_start;
+  t_start = vpTime::measureTimeMs();
+  vpImageFilter::sepFilter(I, I_filtered, kernelH, kernelV);
+  t_float += vpTime::measureTimeMs() - t_start;
+  ok = isClose(I_ref, I_filtered, "sepFilter float") && ok;
+
+  if (verbose) {
+    std::cout << height << "x" << width << " kernel size " << size << ": t_double=" << t_double
+              << " ms ; t_float=" << t_float << " ms ; ratio=" << t_double / t_float << std::endl;
+  }
+
+  return ok;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+
+    // Odd sizes to test the columns that are not processed by the vectorized code
+    const unsigned int heights[] = {13, 31, 480};
+    const unsigned int widths[] = {17, 45, 641};
+    const unsigned int sizes[] = {3, 5, 7, 9};
+
+    for (unsigned int i = 0; i < sizeof(heights) / sizeof(heights[0]); i++) {
+      for (unsigned int j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+        if (!testSize(heights[i], widths[i], sizes[j], rand, i == 2)) {
+          std::cerr << "Difference with the per-pixel filtering for the image " << heights[i] << "x" << widths[i]
+                    << " and the kernel size " << sizes[j] << "!" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    for (unsigned int i = 0; i < sizeof(heights) / sizeof(heights[0]); i++) {
+      for (unsigned int j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+        if (!testSizeFloat(heights[i], widths[i], sizes[j], rand, i == 2)) {
+          std::cerr << "Difference between the float and the double filtering for the image " << heights[i] << "x"
+                    << widths[i] << " and the kernel size " << sizes[j] << "!" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    std::cout << "The separable filters return the same images than the per-pixel filtering." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,120 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImage ownership of the bitmap.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageOwnership.cpp
+
+  \brief Test that a vpImage built over an external memory does not copy nor
+  free it, and that the copies of such an image own their bitmap.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+
+int main()
+{
+  const unsigned int height = 48, width = 64;
+  std::vector<unsigned char> array(height * width), array2(height * width);
+  for (size_t i = 0; i < array.size(); i++) {
+    array[i] = (unsigned char)(i % 251);
+    array2[i] = (unsigned char)(i % 13);
+  }
+
+  {
+    // View on the external memory
+    vpImage<unsigned char> I(&array[0], height, width, false);
+    if (I.bitmap != &array[0] || I[1][2] != array[width + 2]) {
+      std::cerr << "The view does not use the external memory" << std::endl;
+      return EXIT_FAILURE;
+    }
+    I[1][2] = 255;
+    if (array[width + 2] != 255) {
+      std::cerr << "The view does not modify the external memory" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The copies own their bitmap
+    vpImage<unsigned char> I2(I), I3;
+    I3 = I;
+    if (I2.bitmap == I.bitmap || I3.bitmap == I.bitmap || I2 != I || I3 != I) {
+      std::cerr << "Wrong copy of a view" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Copying data of the same size in a view must not write into the
+    // external memory
+    I.init(&array2[0], height, width, true);
+    if (I.bitmap == &array[0] || array[width + 2] != 255 || I[1][2] != array2[width + 2]) {
+      std::cerr << "Wrong init() of a view with a copy" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // A new view, then a resize to another size
+    I.init(&array2[0], height, width, false);
+    I.resize(height / 2, width / 2);
+    if (I.bitmap == &array2[0] || I.getHeight() != height / 2) {
+      std::cerr << "Wrong resize() of a view" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpImage<unsigned char> I4(&array2[0], height, width, false);
+    swap(I4, I2);
+    if (I2.bitmap != &array2[0] || I4[1][2] != 255) {
+      std::cerr << "Wrong swap() of a view" << std::endl;
+      return EXIT_FAILURE;
+    }
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+    vpImage<unsigned char> I5(std::move(I2));
+    if (I5.bitmap != &array2[0]) {
+      std::cerr << "Wrong move of a view" << std::endl;
+      return EXIT_FAILURE;
+    }
+#endif
+    // The views are destroyed here: the external memory must not be freed
+  }
+
+  for (size_t i = 0; i < array2.size(); i++) {
+    if (array2[i] != (unsigned char)(i % 13)) {
+      std::cerr << "The external memory has been modified" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "vpImage ownership is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
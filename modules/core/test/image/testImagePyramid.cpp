@@ -0,0 +1,181 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test image pyramid.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Test that vpImagePyramid gives the same levels than
+  vpImageFilter::getGaussPyramidal() and than a plain subsampling, and that
+  its levels and frame stamp are reused.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+void randomImage(vpImage<unsigned char> &I, vpUniRand &rand)
+{
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)(256 * rand());
+  }
+}
+
+bool isSameLevel(const vpImagePyramid &pyramid, const vpImagePyramid &reference, unsigned int level)
+{
+  vpImage<unsigned char> I = pyramid[level];
+  return I == reference[level];
+}
+
+bool checkLevels(const vpImagePyramid &pyramid, const vpImage<unsigned char> &I, unsigned int nbLevels)
+{
+  if (pyramid.getNbLevels() != nbLevels || &pyramid[0] != &I) {
+    std::cerr << "Wrong number of levels or level 0 is not the input image!" << std::endl;
+    return false;
+  }
+
+  vpImage<unsigned char> ref = I, tmp;
+  for (unsigned int l = 1; l < nbLevels; l++) {
+    if (pyramid.getType() == vpImagePyramid::GAUSSIAN_PYRAMID) {
+      vpImageFilter::getGaussPyramidal(ref, tmp);
+    } else {
+      tmp.resize(ref.getHeight() / 2, ref.getWidth() / 2);
+      for (unsigned int i = 0; i < tmp.getHeight(); i++) {
+        for (unsigned int j = 0; j < tmp.getWidth(); j++) {
+          tmp[i][j] = ref[2 * i][2 * j];
+        }
+      }
+    }
+    ref = tmp;
+
+    if (ref != pyramid[l]) {
+      std::cerr << "Difference at level " << l << "!" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+    vpImage<unsigned char> I1(481, 643), I2(481, 643);
+    randomImage(I1, rand);
+    randomImage(I2, rand);
+
+    for (int type = 0; type < 2; type++) {
+      vpImagePyramid pyramid(type == 0 ? vpImagePyramid::GAUSSIAN_PYRAMID : vpImagePyramid::SUBSAMPLED_PYRAMID);
+      pyramid.build(I1, 4);
+      if (!checkLevels(pyramid, I1, 4)) {
+        return EXIT_FAILURE;
+      }
+
+      // Levels are reused for another frame of the same size
+      const unsigned char *level1 = pyramid[1].bitmap;
+      pyramid.build(I2, 4, 1);
+      if (!checkLevels(pyramid, I2, 4) || pyramid[1].bitmap != level1 || !pyramid.isUpToDate(1, 4)) {
+        std::cerr << "Levels not reused!" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Same frame stamp: nothing is computed again, even if the image changed
+      vpImage<unsigned char> level2 = pyramid[2];
+      randomImage(I2, rand);
+      pyramid.build(I2, 3, 1);
+      if (pyramid.getNbLevels() != 4 || level2 != pyramid[2]) {
+        std::cerr << "The pyramid was computed again for the same frame stamp!" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // New frame stamp, with less levels
+      pyramid.build(I2, 2, 2);
+      if (!checkLevels(pyramid, I2, 2) || pyramid.isUpToDate(1, 2) || !pyramid.isUpToDate(2, 2)) {
+        return EXIT_FAILURE;
+      }
+
+      // Missing levels are added for the same frame stamp
+      pyramid.build(I2, 5, 2);
+      if (!checkLevels(pyramid, I2, 5)) {
+        return EXIT_FAILURE;
+      }
+
+      // Only the used levels are computed, the levels of a Gaussian pyramid
+      // below the last used one being needed
+      vpImagePyramid full(pyramid.getType());
+      full.build(I1, 5);
+      std::vector<bool> levels(5, false);
+      levels[0] = levels[2] = levels[4] = true;
+      pyramid.build(I1, levels, 3);
+      if (pyramid.getNbLevels() != 5 || pyramid.isLevelBuilt(1) != (type == 0) ||
+          pyramid.isLevelBuilt(3) != (type == 0) || !isSameLevel(pyramid, full, 2) || !isSameLevel(pyramid, full, 4) ||
+          !pyramid.isUpToDate(3, levels) || pyramid.isUpToDate(3, 5) != (type == 0)) {
+        std::cerr << "Wrong levels for the used levels!" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // A used level is added for the same frame stamp
+      levels[3] = true;
+      pyramid.build(I1, levels, 3);
+      if (!isSameLevel(pyramid, full, 3) || pyramid.isLevelBuilt(1) != (type == 0) || !pyramid.isUpToDate(3, levels)) {
+        std::cerr << "Wrong level added to the used levels!" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      bool exception = false;
+      try {
+        pyramid.getLevel(5);
+      } catch (const vpException &) {
+        exception = true;
+      }
+      if (!exception) {
+        std::cerr << "No exception for a level that is not built!" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "vpImagePyramid gives the expected levels." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
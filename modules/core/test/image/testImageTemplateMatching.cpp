@@ -339,6 +339,23 @@ int main(int argc, const char **argv)
           }
         }
       }
+
+      // Single precision template matching
+      vpImage<float> I_score_float;
+      double t_float = vpTime::measureTimeMs();
+      vpImageTools::templateMatching(I, I_template, I_score_float, step_u, step_v, true);
+      t_float = vpTime::measureTimeMs() - t_float;
+      std::cout << "Template matching (float): " << t_float << " ms" << std::endl;
+
+      for (unsigned int i = 0; i < I_score_float.getHeight(); i++) {
+        for (unsigned int j = 0; j < I_score_float.getWidth(); j++) {
+          if (!vpMath::equal(I_score_float[i][j], I_score_gold[i][j], 1e-4)) {
+            std::cerr << "Issue with float template matching, gold: " << std::setprecision(17) << I_score_gold[i][j]
+                      << " ; compute: " << I_score_float[i][j] << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
     }
 
   } catch (const vpException &e) {
@@ -0,0 +1,251 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test and benchmark the built-in matrix products.
+ *
+ *****************************************************************************/
+
+
+/*!
+  \example testMatrixMultiplication.cpp
+
+  \brief Test the built-in blocked matrix products used when ViSP is not
+  built with an external BLAS library against naive loops, and compare their
+  computation times.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+double element(const std::vector<double> &X, unsigned int ldx, bool trans, unsigned int i, unsigned int j)
+{
+  return trans ? X[j * ldx + i] : X[i * ldx + j];
+}
+
+// C = alpha * op(A) * op(B) + beta * C
+void referenceGEMM(bool transA, bool transB, unsigned int M, unsigned int N, unsigned int K, double alpha,
+                   const std::vector<double> &A, const std::vector<double> &B, double beta, std::vector<double> &C)
+{
+  const unsigned int lda = transA ? M : K, ldb = transB ? K : N;
+  for (unsigned int i = 0; i < M; i++) {
+    for (unsigned int j = 0; j < N; j++) {
+      double sum = 0;
+      for (unsigned int k = 0; k < K; k++) {
+        sum += element(A, lda, transA, i, k) * element(B, ldb, transB, k, j);
+      }
+      C[i * N + j] = alpha * sum + beta * C[i * N + j];
+    }
+  }
+}
+
+std::vector<double> random(unsigned int size, vpUniRand &rand)
+{
+  std::vector<double> v(size);
+  for (unsigned int i = 0; i < size; i++) {
+    v[i] = 2 * rand() - 1;
+  }
+  return v;
+}
+
+bool check(const std::vector<double> &res, const std::vector<double> &ref, unsigned int K, const std::string &name)
+{
+  // Only the summation order differs
+  const double tolerance = 1e-13 * (K + 1);
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (std::fabs(res[i] - ref[i]) > tolerance) {
+      std::cerr << "Difference between " << name << " and the reference at " << i << ": " << res[i]
+                << " != " << ref[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool testSize(unsigned int M, unsigned int N, unsigned int K, vpUniRand &rand)
+{
+  const std::vector<double> A = random(M * K, rand), B = random(K * N, rand), C = random(M * N, rand);
+  const double alpha = 0.75, beta = -1.5;
+
+  for (unsigned int t = 0; t < 4; t++) {
+    const bool transA = (t & 1) != 0, transB = (t & 2) != 0;
+    std::vector<double> res = C, ref = C;
+    referenceGEMM(transA, transB, M, N, K, alpha, A, B, beta, ref);
+    vpGEMMKernel(transA, transB, M, N, K, alpha, &A[0], transA ? M : K, &B[0], transB ? K : N, beta, &res[0], N);
+    if (!check(res, ref, K, "vpGEMMKernel()")) {
+      return false;
+    }
+
+    // beta = 0 must ignore the content of C
+    res.assign(M * N, std::numeric_limits<double>::quiet_NaN());
+    ref.assign(M * N, 0.);
+    referenceGEMM(transA, transB, M, N, K, alpha, A, B, 0., ref);
+    vpGEMMKernel(transA, transB, M, N, K, alpha, &A[0], transA ? M : K, &B[0], transB ? K : N, 0., &res[0], N);
+    if (!check(res, ref, K, "vpGEMMKernel() with beta = 0")) {
+      return false;
+    }
+  }
+
+  // A * A^T and A^T * A, A being M x K
+  for (unsigned int t = 0; t < 2; t++) {
+    const bool transA = t != 0;
+    const unsigned int n = transA ? K : M, k = transA ? M : K;
+    std::vector<double> res(n * n, std::numeric_limits<double>::quiet_NaN()), ref(n * n, 0.);
+    referenceGEMM(transA, !transA, n, n, k, alpha, A, A, 0., ref);
+    vpSYRKKernel(transA, n, k, alpha, &A[0], K, 0., &res[0], n);
+    if (!check(res, ref, k, transA ? "vpSYRKKernel(A^T A)" : "vpSYRKKernel(A A^T)")) {
+      return false;
+    }
+  }
+
+  // op(A) * x
+  for (unsigned int t = 0; t < 2; t++) {
+    const bool transA = t != 0;
+    const unsigned int m = transA ? K : M, k = transA ? M : K;
+    const std::vector<double> x = random(k, rand);
+    std::vector<double> res = random(m, rand), ref = res;
+    referenceGEMM(transA, false, m, 1, k, alpha, A, x, beta, ref);
+    vpGEMVKernel(transA, M, K, alpha, &A[0], K, &x[0], beta, &res[0]);
+    if (!check(res, ref, k, transA ? "vpGEMVKernel(A^T x)" : "vpGEMVKernel(A x)")) {
+      return false;
+    }
+  }
+
+  // vpMatrix and vpGEMM() interfaces
+  vpMatrix mA(M, K), mB(K, N);
+  std::copy(A.begin(), A.end(), mA.data);
+  std::copy(B.begin(), B.end(), mB.data);
+  std::vector<double> ref(M * N, 0.);
+  referenceGEMM(false, false, M, N, K, 1., A, B, 0., ref);
+  vpMatrix mC = mA * mB;
+  if (!check(std::vector<double>(mC.data, mC.data + mC.size()), ref, K, "vpMatrix::operator*()")) {
+    return false;
+  }
+  vpMatrix mD;
+  vpGEMM(mB, mA, 1., mC, 2., mD, VP_GEMM_A_T + VP_GEMM_B_T + VP_GEMM_C_T);
+  for (unsigned int i = 0; i < ref.size(); i++) {
+    ref[i] *= 3;
+  }
+  vpMatrix mDt = mD.t();
+  if (!check(std::vector<double>(mDt.data, mDt.data + mDt.size()), ref, K, "vpGEMM()")) {
+    return false;
+  }
+  vpMatrix mAtA = mA.AtA(), mAAt = mA.AAt();
+  ref.assign(K * K, 0.);
+  referenceGEMM(true, false, K, K, M, 1., A, A, 0., ref);
+  if (!check(std::vector<double>(mAtA.data, mAtA.data + mAtA.size()), ref, M, "vpMatrix::AtA()")) {
+    return false;
+  }
+  ref.assign(M * M, 0.);
+  referenceGEMM(false, true, M, M, K, 1., A, A, 0., ref);
+  if (!check(std::vector<double>(mAAt.data, mAAt.data + mAAt.size()), ref, K, "vpMatrix::AAt()")) {
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+    // Sizes that are not multiples of the register tile and of the cache blocks
+    const unsigned int sizes[][3] = {{1, 1, 1},     {6, 6, 6},      {3, 5, 7},      {2000, 6, 6},   {6, 2000, 6},
+                                     {6, 6, 2000},  {37, 129, 45},  {131, 67, 300}, {257, 259, 513}};
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      if (!testSize(sizes[s][0], sizes[s][1], sizes[s][2], rand)) {
+        std::cerr << "Failed for M=" << sizes[s][0] << " N=" << sizes[s][1] << " K=" << sizes[s][2] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    const unsigned int n = 512, nbIterations = 3;
+    const std::vector<double> A = random(n * n, rand), B = random(n * n, rand);
+    std::vector<double> C(n * n);
+
+    double t_reference = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIterations; i++) {
+      referenceGEMM(false, false, n, n, n, 1., A, B, 0., C);
+    }
+    t_reference = (vpTime::measureTimeMs() - t_reference) / nbIterations;
+    double t_optim = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIterations; i++) {
+      vpGEMMKernel(false, false, n, n, n, 1., &A[0], n, &B[0], n, 0., &C[0], n);
+    }
+    t_optim = (vpTime::measureTimeMs() - t_optim) / nbIterations;
+    std::cout << "GEMM " << n << "x" << n << ": naive=" << t_reference << " ms ; built-in=" << t_optim
+              << " ms ; speed-up=" << t_reference / t_optim << std::endl;
+
+    vpMatrix mA(n, n), mB(n, n), mC;
+    std::copy(A.begin(), A.end(), mA.data);
+    std::copy(B.begin(), B.end(), mB.data);
+    double t_matrix = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIterations; i++) {
+      vpMatrix::mult2Matrices(mA, mB, mC);
+    }
+    t_matrix = (vpTime::measureTimeMs() - t_matrix) / nbIterations;
+    std::cout << "vpMatrix::mult2Matrices() " << n << "x" << n << ": " << t_matrix << " ms" << std::endl;
+
+    // Typical normal equations of a visual servoing or tracking task
+    const unsigned int m = 20000;
+    const std::vector<double> L = random(m * 6, rand);
+    std::vector<double> LtL(36);
+    t_reference = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 10 * nbIterations; i++) {
+      referenceGEMM(true, false, 6, 6, m, 1., L, L, 0., LtL);
+    }
+    t_reference = (vpTime::measureTimeMs() - t_reference) / (10 * nbIterations);
+    t_optim = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 10 * nbIterations; i++) {
+      vpSYRKKernel(true, 6, m, 1., &L[0], 6, 0., &LtL[0], 6);
+    }
+    t_optim = (vpTime::measureTimeMs() - t_optim) / (10 * nbIterations);
+    std::cout << "L^T L " << m << "x6: naive=" << t_reference << " ms ; built-in=" << t_optim
+              << " ms ; speed-up=" << t_reference / t_optim << std::endl;
+
+    std::cout << "The built-in matrix products give the same results than the naive ones." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -42,6 +42,7 @@
   Test some vpMath functionalities.
 */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
@@ -49,6 +50,7 @@
 #include <string>
 #include <visp3/core/vpIoTools.h>
 #include <visp3/core/vpRobust.h>
+#include <visp3/core/vpUniRand.h>
 #include <visp3/io/vpParseArgv.h>
 // List of allowed command line options
 #define GETOPTARGS "cdho:"
@@ -56,6 +58,49 @@
 void usage(const char *name, const char *badparam, std::string ofilename);
 bool getOptions(int argc, const char **argv, std::string &ofilename);
 
+/*!
+  Check that the weights computed with SSE2 are the same as the ones computed
+  by the scalar loop. The vector of residuals has an odd size, so that its
+  last residual is always processed by the scalar loop. Since the scale
+  estimate does not depend on the order of the residuals, the weight of each
+  residual is computed again after swapping it with the last one, and must be
+  bit-identical.
+
+  \return true if the weights are the same.
+*/
+bool testWeights(vpRobust::vpRobustEstimatorType method, const std::string &name)
+{
+  const unsigned int n = 101;
+  vpUniRand rng(42);
+  vpColVector residues(n), initialWeights(n);
+  for (unsigned int i = 0; i < n; i++) {
+    residues[i] = 2 * rng() - 1;
+    // Some outliers and some residuals already rejected
+    if (i % 10 == 3)
+      residues[i] *= 20;
+    initialWeights[i] = (i % 17 == 5) ? 0 : 1;
+  }
+
+  vpRobust robust(n);
+  vpColVector weights = initialWeights;
+  robust.MEstimator(method, residues, weights);
+
+  for (unsigned int i = 0; i + 1 < n; i++) {
+    vpColVector swappedResidues = residues, swappedWeights = initialWeights;
+    std::swap(swappedResidues[i], swappedResidues[n - 1]);
+    std::swap(swappedWeights[i], swappedWeights[n - 1]);
+    robust.MEstimator(method, swappedResidues, swappedWeights);
+    if (swappedWeights[n - 1] != weights[i]) {
+      std::cerr << name << ": weight " << weights[i] << " instead of " << swappedWeights[n - 1] << " for the residual "
+                << residues[i] << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << name << " weights are ok" << std::endl;
+  return true;
+}
+
 /*!
 
   Print the program options.
@@ -203,6 +248,11 @@ int main(int argc, const char **argv)
       f << x << "  " << w << std::endl;
       x += 0.01;
     }
+
+    if (!testWeights(vpRobust::TUKEY, "Tukey") || !testWeights(vpRobust::CAUCHY, "Cauchy") ||
+        !testWeights(vpRobust::HUBER, "Huber")) {
+      return 1;
+    }
     return 0;
   } catch (const vpException &e) {
     std::cout << "Catch an exception: " << e << std::endl;
@@ -0,0 +1,152 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpMemoryMappedFile.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMemoryMappedFile.cpp
+
+  \brief Test that vpMemoryMappedFile gives access to the content of a file
+  and that modifying the mapping does not modify the file.
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMemoryMappedFile.h>
+
+namespace
+{
+void writeFile(const std::string &filename, const std::vector<unsigned char> &content)
+{
+  std::ofstream file(filename.c_str(), std::ofstream::binary);
+  if (!content.empty()) {
+    file.write(reinterpret_cast<const char *>(&content[0]), (std::streamsize)content.size());
+  }
+}
+
+bool checkContent(const vpMemoryMappedFile &file, const std::vector<unsigned char> &content, const std::string &name)
+{
+  if (!file.isOpen() || file.getSize() != content.size()) {
+    std::cerr << name << ": wrong size " << file.getSize() << " instead of " << content.size() << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < content.size(); i++) {
+    if (file.getData()[i] != content[i]) {
+      std::cerr << name << ": difference at byte " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::string username;
+    vpIoTools::getUserName(username);
+#if defined(_WIN32)
+    std::string tmp_dir = "C:/temp/" + username;
+#else
+    std::string tmp_dir = "/tmp/" + username;
+#endif
+    vpIoTools::makeDirectory(tmp_dir);
+    const std::string filename1 = tmp_dir + "/testMemoryMappedFile1.bin";
+    const std::string filename2 = tmp_dir + "/testMemoryMappedFile2.bin";
+
+    // Size that is not a multiple of the page size
+    std::vector<unsigned char> content1(100003), content2;
+    for (size_t i = 0; i < content1.size(); i++) {
+      content1[i] = (unsigned char)((i * 7 + i / 256) & 0xff);
+    }
+    writeFile(filename1, content1);
+    writeFile(filename2, content2);
+
+    vpMemoryMappedFile file1(filename1), file2;
+    if (!checkContent(file1, content1, "Mapping") || file2.isOpen()) {
+      return EXIT_FAILURE;
+    }
+    if ((size_t)file1.getData() % 4096 != 0) {
+      std::cerr << "The mapping is not aligned on a page boundary" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Empty file
+    file2.open(filename2);
+    if (!checkContent(file2, content2, "Empty file") || file2.getData() != NULL) {
+      return EXIT_FAILURE;
+    }
+
+    // Private mapping: the file is not modified
+    file1.getData()[0] = (unsigned char)(content1[0] + 1);
+    file2.swap(file1);
+    if (file1.getSize() != 0 || file2.getSize() != content1.size() || file2.getData()[0] != content1[0] + 1) {
+      std::cerr << "Wrong swap()" << std::endl;
+      return EXIT_FAILURE;
+    }
+    file2.close();
+    if (file2.isOpen() || file2.getData() != NULL) {
+      std::cerr << "Wrong close()" << std::endl;
+      return EXIT_FAILURE;
+    }
+    file2.open(filename1);
+    if (!checkContent(file2, content1, "Mapping after modification")) {
+      return EXIT_FAILURE;
+    }
+
+    bool exceptionThrown = false;
+    try {
+      vpMemoryMappedFile file3(tmp_dir + "/testMemoryMappedFileMissing.bin");
+    } catch (const vpException &) {
+      exceptionThrown = true;
+    }
+    if (!exceptionThrown) {
+      std::cerr << "No exception for a missing file" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    file2.close();
+    vpIoTools::remove(filename1);
+    vpIoTools::remove(filename2);
+
+    std::cout << "vpMemoryMappedFile is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -38,6 +38,8 @@
 #include <visp3/core/vpConfig.h>
 
 #ifdef VISP_HAVE_APRILTAG
+#include <map>
+
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImage.h>
@@ -157,6 +159,14 @@ Tag number 1:
   Tag Id: 1
 \endcode
 
+  For calibration boards and other rigid layouts of tags, setTagBundle()
+  allows to estimate a joint pose of the tags, and setUseParallelPose() to
+  estimate the tag poses in parallel.
+
+  To process a video stream, setIncrementalDetection() allows to search the
+  tags only around their previous locations, with a periodic detection in
+  the whole image.
+
   Other examples are also provided in tutorial-apriltag-detector.cpp and
   tutorial-apriltag-detector-live.cpp
 */
@@ -205,6 +215,10 @@ public:
   bool detect(const vpImage<unsigned char> &I, const double tagSize, const vpCameraParameters &cam,
               std::vector<vpHomogeneousMatrix> &cMo_vec);
 
+  bool getBundlePose(vpHomogeneousMatrix &cMb) const;
+  double getDetectionTime() const;
+  double getPoseTime() const;
+
   /*!
     Return the pose estimation method.
   */
@@ -227,6 +241,12 @@ public:
     m_displayTagThickness = thickness;
   }
 
+  void setIncrementalDetection(const bool enable, const unsigned int fullDetectionPeriod = 10,
+                               const double roiMargin = 0.5);
+  void setNbParallelPoseThreads(const int nb);
+  void setTagBundle(const std::map<int, vpHomogeneousMatrix> &bMt);
+  void setUseParallelPose(const bool use);
+
 protected:
   bool m_displayTag;
   vpColor m_displayTagColor;
@@ -35,6 +35,9 @@
 #include <visp3/core/vpConfig.h>
 
 #ifdef VISP_HAVE_APRILTAG
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <map>
 
 #include <apriltag.h>
@@ -47,18 +50,28 @@
 #include <tag36h11.h>
 
 #include <visp3/core/vpDisplay.h>
+#include <visp3/core/vpParallelTaskException.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpPoint.h>
+#include <visp3/core/vpRect.h>
+#include <visp3/core/vpTime.h>
 #include <visp3/detection/vpDetectorAprilTag.h>
 #include <visp3/vision/vpPose.h>
 
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 class vpDetectorAprilTag::Impl
 {
 public:
   Impl(const vpAprilTagFamily &tagFamily, const vpPoseEstimationMethod &method)
     : m_cam(), m_poseEstimationMethod(method), m_tagFamily(tagFamily), m_tagPoses(), m_tagSize(1.0), m_td(NULL),
-      m_tf(NULL)
+      m_tf(NULL), m_incrementalDetection(false), m_fullDetectionPeriod(10), m_roiMargin(0.5),
+      m_nbFramesSinceFullDetection(0), m_imageWidth(0), m_imageHeight(0), m_rois(), m_trackedIds(),
+      m_trackedCenters(), m_bundle(), m_bundleDetected(false), m_bundlePose(), m_useParallelPose(false),
+      m_nbParallelPoseThreads(0), m_detectionTime(0), m_poseTime(0)
   {
     switch (m_tagFamily) {
     case TAG_36h11:
@@ -136,13 +149,40 @@ public:
               const vpColor color, const unsigned int thickness)
   {
     m_tagPoses.clear();
+    m_bundleDetected = false;
+    m_poseTime = 0;
+
+    double t = vpTime::measureTimeMs();
+    bool fullDetection = !m_incrementalDetection || m_rois.empty() ||
+                         m_nbFramesSinceFullDetection >= m_fullDetectionPeriod || I.getWidth() != m_imageWidth ||
+                         I.getHeight() != m_imageHeight;
+    zarray_t *detections = NULL;
+    if (!fullDetection) {
+      detections = detectInRois(I);
+      // All the tags are lost: fall back to a full-frame scan
+      if (zarray_size(detections) == 0) {
+        apriltag_detections_destroy(detections);
+        fullDetection = true;
+      }
+    }
+    if (fullDetection) {
+      image_u8_t im = {/*.width =*/(int32_t)I.getWidth(),
+                       /*.height =*/(int32_t)I.getHeight(),
+                       /*.stride =*/(int32_t)I.getWidth(),
+                       /*.buf =*/I.bitmap};
+
+      detections = apriltag_detector_detect(m_td, &im);
+      m_nbFramesSinceFullDetection = 0;
+    }
+    m_nbFramesSinceFullDetection++;
+    m_imageWidth = I.getWidth();
+    m_imageHeight = I.getHeight();
 
-    image_u8_t im = {/*.width =*/(int32_t)I.getWidth(),
-                     /*.height =*/(int32_t)I.getHeight(),
-                     /*.stride =*/(int32_t)I.getWidth(),
-                     /*.buf =*/I.bitmap};
+    if (m_incrementalDetection) {
+      updateRois(detections);
+    }
+    m_detectionTime = vpTime::measureTimeMs() - t;
 
-    zarray_t *detections = apriltag_detector_detect(m_td, &im);
     int nb_detections = zarray_size(detections);
     bool detected = nb_detections > 0;
 
@@ -177,113 +217,340 @@ public:
         vpDisplay::displayLine(I, (int)det->p[2][1], (int)det->p[2][0], (int)det->p[3][1], (int)det->p[3][0],
                                Oy2, thickness);
       }
+    }
 
-      if (computePose) {
-        vpHomogeneousMatrix cMo;
-        if (m_poseEstimationMethod == HOMOGRAPHY || m_poseEstimationMethod == HOMOGRAPHY_VIRTUAL_VS
-            || m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
-          double fx = m_cam.get_px(), fy = m_cam.get_py();
-          double cx = m_cam.get_u0(), cy = m_cam.get_v0();
+    if (computePose) {
+      double t = vpTime::measureTimeMs();
+      computeTagPoses(detections);
+      if (!m_bundle.empty()) {
+        computeBundlePose(detections);
+      }
+      m_poseTime = vpTime::measureTimeMs() - t;
+    }
 
-          matd_t *M = homography_to_pose(det->H, fx, fy, cx, cy, m_tagSize / 2);
+    apriltag_detections_destroy(detections);
 
-          for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-              cMo[i][j] = MATD_EL(M, i, j);
-            }
-            cMo[i][3] = MATD_EL(M, i, 3);
-          }
+    return detected;
+  }
+
+  // Add the corners of a tag to the pose estimation, oMt being the pose of
+  // the tag in the object frame
+  void addTagCorners(vpPose &pose, const apriltag_detection_t *det, const vpHomogeneousMatrix &oMt) const
+  {
+    const double tagCorners[4][2] = {{-m_tagSize / 2.0, -m_tagSize / 2.0},
+                                     {m_tagSize / 2.0, -m_tagSize / 2.0},
+                                     {m_tagSize / 2.0, m_tagSize / 2.0},
+                                     {-m_tagSize / 2.0, m_tagSize / 2.0}};
+    std::vector<vpPoint> pts(4);
+    for (int j = 0; j < 4; j++) {
+      double X = tagCorners[j][0], Y = tagCorners[j][1];
+      pts[j].setWorldCoordinates(oMt[0][0] * X + oMt[0][1] * Y + oMt[0][3], oMt[1][0] * X + oMt[1][1] * Y + oMt[1][3],
+                                 oMt[2][0] * X + oMt[2][1] * Y + oMt[2][3]);
+
+      double x = 0.0, y = 0.0;
+      vpPixelMeterConversion::convertPoint(m_cam, vpImagePoint(det->p[j][1], det->p[j][0]), x, y);
+      pts[j].set_x(x);
+      pts[j].set_y(y);
+    }
+
+    pose.addPoints(pts);
+  }
+
+  // Pose of a single tag
+  void computeTagPose(apriltag_detection_t *det, vpHomogeneousMatrix &cMo) const
+  {
+    cMo.eye();
+    if (m_poseEstimationMethod == HOMOGRAPHY || m_poseEstimationMethod == HOMOGRAPHY_VIRTUAL_VS
+        || m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
+      double fx = m_cam.get_px(), fy = m_cam.get_py();
+      double cx = m_cam.get_u0(), cy = m_cam.get_v0();
 
-          matd_destroy(M);
+      matd_t *M = homography_to_pose(det->H, fx, fy, cx, cy, m_tagSize / 2);
+
+      for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+          cMo[i][j] = MATD_EL(M, i, j);
         }
+        cMo[i][3] = MATD_EL(M, i, 3);
+      }
+
+      matd_destroy(M);
+    }
+
+    // Add marker object points
+    vpPose pose;
+    if (m_poseEstimationMethod != HOMOGRAPHY) {
+      addTagCorners(pose, det, vpHomogeneousMatrix());
+    }
 
-        // Add marker object points
-        vpPose pose;
-        if (m_poseEstimationMethod != HOMOGRAPHY) {
-          vpPoint pt;
-
-          vpImagePoint imPt;
-          double x = 0.0, y = 0.0;
-          std::vector<vpPoint> pts(4);
-          pt.setWorldCoordinates(-m_tagSize / 2.0, -m_tagSize / 2.0, 0.0);
-          imPt.set_uv(det->p[0][0], det->p[0][1]);
-          vpPixelMeterConversion::convertPoint(m_cam, imPt, x, y);
-          pt.set_x(x);
-          pt.set_y(y);
-          pts[0] = pt;
-
-          pt.setWorldCoordinates(m_tagSize / 2.0, -m_tagSize / 2.0, 0.0);
-          imPt.set_uv(det->p[1][0], det->p[1][1]);
-          vpPixelMeterConversion::convertPoint(m_cam, imPt, x, y);
-          pt.set_x(x);
-          pt.set_y(y);
-          pts[1] = pt;
-
-          pt.setWorldCoordinates(m_tagSize / 2.0, m_tagSize / 2.0, 0.0);
-          imPt.set_uv(det->p[2][0], det->p[2][1]);
-          vpPixelMeterConversion::convertPoint(m_cam, imPt, x, y);
-          pt.set_x(x);
-          pt.set_y(y);
-          pts[2] = pt;
-
-          pt.setWorldCoordinates(-m_tagSize / 2.0, m_tagSize / 2.0, 0.0);
-          imPt.set_uv(det->p[3][0], det->p[3][1]);
-          vpPixelMeterConversion::convertPoint(m_cam, imPt, x, y);
-          pt.set_x(x);
-          pt.set_y(y);
-          pts[3] = pt;
-
-          pose.addPoints(pts);
+    if (m_poseEstimationMethod != HOMOGRAPHY && m_poseEstimationMethod != HOMOGRAPHY_VIRTUAL_VS) {
+      if (m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
+        vpHomogeneousMatrix cMo_dementhon, cMo_lagrange, cMo_homography = cMo;
+
+        double residual_dementhon = std::numeric_limits<double>::max(),
+               residual_lagrange = std::numeric_limits<double>::max();
+        double residual_homography = pose.computeResidual(cMo_homography);
+
+        if (pose.computePose(vpPose::DEMENTHON, cMo_dementhon)) {
+          residual_dementhon = pose.computeResidual(cMo_dementhon);
+        }
+
+        if (pose.computePose(vpPose::LAGRANGE, cMo_lagrange)) {
+          residual_lagrange = pose.computeResidual(cMo_lagrange);
         }
 
-        if (m_poseEstimationMethod != HOMOGRAPHY && m_poseEstimationMethod != HOMOGRAPHY_VIRTUAL_VS) {
-          if (m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
-            vpHomogeneousMatrix cMo_dementhon, cMo_lagrange, cMo_homography = cMo;
-
-            double residual_dementhon = std::numeric_limits<double>::max(),
-                   residual_lagrange = std::numeric_limits<double>::max();
-            double residual_homography = pose.computeResidual(cMo_homography);
-
-            if (pose.computePose(vpPose::DEMENTHON, cMo_dementhon)) {
-              residual_dementhon = pose.computeResidual(cMo_dementhon);
-            }
-
-            if (pose.computePose(vpPose::LAGRANGE, cMo_lagrange)) {
-              residual_lagrange = pose.computeResidual(cMo_lagrange);
-            }
-
-            if (residual_dementhon < residual_lagrange) {
-              if (residual_dementhon < residual_homography) {
-                cMo = cMo_dementhon;
-              } else {
-                cMo = cMo_homography;
-              }
-            } else if (residual_lagrange < residual_homography) {
-              cMo = cMo_lagrange;
-            } else {
-              //              cMo = cMo_homography; //already the case
-            }
+        if (residual_dementhon < residual_lagrange) {
+          if (residual_dementhon < residual_homography) {
+            cMo = cMo_dementhon;
           } else {
-            pose.computePose(m_mapOfCorrespondingPoseMethods[m_poseEstimationMethod], cMo);
+            cMo = cMo_homography;
           }
+        } else if (residual_lagrange < residual_homography) {
+          cMo = cMo_lagrange;
+        } else {
+          //              cMo = cMo_homography; //already the case
         }
+      } else {
+        pose.computePose(m_mapOfCorrespondingPoseMethods.find(m_poseEstimationMethod)->second, cMo);
+      }
+    }
+
+    if (m_poseEstimationMethod != HOMOGRAPHY) {
+      // Compute final pose using VVS
+      pose.computePose(vpPose::VIRTUAL_VS, cMo);
+    }
+  }
+
+  // Pose of all the detected tags. The tags are independent and are
+  // processed in parallel if enabled.
+  void computeTagPoses(zarray_t *detections)
+  {
+    int nb_detections = zarray_size(detections);
+    std::vector<apriltag_detection_t *> dets((size_t)nb_detections);
+    for (int i = 0; i < nb_detections; i++) {
+      zarray_get(detections, i, &dets[(size_t)i]);
+    }
+    m_tagPoses.resize((size_t)nb_detections);
 
-        if (m_poseEstimationMethod != HOMOGRAPHY) {
-          // Compute final pose using VVS
-          pose.computePose(vpPose::VIRTUAL_VS, cMo);
+    int nbThreads = 1;
+#if defined(VISP_HAVE_OPENMP)
+    if (m_useParallelPose && nb_detections > 1 && !omp_in_parallel()) {
+      nbThreads = std::min(m_nbParallelPoseThreads > 0 ? m_nbParallelPoseThreads : omp_get_max_threads(),
+                           nb_detections);
+    }
+#endif
+
+    if (nbThreads > 1) {
+#if defined(VISP_HAVE_OPENMP)
+      // The exception raised by the first tag (in the detection order) is
+      // thrown again after the loop
+      vpParallelTaskException exception("Unknown exception in parallel pose estimation");
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbThreads)
+      for (int i = 0; i < nb_detections; i++) {
+        try {
+          computeTagPose(dets[(size_t)i], m_tagPoses[(size_t)i]);
+        } catch (...) {
+          exception.capture(i);
         }
+      }
+      exception.rethrow();
+#endif
+    } else {
+      for (size_t i = 0; i < dets.size(); i++) {
+        computeTagPose(dets[i], m_tagPoses[i]);
+      }
+    }
+  }
+
+  // Joint pose of the tags of the bundle, initialized by the tag pose that
+  // best fits all the corners. The poses of these tags are then given by
+  // the bundle pose.
+  void computeBundlePose(zarray_t *detections)
+  {
+    vpPose pose;
+    std::vector<size_t> bundleTags;
+    std::vector<vpHomogeneousMatrix> bMt;
+    for (int i = 0; i < zarray_size(detections); i++) {
+      apriltag_detection_t *det;
+      zarray_get(detections, i, &det);
+      std::map<int, vpHomogeneousMatrix>::const_iterator it = m_bundle.find(det->id);
+      if (it != m_bundle.end()) {
+        addTagCorners(pose, det, it->second);
+        bundleTags.push_back((size_t)i);
+        bMt.push_back(it->second);
+      }
+    }
+
+    if (bundleTags.empty()) {
+      return;
+    }
 
-        m_tagPoses.push_back(cMo);
+    double minResidual = std::numeric_limits<double>::max();
+    for (size_t k = 0; k < bundleTags.size(); k++) {
+      vpHomogeneousMatrix cMb = m_tagPoses[bundleTags[k]] * bMt[k].inverse();
+      double residual = pose.computeResidual(cMb);
+      if (residual < minResidual) {
+        minResidual = residual;
+        m_bundlePose = cMb;
       }
     }
 
-    apriltag_detections_destroy(detections);
+    pose.computePose(vpPose::VIRTUAL_VS, m_bundlePose);
+    m_bundleDetected = true;
 
-    return detected;
+    for (size_t k = 0; k < bundleTags.size(); k++) {
+      m_tagPoses[bundleTags[k]] = m_bundlePose * bMt[k];
+    }
+  }
+
+  // Detect the tags in the regions of interest predicted from the previous
+  // detections. The sub-images share the memory of I thanks to the stride.
+  zarray_t *detectInRois(const vpImage<unsigned char> &I)
+  {
+    zarray_t *detections = zarray_create(sizeof(apriltag_detection_t *));
+
+    for (size_t k = 0; k < m_rois.size(); k++) {
+      int left = (int)m_rois[k].getLeft(), top = (int)m_rois[k].getTop();
+      image_u8_t im = {/*.width =*/(int32_t)m_rois[k].getWidth(),
+                       /*.height =*/(int32_t)m_rois[k].getHeight(),
+                       /*.stride =*/(int32_t)I.getWidth(),
+                       /*.buf =*/I.bitmap + (size_t)top * I.getWidth() + (size_t)left};
+
+      zarray_t *roiDetections = apriltag_detector_detect(m_td, &im);
+      for (int i = 0; i < zarray_size(roiDetections); i++) {
+        apriltag_detection_t *det;
+        zarray_get(roiDetections, i, &det);
+
+        // From the region of interest to the image frame
+        det->c[0] += left;
+        det->c[1] += top;
+        for (int j = 0; j < 4; j++) {
+          det->p[j][0] += left;
+          det->p[j][1] += top;
+        }
+        for (int j = 0; j < 3; j++) {
+          MATD_EL(det->H, 0, j) += left * MATD_EL(det->H, 2, j);
+          MATD_EL(det->H, 1, j) += top * MATD_EL(det->H, 2, j);
+        }
+
+        zarray_add(detections, &det);
+      }
+      // The detections are now owned by the merged array
+      zarray_destroy(roiDetections);
+    }
+
+    return detections;
   }
 
+  // Predict the regions of interest of the next frame with a constant
+  // velocity model of the tag centers
+  void updateRois(zarray_t *detections)
+  {
+    std::vector<int> ids((size_t)zarray_size(detections));
+    std::vector<vpImagePoint> centers(ids.size());
+    std::vector<vpRect> rois;
+
+    for (int i = 0; i < zarray_size(detections); i++) {
+      apriltag_detection_t *det;
+      zarray_get(detections, i, &det);
+      ids[i] = det->id;
+      centers[i].set_uv(det->c[0], det->c[1]);
+
+      double uMin = det->p[0][0], uMax = uMin, vMin = det->p[0][1], vMax = vMin;
+      for (int j = 1; j < 4; j++) {
+        uMin = std::min(uMin, det->p[j][0]);
+        uMax = std::max(uMax, det->p[j][0]);
+        vMin = std::min(vMin, det->p[j][1]);
+        vMax = std::max(vMax, det->p[j][1]);
+      }
+
+      // Displacement since the previous frame of the closest tag with the same id
+      double du = 0, dv = 0, minDist = std::numeric_limits<double>::max();
+      for (size_t k = 0; k < m_trackedIds.size(); k++) {
+        if (m_trackedIds[k] == det->id) {
+          double dist = vpImagePoint::sqrDistance(centers[i], m_trackedCenters[k]);
+          if (dist < minDist) {
+            minDist = dist;
+            du = centers[i].get_u() - m_trackedCenters[k].get_u();
+            dv = centers[i].get_v() - m_trackedCenters[k].get_v();
+          }
+        }
+      }
+
+      double margin = m_roiMargin * std::max(uMax - uMin, vMax - vMin);
+      uMin = std::min(uMin, uMin + du) - margin;
+      uMax = std::max(uMax, uMax + du) + margin;
+      vMin = std::min(vMin, vMin + dv) - margin;
+      vMax = std::max(vMax, vMax + dv) + margin;
+
+      // The adaptive thresholding of AprilTag works on tiles of 4x4 pixels of
+      // the decimated image. Aligning the regions of interest on these tiles
+      // gives the same detections as in the whole image.
+      int tileSize = (int)std::ceil(4 * std::max(1.0f, m_td->quad_decimate));
+      int left = std::max(0, (int)uMin / tileSize * tileSize), top = std::max(0, (int)vMin / tileSize * tileSize);
+      int right = std::min((int)m_imageWidth, (int)uMax + 1), bottom = std::min((int)m_imageHeight, (int)vMax + 1);
+      if (right > left && bottom > top) {
+        rois.push_back(vpRect(left, top, right - left, bottom - top));
+      }
+    }
+
+    // Merge the overlapping regions so that a tag is searched only once
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      for (size_t i = 0; i < rois.size() && !merged; i++) {
+        for (size_t j = i + 1; j < rois.size() && !merged; j++) {
+          if (rois[i].getLeft() < rois[j].getLeft() + rois[j].getWidth() &&
+              rois[j].getLeft() < rois[i].getLeft() + rois[i].getWidth() &&
+              rois[i].getTop() < rois[j].getTop() + rois[j].getHeight() &&
+              rois[j].getTop() < rois[i].getTop() + rois[i].getHeight()) {
+            double left = std::min(rois[i].getLeft(), rois[j].getLeft());
+            double top = std::min(rois[i].getTop(), rois[j].getTop());
+            double right = std::max(rois[i].getLeft() + rois[i].getWidth(), rois[j].getLeft() + rois[j].getWidth());
+            double bottom = std::max(rois[i].getTop() + rois[i].getHeight(), rois[j].getTop() + rois[j].getHeight());
+            rois[i].setRect(left, top, right - left, bottom - top);
+            rois.erase(rois.begin() + (std::ptrdiff_t)j);
+            merged = true;
+          }
+        }
+      }
+    }
+
+    m_rois.swap(rois);
+    m_trackedIds.swap(ids);
+    m_trackedCenters.swap(centers);
+  }
+
+  bool getBundlePose(vpHomogeneousMatrix &cMb) const
+  {
+    if (m_bundleDetected) {
+      cMb = m_bundlePose;
+    }
+    return m_bundleDetected;
+  }
+
+  double getDetectionTime() const { return m_detectionTime; }
+
+  double getPoseTime() const { return m_poseTime; }
+
   void getTagPoses(std::vector<vpHomogeneousMatrix> &tagPoses) const { tagPoses = m_tagPoses; }
 
+  void setTagBundle(const std::map<int, vpHomogeneousMatrix> &bundle) { m_bundle = bundle; }
+
+  void setNbParallelPoseThreads(const int nb) { m_nbParallelPoseThreads = nb; }
+
+  void setUseParallelPose(const bool use) { m_useParallelPose = use; }
+
+  void setIncrementalDetection(const bool enable, const unsigned int fullDetectionPeriod, const double roiMargin)
+  {
+    m_incrementalDetection = enable;
+    m_fullDetectionPeriod = fullDetectionPeriod;
+    m_roiMargin = roiMargin;
+    m_rois.clear();
+    m_trackedIds.clear();
+    m_trackedCenters.clear();
+  }
+
   void setCameraParameters(const vpCameraParameters &cam) { m_cam = cam; }
 
   void setNbThreads(const int nThreads) { m_td->nthreads = nThreads; }
@@ -311,6 +578,22 @@ protected:
   double m_tagSize;
   apriltag_detector_t *m_td;
   apriltag_family_t *m_tf;
+  bool m_incrementalDetection;
+  unsigned int m_fullDetectionPeriod;
+  double m_roiMargin;
+  unsigned int m_nbFramesSinceFullDetection;
+  unsigned int m_imageWidth;
+  unsigned int m_imageHeight;
+  std::vector<vpRect> m_rois;
+  std::vector<int> m_trackedIds;
+  std::vector<vpImagePoint> m_trackedCenters;
+  std::map<int, vpHomogeneousMatrix> m_bundle;
+  bool m_bundleDetected;
+  vpHomogeneousMatrix m_bundlePose;
+  bool m_useParallelPose;
+  int m_nbParallelPoseThreads;
+  double m_detectionTime;
+  double m_poseTime;
 };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -375,6 +658,105 @@ bool vpDetectorAprilTag::detect(const vpImage<unsigned char> &I, const double ta
   return detected;
 }
 
+/*!
+  Get the pose of the tag bundle estimated by the last call to
+  detect(const vpImage<unsigned char> &, const double, const
+  vpCameraParameters &, std::vector<vpHomogeneousMatrix> &).
+
+  \param cMb : Pose of the bundle frame in the camera frame. Not modified if
+  no tag of the bundle was detected.
+  \return true if at least one tag of the bundle was detected.
+
+  \sa setTagBundle()
+*/
+bool vpDetectorAprilTag::getBundlePose(vpHomogeneousMatrix &cMb) const { return m_impl->getBundlePose(cMb); }
+
+/*!
+  Get the time spent by the last call to detect() to detect the tags
+  in the image, in ms.
+
+  \sa getPoseTime()
+*/
+double vpDetectorAprilTag::getDetectionTime() const { return m_impl->getDetectionTime(); }
+
+/*!
+  Get the time spent by the last call to detect(const vpImage<unsigned
+  char> &, const double, const vpCameraParameters &,
+  std::vector<vpHomogeneousMatrix> &) to estimate the tag poses, including the
+  bundle pose, in ms. 0 if the poses were not estimated.
+
+  \sa getDetectionTime()
+*/
+double vpDetectorAprilTag::getPoseTime() const { return m_impl->getPoseTime(); }
+
+/*!
+  Set the number of threads used to estimate the tag poses when
+  setUseParallelPose() is enabled. 0 (default) means that the number of
+  threads is determined by OpenMP.
+
+  \param nb : Number of threads.
+*/
+void vpDetectorAprilTag::setNbParallelPoseThreads(const int nb) { m_impl->setNbParallelPoseThreads(nb); }
+
+/*!
+  Set the layout of a bundle of tags, for instance a calibration board, that
+  share a rigid transformation.
+
+  When the tag poses are estimated, all the corners of the detected tags of
+  the bundle are used to estimate the pose of the bundle with a non linear
+  virtual visual servoing, initialized by the tag pose that gives the lowest
+  residual over all these corners. The poses of these tags are then deduced
+  from the bundle pose, which is more accurate than the pose of an isolated
+  tag. The tags that are not in the bundle are not modified.
+
+  All the tags must have the size given to detect(const vpImage<unsigned
+  char> &, const double, const vpCameraParameters &,
+  std::vector<vpHomogeneousMatrix> &).
+
+  \param bMt : Pose of each tag in the bundle frame, indexed by the tag
+  id. An empty map disables the bundle pose estimation.
+
+  \sa getBundlePose()
+*/
+void vpDetectorAprilTag::setTagBundle(const std::map<int, vpHomogeneousMatrix> &bMt) { m_impl->setTagBundle(bMt); }
+
+/*!
+  Enable the parallel estimation of the tag poses with OpenMP. The poses do
+  not depend on the number of threads since each tag is processed
+  independently.
+
+  \param use : If true, the poses of the tags are estimated in parallel.
+
+  \sa setNbParallelPoseThreads()
+*/
+void vpDetectorAprilTag::setUseParallelPose(const bool use) { m_impl->setUseParallelPose(use); }
+
+/*!
+  Enable or disable the incremental detection mode, useful to track tags in
+  a video stream at a high frame rate.
+
+  In this mode, the tags are searched only in regions of interest predicted
+  from the tags detected in the previous frame, assuming a constant velocity
+  of the tag centers in the image. Every \e fullDetectionPeriod frames, or
+  when no tag is found in the regions of interest, the whole image is
+  processed to detect the tags that have just appeared.
+
+  Since the regions of interest share the memory of the input image, and
+  the AprilTag detector with its pool of threads is kept between two calls,
+  there is no copy of the image in this mode.
+
+  \param enable : If true, enable the incremental detection mode.
+  \param fullDetectionPeriod : Number of frames between two detections in
+  the whole image. 1 corresponds to a full-frame detection in every frame.
+  \param roiMargin : Margin added around a tag to build its region of
+  interest, as a ratio of the tag size in the image.
+*/
+void vpDetectorAprilTag::setIncrementalDetection(const bool enable, const unsigned int fullDetectionPeriod,
+                                                 const double roiMargin)
+{
+  m_impl->setIncrementalDetection(enable, fullDetectionPeriod, roiMargin);
+}
+
 /*!
   Set the number of threads for April Tag detection (default is 1).
 
@@ -402,6 +402,53 @@ int main(int argc, const char *argv[])
       }
     }
 
+    // The poses estimated in parallel must be the same
+    vpDetectorAprilTag parallelDetector(tagFamily, poseEstimationMethod);
+    parallelDetector.setAprilTagQuadDecimate(quad_decimate);
+    parallelDetector.setUseParallelPose(true);
+    std::vector<vpHomogeneousMatrix> cMo_vec_parallel;
+    parallelDetector.detect(I, tagSize, cam, cMo_vec_parallel);
+    if (cMo_vec_parallel.size() != cMo_vec.size()) {
+      std::cerr << "Problem with parallel pose estimation: " << cMo_vec_parallel.size() << " poses instead of "
+                << cMo_vec.size() << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < cMo_vec.size(); i++) {
+      for (unsigned int j = 0; j < 16; j++) {
+        if (!vpMath::equal(cMo_vec_parallel[i].data[j], cMo_vec[i].data[j], 1e-9)) {
+          std::cerr << "Problem with parallel pose estimation:\n" << cMo_vec_parallel[i] << "\ninstead of:\n"
+                    << cMo_vec[i] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // The incremental detection mode must find the same tags in the whole
+    // image (first frame) and in the regions of interest (second frame)
+    vpDetectorAprilTag incrementalDetector(tagFamily);
+    incrementalDetector.setAprilTagQuadDecimate(quad_decimate);
+    incrementalDetector.setIncrementalDetection(true);
+    for (int frame = 0; frame < 2; frame++) {
+      incrementalDetector.detect(I);
+      if (incrementalDetector.getNbObjects() != detector->getNbObjects()) {
+        std::cerr << "Problem with incremental detection: " << incrementalDetector.getNbObjects()
+                  << " tags instead of " << detector->getNbObjects() << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      for (size_t i = 0; i < incrementalDetector.getNbObjects(); i++) {
+        TagGroundTruth current(incrementalDetector.getMessage(i), incrementalDetector.getPolygon(i));
+        bool found = false;
+        for (size_t j = 0; j < detector->getNbObjects() && !found; j++) {
+          found = (current == TagGroundTruth(detector->getMessage(j), detector->getPolygon(j)));
+        }
+        if (!found) {
+          std::cerr << "Problem with incremental detection:\n" << current << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
     if (opt_display) {
       vpDisplay::displayText(I, 20, 20, "Click to quit.", vpColor::red);
       vpDisplay::flush(I);
@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the pose estimation of a bundle of AprilTags.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testAprilTagBundle.cpp
+
+  \brief Test the pose of a bundle of AprilTags on a synthetic image where
+  the tags are rendered with a known layout and a known camera pose.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <stdint.h>
+
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/detection/vpDetectorAprilTag.h>
+
+#if defined(VISP_HAVE_APRILTAG)
+
+namespace
+{
+// Codes of the first tags of the 36h11 family
+const uint64_t tag36h11Codes[] = {0x0000000d5d628584ULL, 0x0000000d97f18b49ULL, 0x0000000dd280910eULL,
+                                  0x0000000e479e9c98ULL, 0x0000000ebcbca822ULL};
+const int tagDim = 6;
+
+/*
+  Intensity of a point of the plane z=0 of a tag frame: the tag has tagDim x
+  tagDim data bits surrounded by a black border and a white border, one bit
+  wide each. The black border is tagSize wide. The y axis of the tag frame
+  goes from the bottom to the top of the tag.
+*/
+bool tagIntensity(uint64_t code, double tagSize, double X, double Y, unsigned char &intensity)
+{
+  const double bitSize = tagSize / (tagDim + 2);
+  const int x = (int)std::floor(X / bitSize + tagDim / 2 + 2);
+  const int y = (int)std::floor(-Y / bitSize + tagDim / 2 + 2);
+  if (x < 0 || y < 0 || x >= tagDim + 4 || y >= tagDim + 4) {
+    return false;
+  }
+
+  if (x == 0 || y == 0 || x == tagDim + 3 || y == tagDim + 3) {
+    intensity = 255;
+  } else if (x == 1 || y == 1 || x == tagDim + 2 || y == tagDim + 2) {
+    intensity = 0;
+  } else {
+    const int pos = (tagDim - 1 - (y - 2)) * tagDim + (tagDim - 1 - (x - 2));
+    intensity = ((code >> pos) & 0x1) ? 255 : 0;
+  }
+  return true;
+}
+
+/*
+  Render the tags lying on the plane z=0 of the bundle frame, with 4x4 samples
+  per pixel.
+*/
+void renderBundle(vpImage<unsigned char> &I, const vpCameraParameters &cam, const vpHomogeneousMatrix &cMb,
+                  const std::map<int, vpHomogeneousMatrix> &bMt, double tagSize)
+{
+  const vpHomogeneousMatrix bMc = cMb.inverse();
+  const int nbSamples = 4;
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      unsigned int sum = 0;
+      for (int si = 0; si < nbSamples; si++) {
+        for (int sj = 0; sj < nbSamples; sj++) {
+          double x = 0.0, y = 0.0;
+          vpPixelMeterConversion::convertPoint(cam, j + (sj + 0.5) / nbSamples - 0.5,
+                                               i + (si + 0.5) / nbSamples - 0.5, x, y);
+
+          // Intersection of the ray with the plane of the bundle
+          double dir[3];
+          for (unsigned int k = 0; k < 3; k++) {
+            dir[k] = bMc[k][0] * x + bMc[k][1] * y + bMc[k][2];
+          }
+          const double t = -bMc[2][3] / dir[2];
+          const double Xb = bMc[0][3] + t * dir[0], Yb = bMc[1][3] + t * dir[1];
+
+          unsigned char intensity = 128;
+          for (std::map<int, vpHomogeneousMatrix>::const_iterator it = bMt.begin(); it != bMt.end(); ++it) {
+            const vpHomogeneousMatrix &M = it->second;
+            const double dX = Xb - M[0][3], dY = Yb - M[1][3];
+            const double X = M[0][0] * dX + M[1][0] * dY, Y = M[0][1] * dX + M[1][1] * dY;
+            if (tagIntensity(tag36h11Codes[it->first], tagSize, X, Y, intensity)) {
+              break;
+            }
+          }
+          sum += intensity;
+        }
+      }
+      I[i][j] = (unsigned char)((sum + nbSamples * nbSamples / 2) / (nbSamples * nbSamples));
+    }
+  }
+}
+
+bool samePose(const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cMo_truth, double maxTranslation,
+              double maxRotation)
+{
+  const vpHomogeneousMatrix cdMc = cMo_truth * cMo.inverse();
+  return cdMc.getTranslationVector().euclideanNorm() < maxTranslation &&
+         vpThetaUVector(cdMc.getRotationMatrix()).getTheta() < maxRotation;
+}
+}
+
+int main()
+{
+  try {
+    const double tagSize = 0.04;
+    vpCameraParameters cam(600, 600, 320, 240);
+    vpImage<unsigned char> I(480, 640);
+
+    // Four tags of a calibration board, one of them rotated of 90 deg, and a
+    // tag of the same plane which is not part of the bundle
+    std::map<int, vpHomogeneousMatrix> layout;
+    layout[0] = vpHomogeneousMatrix(-0.04, -0.04, 0, 0, 0, 0);
+    layout[1] = vpHomogeneousMatrix(0.04, -0.04, 0, 0, 0, 0);
+    layout[2] = vpHomogeneousMatrix(-0.04, 0.04, 0, 0, 0, M_PI / 2);
+    layout[3] = vpHomogeneousMatrix(0.04, 0.04, 0, 0, 0, 0);
+    layout[4] = vpHomogeneousMatrix(0.13, 0, 0, 0, 0, 0);
+    std::map<int, vpHomogeneousMatrix> bundle = layout;
+    bundle.erase(4);
+
+    // The z axis of the bundle frame goes out of the tags, towards the camera
+    const vpHomogeneousMatrix cMb = vpHomogeneousMatrix(-0.03, 0.01, 0.45, vpMath::rad(20), vpMath::rad(-15),
+                                                        vpMath::rad(10)) *
+                                    vpHomogeneousMatrix(0, 0, 0, M_PI, 0, 0);
+    renderBundle(I, cam, cMb, layout, tagSize);
+
+    for (int parallel = 0; parallel < 2; parallel++) {
+      vpDetectorAprilTag detector(vpDetectorAprilTag::TAG_36h11);
+      detector.setTagBundle(bundle);
+      detector.setUseParallelPose(parallel == 1);
+
+      std::vector<vpHomogeneousMatrix> cMo_vec;
+      detector.detect(I, tagSize, cam, cMo_vec);
+      if (detector.getNbObjects() != layout.size()) {
+        std::cerr << "Problem with tag detection: " << detector.getNbObjects() << " tags instead of " << layout.size()
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpHomogeneousMatrix cMb_est;
+      if (!detector.getBundlePose(cMb_est)) {
+        std::cerr << "The bundle is not detected" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!samePose(cMb_est, cMb, 0.001, vpMath::rad(0.5))) {
+        std::cerr << "Problem, bundle pose:\n" << cMb_est << "\nGround truth:\n" << cMb << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // The tags of the bundle are given by the bundle pose, the other ones
+      // by their own pose
+      for (size_t i = 0; i < detector.getNbObjects(); i++) {
+        const int id = atoi(detector.getMessage(i).substr(std::string("36h11 id: ").size()).c_str());
+        const vpHomogeneousMatrix cMt = cMb * layout[id];
+        const bool inBundle = bundle.find(id) != bundle.end();
+        if ((inBundle && !samePose(cMo_vec[i], cMb_est * bundle[id], 1e-9, 1e-9)) ||
+            !samePose(cMo_vec[i], cMt, inBundle ? 0.001 : 0.005, vpMath::rad(inBundle ? 0.5 : 3))) {
+          std::cerr << "Problem, pose of the tag " << id << ":\n" << cMo_vec[i] << "\nGround truth:\n" << cMt
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Without bundle, the bundle pose is not available
+    vpDetectorAprilTag detector(vpDetectorAprilTag::TAG_36h11);
+    std::vector<vpHomogeneousMatrix> cMo_vec;
+    detector.detect(I, tagSize, cam, cMo_vec);
+    vpHomogeneousMatrix cMb_est;
+    if (detector.getBundlePose(cMb_est)) {
+      std::cerr << "A bundle is detected without bundle layout" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testAprilTagBundle is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cout << "Need ViSP AprilTag." << std::endl;
+  return 0;
+}
+#endif
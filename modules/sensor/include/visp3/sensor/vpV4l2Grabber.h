@@ -59,6 +59,8 @@
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpRect.h>
 
+#include <vector>
+
 /*!
   \class vpV4l2Grabber
 
@@ -127,6 +129,16 @@ int main()
 }
   \endcode
 
+  For visual servoing or tracking loops that work on a Gaussian pyramid,
+  acquire(std::vector<vpImage<unsigned char> > &, unsigned int) converts the
+  driver buffer and builds the pyramid in a single pass over bands of rows,
+  while the data are still in cache. The ring buffer is handed back to the
+  driver as soon as it has been read, without any intermediate copy, and the
+  pyramid levels are reused from one frame to the other.
+  \code
+  std::vector<vpImage<unsigned char> > pyramid;
+  g.acquire(pyramid, 3); // pyramid[0] is the full resolution grey image
+  \endcode
 
   \author Fabien Spindler (Fabien.Spindler@irisa.fr), Irisa / Inria Rennes
 
@@ -229,6 +241,10 @@ public:
   void acquire(vpImage<vpRGBa> &I);
   void acquire(vpImage<vpRGBa> &I, const vpRect &roi);
   void acquire(vpImage<vpRGBa> &I, struct timeval &timestamp, const vpRect &roi = vpRect());
+  void acquire(std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels);
+  void acquire(std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels, struct timeval &timestamp);
+  void acquire(vpImage<vpRGBa> &I, std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels,
+               struct timeval &timestamp);
   bool getField();
   vpV4l2FramerateType getFramerate();
   /*!
@@ -320,6 +336,10 @@ private:
   int queueBuffer();
   void queueAll();
   void printBufInfo(struct v4l2_buffer buf);
+  void acquirePyramid(vpImage<vpRGBa> *I, std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels,
+                      struct timeval &timestamp);
+  void convertRows(const unsigned char *bitmap, unsigned int first_row, unsigned int nb_rows, vpImage<vpRGBa> *I,
+                   vpImage<unsigned char> &Igrey);
 
   int fd;
   char device[FILENAME_MAX];
@@ -350,6 +370,7 @@ private:
   vpV4l2FramerateType m_framerate;
   vpV4l2FrameFormatType m_frameformat;
   vpV4l2PixelFormatType m_pixelformat;
+  std::vector<vpImage<unsigned char> > m_pyramidX; //!< Horizontally filtered pyramid levels, reused between frames
 };
 
 #endif
@@ -46,6 +46,7 @@
 
 #ifdef VISP_HAVE_V4L2
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <iostream>
@@ -74,6 +75,59 @@ const unsigned int vpV4l2Grabber::MAX_BUFFERS = 32;
 const unsigned int vpV4l2Grabber::FRAME_SIZE = 288;
 #define vpCLEAR(x) memset(&(x), 0, sizeof(x))
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of rows converted at once when acquiring a pyramid, small enough to remain in cache
+const unsigned int nbRowsPerBand = 16;
+
+/*
+  Compute the rows of the half resolution image GI that only depend on the
+  first nb_rows rows of I, GIx being the horizontally filtered image. The
+  result is the same than vpImageFilter::getGaussXPyramidal() followed by
+  vpImageFilter::getGaussYPyramidal(). next_row_x and next_row_y are the
+  first rows of GIx and GI that remain to be computed.
+*/
+void pyramidDown(const vpImage<unsigned char> &I, const unsigned int nb_rows, vpImage<unsigned char> &GIx,
+                 vpImage<unsigned char> &GI, unsigned int &next_row_x, unsigned int &next_row_y)
+{
+  const unsigned int w = GI.getWidth(), h = GI.getHeight();
+
+  for (; next_row_x < nb_rows; next_row_x++) {
+    const unsigned char *src = I[next_row_x];
+    unsigned char *dst = GIx[next_row_x];
+    dst[0] = src[0];
+    for (unsigned int j = 1; j < w - 1; j++) {
+      const unsigned char *s = src + 2 * j;
+      dst[j] = (unsigned char)((s[-2] + 4 * s[-1] + 6 * s[0] + 4 * s[1] + s[2]) >> 4);
+    }
+    dst[w - 1] = src[2 * w - 1];
+  }
+
+  for (; next_row_y < h; next_row_y++) {
+    const unsigned int i = next_row_y;
+    if (i == 0 || i == h - 1) {
+      const unsigned int row = (i == 0) ? 0 : 2 * h - 1;
+      if (row >= next_row_x) {
+        break;
+      }
+      memcpy(GI[i], GIx[row], w);
+    } else {
+      if (2 * i + 2 >= next_row_x) {
+        break;
+      }
+      const unsigned char *s0 = GIx[2 * i - 2], *s1 = GIx[2 * i - 1], *s2 = GIx[2 * i], *s3 = GIx[2 * i + 1],
+                          *s4 = GIx[2 * i + 2];
+      unsigned char *dst = GI[i];
+      for (unsigned int j = 0; j < w; j++) {
+        dst[j] = (unsigned char)((s0[j] + 4 * s1[j] + 6 * s2[j] + 4 * s3[j] + s4[j]) >> 4);
+      }
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Default constructor.
 
@@ -150,7 +204,8 @@ vpV4l2Grabber::vpV4l2Grabber()
   : fd(-1), device(), cap(), streamparm(), inp(NULL), std(NULL), fmt(NULL), ctl(NULL), fmt_v4l2(), fmt_me(), reqbufs(),
     buf_v4l2(NULL), buf_me(NULL), queue(0), waiton_cpt(0), index_buffer(0), m_verbose(false), m_nbuffers(3), field(0),
     streaming(false), m_input(vpV4l2Grabber::DEFAULT_INPUT), m_framerate(vpV4l2Grabber::framerate_25fps),
-    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT)
+    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT),
+    m_pyramidX()
 {
   setDevice("/dev/video0");
   setNBuffers(3);
@@ -206,7 +261,8 @@ vpV4l2Grabber::vpV4l2Grabber(bool verbose)
   : fd(-1), device(), cap(), streamparm(), inp(NULL), std(NULL), fmt(NULL), ctl(NULL), fmt_v4l2(), fmt_me(), reqbufs(),
     buf_v4l2(NULL), buf_me(NULL), queue(0), waiton_cpt(0), index_buffer(0), m_verbose(verbose), m_nbuffers(3), field(0),
     streaming(false), m_input(vpV4l2Grabber::DEFAULT_INPUT), m_framerate(vpV4l2Grabber::framerate_25fps),
-    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT)
+    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT),
+    m_pyramidX()
 {
   setDevice("/dev/video0");
   setNBuffers(3);
@@ -252,7 +308,8 @@ vpV4l2Grabber::vpV4l2Grabber(unsigned input, unsigned scale)
   : fd(-1), device(), cap(), streamparm(), inp(NULL), std(NULL), fmt(NULL), ctl(NULL), fmt_v4l2(), fmt_me(), reqbufs(),
     buf_v4l2(NULL), buf_me(NULL), queue(0), waiton_cpt(0), index_buffer(0), m_verbose(false), m_nbuffers(3), field(0),
     streaming(false), m_input(vpV4l2Grabber::DEFAULT_INPUT), m_framerate(vpV4l2Grabber::framerate_25fps),
-    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT)
+    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT),
+    m_pyramidX()
 {
   setDevice("/dev/video0");
   setNBuffers(3);
@@ -298,7 +355,8 @@ vpV4l2Grabber::vpV4l2Grabber(vpImage<unsigned char> &I, unsigned input, unsigned
   : fd(-1), device(), cap(), streamparm(), inp(NULL), std(NULL), fmt(NULL), ctl(NULL), fmt_v4l2(), fmt_me(), reqbufs(),
     buf_v4l2(NULL), buf_me(NULL), queue(0), waiton_cpt(0), index_buffer(0), m_verbose(false), m_nbuffers(3), field(0),
     streaming(false), m_input(vpV4l2Grabber::DEFAULT_INPUT), m_framerate(vpV4l2Grabber::framerate_25fps),
-    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT)
+    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT),
+    m_pyramidX()
 {
   setDevice("/dev/video0");
   setNBuffers(3);
@@ -347,7 +405,8 @@ vpV4l2Grabber::vpV4l2Grabber(vpImage<vpRGBa> &I, unsigned input, unsigned scale)
   : fd(-1), device(), cap(), streamparm(), inp(NULL), std(NULL), fmt(NULL), ctl(NULL), fmt_v4l2(), fmt_me(), reqbufs(),
     buf_v4l2(NULL), buf_me(NULL), queue(0), waiton_cpt(0), index_buffer(0), m_verbose(false), m_nbuffers(3), field(0),
     streaming(false), m_input(vpV4l2Grabber::DEFAULT_INPUT), m_framerate(vpV4l2Grabber::framerate_25fps),
-    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT)
+    m_frameformat(vpV4l2Grabber::V4L2_FRAME_FORMAT), m_pixelformat(vpV4l2Grabber::V4L2_YUYV_FORMAT),
+    m_pyramidX()
 {
   setDevice("/dev/video0");
   setNBuffers(3);
@@ -772,6 +831,201 @@ void vpV4l2Grabber::acquire(vpImage<vpRGBa> &I, struct timeval &timestamp, const
 
   queueAll();
 }
+
+/*!
+  Acquire a grey level image and build its Gaussian pyramid.
+
+  \param pyramid : Pyramid levels, resized to \e nbLevels. pyramid[0] is the
+  full resolution image and each other level is half the size of the
+  previous one.
+  \param nbLevels : Number of pyramid levels (at least 1).
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized.
+
+  \sa acquire(std::vector<vpImage<unsigned char> > &, unsigned int, struct timeval &)
+*/
+void vpV4l2Grabber::acquire(std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels)
+{
+  struct timeval timestamp;
+
+  acquirePyramid(NULL, pyramid, nbLevels, timestamp);
+}
+
+/*!
+  Acquire a grey level image and build its Gaussian pyramid.
+
+  The conversion of the driver buffer and the construction of all the
+  pyramid levels are done in a single pass over bands of rows, each band
+  being downsampled while it is still in cache. The driver buffer is read in
+  place and handed back to the driver as soon as the last band is converted.
+  The levels are equal to the ones obtained with
+  vpImageFilter::getGaussXPyramidal() followed by
+  vpImageFilter::getGaussYPyramidal(), and their memory is reused from one
+  call to the other when the image size does not change.
+
+  \param pyramid : Pyramid levels, resized to \e nbLevels. pyramid[0] is the
+  full resolution image and each other level is half the size of the
+  previous one.
+  \param nbLevels : Number of pyramid levels (at least 1).
+  \param timestamp : Timeval data structure providing the unix time
+  at which the frame was captured in the ringbuffer.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized.
+  \exception vpException::dimensionError : The image is too small to build
+  \e nbLevels levels.
+*/
+void vpV4l2Grabber::acquire(std::vector<vpImage<unsigned char> > &pyramid, unsigned int nbLevels,
+                            struct timeval &timestamp)
+{
+  acquirePyramid(NULL, pyramid, nbLevels, timestamp);
+}
+
+/*!
+  Acquire a color image together with the Gaussian pyramid of the
+  corresponding grey level image, in a single pass over the driver buffer.
+
+  \param I : Full resolution color image.
+  \param pyramid : Grey level pyramid, see
+  acquire(std::vector<vpImage<unsigned char> > &, unsigned int, struct timeval &).
+  \param nbLevels : Number of pyramid levels (at least 1).
+  \param timestamp : Timeval data structure providing the unix time
+  at which the frame was captured in the ringbuffer.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized.
+  \exception vpException::dimensionError : The image is too small to build
+  \e nbLevels levels.
+*/
+void vpV4l2Grabber::acquire(vpImage<vpRGBa> &I, std::vector<vpImage<unsigned char> > &pyramid,
+                            unsigned int nbLevels, struct timeval &timestamp)
+{
+  acquirePyramid(&I, pyramid, nbLevels, timestamp);
+}
+
+/*!
+  Fused acquisition, conversion and pyramid construction. If \e I is not
+  NULL, the full resolution color image is also converted.
+*/
+void vpV4l2Grabber::acquirePyramid(vpImage<vpRGBa> *I, std::vector<vpImage<unsigned char> > &pyramid,
+                                   unsigned int nbLevels, struct timeval &timestamp)
+{
+  if (nbLevels == 0) {
+    throw(vpException(vpException::badValue, "The pyramid must have at least one level"));
+  }
+
+  pyramid.resize(nbLevels);
+  if (init == false) {
+    if (I != NULL)
+      open(*I);
+    else
+      open(pyramid[0]);
+  }
+
+  if (init == false) {
+    close();
+
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError, "V4l2 frame grabber not initialized"));
+  }
+
+  // Check the size before dequeuing a buffer
+  if (nbLevels > 1 && ((height >> (nbLevels - 2)) < 4 || (width >> (nbLevels - 2)) < 4)) {
+    throw(vpException(vpException::dimensionError, "Cannot build %d pyramid levels from a %dx%d image", nbLevels,
+                      width, height));
+  }
+
+  if (I != NULL)
+    I->resize(height, width);
+  pyramid[0].resize(height, width);
+  m_pyramidX.resize(nbLevels);
+  for (unsigned int l = 1; l < nbLevels; l++) {
+    m_pyramidX[l].resize(pyramid[l - 1].getHeight(), pyramid[l - 1].getWidth() / 2);
+    pyramid[l].resize(pyramid[l - 1].getHeight() / 2, pyramid[l - 1].getWidth() / 2);
+  }
+
+  std::vector<unsigned int> next_row_x(nbLevels, 0), next_row_y(nbLevels, 0);
+  unsigned char *bitmap = waiton(index_buffer, timestamp);
+
+  for (unsigned int first_row = 0; first_row < height; first_row += nbRowsPerBand) {
+    const unsigned int nb_rows = std::min(nbRowsPerBand, height - first_row);
+    convertRows(bitmap, first_row, nb_rows, I, pyramid[0]);
+
+    // Propagate the new rows through the levels
+    next_row_y[0] = first_row + nb_rows;
+    for (unsigned int l = 1; l < nbLevels; l++) {
+      pyramidDown(pyramid[l - 1], next_row_y[l - 1], m_pyramidX[l], pyramid[l], next_row_x[l], next_row_y[l]);
+    }
+  }
+
+  queueAll();
+}
+
+/*!
+  Convert \e nb_rows rows of the driver buffer starting at \e first_row in
+  the grey level image \e Igrey and, if \e I is not NULL, in the color image.
+*/
+void vpV4l2Grabber::convertRows(const unsigned char *bitmap, unsigned int first_row, unsigned int nb_rows,
+                                vpImage<vpRGBa> *I, vpImage<unsigned char> &Igrey)
+{
+  const unsigned int size = nb_rows * width;
+  const unsigned int offset = first_row * width;
+  unsigned char *src = const_cast<unsigned char *>(bitmap);
+  unsigned char *grey = Igrey[first_row];
+
+  if (I != NULL) {
+    unsigned char *rgba = (unsigned char *)(*I)[first_row];
+    switch (m_pixelformat) {
+    case V4L2_GREY_FORMAT:
+      vpImageConvert::GreyToRGBa(src + offset, rgba, size);
+      break;
+    case V4L2_RGB24_FORMAT:
+      vpImageConvert::RGBToRGBa(src + 3 * offset, rgba, size);
+      break;
+    case V4L2_RGB32_FORMAT: {
+      // The framegrabber acquire aRGB format. We just shift the data
+      // from 1 byte all the data and initialize the last byte
+      const bool last_band = (first_row + nb_rows == height);
+      memcpy(rgba, src + 4 * offset + 1, size * sizeof(vpRGBa) - (last_band ? 1 : 0));
+      if (last_band)
+        (*I)[height - 1][width - 1].A = 0;
+      break;
+    }
+    case V4L2_BGR24_FORMAT:
+      vpImageConvert::BGRToRGBa(src + 3 * offset, rgba, width, nb_rows, false);
+      break;
+    case V4L2_YUYV_FORMAT:
+      vpImageConvert::YUYVToRGBa(src + 2 * offset, rgba, width, nb_rows);
+      break;
+    default:
+      break;
+    }
+  }
+
+  // The grey image is converted from the source, as in acquire(vpImage<unsigned char> &)
+  switch (m_pixelformat) {
+  case V4L2_GREY_FORMAT:
+    memcpy(grey, src + offset, size);
+    break;
+  case V4L2_RGB24_FORMAT:
+    vpImageConvert::RGBToGrey(src + 3 * offset, grey, size);
+    break;
+  case V4L2_RGB32_FORMAT:
+    vpImageConvert::RGBaToGrey(src + 4 * offset, grey, size);
+    break;
+  case V4L2_BGR24_FORMAT:
+    vpImageConvert::BGRToGrey(src + 3 * offset, grey, width, nb_rows, false);
+    break;
+  case V4L2_YUYV_FORMAT:
+    vpImageConvert::YUYVToGrey(src + 2 * offset, grey, size);
+    break;
+  default:
+    if (first_row == 0)
+      std::cout << "V4l2 conversion not handled" << std::endl;
+    break;
+  }
+}
+
 /*!
 
   Return the field (odd or even) corresponding to the last acquired
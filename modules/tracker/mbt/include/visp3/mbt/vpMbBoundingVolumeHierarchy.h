@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy over the polygons of a 3D model.
+ *
+ *****************************************************************************/
+
+#ifndef vpMbBoundingVolumeHierarchy_HH
+#define vpMbBoundingVolumeHierarchy_HH
+
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbBoundingVolumeHierarchy
+
+  \ingroup group_mbt_faces
+
+  \brief Bounding volume hierarchy (BVH) over the polygons of a 3D model,
+  expressed in the object frame.
+
+  The hierarchy is a binary tree of axis-aligned bounding boxes built once
+  from the polygons of the model. Each node also stores the cone that bounds
+  the normals of its polygons. It allows to answer without testing every
+  polygon:
+  - which polygons may be seen by a camera, culling the sub-trees that are
+    outside the field of view or that only contain polygons facing away from
+    the camera (see queryFrustum());
+  - which polygon is first hit by a ray (see intersectRay()).
+
+  It is used by vpMbHiddenFaces when the BVH visibility test is enabled.
+
+  \code
+  vpMbBoundingVolumeHierarchy bvh;
+  for (size_t i = 0; i < faces.size(); i++)
+    bvh.addPolygon(&faces[i][0], (unsigned int)faces[i].size());
+  bvh.build();
+
+  std::vector<unsigned int> candidates;
+  bvh.queryFrustum(cMo, cam, I.getWidth(), I.getHeight(), candidates, vpMath::rad(90));
+  \endcode
+*/
+class VISP_EXPORT vpMbBoundingVolumeHierarchy
+{
+public:
+  vpMbBoundingVolumeHierarchy();
+
+  void addPolygon(const vpPoint *points, const unsigned int nbpt, const bool oriented = true);
+
+  void build();
+
+  void clear();
+
+  /*!
+    Get the number of nodes of the hierarchy.
+
+    \return Number of nodes, 0 if build() has not been called.
+  */
+  inline unsigned int getNbNodes() const { return (unsigned int)m_nodes.size(); }
+
+  /*!
+    Get the number of polygons added with addPolygon().
+
+    \return Number of polygons.
+  */
+  inline unsigned int getNbPolygons() const { return (unsigned int)m_polygons.size(); }
+
+  bool intersectRay(const double origin[3], const double direction[3], const double maxDistance, double &distance,
+                    unsigned int &index, const int ignoredIndex = -1) const;
+
+  void queryFrustum(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, const unsigned int width,
+                    const unsigned int height, std::vector<unsigned int> &indices, const double angle = M_PI) const;
+
+private:
+  //! Polygon of the hierarchy.
+  struct vpBVHPolygon {
+    unsigned int first_vertex;
+    unsigned int nb_vertices;
+    double bmin[3], bmax[3];
+    double centroid[3];
+    double normal[3];  // Unit normal, only valid if b_plane is true.
+    double d;          // Plane equation: normal . X = d
+    unsigned int axis; // Dominant axis of the normal, dropped for point in polygon tests.
+    bool b_oriented;   // True if the polygon may be culled when facing away from the camera.
+    bool b_plane;      // True if the polygon has a non-zero area and may occlude a ray.
+  };
+
+  //! Node of the hierarchy.
+  struct vpBVHNode {
+    double bmin[3], bmax[3];
+    double axis[3];     // Axis of the cone of the normals.
+    double cone_angle;  // Half-angle of the cone of the normals, M_PI if the node cannot be back-face culled.
+    unsigned int first; // First polygon for a leaf, index of the first of the two children otherwise.
+    unsigned int count; // Number of polygons for a leaf, 0 otherwise.
+  };
+
+  void buildNode(const unsigned int node, const unsigned int begin, const unsigned int end);
+  bool intersectPolygon(const vpBVHPolygon &polygon, const double origin[3], const double direction[3],
+                        double &t) const;
+
+  //! Coordinates of the vertices of all the polygons in the object frame.
+  std::vector<double> m_vertices;
+  //! Polygons, in the order they have been added.
+  std::vector<vpBVHPolygon> m_polygons;
+  //! Indexes of the polygons, sorted such that each leaf refers to a range.
+  std::vector<unsigned int> m_indices;
+  //! Nodes, the root being the first one.
+  std::vector<vpBVHNode> m_nodes;
+};
+
+#endif
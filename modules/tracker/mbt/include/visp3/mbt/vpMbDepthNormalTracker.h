@@ -113,12 +113,15 @@ public:
   virtual void track(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud);
 #endif
   virtual void track(const std::vector<vpColVector> &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpMbtPointCloud &point_cloud);
 
 protected:
   //! Method to estimate the desired features
   vpMbtFaceDepthNormal::vpFeatureEstimationType m_depthNormalFeatureEstimationMethod;
   //! Set of faces describing the object used only for display with scan line.
   vpMbHiddenFaces<vpMbtPolygon> m_depthNormalHiddenFacesDisplay;
+  //! If true, the faces are copied again into the set of faces used for display
+  bool m_depthNormalHiddenFacesDisplayOutdated;
   //! Dummy image used to compute the visibility
   vpImage<unsigned char> m_depthNormalI_dummyVisibility;
   //! List of current active (visible and with features extracted) faces
@@ -177,5 +180,8 @@ protected:
 #endif
   void segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                          const unsigned int height);
+  void segmentPointCloud(const vpMbtPointCloud &point_cloud);
+  template <class PointCloud>
+  void segmentPointCloudImpl(const PointCloud &point_cloud, const unsigned int width, const unsigned int height);
 };
 #endif
@@ -46,6 +46,7 @@
 #ifndef vpMbEdgeTracker_HH
 #define vpMbEdgeTracker_HH
 
+#include <visp3/core/vpImagePyramid.h>
 #include <visp3/core/vpPoint.h>
 #include <visp3/core/vpXmlParser.h>
 #include <visp3/mbt/vpMbTracker.h>
@@ -58,6 +59,7 @@
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <map>
 #include <vector>
 
 #if defined(VISP_HAVE_COIN3D)
@@ -280,6 +282,9 @@ protected:
   //! of moving edges). Each element of the vector is for a scale (element 0 =
   //! level 0 = no subsampling).
   std::vector<std::list<vpMbtDistanceLine *> > lines;
+  //! For each scale, the lines sorted by the key of their extremities, used
+  //! to find the lines already in the model (see vpMbTracker::findSameLines())
+  std::vector<std::multimap<double, vpMbtDistanceLine *> > m_linesIndex;
 
   //! Vector of the tracked circles.
   std::vector<std::list<vpMbtDistanceCircle *> > circles;
@@ -312,6 +317,9 @@ protected:
   //! Pyramid of image associated to the current image. This pyramid is
   //! computed in the init() and in the track() methods.
   std::vector<const vpImage<unsigned char> *> Ipyramid;
+  //! Pyramid levels computed by the tracker, reused from one frame to the
+  //! other
+  vpImagePyramid m_imagePyramid;
 
   //! Current scale level used. This attribute must not be modified outside of
   //! the downScale() and upScale() methods, as it used to specify to some
@@ -494,6 +502,7 @@ public:
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
   void track(const vpImage<unsigned char> &I);
+  void track(const vpImagePyramid &pyramid);
   //@}
 
 protected:
@@ -532,6 +541,7 @@ protected:
                                unsigned int &nberrors_circles);
   void initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo);
   void initPyramid(const vpImage<unsigned char> &_I, std::vector<const vpImage<unsigned char> *> &_pyramid);
+  void initPyramid(const vpImagePyramid &pyramid, std::vector<const vpImage<unsigned char> *> &_pyramid);
   void reInitLevel(const unsigned int _lvl);
   void reinitMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo);
   void removeCircle(const std::string &name);
@@ -178,6 +178,14 @@ public:
   virtual unsigned int getNbPoints(const unsigned int level = 0) const;
   virtual void getNbPoints(std::map<std::string, unsigned int> &mapOfNbPoints, const unsigned int level = 0) const;
 
+  /*!
+    Get the number of threads used by the parallel tracking mode (0 means
+    that the number of threads is determined by OpenMP).
+
+    \sa setNbParallelTrackingThreads(), setUseParallelTracking()
+  */
+  inline int getNbParallelTrackingThreads() const { return m_nbParallelTrackingThreads; }
+
   virtual inline unsigned int getNbPolygon() const;
   virtual void getNbPolygon(std::map<std::string, unsigned int> &mapOfNbPolygons) const;
 
@@ -197,6 +205,14 @@ public:
 
   virtual inline vpColVector getRobustWeights() const { return m_w; }
 
+  /*!
+    \return True if the cameras and the feature types are processed in
+    parallel.
+
+    \sa setUseParallelTracking()
+  */
+  inline bool getUseParallelTracking() const { return m_useParallelTracking; }
+
   virtual void init(const vpImage<unsigned char> &I);
 
 #ifdef VISP_HAVE_MODULE_GUI
@@ -259,6 +275,8 @@ public:
   virtual void setAngleDisappear(const double &a1, const double &a2);
   virtual void setAngleDisappear(const std::map<std::string, double> &mapOfAngles);
 
+  virtual void setBVHVisibilityTest(const bool &v);
+
   virtual void setCameraParameters(const vpCameraParameters &camera);
   virtual void setCameraParameters(const vpCameraParameters &camera1, const vpCameraParameters &camera2);
   virtual void setCameraParameters(const std::map<std::string, vpCameraParameters> &mapOfCameraParameters);
@@ -295,10 +313,8 @@ public:
 
   virtual void setGoodMovingEdgesRatioThreshold(const double threshold);
 
-#ifdef VISP_HAVE_OGRE
   virtual void setGoodNbRayCastingAttemptsRatio(const double &ratio);
   virtual void setNbRayCastingAttemptsForVisibility(const unsigned int &attempts);
-#endif
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setKltMaskBorder(const unsigned int &e);
@@ -320,6 +336,8 @@ public:
   virtual void setMinLineLengthThresh(const double minLineLengthThresh, const std::string &name = "");
   virtual void setMinPolygonAreaThresh(const double minPolygonAreaThresh, const std::string &name = "");
 
+  virtual void setModelCacheDirectory(const std::string &directory);
+
   virtual void setMovingEdge(const vpMe &me);
   virtual void setMovingEdge(const vpMe &me1, const vpMe &me2);
   virtual void setMovingEdge(const std::map<std::string, vpMe> &mapOfMe);
@@ -328,6 +346,8 @@ public:
   virtual void setNearClippingDistance(const double &dist1, const double &dist2);
   virtual void setNearClippingDistance(const std::map<std::string, double> &mapOfDists);
 
+  virtual void setNbParallelTrackingThreads(const int nb);
+
   virtual void setOgreShowConfigDialog(const bool showConfigDialog);
   virtual void setOgreVisibilityTest(const bool &v);
 
@@ -358,6 +378,7 @@ public:
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 #endif
+  virtual void setUseParallelTracking(const bool use);
 
   virtual void testTracking();
 
@@ -372,6 +393,8 @@ public:
                      std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                      std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                     std::map<std::string, const vpMbtPointCloud *> &mapOfPointClouds);
 
 protected:
   virtual void computeProjectionError();
@@ -381,8 +404,7 @@ protected:
   virtual void computeVVSInit();
   virtual void computeVVSInit(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
   virtual void computeVVSInteractionMatrixAndResidu();
-  virtual void computeVVSInteractionMatrixAndResidu(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
-                                                    std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist);
+  virtual void computeVVSInteractionMatrixAndResidu(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages);
   using vpMbTracker::computeVVSWeights;
   virtual void computeVVSWeights();
 
@@ -396,6 +418,14 @@ protected:
 
   virtual void initFaceFromLines(vpMbtPolygon &polygon);
 
+#ifdef VISP_HAVE_PCL
+  virtual void postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                            std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds);
+#endif
+  virtual void postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+
 #ifdef VISP_HAVE_PCL
   virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                            std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds);
@@ -404,8 +434,17 @@ protected:
                            std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                           std::map<std::string, const vpMbtPointCloud *> &mapOfPointClouds);
 
 private:
+  // Tasks run for each camera, see the parallel tracking mode
+  class ComputeVVSWeightedNormalEquationsTask;
+  class ComputeVVSInteractionMatrixAndResiduTask;
+  class ComputeVVSWeightsTask;
+  class PostTrackingTask;
+  template <class PointCloud> class PreTrackingTask;
+
   class TrackerWrapper : public vpMbEdgeTracker,
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                          public vpMbKltTracker,
@@ -415,13 +454,21 @@ private:
   {
     friend class vpMbGenericTracker;
 
+    // Tasks run for each feature type, see the parallel tracking mode
+    class ComputeVVSFeatureInteractionMatrixAndResiduTask;
+    template <class PointCloud> class PreTrackingFeatureTask;
+
   public:
     //! (s - s*)
     vpColVector m_error;
     //! Interaction matrix
     vpMatrix m_L;
+    //! Number of threads used to process the feature types in parallel
+    int m_nbParallelTrackingThreads;
     //! Type of the tracker (a combination of the above)
     int m_trackerType;
+    //! If true, the feature types are processed in parallel
+    bool m_useParallelTracking;
     //! Robust weights
     vpColVector m_w;
     //! Weighted error
@@ -491,6 +538,13 @@ private:
     using vpMbTracker::computeVVSWeights;
     virtual void computeVVSWeights();
 
+    void computeVVSFeatureInteractionMatrixAndResidu(const int featureType, const vpImage<unsigned char> *const ptr_I);
+    void computeVVSWeightedNormalEquations(const double factorEdge, const double factorKlt, const double factorDepth,
+                                           const double factorDepthDense, vpColVector &w, vpMatrix &LTL,
+                                           vpColVector &LTR, double &num, double &den);
+
+    std::vector<int> getFeatureTypes(const bool groupDepthFeatures = false) const;
+
     virtual void initCircle(const vpPoint &p1, const vpPoint &p2, const vpPoint &p3, const double radius,
                             const int idFace = 0, const std::string &name = "");
 
@@ -513,6 +567,15 @@ private:
     virtual void preTracking(const vpImage<unsigned char> *const ptr_I = NULL,
                              const std::vector<vpColVector> *const point_cloud = NULL,
                              const unsigned int pointcloud_width = 0, const unsigned int pointcloud_height = 0);
+    virtual void preTracking(const vpImage<unsigned char> *const ptr_I, const vpMbtPointCloud *const point_cloud);
+
+    template <class PointCloud>
+    void preTrackingFeature(const int featureType, const vpImage<unsigned char> *const ptr_I,
+                            const PointCloud *const point_cloud, const unsigned int pointcloud_width,
+                            const unsigned int pointcloud_height);
+    template <class PointCloud>
+    void preTrackingImpl(const vpImage<unsigned char> *const ptr_I, const PointCloud *const point_cloud,
+                         const unsigned int pointcloud_width, const unsigned int pointcloud_height);
   };
 
 protected:
@@ -528,6 +591,9 @@ protected:
   //! Map of Model-based trackers, key is the name of the camera, value is the
   //! tracker
   std::map<std::string, TrackerWrapper *> m_mapOfTrackers;
+  //! Number of threads used by the parallel tracking mode (0 means that
+  //! OpenMP determines it)
+  int m_nbParallelTrackingThreads;
   //! Percentage of good points over total number of points below which
   //! tracking is supposed to have failed (only for Edge tracking).
   double m_percentageGdPt;
@@ -536,6 +602,8 @@ protected:
   //! Threshold below which the weight associated to a point to consider this
   //! one as an outlier (only for KLT tracking).
   double m_thresholdOutlier;
+  //! If true, the cameras and the feature types are processed in parallel
+  bool m_useParallelTracking;
   //! Robust weights
   vpColVector m_w;
   //! Weighted error
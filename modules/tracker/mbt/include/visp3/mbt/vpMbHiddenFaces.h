@@ -45,6 +45,7 @@
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
 #include <visp3/mbt/vpMbScanLine.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
@@ -52,6 +53,7 @@
 #include <visp3/ar/vpAROgre.h>
 #endif
 
+#include <cstdlib>
 #include <limits>
 #include <vector>
 
@@ -75,12 +77,20 @@ private:
   //! Number of visible polygon
   unsigned int nbVisiblePolygon;
   vpMbScanLine scanlineRender;
+  //! Number of rays sent toward each polygon for the visibility test
+  unsigned int nbRayAttempts;
+  //! Ratio of rays that have to reach a polygon to consider it as visible
+  double ratioVisibleRay;
+  //! Bounding volume hierarchy of the polygons
+  vpMbBoundingVolumeHierarchy bvh;
+  //! True if the bounding volume hierarchy is used for the visibility test
+  bool bvhVisibilityTest;
+  //! Polygons that may be seen by the camera, updated by setVisible()
+  std::vector<unsigned int> bvhCandidates;
 
 #ifdef VISP_HAVE_OGRE
   vpImage<unsigned char> ogreBackground;
   bool ogreInitialised;
-  unsigned int nbRayAttempts;
-  double ratioVisibleRay;
   vpAROgre *ogre;
   std::vector<Ogre::ManualObject *> lOgrePolygons;
   bool ogreShowConfigDialog;
@@ -91,6 +101,10 @@ private:
                                  bool not_used = false, const vpImage<unsigned char> &I = vpImage<unsigned char>(),
                                  const vpCameraParameters &cam = vpCameraParameters());
 
+  unsigned int setVisibleBVH(const vpHomogeneousMatrix &cMo, const double &angleAppears,
+                             const double &angleDisappears, bool &changed, const vpImage<unsigned char> &I,
+                             const vpCameraParameters &cam);
+
 public:
   vpMbHiddenFaces();
   ~vpMbHiddenFaces();
@@ -124,6 +138,22 @@ public:
   */
   std::vector<PolygonType *> &getPolygon() { return Lpol; }
 
+  /*!
+    Tell whether the bounding volume hierarchy is used for the visibility
+    test.
+
+    \sa setBVHVisibilityTest()
+  */
+  bool getBVHVisibilityTest() const { return bvhVisibilityTest; }
+
+  /*!
+    Get the bounding volume hierarchy of the polygons. It is built by
+    initBVH(), or by setVisible() when the BVH visibility test is enabled.
+  */
+  const vpMbBoundingVolumeHierarchy &getBoundingVolumeHierarchy() const { return bvh; }
+
+  void initBVH();
+
 #ifdef VISP_HAVE_OGRE
   void initOgre(const vpCameraParameters &cam = vpCameraParameters());
 #endif
@@ -135,7 +165,6 @@ public:
   */
   unsigned int getNbVisiblePolygon() const { return nbVisiblePolygon; }
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Get the number of rays that will be sent toward each polygon for
     visibility test. Each ray will go from the optic center of the camera to a
@@ -147,12 +176,14 @@ public:
   */
   unsigned int getNbRayCastingAttemptsForVisibility() { return nbRayAttempts; }
 
+#ifdef VISP_HAVE_OGRE
   /*!
     Get the Ogre3D Context.
 
     \return A pointer on a vpAROgre instance.
   */
   vpAROgre *getOgreContext() { return ogre; }
+#endif
 
   /*!
     Get the ratio of visibility attempts that has to be successful to consider
@@ -164,7 +195,6 @@ public:
     be between 0.0 (0%) and 1.0 (100%).
   */
   double getGoodNbRayCastingAttemptsRatio() { return ratioVisibleRay; }
-#endif
 
   bool isAppearing(const unsigned int i) { return Lpol[i]->isAppearing(); }
 
@@ -186,6 +216,8 @@ public:
 */
   bool isVisible(const unsigned int i) { return Lpol[i]->isVisible(); }
 
+  bool isVisibleBVH(const vpTranslationVector &cameraPos, const unsigned int &index);
+
 #ifdef VISP_HAVE_OGRE
   bool isVisibleOgre(const vpTranslationVector &cameraPos, const unsigned int &index);
 #endif
@@ -212,6 +244,24 @@ public:
   {
     ogreBackground = vpImage<unsigned char>(h, w, 0);
   }
+#endif
+
+  /*!
+    Use a bounding volume hierarchy (BVH) of the polygons for the visibility
+    test done by setVisible(). The polygons that are outside the field of view
+    or facing away from the camera are discarded by sub-trees, without being
+    tested one by one. The remaining polygons are tested as usual, then by
+    ray casting through the BVH as with Ogre3D: see
+    setNbRayCastingAttemptsForVisibility() and
+    setGoodNbRayCastingAttemptsRatio(). Setting the number of rays to 0
+    disables the ray casting.
+
+    The BVH is built from the polygons by initBVH(), or by setVisible() when
+    polygons have been added since.
+
+    \param v : True to use the BVH, false otherwise.
+  */
+  void setBVHVisibilityTest(const bool &v) { bvhVisibilityTest = v; }
 
   /*!
     Set the number of rays that will be sent toward each polygon for
@@ -241,6 +291,8 @@ public:
     if (ratioVisibleRay < 0.0)
       ratioVisibleRay = 0.0;
   }
+
+#ifdef VISP_HAVE_OGRE
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -281,12 +333,12 @@ public:
   Basic constructor.
 */
 template <class PolygonType>
-vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces() : Lpol(), nbVisiblePolygon(0), scanlineRender()
+vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces()
+  : Lpol(), nbVisiblePolygon(0), scanlineRender(), nbRayAttempts(1), ratioVisibleRay(1.0), bvh(),
+    bvhVisibilityTest(false), bvhCandidates()
 {
 #ifdef VISP_HAVE_OGRE
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogreShowConfigDialog = false;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640, 0);
@@ -329,11 +381,13 @@ template <class PolygonType> vpMbHiddenFaces<PolygonType>::~vpMbHiddenFaces()
 */
 template <class PolygonType>
 vpMbHiddenFaces<PolygonType>::vpMbHiddenFaces(const vpMbHiddenFaces<PolygonType> &copy)
-  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender)
+  : Lpol(), nbVisiblePolygon(copy.nbVisiblePolygon), scanlineRender(copy.scanlineRender),
+    nbRayAttempts(copy.nbRayAttempts), ratioVisibleRay(copy.ratioVisibleRay), bvh(copy.bvh),
+    bvhVisibilityTest(copy.bvhVisibilityTest), bvhCandidates()
 #ifdef VISP_HAVE_OGRE
     ,
-    ogreBackground(copy.ogreBackground), ogreInitialised(copy.ogreInitialised), nbRayAttempts(copy.nbRayAttempts),
-    ratioVisibleRay(copy.ratioVisibleRay), ogre(NULL), lOgrePolygons(), ogreShowConfigDialog(copy.ogreShowConfigDialog)
+    ogreBackground(copy.ogreBackground), ogreInitialised(copy.ogreInitialised), ogre(NULL), lOgrePolygons(),
+    ogreShowConfigDialog(copy.ogreShowConfigDialog)
 #endif
 {
   // Copy the list of polygons
@@ -349,10 +403,12 @@ template <class PolygonType> void swap(vpMbHiddenFaces<PolygonType> &first, vpMb
   swap(first.Lpol, second.Lpol);
   swap(first.nbVisiblePolygon, second.nbVisiblePolygon);
   swap(first.scanlineRender, second.scanlineRender);
-#ifdef VISP_HAVE_OGRE
-  swap(first.ogreInitialised, second.ogreInitialised);
   swap(first.nbRayAttempts, second.nbRayAttempts);
   swap(first.ratioVisibleRay, second.ratioVisibleRay);
+  swap(first.bvh, second.bvh);
+  swap(first.bvhVisibilityTest, second.bvhVisibilityTest);
+#ifdef VISP_HAVE_OGRE
+  swap(first.ogreInitialised, second.ogreInitialised);
   swap(first.ogreShowConfigDialog, second.ogreShowConfigDialog);
   swap(first.ogre, second.ogre);
   swap(first.ogreBackground, second.ogreBackground);
@@ -405,6 +461,9 @@ template <class PolygonType> void vpMbHiddenFaces<PolygonType>::reset()
     Lpol[i] = NULL;
   }
   Lpol.resize(0);
+  bvh.clear();
+  nbRayAttempts = 1;
+  ratioVisibleRay = 1.0;
 
 #ifdef VISP_HAVE_OGRE
   if (ogre != NULL) {
@@ -423,13 +482,26 @@ template <class PolygonType> void vpMbHiddenFaces<PolygonType>::reset()
   lOgrePolygons.resize(0);
 
   ogreInitialised = false;
-  nbRayAttempts = 1;
-  ratioVisibleRay = 1.0;
   ogre = new vpAROgre();
   ogreBackground = vpImage<unsigned char>(480, 640);
 #endif
 }
 
+/*!
+  Build the bounding volume hierarchy of the polygons that have been added
+  via addPolygon(). It has to be called again if the points of the polygons
+  are modified.
+
+  \sa setBVHVisibilityTest()
+*/
+template <class PolygonType> void vpMbHiddenFaces<PolygonType>::initBVH()
+{
+  bvh.clear();
+  for (unsigned int i = 0; i < Lpol.size(); i++)
+    bvh.addPolygon(Lpol[i]->p, Lpol[i]->nbpt, Lpol[i]->hasOrientation);
+  bvh.build();
+}
+
 /*!
   Compute the clipped points of the polygons that have been added via
   addPolygon().
@@ -537,6 +609,8 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneous
 #else
     vpTRACE("ViSP doesn't have Ogre3D, simple visibility test used");
 #endif
+  } else if (bvhVisibilityTest) {
+    return setVisibleBVH(cMo, angleAppears, angleDisappears, changed, I, cam);
   }
 
   for (unsigned int i = 0; i < Lpol.size(); i++) {
@@ -547,6 +621,52 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneous
   return nbVisiblePolygon;
 }
 
+/*!
+  Compute the number of visible polygons using the bounding volume hierarchy.
+  Only the polygons that may be seen by the camera are tested by
+  computeVisibility(), the other ones are set as not visible.
+
+  \param cMo : The pose of the camera
+  \param angleAppears : Angle used to test the appearance of a face
+  \param angleDisappears : Angle used to test the disappearance of a face
+  \param changed : True if a face appeared or disappeared.
+  \param I : Image used to get the field of view, can be empty.
+  \param cam : Camera parameters.
+
+  \return Return the number of visible polygons
+*/
+template <class PolygonType>
+unsigned int vpMbHiddenFaces<PolygonType>::setVisibleBVH(const vpHomogeneousMatrix &cMo, const double &angleAppears,
+                                                         const double &angleDisappears, bool &changed,
+                                                         const vpImage<unsigned char> &I,
+                                                         const vpCameraParameters &cam)
+{
+  if (bvh.getNbPolygons() != Lpol.size())
+    initBVH();
+
+  vpTranslationVector cameraPos;
+  cMo.inverse().extract(cameraPos);
+
+  // Beyond this angle a polygon is neither visible nor appearing
+  const double angle = (std::max)(angleAppears, angleDisappears) + vpMath::rad(1);
+  bvh.queryFrustum(cMo, cam, I.getWidth(), I.getHeight(), bvhCandidates, angle);
+
+  size_t k = 0;
+  for (unsigned int i = 0; i < Lpol.size(); i++) {
+    if (k < bvhCandidates.size() && bvhCandidates[k] == i) {
+      k++;
+      if (computeVisibility(cMo, angleAppears, angleDisappears, changed, false, true, I, cam, cameraPos, i))
+        nbVisiblePolygon++;
+    } else {
+      if (Lpol[i]->isvisible)
+        changed = true;
+      Lpol[i]->isvisible = false;
+      Lpol[i]->isappearing = false;
+    }
+  }
+  return nbVisiblePolygon;
+}
+
 /*!
   Compute the visibility of a given face index.
 
@@ -558,8 +678,9 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisiblePrivate(const vpHomogeneous
   test the visibility, False otherwise. \param not_used : Unused parameter.
   \param I : Image used to test if a face is entirely projected in the image.
   \param cam : Camera parameters.
-  \param cameraPos : Position of the camera. Used only when Ogre is used as
-  3rd party. \param index : Index of the face to consider.
+  \param cameraPos : Position of the camera in the object frame. Used only
+  when Ogre is used as 3rd party or when the BVH visibility test is enabled.
+  \param index : Index of the face to consider.
 
   \return Return true if the face is visible.
 */
@@ -597,7 +718,8 @@ bool vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &
         }
 #endif
         else
-          testDisappear = (!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I));
+          testDisappear = ((!Lpol[i]->isVisible(cMo, angleDisappears, false, cam, I)) ||
+                           (bvhVisibilityTest && !isVisibleBVH(cameraPos, i)));
       }
 
       // test if the face is still visible
@@ -624,7 +746,8 @@ bool vpMbHiddenFaces<PolygonType>::computeVisibility(const vpHomogeneousMatrix &
           testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
 #endif
         else
-          testAppear = (Lpol[i]->isVisible(cMo, angleAppears, false, cam, I));
+          testAppear = ((Lpol[i]->isVisible(cMo, angleAppears, false, cam, I)) &&
+                        (!bvhVisibilityTest || isVisibleBVH(cameraPos, i)));
       }
 
       if (testAppear) {
@@ -700,6 +823,77 @@ unsigned int vpMbHiddenFaces<PolygonType>::setVisible(const vpHomogeneousMatrix
   return setVisiblePrivate(cMo, angleAppears, angleDisappears, changed, false);
 }
 
+/*!
+  Test the visibility of a polygon via ray casting through the bounding volume
+  hierarchy. The polygon is visible if the ratio of the rays going from the
+  camera to a point of the polygon without hitting another polygon before is
+  greater than the one set with setGoodNbRayCastingAttemptsRatio().
+
+  \param cameraPos : Position of the camera in the object frame.
+  \param index : Index of the polygon.
+
+  \return Return true if the polygon is visible, False otherwise.
+*/
+template <class PolygonType>
+bool vpMbHiddenFaces<PolygonType>::isVisibleBVH(const vpTranslationVector &cameraPos, const unsigned int &index)
+{
+  if (nbRayAttempts == 0)
+    return true;
+
+  if (bvh.getNbPolygons() != Lpol.size())
+    initBVH();
+
+  const double origin[3] = {cameraPos[0], cameraPos[1], cameraPos[2]};
+  unsigned int nbVisible = 0;
+
+  for (unsigned int i = 0; i < nbRayAttempts; i++) {
+    // Random point inside the polygon, as in isVisibleOgre()
+    double target[3] = {0.0, 0.0, 0.0};
+    double totalFactor = 0.0;
+    for (unsigned int j = 0; j < Lpol[index]->getNbPoint(); j++) {
+      double factor = 1.0;
+
+      if (nbRayAttempts > 1) {
+        int r = rand() % 101;
+
+        if (r != 0)
+          factor = ((double)r) / 100.0;
+      }
+
+      target[0] += factor * Lpol[index]->getPoint(j).get_oX();
+      target[1] += factor * Lpol[index]->getPoint(j).get_oY();
+      target[2] += factor * Lpol[index]->getPoint(j).get_oZ();
+      totalFactor += factor;
+    }
+
+    double direction[3];
+    for (unsigned int k = 0; k < 3; k++)
+      direction[k] = target[k] / totalFactor - origin[k];
+    const double distanceTarget =
+        std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    if (distanceTarget <= std::numeric_limits<double>::epsilon()) {
+      nbVisible++;
+      continue;
+    }
+    for (unsigned int k = 0; k < 3; k++)
+      direction[k] /= distanceTarget;
+
+    // The polygons sharing an edge or a plane with the target polygon are
+    // hit at the same distance and do not occlude it
+    double distance;
+    unsigned int hit;
+    if (!bvh.intersectRay(origin, direction, distanceTarget * (1.0 - 1e-6), distance, hit, (int)index))
+      nbVisible++;
+  }
+
+  Lpol[index]->isvisible =
+      ((double)nbVisible) / ((double)nbRayAttempts) > ratioVisibleRay ||
+      std::fabs(((double)nbVisible) / ((double)nbRayAttempts) - ratioVisibleRay) <
+          ratioVisibleRay * std::numeric_limits<double>::epsilon();
+
+  return Lpol[index]->isvisible;
+}
+
 #ifdef VISP_HAVE_OGRE
 /*!
   Initialise the ogre context for face visibility tests.
@@ -235,7 +235,8 @@ class VISP_EXPORT vpMbKltTracker : public virtual vpMbTracker
   friend class vpMbEdgeKltMultiTracker;
 
 protected:
-//! Temporary OpenCV image for fast conversion.
+//! Temporary OpenCV image for fast conversion. With OpenCV >= 2.4.8, it
+//! is a view on the data of the last image given to the tracker.
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat cur;
 #else
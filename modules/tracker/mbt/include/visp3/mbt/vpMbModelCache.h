@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Binary cache of the primitives of a 3D model.
+ *
+ *****************************************************************************/
+
+#ifndef vpMbModelCache_HH
+#define vpMbModelCache_HH
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpMemoryMappedFile.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpMbModelCache
+
+  \ingroup group_mbt_faces
+
+  \brief Binary cache of the primitives of a 3D model, as produced by the
+  parsers of the CAO and VRML files of vpMbTracker.
+
+  The primitives are the faces, lines, cylinders and circles of the model,
+  with their points expressed in the object frame, their name and their LOD
+  settings. They are the ones passed to the tracker once the text files have
+  been parsed and their included files expanded, so that a model can be
+  loaded again without parsing it.
+
+  The cache file stores a key describing the loading parameters, and the
+  size and hash of every source file of the model. load() rejects the file
+  if the key differs, if a source file has been modified, or if the file has
+  been written by another version of this class. The file is mapped in
+  memory with vpMemoryMappedFile and its content is read in place.
+
+  This class is used by vpMbTracker::loadModel() when a cache directory is
+  set with vpMbTracker::setModelCacheDirectory().
+*/
+class VISP_EXPORT vpMbModelCache
+{
+public:
+  //! Type of the primitives of a model.
+  typedef enum {
+    FACE_FROM_CORNERS, //!< Face or line defined by its corners.
+    FACE_FROM_LINES,   //!< Face defined by the extremities of its lines.
+    CYLINDER,          //!< Cylinder defined by two points on its axis and its radius.
+    CIRCLE             //!< Circle defined by its center, two points of its plane and its radius.
+  } vpPrimitiveType;
+
+  //! Primitive of a model.
+  struct vpPrimitive {
+    //! Type of the primitive.
+    vpPrimitiveType type;
+    //! Id of the first face of the primitive.
+    int idFace;
+    //! Points of the primitive.
+    std::vector<vpPoint> points;
+    //! Radius of a cylinder or a circle.
+    double radius;
+    //! Name of the primitive.
+    std::string name;
+    //! True if the primitive uses the LOD.
+    bool useLod;
+    //! Minimum polygon area threshold for the LOD.
+    double minPolygonAreaThreshold;
+    //! Minimum line length threshold for the LOD.
+    double minLineLengthThreshold;
+  };
+
+  vpMbModelCache();
+
+  void addPrimitive(const vpPrimitive &primitive);
+  void addSourceFile(const std::string &filename);
+
+  void clear();
+
+  /*!
+    Get the id of the first face of the model when it was recorded.
+
+    \return Id of the first face.
+  */
+  inline int getFirstIdFace() const { return m_firstIdFace; }
+  /*!
+    Get the number of primitives.
+
+    \return Number of primitives.
+  */
+  inline unsigned int getNbPrimitives() const { return m_nbPrimitives; }
+  void getPrimitive(const unsigned int index, vpPrimitive &primitive) const;
+  void getStatistics(unsigned int statistics[6]) const;
+
+  static std::string getCacheFilename(const std::string &directory, const std::string &modelFile,
+                                      const std::string &key);
+
+  bool load(const std::string &filename, const std::string &key);
+
+  void save(const std::string &filename, const std::string &key) const;
+
+  /*!
+    Set the id of the first face of the model, subtracted from the id of the
+    primitives when the model is loaded from the cache.
+
+    \param idFace : Id of the first face.
+  */
+  inline void setFirstIdFace(const int idFace) { m_firstIdFace = idFace; }
+  void setStatistics(const unsigned int statistics[6]);
+
+private:
+  // The cache cannot be copied since it may refer to a mapped file
+  vpMbModelCache(const vpMbModelCache &);
+  vpMbModelCache &operator=(const vpMbModelCache &);
+
+  //! Primitive as stored in the file.
+  struct vpRecord {
+    uint32_t type;
+    int32_t idFace;
+    uint32_t firstPoint;
+    uint32_t nbPoints;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t useLod;
+    uint32_t reserved;
+    double radius;
+    double minPolygonAreaThreshold;
+    double minLineLengthThreshold;
+  };
+
+  //! Source file as stored in the file.
+  struct vpSource {
+    uint64_t size;
+    uint64_t hash;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+  };
+
+  void setPointers();
+
+  //! Id of the first face when the model was recorded.
+  int m_firstIdFace;
+  //! Number of points, lines, polygon lines, polygon points, cylinders and
+  //! circles of the model.
+  unsigned int m_statistics[6];
+
+  //! Primitives, points and strings of a recorded model.
+  std::vector<vpRecord> m_records;
+  std::vector<double> m_points;
+  std::vector<char> m_strings;
+  std::vector<vpSource> m_sources;
+
+  //! Mapped cache file of a loaded model.
+  vpMemoryMappedFile m_file;
+
+  //! Views on the recorded data or on the mapped file.
+  const vpRecord *m_recordsData;
+  const double *m_pointsData;
+  const char *m_stringsData;
+  unsigned int m_nbPrimitives;
+};
+
+#endif
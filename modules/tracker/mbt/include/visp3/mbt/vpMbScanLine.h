@@ -45,6 +45,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <visp3/core/vpCameraParameters.h>
@@ -75,15 +76,29 @@ public:
   //! ending point of a polygon, or just a single line intersection.
   typedef enum { START = 1, END = 0, POINT = 2 } vpMbScanLineType;
 
-  //! Structure to define a scanline edge (basically a pair of (X,Y,Z)
-  //! vectors).
-  typedef std::pair<vpColVector, vpColVector> vpMbScanLineEdge;
+  /*!
+    Structure to define a scanline edge (basically a pair of (X,Y,Z)
+    points).
+
+    \note This structure replaces the former typedef of
+    std::pair<vpColVector, vpColVector>, which breaks the code that used
+    vpMbScanLineEdge as a pair of vectors: the coordinates are now the
+    first and second arrays of 3 doubles.
+  */
+  struct vpMbScanLineEdge {
+    double first[3];
+    double second[3];
+  };
 
   //! Structure to define a scanline intersection.
   struct vpMbScanLineSegment {
-    vpMbScanLineSegment() : type(START), edge(), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false) {}
+    vpMbScanLineSegment()
+      : type(START), edge(0), scanline(0), p(0), P1(0), P2(0), Z1(0), Z2(0), ID(0), b_sample_Y(false)
+    {
+    }
     vpMbScanLineType type;
-    vpMbScanLineEdge edge;
+    unsigned int edge;     // Index of the edge in the table of the edges of the scene.
+    unsigned int scanline; // Index of the row or of the column.
     double p;      // This value can be either x or y-coordinate value depending if
                    // the structure is used in X or Y-axis scanlines computation.
     double P1, P2; // Same comment as previous value.
@@ -126,13 +141,40 @@ public:
   };
 
 private:
+  //! Edge of a polygon projected in the image.
+  struct vpMbScanLineProjectedEdge {
+    double x0, y0, z0;
+    double x1, y1, z1;
+    unsigned int edge; // Index in the table of the edges of the scene.
+    bool b_sample_Y;
+  };
+
+  //! Polygon projected in the image.
+  struct vpMbScanLinePolygon {
+    int ID;
+    unsigned int first_edge;
+    unsigned int nb_edges;
+    bool b_closed; // False for a line.
+    double xmin, xmax, ymin, ymax;
+  };
+
   unsigned int w, h;
   vpCameraParameters K;
   unsigned int maskBorder;
   vpImage<unsigned char> mask;
   vpImage<int> primitive_ids;
-  std::map<vpMbScanLineEdge, std::set<int>, vpMbScanLineEdgeComparator> visibility_samples;
+  std::vector<vpMbScanLinePolygon> projected_polygons;
+  std::vector<vpMbScanLineProjectedEdge> projected_edges;
+  //! Sorted table of the edges of the scene.
+  std::vector<vpMbScanLineEdge> edges;
+  //! The visible samples of the i-th edge are the sorted values
+  //! visibility_samples[visibility_offsets[i]] to
+  //! visibility_samples[visibility_offsets[i+1]-1].
+  std::vector<unsigned int> visibility_offsets;
+  std::vector<int> visibility_samples;
   double depthTreshold;
+  //! Number of bands of scanlines, 0 to choose it from the number of threads.
+  unsigned int nbBands;
 
 public:
 #if defined(DEBUG_DISP)
@@ -156,6 +198,11 @@ public:
   */
   double getDepthTreshold() { return depthTreshold; }
   unsigned int getMaskBorder() { return maskBorder; }
+  /*!
+    Return the number of bands of scanlines rendered independently, 0 if it
+    is chosen from the number of threads.
+  */
+  unsigned int getNbBands() const { return nbBands; }
   const vpImage<unsigned char> &getMask() const { return mask; }
   const vpImage<int> &getPrimitiveIDs() const { return primitive_ids; }
 
@@ -171,27 +218,34 @@ public:
   */
   void setDepthTreshold(const double &treshold) { depthTreshold = treshold; }
   void setMaskBorder(const unsigned int &mb) { maskBorder = mb; }
+  /*!
+    Set the number of bands of scanlines rendered independently. The result
+    does not depend on the number of bands.
+
+    \param nb : Number of bands, 0 to use 4 bands per thread when OpenMP is
+    available and a single band otherwise (default).
+  */
+  void setNbBands(const unsigned int &nb) { nbBands = nb; }
 
 private:
-  void createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
-                                 std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                 const unsigned int &size);
+  void drawBand(const bool b_axis_Y, const unsigned int begin, const unsigned int end,
+                std::vector<vpMbScanLineSegment> &segments, std::vector<vpMbScanLineSegment> &polygon_segments) const;
 
-  void drawLineY(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &line_ID, const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void drawEdge(const bool b_axis_Y, const vpMbScanLineProjectedEdge &edge, const int ID, const unsigned int begin,
+                const unsigned int end, std::vector<vpMbScanLineSegment> &segments) const;
 
-  void drawLineX(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &line_ID, const int ID,
-                 std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void drawScanLine(const bool b_axis_Y, const vpMbScanLineSegment *scanline, const size_t size,
+                    std::vector<std::pair<double, vpMbScanLineSegment> > &stack,
+                    std::vector<std::pair<unsigned int, int> > &samples, vpImage<unsigned char> &mask_axis);
 
-  void drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  void drawScanLines(const bool b_axis_Y, std::vector<std::pair<unsigned int, int> > &samples,
+                     vpImage<unsigned char> &mask_axis);
 
-  void drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                    std::vector<std::vector<vpMbScanLineSegment> > &scanlines);
+  bool findEdge(const vpMbScanLineEdge &edge, unsigned int &index) const;
 
   // Static functions
   static vpMbScanLineEdge makeMbScanLineEdge(const vpPoint &a, const vpPoint &b);
-  static void createVectorFromPoint(const vpPoint &p, vpColVector &v, const vpCameraParameters &K);
+  static void createVectorFromPoint(const vpPoint &p, double v[3], const vpCameraParameters &K);
   static double getAlpha(double x, double X0, double Z0, double X1, double Z1);
   static double mix(double a, double b, double alpha);
   static vpPoint mix(const vpPoint &a, const vpPoint &b, double alpha);
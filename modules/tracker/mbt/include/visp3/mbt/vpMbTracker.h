@@ -66,6 +66,7 @@
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpRobust.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
+#include <visp3/mbt/vpMbModelCache.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 
 #include <visp3/mbt/vpMbtDistanceCircle.h>
@@ -200,6 +201,9 @@ protected:
 
   //! Distance line primitives for projection error
   std::vector<vpMbtDistanceLine *> m_projectionErrorLines;
+  //! Distance line primitives for projection error sorted by the key of
+  //! their extremities, see findSameLines()
+  std::multimap<double, vpMbtDistanceLine *> m_projectionErrorLinesIndex;
   //! Distance cylinder primitives for projection error
   std::vector<vpMbtDistanceCylinder *> m_projectionErrorCylinders;
   //! Distance circle primitive for projection error
@@ -225,6 +229,12 @@ protected:
   vpCameraParameters m_projectionErrorCam;
   //! Mask used to disable tracking on a part of image
   const vpImage<bool> *m_mask;
+  //! Directory of the binary cache of the models, empty if the cache is
+  //! disabled
+  std::string m_modelCacheDirectory;
+  //! Cache in which the primitives are recorded while a model is parsed,
+  //! NULL otherwise
+  vpMbModelCache *m_modelCache;
 
 public:
   vpMbTracker();
@@ -297,6 +307,15 @@ public:
    */
   virtual inline unsigned int getMaxIter() const { return m_maxIter; }
 
+  /*!
+    Get the directory of the binary cache of the models.
+
+    \return The directory, empty if the cache is disabled.
+
+    \sa setModelCacheDirectory()
+  */
+  virtual inline std::string getModelCacheDirectory() const { return m_modelCacheDirectory; }
+
   /*!
     Get the error angle between the gradient direction of the model features
     projected at the resulting pose and their normal. The error is expressed
@@ -533,6 +552,22 @@ public:
 
   virtual void setMinPolygonAreaThresh(const double minPolygonAreaThresh, const std::string &name = "");
 
+  /*!
+    Set the directory of the binary cache of the models, used by
+    loadModel().
+
+    When a directory is set, loadModel() looks for a cache file of the model
+    in this directory, written by a previous call with the same model file,
+    transformation and LOD settings. If its source files have not been
+    modified since, the primitives of the model are read from it instead of
+    parsing the CAO or VRML files. Otherwise the model is parsed and the
+    cache file is written. See vpMbModelCache.
+
+    \param directory : The directory, created if needed. An empty string
+    disables the cache, which is the default.
+  */
+  virtual inline void setModelCacheDirectory(const std::string &directory) { m_modelCacheDirectory = directory; }
+
   virtual void setNearClippingDistance(const double &dist);
 
   /*!
@@ -586,11 +621,23 @@ public:
 
   virtual void setScanLineVisibilityTest(const bool &v) { useScanLine = v; }
 
+  /*!
+    Use a bounding volume hierarchy of the faces of the model for the
+    visibility test, instead of testing every face at each iteration. The
+    faces outside the field of view or facing away from the camera are
+    discarded, and the occluded ones are detected by ray casting without the
+    need of Ogre3D.
+
+    \sa vpMbHiddenFaces::setBVHVisibilityTest(), setNbRayCastingAttemptsForVisibility()
+
+    \param v : True to use it, False otherwise
+  */
+  virtual void setBVHVisibilityTest(const bool &v) { faces.setBVHVisibilityTest(v); }
+
   virtual void setOgreVisibilityTest(const bool &v);
 
   void savePose(const std::string &filename) const;
 
-#ifdef VISP_HAVE_OGRE
   /*!
     Set the ratio of visibility attempts that has to be successful to consider
     a polygon as visible.
@@ -614,7 +661,6 @@ public:
   {
     faces.setNbRayCastingAttemptsForVisibility(attempts);
   }
-#endif
 
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
@@ -732,6 +778,16 @@ protected:
                   const std::string &polygonName = "", const bool useLod = false,
                   const double minLineLengthThreshold = 50);
 
+  void addModelCircle(const vpPoint &p1, const vpPoint &p2, const vpPoint &p3, const double radius, int &idFace,
+                      const std::string &polygonName = "", const bool useLod = false,
+                      const double minPolygonAreaThreshold = 2500.0);
+  void addModelCylinder(const vpPoint &p1, const vpPoint &p2, const double radius, int &idFace,
+                        const std::string &polygonName = "", const bool useLod = false,
+                        const double minLineLengthThreshold = 50.0);
+  void addModelFace(const std::vector<vpPoint> &corners, int &idFace, const std::string &polygonName = "",
+                    const bool useLod = false, const double minPolygonAreaThreshold = 2500.0,
+                    const double minLineLengthThreshold = 50.0, const bool fromLines = false);
+
   void addProjectionErrorCircle(const vpPoint &P1, const vpPoint &P2, const vpPoint &P3, const double r, int idFace = -1,
                                 const std::string &name = "");
   void addProjectionErrorCylinder(const vpPoint &P1, const vpPoint &P2, const double r, int idFace = -1, const std::string &name = "");
@@ -767,13 +823,19 @@ protected:
                                                  vpColVector *const w = NULL, const vpColVector *const m_w_prev = NULL);
   virtual void computeVVSInit() = 0;
   virtual void computeVVSInteractionMatrixAndResidu() = 0;
+  void computeVVSNormalEquations(const vpMatrix &L, const vpColVector &w, const vpColVector &error, vpMatrix &LTL,
+                                 vpColVector &LTR, const unsigned int start_index = 0) const;
   virtual void computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, vpMatrix &L, vpMatrix &LTL,
                                         vpColVector &R, const vpColVector &error, vpColVector &error_prev,
                                         vpColVector &LTR, double &mu, vpColVector &v, const vpColVector *const w = NULL,
                                         vpColVector *const m_w_prev = NULL);
+  void computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, const vpMatrix &LTL,
+                                const vpColVector &LTR, const vpColVector &error, vpColVector &error_prev, double &mu,
+                                vpColVector &v, const vpColVector *const w = NULL, vpColVector *const m_w_prev = NULL);
   virtual void computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w);
 
 #ifdef VISP_HAVE_COIN3D
+  static void addVRMLSourceFile(const std::string &filename, std::vector<std::string> &vectorOfModelFilename);
   virtual void extractGroup(SoVRMLGroup *sceneGraphVRML2, vpHomogeneousMatrix &transform, int &idFace);
   virtual void extractFaces(SoVRMLIndexedFaceSet *face_set, vpHomogeneousMatrix &transform, int &idFace,
                             const std::string &polygonName = "");
@@ -826,6 +888,8 @@ protected:
   virtual void initFaceFromCorners(vpMbtPolygon &polygon) = 0;
   virtual void initFaceFromLines(vpMbtPolygon &polygon) = 0;
 
+  void initModelFromCache(const vpMbModelCache &cache, const bool isCao);
+
   void initProjectionErrorCircle(const vpPoint &p1, const vpPoint &p2, const vpPoint &p3, const double radius,
                                  const int idFace = 0, const std::string &name = "");
   void initProjectionErrorCylinder(const vpPoint &p1, const vpPoint &p2, const double radius, const int idFace = 0,
@@ -833,7 +897,7 @@ protected:
   void initProjectionErrorFaceFromCorners(vpMbtPolygon &polygon);
   void initProjectionErrorFaceFromLines(vpMbtPolygon &polygon);
 
-  virtual void loadVRMLModel(const std::string &modelFile);
+  virtual void loadVRMLModel(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename);
   virtual void loadCAOModel(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename,
                             int &startIdFace, const bool verbose = false, const bool parent = true,
                             const vpHomogeneousMatrix &T=vpHomogeneousMatrix());
@@ -872,6 +936,10 @@ protected:
   inline std::string &trim(std::string &s) const { return ltrim(rtrim(s)); }
 
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
+
+  static double getLineKey(const vpPoint &P1, const vpPoint &P2, double &tolerance);
+  void findSameLines(const std::multimap<double, vpMbtDistanceLine *> &linesIndex, const vpPoint &P1,
+                     const vpPoint &P2, std::vector<vpMbtDistanceLine *> &sameLines) const;
 };
 
 #endif
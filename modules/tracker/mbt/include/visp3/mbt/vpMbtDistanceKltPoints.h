@@ -45,6 +45,7 @@
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
 #include <map>
+#include <vector>
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpGEMM.h>
@@ -78,12 +79,22 @@ private:
   double invd0;
   //! cRc0_0n (temporary variable to speed up the computation)
   vpColVector cRc0_0n;
-  //! Initial points and their ID
-  std::map<int, vpImagePoint> initPoints;
-  //! Current points and their ID
-  std::map<int, vpImagePoint> curPoints;
-  //! Current points ID and their indexes
-  std::map<int, int> curPointsInd;
+  //! ID of the initial points, sorted in increasing order
+  std::vector<int> initPointsId;
+  //! Initial points, in the order of initPointsId
+  std::vector<vpImagePoint> initPoints;
+  //! ID of the current points, sorted in increasing order
+  std::vector<int> curPointsId;
+  //! Current points, in the order of curPointsId
+  std::vector<vpImagePoint> curPoints;
+  //! Indexes of the current points in the KLT tracker
+  std::vector<int> curPointsInd;
+  //! Indexes of the current points in initPoints
+  std::vector<unsigned int> curPointsInit;
+  //! Current points and their ID, built by getCurrentPoints()
+  std::map<int, vpImagePoint> curPointsMap;
+  //! Current points ID and their indexes, built by getCurrentPointsInd()
+  std::map<int, int> curPointsIndMap;
   //! number of points detected
   unsigned int nbPointsCur;
   //! initial number of points
@@ -113,6 +124,8 @@ private:
   double compute_1_over_Z(const double x, const double y);
   void computeP_mu_t(const double x_in, const double y_in, double &x_out, double &y_out, const vpMatrix &cHc0);
   bool isTrackedFeature(const int id);
+  void sortCurrentPoints();
+  void updateCurrentPointsInit();
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -158,9 +171,36 @@ public:
 
   inline vpColVector getCurrentNormal() const { return N_cur; }
 
-  inline std::map<int, vpImagePoint> &getCurrentPoints() { return curPoints; }
+  /*!
+    Get a current point.
+
+    \param k : Index of the point, lower than getCurrentNumberPoints(). The
+    points are sorted by increasing ID.
+
+    \return The location of the point in the image.
+  */
+  inline const vpImagePoint &getCurrentPoint(const unsigned int k) const { return curPoints[k]; }
+
+  /*!
+    Get the ID of a current point.
+
+    \param k : Index of the point, lower than getCurrentNumberPoints().
+
+    \return The ID of the feature in the KLT tracker.
+  */
+  inline int getCurrentPointId(const unsigned int k) const { return curPointsId[k]; }
+
+  /*!
+    Get the index of a current point in the KLT tracker.
+
+    \param k : Index of the point, lower than getCurrentNumberPoints().
+
+    \return The index of the feature in the KLT tracker.
+  */
+  inline int getCurrentPointInd(const unsigned int k) const { return curPointsInd[k]; }
 
-  inline std::map<int, int> &getCurrentPointsInd() { return curPointsInd; }
+  std::map<int, vpImagePoint> &getCurrentPoints();
+  std::map<int, int> &getCurrentPointsInd();
 
   /*!
     Get the number of point that was belonging to the face at the
@@ -47,6 +47,7 @@
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
+#include <visp3/mbt/vpMbtPointCloud.h>
 
 #define DEBUG_DISPLAY_DEPTH_DENSE 0
 
@@ -108,6 +109,15 @@ public:
                               , const vpImage<bool> *mask = NULL
   );
 
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtPointCloud &point_cloud,
+                              const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
+
   void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &error);
 
   void computeVisibility();
@@ -221,6 +231,16 @@ protected:
   std::vector<PolygonLine> m_polygonLines;
 
 protected:
+  template <class PointAccessor>
+  bool computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const PointAccessor &points, const unsigned int stepX,
+                                  const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                  ,
+                                  vpImage<unsigned char> &debugImage,
+                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                  , const vpImage<bool> *mask);
+
   void computeROI(const vpHomogeneousMatrix &cMo, const unsigned int width, const unsigned int height,
                   std::vector<vpImagePoint> &roiPts
 #if DEBUG_DISPLAY_DEPTH_DENSE
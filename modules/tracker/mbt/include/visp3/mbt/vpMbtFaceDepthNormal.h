@@ -47,6 +47,7 @@
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
+#include <visp3/mbt/vpMbtPointCloud.h>
 
 #define DEBUG_DISPLAY_DEPTH_NORMAL 0
 
@@ -110,6 +111,15 @@ public:
                               , const vpImage<bool> *mask = NULL
   );
 
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtPointCloud &point_cloud,
+                              vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
+
   void computeInteractionMatrix(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &features);
 
   void computeVisibility();
@@ -261,6 +271,16 @@ protected:
   //!
   std::vector<PolygonLine> m_polygonLines;
 
+  template <class PointAccessor>
+  bool computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const PointAccessor &points,
+                                  vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                  ,
+                                  vpImage<unsigned char> &debugImage,
+                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                  , const vpImage<bool> *mask);
+
 #ifdef VISP_HAVE_PCL
   bool computeDesiredFeaturesPCL(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud_face,
                                  vpColVector &desired_features, vpColVector &desired_normal,
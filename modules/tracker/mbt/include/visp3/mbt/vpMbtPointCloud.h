@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored as a contiguous array of float coordinates.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtPointCloud_h_
+#define __vpMbtPointCloud_h_
+
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpMbtPointCloud
+  \ingroup group_mbt_features
+
+  \brief Organized point cloud (one 3D point per depth pixel) stored as a
+  single contiguous array of float coordinates.
+
+  Each point is made of \e stride consecutive floats, the first three being
+  the X, Y, Z coordinates expressed in the depth camera frame. Points are
+  stored row after row, so the point corresponding to the pixel (i, j) starts
+  at index <tt>(i * width + j) * stride</tt>.
+
+  The point cloud either owns its memory (see resize() and buildFrom()) or
+  simply wraps an external buffer without any copy (see init()). The latter
+  allows to give the data acquired by a depth sensor directly to the
+  model-based tracker, for instance a packed XYZ buffer (stride = 3) or
+  a buffer of padded points like <tt>pcl::PointXYZ</tt> (stride = 4). In that
+  case the external buffer must remain valid while the point cloud is used.
+
+  \code
+  const float *vertices = ...; // width * height packed XYZ points from the sensor
+  vpMbtPointCloud point_cloud(vertices, height, width);
+
+  std::map<std::string, const vpMbtPointCloud *> mapOfPointClouds;
+  mapOfPointClouds["Camera2"] = &point_cloud;
+  tracker.track(mapOfImages, mapOfPointClouds);
+  \endcode
+*/
+class VISP_EXPORT vpMbtPointCloud
+{
+public:
+  vpMbtPointCloud();
+  vpMbtPointCloud(const unsigned int height, const unsigned int width);
+  vpMbtPointCloud(const float *const data, const unsigned int height, const unsigned int width,
+                  const unsigned int stride = 3);
+  vpMbtPointCloud(const vpMbtPointCloud &pc);
+  virtual ~vpMbtPointCloud();
+
+  void buildFrom(const std::vector<vpColVector> &point_cloud, const unsigned int height, const unsigned int width);
+
+  //! Return a pointer to the first coordinate of the point cloud.
+  inline const float *getData() const { return m_data; }
+  float *getData();
+
+  //! Return the number of rows of the organized point cloud.
+  inline unsigned int getHeight() const { return m_height; }
+
+  //! Return the number of points in the point cloud.
+  inline unsigned int getSize() const { return m_width * m_height; }
+
+  //! Return the number of floats between two consecutive points.
+  inline unsigned int getStride() const { return m_stride; }
+
+  //! Return the number of columns of the organized point cloud.
+  inline unsigned int getWidth() const { return m_width; }
+
+  //! Return a pointer to the X, Y, Z coordinates of the point at pixel (\e i, \e j).
+  inline const float *getPoint(const unsigned int i, const unsigned int j) const
+  {
+    return m_data + ((size_t)i * m_width + j) * m_stride;
+  }
+
+  //! Return the depth of the point at pixel (\e i, \e j).
+  inline float getZ(const unsigned int i, const unsigned int j) const
+  {
+    return m_data[((size_t)i * m_width + j) * m_stride + 2];
+  }
+
+  void init(const float *const data, const unsigned int height, const unsigned int width,
+            const unsigned int stride = 3);
+
+  //! Return true if the point cloud owns its memory.
+  inline bool isOwner() const { return m_isOwner; }
+
+  vpMbtPointCloud &operator=(const vpMbtPointCloud &pc);
+
+  void resize(const unsigned int height, const unsigned int width);
+
+private:
+  //! Internal storage when the point cloud owns its memory
+  std::vector<float> m_buffer;
+  //! Pointer to the first coordinate, either in m_buffer or in an external buffer
+  const float *m_data;
+  //! Number of rows
+  unsigned int m_height;
+  //! True if the coordinates are stored in m_buffer
+  bool m_isOwner;
+  //! Number of floats between two consecutive points
+  unsigned int m_stride;
+  //! Number of columns
+  unsigned int m_width;
+};
+
+#endif
@@ -52,10 +52,50 @@
 #include <visp3/gui/vpDisplayX.h>
 #endif
 
+namespace
+{
+// Give each type of point cloud to the faces, so that
+// vpMbDepthDenseTracker::segmentPointCloudImpl() does not depend on it
+template <class PointCloud>
+bool computeDesiredFeatures(vpMbtFaceDepthDense *face, const vpHomogeneousMatrix &cMo, const PointCloud &point_cloud,
+                            const unsigned int, const unsigned int, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                            ,
+                            vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                            , const vpImage<bool> *mask)
+{
+  return face->computeDesiredFeatures(cMo, point_cloud, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                      ,
+                                      debugImage, roiPts_vec
+#endif
+                                      , mask);
+}
+
+bool computeDesiredFeatures(vpMbtFaceDepthDense *face, const vpHomogeneousMatrix &cMo,
+                            const std::vector<vpColVector> &point_cloud, const unsigned int width,
+                            const unsigned int height, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                            ,
+                            vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                            , const vpImage<bool> *mask)
+{
+  return face->computeDesiredFeatures(cMo, width, height, point_cloud, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                      ,
+                                      debugImage, roiPts_vec
+#endif
+                                      , mask);
+}
+}
+
 vpMbDepthDenseTracker::vpMbDepthDenseTracker()
-  : m_depthDenseHiddenFacesDisplay(), m_depthDenseI_dummyVisibility(), m_depthDenseListOfActiveFaces(),
-    m_denseDepthNbFeatures(0), m_depthDenseFaces(), m_depthDenseSamplingStepX(2), m_depthDenseSamplingStepY(2),
-    m_error_depthDense(), m_L_depthDense(), m_robust_depthDense(), m_w_depthDense(), m_weightedError_depthDense()
+  : m_depthDenseHiddenFacesDisplay(), m_depthDenseHiddenFacesDisplayOutdated(false), m_depthDenseI_dummyVisibility(),
+    m_depthDenseListOfActiveFaces(), m_denseDepthNbFeatures(0), m_depthDenseFaces(), m_depthDenseSamplingStepX(2),
+    m_depthDenseSamplingStepY(2), m_error_depthDense(), m_L_depthDense(), m_robust_depthDense(), m_w_depthDense(),
+    m_weightedError_depthDense()
 #if DEBUG_DISPLAY_DEPTH_DENSE
     ,
     m_debugDisp_depthDense(NULL), m_debugImage_depthDense()
@@ -89,8 +129,8 @@ void vpMbDepthDenseTracker::addFace(vpMbtPolygon &polygon, const bool alreadyClo
     return;
   }
 
-  // Copy hidden faces
-  m_depthDenseHiddenFacesDisplay = faces;
+  // The hidden faces are copied for display once all the faces are added
+  m_depthDenseHiddenFacesDisplayOutdated = true;
 
   vpMbtFaceDepthDense *normal_face = new vpMbtFaceDepthDense;
   normal_face->m_hiddenFace = &faces;
@@ -222,15 +262,12 @@ void vpMbDepthDenseTracker::computeVVS()
         m_weightedError_depthDense[i] = m_w_depthDense[i] * m_error_depthDense[i];
         num += m_w_depthDense[i] * vpMath::sqr(m_error_depthDense[i]);
         den += m_w_depthDense[i];
-
-        // weight interaction matrix
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_depthDense[i][j] *= m_w_depthDense[i];
-        }
       }
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthDense, LTL, m_weightedError_depthDense,
-                               m_error_depthDense, error_prev, LTR, mu, v);
+      // Accumulate the normal equations directly, the weighted interaction
+      // matrix is never built
+      computeVVSNormalEquations(m_L_depthDense, m_w_depthDense, m_error_depthDense, LTL, LTR);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthDense, error_prev, mu, v);
 
       cMo_prev = cMo;
       cMo = vpExponentialMap::direct(v).inverse() * cMo;
@@ -293,6 +330,11 @@ void vpMbDepthDenseTracker::display(const vpImage<unsigned char> &I, const vpHom
 {
   vpCameraParameters c = cam_;
 
+  if (m_depthDenseHiddenFacesDisplayOutdated) {
+    m_depthDenseHiddenFacesDisplay = faces;
+    m_depthDenseHiddenFacesDisplayOutdated = false;
+  }
+
   bool changed = false;
   m_depthDenseHiddenFacesDisplay.setVisible(I, c, cMo_, angleAppears, angleDisappears, changed);
 
@@ -320,6 +362,11 @@ void vpMbDepthDenseTracker::display(const vpImage<vpRGBa> &I, const vpHomogeneou
 {
   vpCameraParameters c = cam_;
 
+  if (m_depthDenseHiddenFacesDisplayOutdated) {
+    m_depthDenseHiddenFacesDisplay = faces;
+    m_depthDenseHiddenFacesDisplayOutdated = false;
+  }
+
   bool changed = false;
   vpImage<unsigned char> I_dummy;
   vpImageConvert::convert(I, I_dummy);
@@ -529,14 +576,15 @@ void vpMbDepthDenseTracker::setUseDepthDenseTracking(const std::string &name, co
 
 void vpMbDepthDenseTracker::testTracking() {}
 
-#ifdef VISP_HAVE_PCL
-void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+template <class PointCloud>
+void vpMbDepthDenseTracker::segmentPointCloudImpl(const PointCloud &point_cloud, const unsigned int width,
+                                                  const unsigned int height)
 {
   m_depthDenseListOfActiveFaces.clear();
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
   if (!m_debugDisp_depthDense->isInitialised()) {
-    m_debugImage_depthDense.resize(point_cloud->height, point_cloud->width);
+    m_debugImage_depthDense.resize(height, width);
     m_debugDisp_depthDense->init(m_debugImage_depthDense, 50, 0, "Debug display dense depth tracker");
   }
 
@@ -552,13 +600,14 @@ void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXY
 #if DEBUG_DISPLAY_DEPTH_DENSE
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
-      if (face->computeDesiredFeatures(cMo, point_cloud, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY
+      if (computeDesiredFeatures(face, cMo, point_cloud, width, height, m_depthDenseSamplingStepX,
+                                 m_depthDenseSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
+                                 ,
+                                 m_debugImage_depthDense, roiPts_vec_
 #endif
-                                       , m_mask
-                                       )) {
+                                 , m_mask
+                                 )) {
         m_depthDenseListOfActiveFaces.push_back(*it);
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
@@ -585,65 +634,34 @@ void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXY
   vpDisplay::flush(m_debugImage_depthDense);
 #endif
 }
+
+#ifdef VISP_HAVE_PCL
+void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+{
+  segmentPointCloudImpl(point_cloud, point_cloud->width, point_cloud->height);
+}
 #endif
 
 void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                               const unsigned int height)
 {
-  m_depthDenseListOfActiveFaces.clear();
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-  if (!m_debugDisp_depthDense->isInitialised()) {
-    m_debugImage_depthDense.resize(height, width);
-    m_debugDisp_depthDense->init(m_debugImage_depthDense, 50, 0, "Debug display dense depth tracker");
-  }
-
-  m_debugImage_depthDense = 0;
-  std::vector<std::vector<vpImagePoint> > roiPts_vec;
-#endif
-
-  for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
-       it != m_depthDenseFaces.end(); ++it) {
-    vpMbtFaceDepthDense *face = *it;
-
-    if (face->isVisible() && face->isTracked()) {
-#if DEBUG_DISPLAY_DEPTH_DENSE
-      std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, m_depthDenseSamplingStepX,
-                                       m_depthDenseSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
-        m_depthDenseListOfActiveFaces.push_back(*it);
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-        roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
-      }
-    }
-  }
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-  vpDisplay::display(m_debugImage_depthDense);
-
-  for (size_t i = 0; i < roiPts_vec.size(); i++) {
-    if (roiPts_vec[i].empty())
-      continue;
+  segmentPointCloudImpl(point_cloud, width, height);
+}
 
-    for (size_t j = 0; j < roiPts_vec[i].size() - 1; j++) {
-      vpDisplay::displayLine(m_debugImage_depthDense, roiPts_vec[i][j], roiPts_vec[i][j + 1], vpColor::red, 2);
-    }
-    vpDisplay::displayLine(m_debugImage_depthDense, roiPts_vec[i][0], roiPts_vec[i][roiPts_vec[i].size() - 1],
-                           vpColor::red, 2);
-  }
+void vpMbDepthDenseTracker::segmentPointCloud(const vpMbtPointCloud &point_cloud)
+{
+  segmentPointCloudImpl(point_cloud, point_cloud.getWidth(), point_cloud.getHeight());
+}
 
-  vpDisplay::flush(m_debugImage_depthDense);
+// vpMbGenericTracker segments the point clouds with segmentPointCloudImpl()
+#ifdef VISP_HAVE_PCL
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &,
+                                                           const unsigned int, const unsigned int);
 #endif
-}
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const std::vector<vpColVector> &, const unsigned int,
+                                                           const unsigned int);
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const vpMbtPointCloud &, const unsigned int,
+                                                           const unsigned int);
 
 void vpMbDepthDenseTracker::setCameraParameters(const vpCameraParameters &camera)
 {
@@ -718,6 +736,15 @@ void vpMbDepthDenseTracker::track(const std::vector<vpColVector> &point_cloud, c
   computeVisibility(width, height);
 }
 
+void vpMbDepthDenseTracker::track(const vpMbtPointCloud &point_cloud)
+{
+  segmentPointCloud(point_cloud);
+
+  computeVVS();
+
+  computeVisibility(point_cloud.getWidth(), point_cloud.getHeight());
+}
+
 void vpMbDepthDenseTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                        const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
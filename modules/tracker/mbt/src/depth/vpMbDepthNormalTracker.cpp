@@ -52,13 +52,54 @@
 #include <visp3/gui/vpDisplayX.h>
 #endif
 
+namespace
+{
+// Give each type of point cloud to the faces, so that
+// vpMbDepthNormalTracker::segmentPointCloudImpl() does not depend on it
+template <class PointCloud>
+bool computeDesiredFeatures(vpMbtFaceDepthNormal *face, const vpHomogeneousMatrix &cMo, const PointCloud &point_cloud,
+                            const unsigned int width, const unsigned int height, vpColVector &desired_features,
+                            const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                            ,
+                            vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                            , const vpImage<bool> *mask)
+{
+  return face->computeDesiredFeatures(cMo, width, height, point_cloud, desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                      ,
+                                      debugImage, roiPts_vec
+#endif
+                                      , mask);
+}
+
+bool computeDesiredFeatures(vpMbtFaceDepthNormal *face, const vpHomogeneousMatrix &cMo,
+                            const vpMbtPointCloud &point_cloud, const unsigned int, const unsigned int,
+                            vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                            ,
+                            vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                            , const vpImage<bool> *mask)
+{
+  return face->computeDesiredFeatures(cMo, point_cloud, desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                      ,
+                                      debugImage, roiPts_vec
+#endif
+                                      , mask);
+}
+}
+
 vpMbDepthNormalTracker::vpMbDepthNormalTracker()
   : m_depthNormalFeatureEstimationMethod(vpMbtFaceDepthNormal::ROBUST_FEATURE_ESTIMATION),
-    m_depthNormalHiddenFacesDisplay(), m_depthNormalI_dummyVisibility(), m_depthNormalListOfActiveFaces(),
-    m_depthNormalListOfDesiredFeatures(), m_depthNormalFaces(), m_depthNormalPclPlaneEstimationMethod(2),
-    m_depthNormalPclPlaneEstimationRansacMaxIter(200), m_depthNormalPclPlaneEstimationRansacThreshold(0.001),
-    m_depthNormalSamplingStepX(2), m_depthNormalSamplingStepY(2), m_depthNormalUseRobust(false), m_error_depthNormal(),
-    m_L_depthNormal(), m_robust_depthNormal(), m_w_depthNormal(), m_weightedError_depthNormal()
+    m_depthNormalHiddenFacesDisplay(), m_depthNormalHiddenFacesDisplayOutdated(false),
+    m_depthNormalI_dummyVisibility(), m_depthNormalListOfActiveFaces(), m_depthNormalListOfDesiredFeatures(),
+    m_depthNormalFaces(), m_depthNormalPclPlaneEstimationMethod(2), m_depthNormalPclPlaneEstimationRansacMaxIter(200),
+    m_depthNormalPclPlaneEstimationRansacThreshold(0.001), m_depthNormalSamplingStepX(2),
+    m_depthNormalSamplingStepY(2), m_depthNormalUseRobust(false), m_error_depthNormal(), m_L_depthNormal(),
+    m_robust_depthNormal(), m_w_depthNormal(), m_weightedError_depthNormal()
 #if DEBUG_DISPLAY_DEPTH_NORMAL
     ,
     m_debugDisp_depthNormal(NULL), m_debugImage_depthNormal()
@@ -88,8 +129,8 @@ void vpMbDepthNormalTracker::addFace(vpMbtPolygon &polygon, const bool alreadyCl
     return;
   }
 
-  // Copy hidden faces
-  m_depthNormalHiddenFacesDisplay = faces;
+  // The hidden faces are copied for display once all the faces are added
+  m_depthNormalHiddenFacesDisplayOutdated = true;
 
   vpMbtFaceDepthNormal *normal_face = new vpMbtFaceDepthNormal;
   normal_face->m_hiddenFace = &faces;
@@ -227,15 +268,12 @@ void vpMbDepthNormalTracker::computeVVS()
         m_weightedError_depthNormal[i] = m_w_depthNormal[i] * m_error_depthNormal[i];
         num += m_w_depthNormal[i] * vpMath::sqr(m_error_depthNormal[i]);
         den += m_w_depthNormal[i];
-
-        // weight interaction matrix
-        for (unsigned int j = 0; j < 6; j++) {
-          m_L_depthNormal[i][j] *= m_w_depthNormal[i];
-        }
       }
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L_depthNormal, LTL, m_weightedError_depthNormal,
-                               m_error_depthNormal, error_prev, LTR, mu, v);
+      // Accumulate the normal equations directly, the weighted interaction
+      // matrix is never built
+      computeVVSNormalEquations(m_L_depthNormal, m_w_depthNormal, m_error_depthNormal, LTL, LTR);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error_depthNormal, error_prev, mu, v);
 
       cMo_prev = cMo;
       cMo = vpExponentialMap::direct(v).inverse() * cMo;
@@ -289,6 +327,11 @@ void vpMbDepthNormalTracker::display(const vpImage<unsigned char> &I, const vpHo
 {
   vpCameraParameters c = cam_;
 
+  if (m_depthNormalHiddenFacesDisplayOutdated) {
+    m_depthNormalHiddenFacesDisplay = faces;
+    m_depthNormalHiddenFacesDisplayOutdated = false;
+  }
+
   bool changed = false;
   m_depthNormalHiddenFacesDisplay.setVisible(I, c, cMo_, angleAppears, angleDisappears, changed);
 
@@ -316,6 +359,11 @@ void vpMbDepthNormalTracker::display(const vpImage<vpRGBa> &I, const vpHomogeneo
 {
   vpCameraParameters c = cam_;
 
+  if (m_depthNormalHiddenFacesDisplayOutdated) {
+    m_depthNormalHiddenFacesDisplay = faces;
+    m_depthNormalHiddenFacesDisplayOutdated = false;
+  }
+
   bool changed = false;
   vpImage<unsigned char> I_dummy;
   vpImageConvert::convert(I, I_dummy);
@@ -533,15 +581,16 @@ void vpMbDepthNormalTracker::setUseDepthNormalTracking(const std::string &name,
 
 void vpMbDepthNormalTracker::testTracking() {}
 
-#ifdef VISP_HAVE_PCL
-void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+template <class PointCloud>
+void vpMbDepthNormalTracker::segmentPointCloudImpl(const PointCloud &point_cloud, const unsigned int width,
+                                                   const unsigned int height)
 {
   m_depthNormalListOfActiveFaces.clear();
   m_depthNormalListOfDesiredFeatures.clear();
 
 #if DEBUG_DISPLAY_DEPTH_NORMAL
   if (!m_debugDisp_depthNormal->isInitialised()) {
-    m_debugImage_depthNormal.resize(point_cloud->height, point_cloud->width);
+    m_debugImage_depthNormal.resize(height, width);
     m_debugDisp_depthNormal->init(m_debugImage_depthNormal, 50, 0, "Debug display normal depth tracker");
   }
 
@@ -559,14 +608,15 @@ void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointX
 #if DEBUG_DISPLAY_DEPTH_NORMAL
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
-      if (face->computeDesiredFeatures(cMo, point_cloud->width, point_cloud->height, point_cloud, desired_features,
-                                       m_depthNormalSamplingStepX, m_depthNormalSamplingStepY
+
+      if (computeDesiredFeatures(face, cMo, point_cloud, width, height, desired_features, m_depthNormalSamplingStepX,
+                                 m_depthNormalSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-                                       ,
-                                       m_debugImage_depthNormal, roiPts_vec_
+                                 ,
+                                 m_debugImage_depthNormal, roiPts_vec_
 #endif
-                                       , m_mask
-                                       )) {
+                                 , m_mask
+                                 )) {
         m_depthNormalListOfDesiredFeatures.push_back(desired_features);
         m_depthNormalListOfActiveFaces.push_back(face);
 
@@ -594,70 +644,34 @@ void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointX
   vpDisplay::flush(m_debugImage_depthNormal);
 #endif
 }
+
+#ifdef VISP_HAVE_PCL
+void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+{
+  segmentPointCloudImpl(point_cloud, point_cloud->width, point_cloud->height);
+}
 #endif
 
 void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                                const unsigned int height)
 {
-  m_depthNormalListOfActiveFaces.clear();
-  m_depthNormalListOfDesiredFeatures.clear();
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-  if (!m_debugDisp_depthNormal->isInitialised()) {
-    m_debugImage_depthNormal.resize(height, width);
-    m_debugDisp_depthNormal->init(m_debugImage_depthNormal, 50, 0, "Debug display normal depth tracker");
-  }
-
-  m_debugImage_depthNormal = 0;
-  std::vector<std::vector<vpImagePoint> > roiPts_vec;
-#endif
-
-  for (std::vector<vpMbtFaceDepthNormal *>::iterator it = m_depthNormalFaces.begin(); it != m_depthNormalFaces.end();
-       ++it) {
-    vpMbtFaceDepthNormal *face = *it;
-
-    if (face->isVisible() && face->isTracked()) {
-      vpColVector desired_features;
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-      std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
-
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, desired_features, m_depthNormalSamplingStepX,
-                                       m_depthNormalSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-                                       ,
-                                       m_debugImage_depthNormal, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
-        m_depthNormalListOfDesiredFeatures.push_back(desired_features);
-        m_depthNormalListOfActiveFaces.push_back(face);
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-        roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
-      }
-    }
-  }
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-  vpDisplay::display(m_debugImage_depthNormal);
-
-  for (size_t i = 0; i < roiPts_vec.size(); i++) {
-    if (roiPts_vec[i].empty())
-      continue;
+  segmentPointCloudImpl(point_cloud, width, height);
+}
 
-    for (size_t j = 0; j < roiPts_vec[i].size() - 1; j++) {
-      vpDisplay::displayLine(m_debugImage_depthNormal, roiPts_vec[i][j], roiPts_vec[i][j + 1], vpColor::red, 2);
-    }
-    vpDisplay::displayLine(m_debugImage_depthNormal, roiPts_vec[i][0], roiPts_vec[i][roiPts_vec[i].size() - 1],
-                           vpColor::red, 2);
-  }
+void vpMbDepthNormalTracker::segmentPointCloud(const vpMbtPointCloud &point_cloud)
+{
+  segmentPointCloudImpl(point_cloud, point_cloud.getWidth(), point_cloud.getHeight());
+}
 
-  vpDisplay::flush(m_debugImage_depthNormal);
+// vpMbGenericTracker segments the point clouds with segmentPointCloudImpl()
+#ifdef VISP_HAVE_PCL
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &,
+                                                            const unsigned int, const unsigned int);
 #endif
-}
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const std::vector<vpColVector> &, const unsigned int,
+                                                            const unsigned int);
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const vpMbtPointCloud &, const unsigned int,
+                                                            const unsigned int);
 
 void vpMbDepthNormalTracker::setCameraParameters(const vpCameraParameters &camera)
 {
@@ -759,6 +773,15 @@ void vpMbDepthNormalTracker::track(const std::vector<vpColVector> &point_cloud,
   computeVisibility(width, height);
 }
 
+void vpMbDepthNormalTracker::track(const vpMbtPointCloud &point_cloud)
+{
+  segmentPointCloud(point_cloud);
+
+  computeVVS();
+
+  computeVisibility(point_cloud.getWidth(), point_cloud.getHeight());
+}
+
 void vpMbDepthNormalTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                         const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
@@ -36,6 +36,8 @@
 #include <visp3/core/vpCPUFeatures.h>
 #include <visp3/mbt/vpMbtFaceDepthDense.h>
 
+#include "vpMbtPointAccessor.h"
+
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #include <emmintrin.h>
 #define VISP_HAVE_SSE2 1
@@ -137,22 +139,21 @@ void vpMbtFaceDepthDense::addLine(vpPoint &P1, vpPoint &P2, vpMbHiddenFaces<vpMb
   }
 }
 
-#ifdef VISP_HAVE_PCL
-bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
-                                                 const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud,
-                                                 const unsigned int stepX, const unsigned int stepY
+template <class PointAccessor>
+bool vpMbtFaceDepthDense::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const PointAccessor &points,
+                                                     const unsigned int stepX, const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-                                                 ,
-                                                 vpImage<unsigned char> &debugImage,
-                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
+                                                     ,
+                                                     vpImage<unsigned char> &debugImage,
+                                                     std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-                                                 , const vpImage<bool> *mask
+                                                     , const vpImage<bool> *mask
 )
 {
-  unsigned int width = point_cloud->width, height = point_cloud->height;
+  const unsigned int width = points.getWidth(), height = points.getHeight();
   m_pointCloudFace.clear();
 
-  if (point_cloud->width == 0 || point_cloud->height == 0)
+  if (width == 0 || height == 0)
     return false;
 
   std::vector<vpImagePoint> roiPts;
@@ -205,6 +206,7 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
 #endif
 
   int totalTheoreticalPoints = 0, totalPoints = 0;
+  double X = 0.0, Y = 0.0, Z = 0.0;
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
       if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
@@ -213,32 +215,32 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         totalTheoreticalPoints++;
 
-        if (vpMeTracker::inMask(mask, i, j) && pcl::isFinite((*point_cloud)(j, i)) && (*point_cloud)(j, i).z > 0) {
+        if (vpMeTracker::inMask(mask, i, j) && points.getPoint(i, j, X, Y, Z)) {
           totalPoints++;
 
           if (checkSSE2) {
 #if USE_SSE
             if (!push) {
               push = true;
-              prev_x = (*point_cloud)(j, i).x;
-              prev_y = (*point_cloud)(j, i).y;
-              prev_z = (*point_cloud)(j, i).z;
+              prev_x = X;
+              prev_y = Y;
+              prev_z = Z;
             } else {
               push = false;
               m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).x);
+              m_pointCloudFace.push_back(X);
 
               m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).y);
+              m_pointCloudFace.push_back(Y);
 
               m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).z);
+              m_pointCloudFace.push_back(Z);
             }
 #endif
           } else {
-            m_pointCloudFace.push_back((*point_cloud)(j, i).x);
-            m_pointCloudFace.push_back((*point_cloud)(j, i).y);
-            m_pointCloudFace.push_back((*point_cloud)(j, i).z);
+            m_pointCloudFace.push_back(X);
+            m_pointCloudFace.push_back(Y);
+            m_pointCloudFace.push_back(Z);
           }
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
@@ -264,10 +266,10 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
 
   return true;
 }
-#endif
 
-bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
-                                                 const unsigned int height, const std::vector<vpColVector> &point_cloud,
+#ifdef VISP_HAVE_PCL
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
+                                                 const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud,
                                                  const unsigned int stepX, const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
                                                  ,
@@ -277,115 +279,50 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
                                                  , const vpImage<bool> *mask
 )
 {
-  m_pointCloudFace.clear();
-
-  if (width == 0 || height == 0)
-    return 0;
-
-  std::vector<vpImagePoint> roiPts;
-  double distanceToFace;
-  computeROI(cMo, width, height, roiPts
+  return computeDesiredFeaturesImpl(cMo, vpMbtPclPointAccessor(point_cloud), stepX, stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-             ,
-             roiPts_vec
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-             ,
-             distanceToFace);
-
-  if (roiPts.size() <= 2) {
-#ifndef NDEBUG
-    std::cerr << "Error: roiPts.size() <= 2 in computeDesiredFeatures" << std::endl;
+                                    , mask);
+}
 #endif
-    return false;
-  }
-
-  if (((m_depthDenseFilteringMethod & MAX_DISTANCE_FILTERING) && distanceToFace > m_depthDenseFilteringMaxDist) ||
-      ((m_depthDenseFilteringMethod & MIN_DISTANCE_FILTERING) && distanceToFace < m_depthDenseFilteringMinDist)) {
-    return false;
-  }
-
-  vpPolygon polygon_2d(roiPts);
-  vpRect bb = polygon_2d.getBoundingBox();
-
-  unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
-  unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
-  unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
-  unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
 
-  bb.setTop(top);
-  bb.setBottom(bottom);
-  bb.setLeft(left);
-  bb.setRight(right);
-
-  m_pointCloudFace.reserve((size_t)(bb.getWidth() * bb.getHeight()));
-
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
-#else
-  bool push = false;
-  double prev_x = 0.0, prev_y = 0.0, prev_z = 0.0;
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                 const unsigned int height, const std::vector<vpColVector> &point_cloud,
+                                                 const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                 ,
+                                                 vpImage<unsigned char> &debugImage,
+                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-
-  int totalTheoreticalPoints = 0, totalPoints = 0;
-  for (unsigned int i = top; i < bottom; i += stepY) {
-    for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
-                         : polygon_2d.isInside(vpImagePoint(i, j)))) {
-        totalTheoreticalPoints++;
-
-        if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0) {
-          totalPoints++;
-
-          if (checkSSE2) {
-#if USE_SSE
-            if (!push) {
-              push = true;
-              prev_x = point_cloud[i * width + j][0];
-              prev_y = point_cloud[i * width + j][1];
-              prev_z = point_cloud[i * width + j][2];
-            } else {
-              push = false;
-              m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-
-              m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-
-              m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
-            }
+                                                 , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtColVectorPointAccessor(point_cloud, width, height), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-          } else {
-            m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
-          }
+                                    , mask);
+}
 
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtPointCloud &point_cloud,
+                                                 const unsigned int stepX, const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-          debugImage[i][j] = 255;
+                                                 ,
+                                                 vpImage<unsigned char> &debugImage,
+                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-        }
-      }
-    }
-  }
-
-#if USE_SSE
-  if (checkSSE2 && push) {
-    m_pointCloudFace.push_back(prev_x);
-    m_pointCloudFace.push_back(prev_y);
-    m_pointCloudFace.push_back(prev_z);
-  }
+                                                 , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtPointCloudAccessor(point_cloud), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-
-  if (totalPoints == 0 || ((m_depthDenseFilteringMethod & DEPTH_OCCUPANCY_RATIO_FILTERING) &&
-                           totalPoints / (double)totalTheoreticalPoints < m_depthDenseFilteringOccupancyRatio)) {
-    return false;
-  }
-
-  return true;
+                                    , mask);
 }
 
 void vpMbtFaceDepthDense::computeVisibility() { m_isVisible = m_polygon->isVisible(); }
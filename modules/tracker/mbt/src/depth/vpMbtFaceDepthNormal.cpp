@@ -37,6 +37,8 @@
 #include <visp3/mbt/vpMbtFaceDepthNormal.h>
 #include <visp3/mbt/vpMbtTukeyEstimator.h>
 
+#include "vpMbtPointAccessor.h"
+
 #ifdef VISP_HAVE_PCL
 #include <pcl/common/centroid.h>
 #include <pcl/filters/extract_indices.h>
@@ -307,21 +309,21 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 }
 #endif
 
-bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
-                                                  const unsigned int height,
-                                                  const std::vector<vpColVector> &point_cloud,
-                                                  vpColVector &desired_features, const unsigned int stepX,
-                                                  const unsigned int stepY
+template <class PointAccessor>
+bool vpMbtFaceDepthNormal::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const PointAccessor &points,
+                                                      vpColVector &desired_features, const unsigned int stepX,
+                                                      const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-                                                  ,
-                                                  vpImage<unsigned char> &debugImage,
-                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+                                                      ,
+                                                      vpImage<unsigned char> &debugImage,
+                                                      std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-                                                  , const vpImage<bool> *mask
+                                                      , const vpImage<bool> *mask
 )
 {
   m_faceActivated = false;
 
+  const unsigned int width = points.getWidth(), height = points.getHeight();
   if (width == 0 || height == 0)
     return false;
 
@@ -372,17 +374,18 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 #endif
 
   double x = 0.0, y = 0.0;
+  double X = 0.0, Y = 0.0, Z = 0.0;
   for (unsigned int i = top; i < bottom; i += stepY) {
     for (unsigned int j = left; j < right; j += stepX) {
-      if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0 &&
+      if (vpMeTracker::inMask(mask, i, j) && points.getPoint(i, j, X, Y, Z) &&
           (m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
                             j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
                             m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
                          : polygon_2d.isInside(vpImagePoint(i, j)))) {
         // Add point
-        point_cloud_face.push_back(point_cloud[i * width + j][0]);
-        point_cloud_face.push_back(point_cloud[i * width + j][1]);
-        point_cloud_face.push_back(point_cloud[i * width + j][2]);
+        point_cloud_face.push_back(X);
+        point_cloud_face.push_back(Y);
+        point_cloud_face.push_back(Z);
 
         if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
           // Add point for custom method for plane equation estimation
@@ -394,7 +397,7 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
               push = true;
               prev_x = x;
               prev_y = y;
-              prev_z = point_cloud[i * width + j][2];
+              prev_z = Z;
             } else {
               push = false;
               point_cloud_face_custom.push_back(prev_x);
@@ -404,13 +407,13 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
               point_cloud_face_custom.push_back(y);
 
               point_cloud_face_custom.push_back(prev_z);
-              point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
+              point_cloud_face_custom.push_back(Z);
             }
 #endif
           } else {
             point_cloud_face_custom.push_back(x);
             point_cloud_face_custom.push_back(y);
-            point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
+            point_cloud_face_custom.push_back(Z);
           }
         }
 
@@ -465,6 +468,47 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
   return true;
 }
 
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                  const unsigned int height,
+                                                  const std::vector<vpColVector> &point_cloud,
+                                                  vpColVector &desired_features, const unsigned int stepX,
+                                                  const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                  ,
+                                                  vpImage<unsigned char> &debugImage,
+                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                  , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtColVectorPointAccessor(point_cloud, width, height), desired_features,
+                                    stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                    ,
+                                    debugImage, roiPts_vec
+#endif
+                                    , mask);
+}
+
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpMbtPointCloud &point_cloud,
+                                                  vpColVector &desired_features, const unsigned int stepX,
+                                                  const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                  ,
+                                                  vpImage<unsigned char> &debugImage,
+                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                  , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtPointCloudAccessor(point_cloud), desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                    ,
+                                    debugImage, roiPts_vec
+#endif
+                                    , mask);
+}
+
 #ifdef VISP_HAVE_PCL
 bool vpMbtFaceDepthNormal::computeDesiredFeaturesPCL(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud_face,
                                                      vpColVector &desired_features, vpColVector &desired_normal,
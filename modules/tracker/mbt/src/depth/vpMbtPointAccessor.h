@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Uniform access to the points of the organized point clouds given to the
+ * depth features.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtPointAccessor_h_
+#define __vpMbtPointAccessor_h_
+
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/mbt/vpMbtPointCloud.h>
+
+#ifdef VISP_HAVE_PCL
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+  The depth features extract the points of a face the same way whatever the
+  type of the point cloud. Each accessor gives the size of the organized
+  point cloud and the point at pixel (i, j), getPoint() returning false when
+  there is no valid depth at this pixel.
+*/
+class vpMbtColVectorPointAccessor
+{
+public:
+  vpMbtColVectorPointAccessor(const std::vector<vpColVector> &point_cloud, const unsigned int width,
+                              const unsigned int height)
+    : m_pointCloud(point_cloud), m_width(width), m_height(height)
+  {
+  }
+
+  inline unsigned int getHeight() const { return m_height; }
+  inline unsigned int getWidth() const { return m_width; }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    const vpColVector &pt = m_pointCloud[(size_t)i * m_width + j];
+    if (pt[2] > 0) {
+      X = pt[0];
+      Y = pt[1];
+      Z = pt[2];
+      return true;
+    }
+    return false;
+  }
+
+private:
+  const std::vector<vpColVector> &m_pointCloud;
+  unsigned int m_width;
+  unsigned int m_height;
+};
+
+class vpMbtPointCloudAccessor
+{
+public:
+  explicit vpMbtPointCloudAccessor(const vpMbtPointCloud &point_cloud) : m_pointCloud(point_cloud) {}
+
+  inline unsigned int getHeight() const { return m_pointCloud.getHeight(); }
+  inline unsigned int getWidth() const { return m_pointCloud.getWidth(); }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    const float *const pt = m_pointCloud.getPoint(i, j);
+    if (pt[2] > 0) {
+      X = pt[0];
+      Y = pt[1];
+      Z = pt[2];
+      return true;
+    }
+    return false;
+  }
+
+private:
+  const vpMbtPointCloud &m_pointCloud;
+};
+
+#ifdef VISP_HAVE_PCL
+class vpMbtPclPointAccessor
+{
+public:
+  explicit vpMbtPclPointAccessor(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+    : m_pointCloud(point_cloud)
+  {
+  }
+
+  inline unsigned int getHeight() const { return m_pointCloud->height; }
+  inline unsigned int getWidth() const { return m_pointCloud->width; }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    const pcl::PointXYZ &pt = (*m_pointCloud)(j, i);
+    if (pcl::isFinite(pt) && pt.z > 0) {
+      X = pt.x;
+      Y = pt.y;
+      Z = pt.z;
+      return true;
+    }
+    return false;
+  }
+
+private:
+  const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &m_pointCloud;
+};
+#endif
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored as a contiguous array of float coordinates.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/mbt/vpMbtPointCloud.h>
+
+/*!
+  Default constructor, build an empty point cloud.
+*/
+vpMbtPointCloud::vpMbtPointCloud() : m_buffer(), m_data(NULL), m_height(0), m_isOwner(true), m_stride(3), m_width(0)
+{
+}
+
+/*!
+  Build a point cloud of \e height x \e width packed XYZ points that owns its
+  memory. Coordinates are initialized to zero.
+
+  \param height : Number of rows.
+  \param width : Number of columns.
+*/
+vpMbtPointCloud::vpMbtPointCloud(const unsigned int height, const unsigned int width)
+  : m_buffer(), m_data(NULL), m_height(0), m_isOwner(true), m_stride(3), m_width(0)
+{
+  resize(height, width);
+}
+
+/*!
+  Build a point cloud that wraps an external buffer. No copy is done.
+
+  \param data : Pointer to the first coordinate of the external buffer.
+  \param height : Number of rows.
+  \param width : Number of columns.
+  \param stride : Number of floats between two consecutive points (at least 3).
+
+  \sa init()
+*/
+vpMbtPointCloud::vpMbtPointCloud(const float *const data, const unsigned int height, const unsigned int width,
+                                 const unsigned int stride)
+  : m_buffer(), m_data(NULL), m_height(0), m_isOwner(true), m_stride(3), m_width(0)
+{
+  init(data, height, width, stride);
+}
+
+/*!
+  Copy constructor. If \e pc owns its memory the coordinates are copied,
+  otherwise the new point cloud wraps the same external buffer.
+*/
+vpMbtPointCloud::vpMbtPointCloud(const vpMbtPointCloud &pc)
+  : m_buffer(), m_data(NULL), m_height(0), m_isOwner(true), m_stride(3), m_width(0)
+{
+  *this = pc;
+}
+
+vpMbtPointCloud::~vpMbtPointCloud() {}
+
+/*!
+  Copy the content of a point cloud stored as a vector of vpColVector. The
+  point cloud then owns its memory and uses a stride of 3.
+
+  \param point_cloud : Point cloud where each vpColVector contains at least
+  the X, Y, Z coordinates.
+  \param height : Number of rows.
+  \param width : Number of columns.
+*/
+void vpMbtPointCloud::buildFrom(const std::vector<vpColVector> &point_cloud, const unsigned int height,
+                                const unsigned int width)
+{
+  if (point_cloud.size() != (size_t)height * width) {
+    throw vpException(vpException::dimensionError, "Point cloud size (%d) differs from %dx%d!",
+                      (int)point_cloud.size(), height, width);
+  }
+
+  resize(height, width);
+
+  float *ptr = &m_buffer[0];
+  for (size_t i = 0; i < point_cloud.size(); i++, ptr += 3) {
+    ptr[0] = (float)point_cloud[i][0];
+    ptr[1] = (float)point_cloud[i][1];
+    ptr[2] = (float)point_cloud[i][2];
+  }
+}
+
+/*!
+  Return a pointer to the first coordinate of the point cloud.
+
+  \exception vpException::fatalError : If the point cloud wraps an external
+  buffer, since this memory is read-only.
+*/
+float *vpMbtPointCloud::getData()
+{
+  if (!m_isOwner) {
+    throw vpException(vpException::fatalError, "Cannot get write access to an external point cloud buffer!");
+  }
+
+  return m_buffer.empty() ? NULL : &m_buffer[0];
+}
+
+/*!
+  Wrap an external buffer. No copy is done and the buffer must remain valid
+  while the point cloud is used.
+
+  \param data : Pointer to the first coordinate of the external buffer.
+  \param height : Number of rows.
+  \param width : Number of columns.
+  \param stride : Number of floats between two consecutive points (at least 3).
+*/
+void vpMbtPointCloud::init(const float *const data, const unsigned int height, const unsigned int width,
+                           const unsigned int stride)
+{
+  if (stride < 3) {
+    throw vpException(vpException::badValue, "Point cloud stride (%d) must be at least 3!", stride);
+  }
+
+  if (data == NULL && height * width > 0) {
+    throw vpException(vpException::fatalError, "Point cloud buffer is NULL!");
+  }
+
+  m_buffer.clear();
+  m_data = data;
+  m_height = height;
+  m_isOwner = false;
+  m_stride = stride;
+  m_width = width;
+}
+
+/*!
+  Copy operator. If \e pc owns its memory the coordinates are copied,
+  otherwise the point cloud wraps the same external buffer.
+*/
+vpMbtPointCloud &vpMbtPointCloud::operator=(const vpMbtPointCloud &pc)
+{
+  if (this != &pc) {
+    m_buffer = pc.m_buffer;
+    m_height = pc.m_height;
+    m_isOwner = pc.m_isOwner;
+    m_stride = pc.m_stride;
+    m_width = pc.m_width;
+    m_data = m_isOwner ? (m_buffer.empty() ? NULL : &m_buffer[0]) : pc.m_data;
+  }
+
+  return *this;
+}
+
+/*!
+  Resize the point cloud to \e height x \e width packed XYZ points. After this
+  call the point cloud owns its memory. The internal buffer is only
+  reallocated when its capacity is not sufficient.
+
+  \param height : Number of rows.
+  \param width : Number of columns.
+*/
+void vpMbtPointCloud::resize(const unsigned int height, const unsigned int width)
+{
+  m_buffer.resize((size_t)height * width * 3);
+  m_data = m_buffer.empty() ? NULL : &m_buffer[0];
+  m_height = height;
+  m_isOwner = true;
+  m_stride = 3;
+  m_width = width;
+}
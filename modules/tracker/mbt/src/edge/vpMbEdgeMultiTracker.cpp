@@ -147,18 +147,10 @@ vpMbEdgeMultiTracker::~vpMbEdgeMultiTracker()
 
 void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char> *> > &pyramid)
 {
+  // The images are owned by the edge tracker of each camera
   for (std::map<std::string, std::vector<const vpImage<unsigned char> *> >::iterator it1 = pyramid.begin();
        it1 != pyramid.end(); ++it1) {
-    if (it1->second.size() > 0) {
-      it1->second[0] = NULL;
-      for (size_t i = 1; i < it1->second.size(); i++) {
-        if (it1->second[i] != NULL) {
-          delete it1->second[i];
-          it1->second[i] = NULL;
-        }
-      }
-      it1->second.clear();
-    }
+    it1->second.clear();
   }
 }
 
@@ -1649,9 +1641,11 @@ void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage
 {
   for (std::map<std::string, const vpImage<unsigned char> *>::const_iterator it = mapOfImages.begin();
        it != mapOfImages.end(); ++it) {
-    pyramid[it->first].resize(scales.size());
-
-    vpMbEdgeTracker::initPyramid(*it->second, pyramid[it->first]);
+    // Each camera builds its pyramid in the level buffers of its own tracker
+    std::map<std::string, vpMbEdgeTracker *>::const_iterator it_edge = m_mapOfEdgeTrackers.find(it->first);
+    if (it_edge != m_mapOfEdgeTrackers.end()) {
+      it_edge->second->initPyramid(*it->second, pyramid[it->first]);
+    }
   }
 }
 
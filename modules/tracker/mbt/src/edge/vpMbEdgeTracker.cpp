@@ -67,8 +67,9 @@
   Basic constructor
 */
 vpMbEdgeTracker::vpMbEdgeTracker()
-  : me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0), nbvisiblepolygone(0),
-    percentageGdPt(0.4), scales(1), Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0), m_factor(),
+  : me(), lines(1), m_linesIndex(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0), nbvisiblepolygone(0),
+    percentageGdPt(0.4), scales(1), Ipyramid(0),
+    m_imagePyramid(vpImagePyramid::SUBSAMPLED_PYRAMID), scaleLevel(0), nbFeaturesForProjErrorComputation(0), m_factor(),
     m_robustLines(), m_robustCylinders(), m_robustCircles(), m_wLines(), m_wCylinders(), m_wCircles(), m_errorLines(),
     m_errorCylinders(), m_errorCircles(), m_L_edge(), m_error_edge(), m_w_edge(), m_weightedError_edge(),
     m_robust_edge()
@@ -120,6 +121,7 @@ vpMbEdgeTracker::~vpMbEdgeTracker()
       }
 
       lines[i].clear();
+      m_linesIndex[i].clear();
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -232,7 +234,6 @@ void vpMbEdgeTracker::computeVVS(const vpImage<unsigned char> &_I, const unsigne
     if (!reStartFromLastIncrement) {
       computeVVSWeights();
 
-      L_true = m_L_edge;
       vpVelocityTwistMatrix cVo;
 
       if (computeCovariance) {
@@ -1031,7 +1032,29 @@ void vpMbEdgeTracker::testTracking()
  */
 void vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
 {
-  initPyramid(I, Ipyramid);
+  m_imagePyramid.build(I, scales);
+  track(m_imagePyramid);
+}
+
+/*!
+  Compute each state of the tracking procedure for all the feature sets,
+  using an image pyramid that may be shared with other trackers.
+
+  The pyramid must have at least as many levels as the scales used by the
+  tracker (see setScales()), and the levels of the used scales must be
+  computed, which is the case with vpImagePyramid::build(I, getScales()).
+  Level 0 is the tracked image. A pyramid of type
+  vpImagePyramid::SUBSAMPLED_PYRAMID gives the same results than
+  track(const vpImage<unsigned char> &).
+
+  If the tracking is considered as failed an exception is thrown.
+
+  \param pyramid : The image pyramid.
+ */
+void vpMbEdgeTracker::track(const vpImagePyramid &pyramid)
+{
+  initPyramid(pyramid, Ipyramid);
+  const vpImage<unsigned char> &I = pyramid[0];
 
   //  for (int lvl = ((int)scales.size()-1); lvl >= 0; lvl -= 1)
   unsigned int lvl = (unsigned int)scales.size();
@@ -1832,18 +1855,17 @@ void vpMbEdgeTracker::addLine(vpPoint &P1, vpPoint &P2, int polygon, std::string
     // suppress line already in the model
     bool already_here = false;
     vpMbtDistanceLine *l;
+    std::vector<vpMbtDistanceLine *> sameLines;
 
     for (unsigned int i = 0; i < scales.size(); i += 1) {
       if (scales[i]) {
         downScale(i);
-        for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[i].begin(); it != lines[i].end(); ++it) {
+        findSameLines(m_linesIndex[i], P1, P2, sameLines);
+        for (std::vector<vpMbtDistanceLine *>::const_iterator it = sameLines.begin(); it != sameLines.end(); ++it) {
           l = *it;
-          if ((samePoint(*(l->p1), P1) && samePoint(*(l->p2), P2)) ||
-              (samePoint(*(l->p1), P2) && samePoint(*(l->p2), P1))) {
-            already_here = true;
-            l->addPolygon(polygon);
-            l->hiddenface = &faces;
-          }
+          already_here = true;
+          l->addPolygon(polygon);
+          l->hiddenface = &faces;
         }
 
         if (!already_here) {
@@ -1870,6 +1892,8 @@ void vpMbEdgeTracker::addLine(vpPoint &P1, vpPoint &P2, int polygon, std::string
 
           nline += 1;
           lines[i].push_back(l);
+          double tolerance = 0;
+          m_linesIndex[i].insert(std::make_pair(getLineKey(P1, P2, tolerance), l));
         }
         upScale(i);
       }
@@ -1892,6 +1916,13 @@ void vpMbEdgeTracker::removeLine(const std::string &name)
         l = *it;
         if (name.compare(l->getName()) == 0) {
           lines[i].erase(it);
+          for (std::multimap<double, vpMbtDistanceLine *>::iterator it_index = m_linesIndex[i].begin();
+               it_index != m_linesIndex[i].end(); ++it_index) {
+            if (it_index->second == l) {
+              m_linesIndex[i].erase(it_index);
+              break;
+            }
+          }
           break;
         }
       }
@@ -2266,6 +2297,7 @@ void vpMbEdgeTracker::resetTracker()
         ci = NULL;
       }
       lines[i].clear();
+      m_linesIndex[i].clear();
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -2342,6 +2374,7 @@ void vpMbEdgeTracker::reInitModel(const vpImage<unsigned char> &I, const std::st
       }
 
       lines[i].clear();
+      m_linesIndex[i].clear();
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -2464,6 +2497,8 @@ void vpMbEdgeTracker::setScales(const std::vector<bool> &scale)
 
     lines.resize(1);
     lines[0].clear();
+    m_linesIndex.resize(1);
+    m_linesIndex[0].clear();
 
     cylinders.resize(1);
     cylinders[0].clear();
@@ -2474,11 +2509,13 @@ void vpMbEdgeTracker::setScales(const std::vector<bool> &scale)
     this->scales = scale;
 
     lines.resize(scale.size());
+    m_linesIndex.resize(scale.size());
     cylinders.resize(scale.size());
     circles.resize(scale.size());
 
     for (unsigned int i = 0; i < lines.size(); i++) {
       lines[i].clear();
+      m_linesIndex[i].clear();
       cylinders[i].clear();
       circles[i].clear();
     }
@@ -2571,13 +2608,11 @@ void vpMbEdgeTracker::setClipping(const unsigned int &flags)
 /*!
   Compute the pyramid of image associated to the image in parameter. The
   scales computed are the ones corresponding to the scales  attribute of the
-  class. If OpenCV is detected, the functions used to computed a smoothed
-  pyramid come from OpenCV, otherwise a simple subsampling (no smoothing, no
-  interpolation) is realized.
+  class. The levels are obtained by a simple subsampling (no smoothing, no
+  interpolation) and their memory is reused from one call to the other.
 
-  \warning The pyramid contains pointers to vpImage. To properly deallocate
-  the pyramid. All the element but the first (which is a pointer to the input
-  image) must be freed. A proper cleaning is implemented in the cleanPyramid()
+  \warning The pyramid contains pointers to the input image and to levels
+  owned by the tracker. They remain valid until the next call to this
   method.
 
   \param _I : The input image.
@@ -2586,61 +2621,42 @@ void vpMbEdgeTracker::setClipping(const unsigned int &flags)
 void vpMbEdgeTracker::initPyramid(const vpImage<unsigned char> &_I,
                                   std::vector<const vpImage<unsigned char> *> &_pyramid)
 {
-  _pyramid.resize(scales.size());
+  m_imagePyramid.build(_I, scales);
+  initPyramid(m_imagePyramid, _pyramid);
+}
 
-  if (scales[0]) {
-    _pyramid[0] = &_I;
-  } else {
-    _pyramid[0] = NULL;
+/*!
+  Get the levels of an image pyramid corresponding to the scales attribute of
+  the class. The levels that are not used are set to NULL.
+
+  \param pyramid : The image pyramid, with at least as many levels as scales.
+  \param _pyramid : Pointers to the levels of \e pyramid.
+
+  \exception vpException::dimensionError : If the pyramid has not enough
+  levels or if the level of a used scale is not computed.
+*/
+void vpMbEdgeTracker::initPyramid(const vpImagePyramid &pyramid,
+                                  std::vector<const vpImage<unsigned char> *> &_pyramid)
+{
+  if (pyramid.getNbLevels() < scales.size()) {
+    throw vpException(vpException::dimensionError, "The image pyramid has %d levels while %d scales are used",
+                      pyramid.getNbLevels(), (int)scales.size());
   }
 
-  for (unsigned int i = 1; i < _pyramid.size(); i += 1) {
-    if (scales[i]) {
-      unsigned int cScale = static_cast<unsigned int>(pow(2., (int)i));
-      vpImage<unsigned char> *I = new vpImage<unsigned char>(_I.getHeight() / cScale, _I.getWidth() / cScale);
-#if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408))
-      IplImage *vpI0 = cvCreateImageHeader(cvSize((int)_I.getWidth(), (int)_I.getHeight()), IPL_DEPTH_8U, 1);
-      vpI0->imageData = (char *)(_I.bitmap);
-      IplImage *vpI =
-          cvCreateImage(cvSize((int)(_I.getWidth() / cScale), (int)(_I.getHeight() / cScale)), IPL_DEPTH_8U, 1);
-      cvResize(vpI0, vpI, CV_INTER_NN);
-      vpImageConvert::convert(vpI, *I);
-      cvReleaseImage(&vpI);
-      vpI0->imageData = NULL;
-      cvReleaseImageHeader(&vpI0);
-#else
-      for (unsigned int k = 0, ii = 0; k < I->getHeight(); k += 1, ii += cScale) {
-        for (unsigned int l = 0, jj = 0; l < I->getWidth(); l += 1, jj += cScale) {
-          (*I)[k][l] = _I[ii][jj];
-        }
-      }
-#endif
-      _pyramid[i] = I;
-    } else {
-      _pyramid[i] = NULL;
-    }
+  _pyramid.resize(scales.size());
+  for (unsigned int i = 0; i < _pyramid.size(); i += 1) {
+    _pyramid[i] = scales[i] ? &pyramid[i] : NULL;
   }
 }
 
 /*!
-  Clean the pyramid of image allocated with the initPyramid() method. The
+  Clean the pyramid of image built with the initPyramid() method. The images
+  are owned by the tracker or by the vpImagePyramid and are not freed. The
   vector has a size equal to zero at the end of the method.
 
   \param _pyramid : The pyramid of image to clean.
 */
-void vpMbEdgeTracker::cleanPyramid(std::vector<const vpImage<unsigned char> *> &_pyramid)
-{
-  if (_pyramid.size() > 0) {
-    _pyramid[0] = NULL;
-    for (unsigned int i = 1; i < _pyramid.size(); i += 1) {
-      if (_pyramid[i] != NULL) {
-        delete _pyramid[i];
-        _pyramid[i] = NULL;
-      }
-    }
-    _pyramid.resize(0);
-  }
-}
+void vpMbEdgeTracker::cleanPyramid(std::vector<const vpImage<unsigned char> *> &_pyramid) { _pyramid.clear(); }
 
 /*!
   Get the list of the lines tracked for the specified level. Each line
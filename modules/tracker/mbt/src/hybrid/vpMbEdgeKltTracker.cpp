@@ -1276,6 +1276,7 @@ void vpMbEdgeKltTracker::reInitModel(const vpImage<unsigned char> &I, const std:
         }
 
         lines[i].clear();
+        m_linesIndex[i].clear();
         cylinders[i].clear();
         circles[i].clear();
       }
@@ -160,7 +160,12 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   c0Mo = cMo;
   ctTc0.eye();
 
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+  // No copy: the KLT tracker keeps its own copy of the image
+  vpImageConvert::convert(I, cur, false);
+#else
   vpImageConvert::convert(I, cur);
+#endif
 
   cam.computeFov(I.getWidth(), I.getHeight());
 
@@ -180,7 +185,12 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   vpMbtDistanceKltPoints *kltpoly;
   vpMbtDistanceKltCylinder *kltPolyCylinder;
   if (useScanLine) {
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+    // The mask of the renderer is only read
+    vpImageConvert::convert(faces.getMbScanLineRenderer().getMask(), mask, false);
+#else
     vpImageConvert::convert(faces.getMbScanLineRenderer().getMask(), mask);
+#endif
   } else {
     unsigned char val = 255 /* - i*15*/;
     for (std::list<vpMbtDistanceKltPoints *>::const_iterator it = kltPolygons.begin(); it != kltPolygons.end(); ++it) {
@@ -485,18 +495,9 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> &I, const vpHomogeneou
         vpMatrix cdGc = cam.get_K() * cdHc * cam.get_K_inverse();
 
         // Points displacement
-        std::map<int, vpImagePoint>::const_iterator iter = kltpoly->getCurrentPoints().begin();
-        // nbCur+= (unsigned int)kltpoly->getCurrentPoints().size();
-        for (; iter != kltpoly->getCurrentPoints().end(); ++iter) {
+        for (unsigned int k = 0; k < kltpoly->getCurrentNumberPoints(); k++) {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-#if TARGET_OS_IPHONE
-          if (std::find(init_ids.begin(), init_ids.end(), (long)(kltpoly->getCurrentPointsInd())[(int)iter->first]) !=
-              init_ids.end())
-#else
-          if (std::find(init_ids.begin(), init_ids.end(),
-                        (long)(kltpoly->getCurrentPointsInd())[(size_t)iter->first]) != init_ids.end())
-#endif
-          {
+          if (std::find(init_ids.begin(), init_ids.end(), (long)kltpoly->getCurrentPointInd(k)) != init_ids.end()) {
             // KLT point already processed (a KLT point can exist in another
             // vpMbtDistanceKltPoints due to possible overlapping faces)
             continue;
@@ -504,22 +505,18 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> &I, const vpHomogeneou
 #endif
 
           vpColVector cdp(3);
-          cdp[0] = iter->second.get_j();
-          cdp[1] = iter->second.get_i();
+          cdp[0] = kltpoly->getCurrentPoint(k).get_j();
+          cdp[1] = kltpoly->getCurrentPoint(k).get_i();
           cdp[2] = 1.0;
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
           cv::Point2f p((float)cdp[0], (float)cdp[1]);
           init_pts.push_back(p);
-#if TARGET_OS_IPHONE
-          init_ids.push_back((size_t)(kltpoly->getCurrentPointsInd())[(int)iter->first]);
-#else
-          init_ids.push_back((size_t)(kltpoly->getCurrentPointsInd())[(size_t)iter->first]);
-#endif
+          init_ids.push_back((long)kltpoly->getCurrentPointInd(k));
 #else
           init_pts[iter_pts].x = (float)cdp[0];
           init_pts[iter_pts].y = (float)cdp[1];
-          init_ids[iter_pts] = (kltpoly->getCurrentPointsInd())[(size_t)iter->first];
+          init_ids[iter_pts] = kltpoly->getCurrentPointInd(k);
 #endif
 
           double p_mu_t_2 = cdp[0] * cdGc[2][0] + cdp[1] * cdGc[2][1] + cdGc[2][2];
@@ -545,7 +542,11 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> &I, const vpHomogeneou
       }
     }
 
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+    vpImageConvert::convert(I, cur, false);
+#else
     vpImageConvert::convert(I, cur);
+#endif
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
     tracker.setInitialGuess(init_pts, guess_pts, init_ids);
@@ -636,7 +637,11 @@ void vpMbKltTracker::initFaceFromLines(vpMbtPolygon &polygon)
 */
 void vpMbKltTracker::preTracking(const vpImage<unsigned char> &I)
 {
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+  vpImageConvert::convert(I, cur, false);
+#else
   vpImageConvert::convert(I, cur);
+#endif
   tracker.track(cur);
 
   m_nbInfos = 0;
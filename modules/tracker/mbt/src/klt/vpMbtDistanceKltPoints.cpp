@@ -37,6 +37,8 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+
 #include <visp3/core/vpPolygon.h>
 #include <visp3/mbt/vpMbtDistanceKltPoints.h>
 #include <visp3/me/vpMeTracker.h>
@@ -47,17 +49,13 @@
 #include <clipper.hpp> // clipper private library
 #endif
 
-#if defined(__APPLE__) && defined(__MACH__) // Apple OSX and iOS (Darwin)
-#include <TargetConditionals.h>             // To detect OSX or IOS using TARGET_OS_IPHONE or TARGET_OS_IOS macro
-#endif
-
 /*!
   Basic constructor.
 
 */
 vpMbtDistanceKltPoints::vpMbtDistanceKltPoints()
-  : H(), N(), N_cur(), invd0(1.), cRc0_0n(), initPoints(std::map<int, vpImagePoint>()),
-    curPoints(std::map<int, vpImagePoint>()), curPointsInd(std::map<int, int>()), nbPointsCur(0), nbPointsInit(0),
+  : H(), N(), N_cur(), invd0(1.), cRc0_0n(), initPointsId(), initPoints(), curPointsId(), curPoints(),
+    curPointsInd(), curPointsInit(), curPointsMap(), curPointsIndMap(), nbPointsCur(0), nbPointsInit(0),
     minNbPoint(4), enoughPoints(false), dt(1.), d0(1.), cam(), isTrackedKltPoints(true), polygon(NULL),
     hiddenface(NULL), useScanLine(false)
 {
@@ -82,9 +80,9 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
   // extract ids of the points in the face
   nbPointsInit = 0;
   nbPointsCur = 0;
-  initPoints = std::map<int, vpImagePoint>();
-  curPoints = std::map<int, vpImagePoint>();
-  curPointsInd = std::map<int, int>();
+  curPointsId.clear();
+  curPoints.clear();
+  curPointsInd.clear();
   std::vector<vpImagePoint> roi;
   polygon->getRoiClipped(cam, roi);
 
@@ -110,17 +108,18 @@ void vpMbtDistanceKltPoints::init(const vpKltOpencv &_tracker, const vpImage<boo
     }
 
     if (add) {
-#if TARGET_OS_IPHONE
-      initPoints[(int)id] = vpImagePoint(y_tmp, x_tmp);
-      curPoints[(int)id] = vpImagePoint(y_tmp, x_tmp);
-      curPointsInd[(int)id] = (int)i;
-#else
-      initPoints[id] = vpImagePoint(y_tmp, x_tmp);
-      curPoints[id] = vpImagePoint(y_tmp, x_tmp);
-      curPointsInd[id] = (int)i;
-#endif
+      curPointsId.push_back((int)id);
+      curPoints.push_back(vpImagePoint(y_tmp, x_tmp));
+      curPointsInd.push_back((int)i);
     }
   }
+  sortCurrentPoints();
+
+  initPointsId = curPointsId;
+  initPoints = curPoints;
+  curPointsInit.resize(curPointsId.size());
+  for (unsigned int k = 0; k < curPointsInit.size(); k++)
+    curPointsInit[k] = k;
 
   nbPointsInit = (unsigned int)initPoints.size();
   nbPointsCur = (unsigned int)curPoints.size();
@@ -155,21 +154,20 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
   long id;
   float x, y;
   nbPointsCur = 0;
-  curPoints = std::map<int, vpImagePoint>();
-  curPointsInd = std::map<int, int>();
+  curPointsId.clear();
+  curPoints.clear();
+  curPointsInd.clear();
 
   for (unsigned int i = 0; i < static_cast<unsigned int>(_tracker.getNbFeatures()); i++) {
     _tracker.getFeature((int)i, id, x, y);
     if (isTrackedFeature((int)id) && vpMeTracker::inMask(mask, y, x)) {
-#if TARGET_OS_IPHONE
-      curPoints[(int)id] = vpImagePoint(static_cast<double>(y), static_cast<double>(x));
-      curPointsInd[(int)id] = (int)i;
-#else
-      curPoints[id] = vpImagePoint(static_cast<double>(y), static_cast<double>(x));
-      curPointsInd[id] = (int)i;
-#endif
+      curPointsId.push_back((int)id);
+      curPoints.push_back(vpImagePoint(static_cast<double>(y), static_cast<double>(x)));
+      curPointsInd.push_back((int)i);
     }
   }
+  sortCurrentPoints();
+  updateCurrentPointsInit();
 
   nbPointsCur = (unsigned int)curPoints.size();
 
@@ -193,17 +191,15 @@ unsigned int vpMbtDistanceKltPoints::computeNbDetectedCurrent(const vpKltOpencv
 */
 void vpMbtDistanceKltPoints::computeInteractionMatrixAndResidu(vpColVector &_R, vpMatrix &_J)
 {
-  unsigned int index_ = 0;
-
-  std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
-    int id(iter->first);
-    double i_cur(iter->second.get_i()), j_cur(iter->second.get_j());
+  // The current points and their initial points are stored contiguously: no
+  // lookup by ID
+  for (unsigned int index_ = 0; index_ < curPoints.size(); index_++) {
+    double i_cur(curPoints[index_].get_i()), j_cur(curPoints[index_].get_j());
 
     double x_cur(0), y_cur(0);
     vpPixelMeterConversion::convertPoint(cam, j_cur, i_cur, x_cur, y_cur);
 
-    vpImagePoint iP0 = initPoints[id];
+    const vpImagePoint &iP0 = initPoints[curPointsInit[index_]];
     double x0(0), y0(0);
     vpPixelMeterConversion::convertPoint(cam, iP0, x0, y0);
 
@@ -213,23 +209,24 @@ void vpMbtDistanceKltPoints::computeInteractionMatrixAndResidu(vpColVector &_R,
 
     double invZ = compute_1_over_Z(x_cur, y_cur);
 
-    _J[2 * index_][0] = -invZ;
-    _J[2 * index_][1] = 0;
-    _J[2 * index_][2] = x_cur * invZ;
-    _J[2 * index_][3] = x_cur * y_cur;
-    _J[2 * index_][4] = -(1 + x_cur * x_cur);
-    _J[2 * index_][5] = y_cur;
-
-    _J[2 * index_ + 1][0] = 0;
-    _J[2 * index_ + 1][1] = -invZ;
-    _J[2 * index_ + 1][2] = y_cur * invZ;
-    _J[2 * index_ + 1][3] = (1 + y_cur * y_cur);
-    _J[2 * index_ + 1][4] = -y_cur * x_cur;
-    _J[2 * index_ + 1][5] = -x_cur;
+    double *J_x = _J[2 * index_];
+    double *J_y = _J[2 * index_ + 1];
+    J_x[0] = -invZ;
+    J_x[1] = 0;
+    J_x[2] = x_cur * invZ;
+    J_x[3] = x_cur * y_cur;
+    J_x[4] = -(1 + x_cur * x_cur);
+    J_x[5] = y_cur;
+
+    J_y[0] = 0;
+    J_y[1] = -invZ;
+    J_y[2] = y_cur * invZ;
+    J_y[3] = (1 + y_cur * y_cur);
+    J_y[4] = -y_cur * x_cur;
+    J_y[5] = -x_cur;
 
     _R[2 * index_] = (x0_transform - x_cur);
     _R[2 * index_ + 1] = (y0_transform - y_cur);
-    index_++;
   }
 }
 
@@ -327,19 +324,100 @@ void vpMbtDistanceKltPoints::computeHomography(const vpHomogeneousMatrix &_cTc0,
 */
 bool vpMbtDistanceKltPoints::isTrackedFeature(const int _id)
 {
-  //   std::map<int, vpImagePoint>::const_iterator iter = initPoints.begin();
-  //   while(iter != initPoints.end()){
-  //     if(iter->first == _id){
-  //       return true;
-  //     }
-  //     iter++;
-  //   }
-
-  std::map<int, vpImagePoint>::iterator iter = initPoints.find(_id);
-  if (iter != initPoints.end())
-    return true;
-
-  return false;
+  return std::binary_search(initPointsId.begin(), initPointsId.end(), _id);
+}
+
+/*!
+  Sort the current points by increasing ID. As in a map, only the last
+  feature of the KLT tracker is kept when several features have the same ID.
+*/
+void vpMbtDistanceKltPoints::sortCurrentPoints()
+{
+  // The features of the KLT tracker are usually already sorted
+  bool sorted = true;
+  for (size_t k = 1; k < curPointsId.size() && sorted; k++) {
+    sorted = curPointsId[k - 1] < curPointsId[k];
+  }
+  if (sorted) {
+    return;
+  }
+
+  // Sorted by ID, then by position in the KLT tracker
+  std::vector<std::pair<int, size_t> > order(curPointsId.size());
+  for (size_t k = 0; k < curPointsId.size(); k++) {
+    order[k] = std::make_pair(curPointsId[k], k);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<int> ids, inds;
+  std::vector<vpImagePoint> pts;
+  ids.reserve(order.size());
+  inds.reserve(order.size());
+  pts.reserve(order.size());
+  for (size_t k = 0; k < order.size(); k++) {
+    if (k + 1 < order.size() && order[k + 1].first == order[k].first) {
+      continue;
+    }
+    ids.push_back(order[k].first);
+    pts.push_back(curPoints[order[k].second]);
+    inds.push_back(curPointsInd[order[k].second]);
+  }
+
+  curPointsId.swap(ids);
+  curPoints.swap(pts);
+  curPointsInd.swap(inds);
+}
+
+/*!
+  Compute the indexes of the current points in the list of initial points.
+  Both lists being sorted by ID, a single pass is needed.
+*/
+void vpMbtDistanceKltPoints::updateCurrentPointsInit()
+{
+  curPointsInit.resize(curPointsId.size());
+  unsigned int j = 0;
+  for (size_t k = 0; k < curPointsId.size(); k++) {
+    while (initPointsId[j] < curPointsId[k]) {
+      j++;
+    }
+    curPointsInit[k] = j;
+  }
+}
+
+/*!
+  Get the current points and their ID.
+
+  \note The map is built from the internal storage of the face at each call,
+  a modification of the map is not taken into account. Prefer
+  getCurrentPoint() and getCurrentPointId() that do not build the map.
+
+  \return The current points indexed by their ID.
+*/
+std::map<int, vpImagePoint> &vpMbtDistanceKltPoints::getCurrentPoints()
+{
+  curPointsMap.clear();
+  for (size_t k = 0; k < curPointsId.size(); k++) {
+    curPointsMap[curPointsId[k]] = curPoints[k];
+  }
+  return curPointsMap;
+}
+
+/*!
+  Get the indexes in the KLT tracker of the current points.
+
+  \note The map is built from the internal storage of the face at each call,
+  a modification of the map is not taken into account. Prefer
+  getCurrentPointInd() and getCurrentPointId() that do not build the map.
+
+  \return The indexes of the current points indexed by their ID.
+*/
+std::map<int, int> &vpMbtDistanceKltPoints::getCurrentPointsInd()
+{
+  curPointsIndMap.clear();
+  for (size_t k = 0; k < curPointsId.size(); k++) {
+    curPointsIndMap[curPointsId[k]] = curPointsInd[k];
+  }
+  return curPointsIndMap;
 }
 
 /*!
@@ -506,30 +584,45 @@ void vpMbtDistanceKltPoints::updateMask(
 */
 void vpMbtDistanceKltPoints::removeOutliers(const vpColVector &_w, const double &threshold_outlier)
 {
-  std::map<int, vpImagePoint> tmp;
-  std::map<int, int> tmp2;
   unsigned int nbSupp = 0;
   unsigned int k = 0;
 
+  // The inliers are moved to the front of the arrays
+  std::vector<bool> removedInit(initPointsId.size(), false);
   nbPointsCur = 0;
-  std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
+  for (unsigned int n = 0; n < curPointsId.size(); n++) {
     if (_w[k] > threshold_outlier && _w[k + 1] > threshold_outlier) {
       //     if(_w[k] > threshold_outlier || _w[k+1] > threshold_outlier){
-      tmp[iter->first] = vpImagePoint(iter->second.get_i(), iter->second.get_j());
-      tmp2[iter->first] = curPointsInd[iter->first];
+      curPointsId[nbPointsCur] = curPointsId[n];
+      curPoints[nbPointsCur] = curPoints[n];
+      curPointsInd[nbPointsCur] = curPointsInd[n];
+      curPointsInit[nbPointsCur] = curPointsInit[n];
       nbPointsCur++;
     } else {
       nbSupp++;
-      initPoints.erase(iter->first);
+      removedInit[curPointsInit[n]] = true;
     }
 
     k += 2;
   }
 
   if (nbSupp != 0) {
-    curPoints = tmp;
-    curPointsInd = tmp2;
+    curPointsId.resize(nbPointsCur);
+    curPoints.resize(nbPointsCur);
+    curPointsInd.resize(nbPointsCur);
+
+    unsigned int nbInit = 0;
+    for (unsigned int j = 0; j < initPointsId.size(); j++) {
+      if (!removedInit[j]) {
+        initPointsId[nbInit] = initPointsId[j];
+        initPoints[nbInit] = initPoints[j];
+        nbInit++;
+      }
+    }
+    initPointsId.resize(nbInit);
+    initPoints.resize(nbInit);
+    updateCurrentPointsInit();
+
     if (nbPointsCur >= minNbPoint)
       enoughPoints = true;
     else
@@ -544,12 +637,11 @@ void vpMbtDistanceKltPoints::removeOutliers(const vpColVector &_w, const double
 */
 void vpMbtDistanceKltPoints::displayPrimitive(const vpImage<unsigned char> &_I)
 {
-  std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
-    int id(iter->first);
+  for (size_t k = 0; k < curPoints.size(); k++) {
+    int id(curPointsId[k]);
     vpImagePoint iP;
-    iP.set_i(static_cast<double>(iter->second.get_i()));
-    iP.set_j(static_cast<double>(iter->second.get_j()));
+    iP.set_i(static_cast<double>(curPoints[k].get_i()));
+    iP.set_j(static_cast<double>(curPoints[k].get_j()));
 
     vpDisplay::displayCross(_I, iP, 10, vpColor::red);
 
@@ -568,12 +660,11 @@ void vpMbtDistanceKltPoints::displayPrimitive(const vpImage<unsigned char> &_I)
 */
 void vpMbtDistanceKltPoints::displayPrimitive(const vpImage<vpRGBa> &_I)
 {
-  std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
-    int id(iter->first);
+  for (size_t k = 0; k < curPoints.size(); k++) {
+    int id(curPointsId[k]);
     vpImagePoint iP;
-    iP.set_i(static_cast<double>(iter->second.get_i()));
-    iP.set_j(static_cast<double>(iter->second.get_j()));
+    iP.set_i(static_cast<double>(curPoints[k].get_i()));
+    iP.set_j(static_cast<double>(curPoints[k].get_j()));
 
     vpDisplay::displayCross(_I, iP, 10, vpColor::red);
 
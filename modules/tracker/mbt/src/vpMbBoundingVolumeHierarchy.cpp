@@ -0,0 +1,482 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounding volume hierarchy over the polygons of a 3D model.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Maximum number of polygons in a leaf
+const unsigned int leafSize = 4;
+// Maximum depth of the traversal stack. The median split bounds the depth of
+// the tree by log2 of the number of polygons.
+const unsigned int maxStackSize = 64;
+
+inline double dot(const double a[3], const double b[3]) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+inline double clampCos(const double c) { return (std::max)(-1.0, (std::min)(1.0, c)); }
+
+// Intersection of a ray with an axis-aligned box. Returns the entry distance
+// in tnear.
+bool intersectBox(const double bmin[3], const double bmax[3], const double origin[3], const double direction[3],
+                  const double maxDistance, double &tnear)
+{
+  double t0 = 0.0, t1 = maxDistance;
+  for (unsigned int k = 0; k < 3; k++) {
+    if (std::fabs(direction[k]) <= std::numeric_limits<double>::epsilon()) {
+      if (origin[k] < bmin[k] || origin[k] > bmax[k])
+        return false;
+    } else {
+      const double inv = 1.0 / direction[k];
+      double tmin = (bmin[k] - origin[k]) * inv;
+      double tmax = (bmax[k] - origin[k]) * inv;
+      if (tmin > tmax)
+        std::swap(tmin, tmax);
+      t0 = (std::max)(t0, tmin);
+      t1 = (std::min)(t1, tmax);
+      if (t0 > t1)
+        return false;
+    }
+  }
+  tnear = t0;
+  return true;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor.
+*/
+vpMbBoundingVolumeHierarchy::vpMbBoundingVolumeHierarchy() : m_vertices(), m_polygons(), m_indices(), m_nodes() {}
+
+/*!
+  Add a polygon to the hierarchy. The polygons are indexed in the order they
+  are added. build() has to be called once all the polygons are added.
+
+  \param points : Vertices of the polygon. Their coordinates in the object
+  frame are used.
+  \param nbpt : Number of vertices. Polygons with less than 3 vertices
+  (lines) are only considered for the frustum culling.
+  \param oriented : False if the polygon must never be culled because it is
+  facing away from the camera, as the polygons of the cylinders.
+*/
+void vpMbBoundingVolumeHierarchy::addPolygon(const vpPoint *points, const unsigned int nbpt, const bool oriented)
+{
+  vpBVHPolygon polygon;
+  polygon.first_vertex = (unsigned int)m_vertices.size() / 3;
+  polygon.nb_vertices = nbpt;
+
+  for (unsigned int k = 0; k < 3; k++) {
+    polygon.bmin[k] = std::numeric_limits<double>::max();
+    polygon.bmax[k] = -std::numeric_limits<double>::max();
+    polygon.centroid[k] = 0.0;
+    polygon.normal[k] = 0.0;
+  }
+
+  for (unsigned int i = 0; i < nbpt; i++) {
+    const double X[3] = {points[i].get_oX(), points[i].get_oY(), points[i].get_oZ()};
+    for (unsigned int k = 0; k < 3; k++) {
+      m_vertices.push_back(X[k]);
+      polygon.bmin[k] = (std::min)(polygon.bmin[k], X[k]);
+      polygon.bmax[k] = (std::max)(polygon.bmax[k], X[k]);
+      polygon.centroid[k] += X[k];
+    }
+
+    // Newell's method, as in vpMbtPolygon::isVisible()
+    const vpPoint &next = points[(i + 1) % nbpt];
+    polygon.normal[0] += (X[1] - next.get_oY()) * (X[2] + next.get_oZ());
+    polygon.normal[1] += (X[2] - next.get_oZ()) * (X[0] + next.get_oX());
+    polygon.normal[2] += (X[0] - next.get_oX()) * (X[1] + next.get_oY());
+  }
+
+  if (nbpt > 0) {
+    for (unsigned int k = 0; k < 3; k++)
+      polygon.centroid[k] /= (double)nbpt;
+  }
+
+  const double norm = std::sqrt(dot(polygon.normal, polygon.normal));
+  polygon.b_plane = nbpt > 2 && norm > std::numeric_limits<double>::epsilon();
+  polygon.b_oriented = oriented && polygon.b_plane;
+  polygon.axis = 0;
+  polygon.d = 0.0;
+  if (polygon.b_plane) {
+    for (unsigned int k = 0; k < 3; k++) {
+      polygon.normal[k] /= norm;
+      if (std::fabs(polygon.normal[k]) > std::fabs(polygon.normal[polygon.axis]))
+        polygon.axis = k;
+    }
+    polygon.d = dot(polygon.normal, polygon.centroid);
+  }
+
+  m_polygons.push_back(polygon);
+}
+
+/*!
+  Build the hierarchy from the polygons added with addPolygon(). The nodes are
+  split at the median of the centroids of their polygons along their longest
+  axis.
+*/
+void vpMbBoundingVolumeHierarchy::build()
+{
+  m_indices.resize(m_polygons.size());
+  for (unsigned int i = 0; i < m_indices.size(); i++)
+    m_indices[i] = i;
+
+  m_nodes.clear();
+  if (m_polygons.empty())
+    return;
+
+  m_nodes.reserve(2 * m_polygons.size() / leafSize + 1);
+  m_nodes.resize(1);
+  buildNode(0, 0, (unsigned int)m_polygons.size());
+}
+
+void vpMbBoundingVolumeHierarchy::buildNode(const unsigned int node, const unsigned int begin, const unsigned int end)
+{
+  double bmin[3], bmax[3], cmin[3], cmax[3], axis[3] = {0.0, 0.0, 0.0};
+  for (unsigned int k = 0; k < 3; k++) {
+    bmin[k] = cmin[k] = std::numeric_limits<double>::max();
+    bmax[k] = cmax[k] = -std::numeric_limits<double>::max();
+  }
+
+  bool b_oriented = true;
+  for (unsigned int i = begin; i < end; i++) {
+    const vpBVHPolygon &polygon = m_polygons[m_indices[i]];
+    for (unsigned int k = 0; k < 3; k++) {
+      bmin[k] = (std::min)(bmin[k], polygon.bmin[k]);
+      bmax[k] = (std::max)(bmax[k], polygon.bmax[k]);
+      cmin[k] = (std::min)(cmin[k], polygon.centroid[k]);
+      cmax[k] = (std::max)(cmax[k], polygon.centroid[k]);
+      axis[k] += polygon.normal[k];
+    }
+    b_oriented = b_oriented && polygon.b_oriented;
+  }
+
+  // Cone bounding the normals of the polygons
+  double cone_angle = M_PI;
+  const double norm = std::sqrt(dot(axis, axis));
+  if (b_oriented && norm > std::numeric_limits<double>::epsilon()) {
+    cone_angle = 0.0;
+    for (unsigned int k = 0; k < 3; k++)
+      axis[k] /= norm;
+    for (unsigned int i = begin; i < end; i++)
+      cone_angle = (std::max)(cone_angle, std::acos(clampCos(dot(axis, m_polygons[m_indices[i]].normal))));
+  }
+
+  {
+    vpBVHNode &n = m_nodes[node];
+    for (unsigned int k = 0; k < 3; k++) {
+      n.bmin[k] = bmin[k];
+      n.bmax[k] = bmax[k];
+      n.axis[k] = axis[k];
+    }
+    n.cone_angle = cone_angle;
+    n.first = begin;
+    n.count = end - begin;
+  }
+
+  if (end - begin <= leafSize)
+    return;
+
+  unsigned int split = 0;
+  for (unsigned int k = 1; k < 3; k++)
+    if (cmax[k] - cmin[k] > cmax[split] - cmin[split])
+      split = k;
+
+  // Median split, the index breaking the ties to keep the build deterministic
+  std::vector<std::pair<double, unsigned int> > keys(end - begin);
+  for (unsigned int i = begin; i < end; i++)
+    keys[i - begin] = std::make_pair(m_polygons[m_indices[i]].centroid[split], m_indices[i]);
+  const unsigned int mid = (end - begin) / 2;
+  std::nth_element(keys.begin(), keys.begin() + mid, keys.end());
+  for (unsigned int i = begin; i < end; i++)
+    m_indices[i] = keys[i - begin].second;
+
+  const unsigned int child = (unsigned int)m_nodes.size();
+  m_nodes.resize(child + 2);
+  m_nodes[node].first = child;
+  m_nodes[node].count = 0;
+  buildNode(child, begin, begin + mid);
+  buildNode(child + 1, begin + mid, end);
+}
+
+/*!
+  Remove all the polygons and the nodes.
+*/
+void vpMbBoundingVolumeHierarchy::clear()
+{
+  m_vertices.clear();
+  m_polygons.clear();
+  m_indices.clear();
+  m_nodes.clear();
+}
+
+/*!
+  Find the first polygon hit by a ray. Only the polygons with at least 3
+  vertices and a non-zero area are considered.
+
+  \param origin : Origin of the ray in the object frame.
+  \param direction : Direction of the ray in the object frame, a unit vector
+  for the distances to be metric.
+  \param maxDistance : Only the intersections closer than this distance are
+  considered.
+  \param distance : Distance from the origin to the intersection, along the
+  direction.
+  \param index : Index of the polygon that is hit.
+  \param ignoredIndex : Index of a polygon to ignore, typically the one the
+  ray is targeting; -1 to consider all the polygons.
+
+  \return True if a polygon is hit before maxDistance.
+*/
+bool vpMbBoundingVolumeHierarchy::intersectRay(const double origin[3], const double direction[3],
+                                               const double maxDistance, double &distance, unsigned int &index,
+                                               const int ignoredIndex) const
+{
+  if (m_nodes.empty())
+    return false;
+
+  bool b_hit = false;
+  double best = maxDistance;
+  unsigned int stack[maxStackSize];
+  unsigned int size = 0;
+  stack[size++] = 0;
+
+  while (size > 0) {
+    const vpBVHNode &node = m_nodes[stack[--size]];
+    double tnear;
+    if (!intersectBox(node.bmin, node.bmax, origin, direction, best, tnear))
+      continue;
+
+    if (node.count > 0) {
+      for (unsigned int i = node.first; i < node.first + node.count; i++) {
+        const unsigned int id = m_indices[i];
+        double t;
+        if ((int)id != ignoredIndex && m_polygons[id].b_plane &&
+            intersectPolygon(m_polygons[id], origin, direction, t) && t < best) {
+          best = t;
+          index = id;
+          b_hit = true;
+        }
+      }
+    } else {
+      // Visit the closest child first
+      const vpBVHNode &left = m_nodes[node.first];
+      const vpBVHNode &right = m_nodes[node.first + 1];
+      double tleft = best, tright = best;
+      const bool b_left = intersectBox(left.bmin, left.bmax, origin, direction, best, tleft);
+      const bool b_right = intersectBox(right.bmin, right.bmax, origin, direction, best, tright);
+      if (b_left && b_right) {
+        stack[size++] = tleft < tright ? node.first + 1 : node.first;
+        stack[size++] = tleft < tright ? node.first : node.first + 1;
+      } else if (b_left) {
+        stack[size++] = node.first;
+      } else if (b_right) {
+        stack[size++] = node.first + 1;
+      }
+    }
+  }
+
+  if (b_hit)
+    distance = best;
+  return b_hit;
+}
+
+bool vpMbBoundingVolumeHierarchy::intersectPolygon(const vpBVHPolygon &polygon, const double origin[3],
+                                                   const double direction[3], double &t) const
+{
+  const double denom = dot(polygon.normal, direction);
+  if (std::fabs(denom) <= std::numeric_limits<double>::epsilon())
+    return false;
+
+  t = (polygon.d - dot(polygon.normal, origin)) / denom;
+  if (t <= 0.0)
+    return false;
+
+  // Crossing number test in the plane orthogonal to the dominant axis
+  const unsigned int a0 = (polygon.axis + 1) % 3, a1 = (polygon.axis + 2) % 3;
+  const double u = origin[a0] + t * direction[a0];
+  const double v = origin[a1] + t * direction[a1];
+  const double *vertices = &m_vertices[3 * polygon.first_vertex];
+  bool b_inside = false;
+  for (unsigned int i = 0, j = polygon.nb_vertices - 1; i < polygon.nb_vertices; j = i++) {
+    const double ui = vertices[3 * i + a0], vi = vertices[3 * i + a1];
+    const double uj = vertices[3 * j + a0], vj = vertices[3 * j + a1];
+    if ((vi > v) != (vj > v) && u < (uj - ui) * (v - vi) / (vj - vi) + ui)
+      b_inside = !b_inside;
+  }
+
+  return b_inside;
+}
+
+/*!
+  Get the polygons that may be seen by a camera. A polygon is discarded if its
+  bounding box is behind the camera or outside the field of view, or if it is
+  oriented and the angle between its normal and the direction from its
+  centroid to the camera is greater than \e angle.
+
+  \param cMo : Pose of the camera.
+  \param cam : Camera parameters, used with the image size to get the field
+  of view.
+  \param width : Width of the image, 0 to only discard the polygons behind
+  the camera.
+  \param height : Height of the image, 0 to only discard the polygons behind
+  the camera.
+  \param indices : Sorted indexes of the polygons that may be seen.
+  \param angle : Angle above which an oriented polygon is considered as
+  facing away from the camera; M_PI to disable this test.
+*/
+void vpMbBoundingVolumeHierarchy::queryFrustum(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+                                               const unsigned int width, const unsigned int height,
+                                               std::vector<unsigned int> &indices, const double angle) const
+{
+  indices.clear();
+  if (m_nodes.empty())
+    return;
+
+  // Planes of the frustum in the camera frame, a point X being inside if
+  // n.X + d >= 0: Z >= 0 and the sides of the field of view
+  double planes_c[5][4] = {{0, 0, 1, 0}};
+  unsigned int nbPlanes = 1;
+  if (width > 0 && height > 0) {
+    const double xmin = -cam.get_u0() / cam.get_px(), xmax = (width - cam.get_u0()) / cam.get_px();
+    const double ymin = -cam.get_v0() / cam.get_py(), ymax = (height - cam.get_v0()) / cam.get_py();
+    const double sides[4][4] = {{1, 0, -xmin, 0}, {-1, 0, xmax, 0}, {0, 1, -ymin, 0}, {0, -1, ymax, 0}};
+    for (unsigned int p = 0; p < 4; p++)
+      for (unsigned int k = 0; k < 4; k++)
+        planes_c[nbPlanes + p][k] = sides[p][k];
+    nbPlanes += 4;
+  }
+
+  // Planes and camera position in the object frame
+  double planes[5][4];
+  for (unsigned int p = 0; p < nbPlanes; p++) {
+    planes[p][3] = planes_c[p][3];
+    for (unsigned int k = 0; k < 3; k++) {
+      planes[p][k] = cMo[0][k] * planes_c[p][0] + cMo[1][k] * planes_c[p][1] + cMo[2][k] * planes_c[p][2];
+      planes[p][3] += planes_c[p][k] * cMo[k][3];
+    }
+  }
+  double cameraPos[3];
+  for (unsigned int k = 0; k < 3; k++)
+    cameraPos[k] = -(cMo[0][k] * cMo[0][3] + cMo[1][k] * cMo[1][3] + cMo[2][k] * cMo[2][3]);
+
+  const bool b_backface = angle < M_PI;
+
+  // The nodes are stacked with the mask of the planes they may cross
+  std::pair<unsigned int, unsigned int> stack[maxStackSize];
+  unsigned int size = 0;
+  stack[size++] = std::make_pair(0u, (1u << nbPlanes) - 1);
+
+  while (size > 0) {
+    const std::pair<unsigned int, unsigned int> top = stack[--size];
+    const vpBVHNode &node = m_nodes[top.first];
+    unsigned int mask = top.second;
+
+    bool b_culled = false;
+    for (unsigned int p = 0; p < nbPlanes && !b_culled; p++) {
+      if (!(mask & (1u << p)))
+        continue;
+      double dmax = planes[p][3], dmin = planes[p][3];
+      for (unsigned int k = 0; k < 3; k++) {
+        dmax += planes[p][k] * (planes[p][k] >= 0 ? node.bmax[k] : node.bmin[k]);
+        dmin += planes[p][k] * (planes[p][k] >= 0 ? node.bmin[k] : node.bmax[k]);
+      }
+      if (dmax < 0)
+        b_culled = true;
+      else if (dmin >= 0)
+        mask &= ~(1u << p); // The children are inside this plane
+    }
+
+    // The normals of the polygons are within the cone of the node, and the
+    // directions to the camera within the cone of the bounding sphere
+    if (!b_culled && b_backface && node.cone_angle < M_PI) {
+      double v[3];
+      double radius = 0.0;
+      for (unsigned int k = 0; k < 3; k++) {
+        v[k] = cameraPos[k] - 0.5 * (node.bmin[k] + node.bmax[k]);
+        radius += vpMath::sqr(0.5 * (node.bmax[k] - node.bmin[k]));
+      }
+      radius = std::sqrt(radius);
+      const double dist = std::sqrt(dot(v, v));
+      if (dist > radius) {
+        const double beta = std::acos(clampCos(dot(node.axis, v) / dist));
+        b_culled = beta - node.cone_angle - std::asin(radius / dist) >= angle;
+      }
+    }
+
+    if (b_culled)
+      continue;
+
+    if (node.count == 0) {
+      stack[size++] = std::make_pair(node.first, mask);
+      stack[size++] = std::make_pair(node.first + 1, mask);
+      continue;
+    }
+
+    for (unsigned int i = node.first; i < node.first + node.count; i++) {
+      const unsigned int id = m_indices[i];
+      const vpBVHPolygon &polygon = m_polygons[id];
+
+      bool b_inside = true;
+      for (unsigned int p = 0; p < nbPlanes && b_inside; p++) {
+        if (!(mask & (1u << p)))
+          continue;
+        double dmax = planes[p][3];
+        for (unsigned int k = 0; k < 3; k++)
+          dmax += planes[p][k] * (planes[p][k] >= 0 ? polygon.bmax[k] : polygon.bmin[k]);
+        b_inside = dmax >= 0;
+      }
+
+      if (b_inside && b_backface && polygon.b_oriented) {
+        double v[3];
+        for (unsigned int k = 0; k < 3; k++)
+          v[k] = cameraPos[k] - polygon.centroid[k];
+        const double dist = std::sqrt(dot(v, v));
+        b_inside = dist <= std::numeric_limits<double>::epsilon() ||
+                   std::acos(clampCos(dot(polygon.normal, v) / dist)) < angle;
+      }
+
+      if (b_inside)
+        indices.push_back(id);
+    }
+  }
+
+  std::sort(indices.begin(), indices.end());
+}
@@ -37,12 +37,178 @@
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpParallelTaskException.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace
+{
+/*
+  Number of threads to use to process nbTasks independent tasks, 1 meaning a
+  sequential execution. Nested parallel regions are avoided: a tracker
+  processed by a thread of the per camera loop handles its feature types
+  sequentially.
+*/
+int getNbParallelThreads(const bool useParallel, const int nbThreads, const size_t nbTasks)
+{
+#if defined(VISP_HAVE_OPENMP)
+  if (useParallel && nbTasks > 1 && !omp_in_parallel()) {
+    int nb = nbThreads > 0 ? nbThreads : omp_get_max_threads();
+    return (std::min)(nb, (int)nbTasks);
+  }
+#else
+  (void)useParallel;
+  (void)nbThreads;
+  (void)nbTasks;
+#endif
+
+  return 1;
+}
+
+/*
+  Run task(i) for the nbTasks independent tasks, concurrently when
+  useParallel is true. An exception raised by a task is thrown again once all
+  the tasks are done, see vpParallelTaskException.
+*/
+template <class Task>
+void runParallelTasks(const Task &task, const size_t nbTasks, const bool useParallel, const int nbThreads)
+{
+  const int nbParallelThreads = getNbParallelThreads(useParallel, nbThreads, nbTasks);
+  if (nbParallelThreads > 1) {
+#if defined(VISP_HAVE_OPENMP)
+    vpParallelTaskException exception("Unknown exception in parallel tracking");
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbParallelThreads)
+    for (int i = 0; i < (int)nbTasks; i++) {
+      try {
+        task((size_t)i);
+      } catch (...) {
+        exception.capture(i);
+      }
+    }
+    exception.rethrow();
+#endif
+  } else {
+    for (size_t i = 0; i < nbTasks; i++) {
+      task(i);
+    }
+  }
+}
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class vpMbGenericTracker::ComputeVVSWeightedNormalEquationsTask
+{
+public:
+  ComputeVVSWeightedNormalEquationsTask(const std::vector<TrackerWrapper *> &trackers, const double factorEdge,
+                                        const double factorKlt, const double factorDepth,
+                                        const double factorDepthDense, std::vector<vpColVector> &W_cameras,
+                                        std::vector<vpMatrix> &LTL_cameras, std::vector<vpColVector> &LTR_cameras,
+                                        std::vector<double> &num_cameras, std::vector<double> &den_cameras)
+    : m_trackers(trackers), m_factorEdge(factorEdge), m_factorKlt(factorKlt), m_factorDepth(factorDepth),
+      m_factorDepthDense(factorDepthDense), m_W_cameras(W_cameras), m_LTL_cameras(LTL_cameras),
+      m_LTR_cameras(LTR_cameras), m_num_cameras(num_cameras), m_den_cameras(den_cameras)
+  {
+  }
+
+  void operator()(const size_t i) const
+  {
+    m_trackers[i]->computeVVSWeightedNormalEquations(m_factorEdge, m_factorKlt, m_factorDepth, m_factorDepthDense,
+                                                     m_W_cameras[i], m_LTL_cameras[i], m_LTR_cameras[i],
+                                                     m_num_cameras[i], m_den_cameras[i]);
+  }
+
+private:
+  const std::vector<TrackerWrapper *> &m_trackers;
+  double m_factorEdge;
+  double m_factorKlt;
+  double m_factorDepth;
+  double m_factorDepthDense;
+  std::vector<vpColVector> &m_W_cameras;
+  std::vector<vpMatrix> &m_LTL_cameras;
+  std::vector<vpColVector> &m_LTR_cameras;
+  std::vector<double> &m_num_cameras;
+  std::vector<double> &m_den_cameras;
+};
+
+class vpMbGenericTracker::ComputeVVSInteractionMatrixAndResiduTask
+{
+public:
+  ComputeVVSInteractionMatrixAndResiduTask(const std::vector<TrackerWrapper *> &trackers,
+                                           const std::vector<const vpImage<unsigned char> *> &images)
+    : m_trackers(trackers), m_images(images)
+  {
+  }
+
+  void operator()(const size_t i) const { m_trackers[i]->computeVVSInteractionMatrixAndResidu(m_images[i]); }
+
+private:
+  const std::vector<TrackerWrapper *> &m_trackers;
+  const std::vector<const vpImage<unsigned char> *> &m_images;
+};
+
+class vpMbGenericTracker::ComputeVVSWeightsTask
+{
+public:
+  explicit ComputeVVSWeightsTask(const std::vector<TrackerWrapper *> &trackers) : m_trackers(trackers) {}
+
+  void operator()(const size_t i) const { m_trackers[i]->computeVVSWeights(); }
+
+private:
+  const std::vector<TrackerWrapper *> &m_trackers;
+};
+
+class vpMbGenericTracker::PostTrackingTask
+{
+public:
+  PostTrackingTask(const std::vector<TrackerWrapper *> &trackers,
+                   const std::vector<const vpImage<unsigned char> *> &images, const std::vector<unsigned int> &widths,
+                   const std::vector<unsigned int> &heights)
+    : m_trackers(trackers), m_images(images), m_widths(widths), m_heights(heights)
+  {
+  }
+
+  void operator()(const size_t i) const { m_trackers[i]->postTracking(m_images[i], m_widths[i], m_heights[i]); }
+
+private:
+  const std::vector<TrackerWrapper *> &m_trackers;
+  const std::vector<const vpImage<unsigned char> *> &m_images;
+  const std::vector<unsigned int> &m_widths;
+  const std::vector<unsigned int> &m_heights;
+};
+
+template <class PointCloud> class vpMbGenericTracker::PreTrackingTask
+{
+public:
+  PreTrackingTask(const std::vector<TrackerWrapper *> &trackers,
+                  const std::vector<const vpImage<unsigned char> *> &images,
+                  const std::vector<const PointCloud *> &point_clouds, const std::vector<unsigned int> &widths,
+                  const std::vector<unsigned int> &heights)
+    : m_trackers(trackers), m_images(images), m_pointClouds(point_clouds), m_widths(widths), m_heights(heights)
+  {
+  }
+
+  void operator()(const size_t i) const
+  {
+    m_trackers[i]->preTrackingImpl(m_images[i], m_pointClouds[i], m_widths[i], m_heights[i]);
+  }
+
+private:
+  const std::vector<TrackerWrapper *> &m_trackers;
+  const std::vector<const vpImage<unsigned char> *> &m_images;
+  const std::vector<const PointCloud *> &m_pointClouds;
+  const std::vector<unsigned int> &m_widths;
+  const std::vector<unsigned int> &m_heights;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpMbGenericTracker::vpMbGenericTracker()
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_nbParallelTrackingThreads(0), m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5),
+    m_useParallelTracking(false), m_w(), m_weightedError()
 {
   m_mapOfTrackers["Camera"] = new TrackerWrapper(EDGE_TRACKER);
 
@@ -62,7 +228,8 @@ vpMbGenericTracker::vpMbGenericTracker()
 
 vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int trackerType)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_nbParallelTrackingThreads(0), m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5),
+    m_useParallelTracking(false), m_w(), m_weightedError()
 {
   if (nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot use no camera!");
@@ -98,7 +265,8 @@ vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int t
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_nbParallelTrackingThreads(0), m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5),
+    m_useParallelTracking(false), m_w(), m_weightedError()
 {
   if (trackerTypes.empty()) {
     throw vpException(vpException::badValue, "There is no camera!");
@@ -137,7 +305,8 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNames,
                                        const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_nbParallelTrackingThreads(0), m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5),
+    m_useParallelTracking(false), m_w(), m_weightedError()
 {
   if (cameraNames.size() != trackerTypes.size() || cameraNames.empty()) {
     throw vpException(vpTrackingException::badValue,
@@ -271,24 +440,35 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
   vpColVector W_true(m_error.getRows());
   vpMatrix L_true, LVJ_true;
 
-  // Create the map of VelocityTwistMatrices
-  std::map<std::string, vpVelocityTwistMatrix> mapOfVelocityTwist;
-  for (std::map<std::string, vpHomogeneousMatrix>::const_iterator it = m_mapOfCameraTransformationMatrix.begin();
-       it != m_mapOfCameraTransformationMatrix.end(); ++it) {
+  // Velocity twist matrices between each camera frame and the reference camera frame
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<vpMatrix> velocityTwists, velocityTwistsT;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
     vpVelocityTwistMatrix cVo;
-    cVo.buildFrom(it->second);
-    mapOfVelocityTwist[it->first] = cVo;
+    cVo.buildFrom(m_mapOfCameraTransformationMatrix[it->first]);
+
+    trackers.push_back(it->second);
+    velocityTwists.push_back(cVo);
+    velocityTwistsT.push_back(velocityTwists.back().t());
   }
 
+  // Per camera weights and normal equations, expressed in the camera frames
+  std::vector<vpColVector> W_cameras(trackers.size()), LTR_cameras(trackers.size());
+  std::vector<vpMatrix> LTL_cameras(trackers.size());
+  std::vector<double> num_cameras(trackers.size()), den_cameras(trackers.size());
+
   double factorEdge = m_mapOfFeatureFactors[EDGE_TRACKER];
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   double factorKlt = m_mapOfFeatureFactors[KLT_TRACKER];
+#else
+  double factorKlt = 0.0; // No KLT features
 #endif
   double factorDepth = m_mapOfFeatureFactors[DEPTH_NORMAL_TRACKER];
   double factorDepthDense = m_mapOfFeatureFactors[DEPTH_DENSE_TRACKER];
 
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
-    computeVVSInteractionMatrixAndResidu(mapOfImages, mapOfVelocityTwist);
+    computeVVSInteractionMatrixAndResidu(mapOfImages);
 
     bool reStartFromLastIncrement = false;
     computeVVSCheckLevenbergMarquardt(iter, m_error, error_prev, cMo_prev, mu, reStartFromLastIncrement);
@@ -310,6 +490,16 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
     if (!reStartFromLastIncrement) {
       computeVVSWeights();
 
+      // The stacked interaction matrix is only needed to check the rank and
+      // to compute the covariance matrix
+      if (iter == 0 || computeCovariance) {
+        unsigned int start_index = 0;
+        for (size_t i = 0; i < trackers.size(); i++) {
+          m_L.insert(trackers[i]->m_L * velocityTwists[i], start_index, 0);
+          start_index += trackers[i]->m_error.getRows();
+        }
+      }
+
       if (computeCovariance) {
         L_true = m_L;
         if (!isoJoIdentity_) {
@@ -347,90 +537,36 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
         }
       }
 
-      // Weighting
+      // Weighting and normal equations of each camera
+      runParallelTasks(ComputeVVSWeightedNormalEquationsTask(trackers, factorEdge, factorKlt, factorDepth,
+                                                             factorDepthDense, W_cameras, LTL_cameras, LTR_cameras,
+                                                             num_cameras, den_cameras),
+                       trackers.size(), m_useParallelTracking, m_nbParallelTrackingThreads);
+
+      // Sum the contributions of the cameras in the reference camera frame:
+      // (L V)^T W^2 (L V) = V^T (L^T W^2 L) V. The cameras are summed in the
+      // same order whatever the execution order.
       double num = 0;
       double den = 0;
 
+      LTL.resize(6, 6, true);
+      LTR.resize(6, true);
       unsigned int start_index = 0;
-      for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-           it != m_mapOfTrackers.end(); ++it) {
-        TrackerWrapper *tracker = it->second;
-
-        if (tracker->m_trackerType & EDGE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
-            double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_edge.getRows();
-        }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-        if (tracker->m_trackerType & KLT_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
-            double wi = tracker->m_w_klt[i] * factorKlt;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_klt.getRows();
-        }
-#endif
-
-        if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
-            double wi = tracker->m_w_depthNormal[i] * factorDepth;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthNormal.getRows();
-        }
-
-        if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
-            double wi = tracker->m_w_depthDense[i] * factorDepthDense;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
-          }
-
-          start_index += tracker->m_error_depthDense.getRows();
-        }
+      for (size_t i = 0; i < trackers.size(); i++) {
+        LTL += velocityTwistsT[i] * LTL_cameras[i] * velocityTwists[i];
+        LTR += velocityTwistsT[i] * LTR_cameras[i];
+        num += num_cameras[i];
+        den += den_cameras[i];
+
+        W_true.insert(start_index, W_cameras[i]);
+        m_weightedError.insert(start_index, trackers[i]->m_weightedError);
+        start_index += trackers[i]->m_error.getRows();
       }
 
       normRes_1 = normRes;
       normRes = sqrt(num / den);
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error, error_prev, mu, v);
 
       cMo_prev = cMo;
 
@@ -503,10 +639,10 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu()
 }
 
 void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
-    std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
-    std::map<std::string, vpVelocityTwistMatrix> &mapOfVelocityTwist)
+    std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
 {
-  unsigned int start_index = 0;
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
 
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
@@ -518,26 +654,39 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
     tracker->ctTc0 = c_curr_tTc_curr0;
 #endif
 
-    tracker->computeVVSInteractionMatrixAndResidu(mapOfImages[it->first]);
+    trackers.push_back(tracker);
+    images.push_back(mapOfImages[it->first]);
+  }
+
+  runParallelTasks(ComputeVVSInteractionMatrixAndResiduTask(trackers, images), trackers.size(),
+                   m_useParallelTracking, m_nbParallelTrackingThreads);
 
-    m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
-    m_error.insert(start_index, tracker->m_error);
+  // Stack the residuals in the camera order, the result does not depend on
+  // the execution order. The interaction matrices are not stacked, see
+  // computeVVS().
+  unsigned int start_index = 0;
+  for (size_t i = 0; i < trackers.size(); i++) {
+    m_error.insert(start_index, trackers[i]->m_error);
 
-    start_index += tracker->m_error.getRows();
+    start_index += trackers[i]->m_error.getRows();
   }
 }
 
 void vpMbGenericTracker::computeVVSWeights()
 {
-  unsigned int start_index = 0;
-
+  std::vector<TrackerWrapper *> trackers;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->computeVVSWeights();
+    trackers.push_back(it->second);
+  }
+
+  runParallelTasks(ComputeVVSWeightsTask(trackers), trackers.size(), m_useParallelTracking,
+                   m_nbParallelTrackingThreads);
 
-    m_w.insert(start_index, tracker->m_w);
-    start_index += tracker->m_w.getRows();
+  unsigned int start_index = 0;
+  for (size_t i = 0; i < trackers.size(); i++) {
+    m_w.insert(start_index, trackers[i]->m_w);
+    start_index += trackers[i]->m_w.getRows();
   }
 }
 
@@ -2240,15 +2389,69 @@ void vpMbGenericTracker::loadModel(const std::map<std::string, std::string> &map
   }
 }
 
+#ifdef VISP_HAVE_PCL
+void vpMbGenericTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
+{
+  // Only the size of the point clouds is used, they are not given when no depth feature is tracked
+  std::map<std::string, unsigned int> mapOfPointCloudWidths, mapOfPointCloudHeights;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud = mapOfPointClouds[it->first];
+    mapOfPointCloudWidths[it->first] = point_cloud ? point_cloud->width : 0;
+    mapOfPointCloudHeights[it->first] = point_cloud ? point_cloud->height : 0;
+  }
+
+  postTracking(mapOfImages, mapOfPointCloudWidths, mapOfPointCloudHeights);
+}
+#endif
+
+void vpMbGenericTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
+                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
+{
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<unsigned int> widths, heights;
+  // Display and Ogre rendering cannot be done concurrently
+  bool useParallel = m_useParallelTracking;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    widths.push_back(mapOfPointCloudWidths[it->first]);
+    heights.push_back(mapOfPointCloudHeights[it->first]);
+    useParallel = useParallel && !it->second->displayFeatures && !it->second->useOgre;
+  }
+
+  runParallelTasks(PostTrackingTask(trackers, images, widths, heights), trackers.size(), useParallel,
+                   m_nbParallelTrackingThreads);
+}
+
 #ifdef VISP_HAVE_PCL
 void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
 {
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<const pcl::PointCloud<pcl::PointXYZ>::ConstPtr *> point_clouds;
+  std::vector<unsigned int> widths, heights;
+  // Display and Ogre rendering cannot be done concurrently
+  bool useParallel = m_useParallelTracking;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+    const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud = mapOfPointClouds[it->first];
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    point_clouds.push_back(&point_cloud);
+    widths.push_back(point_cloud ? point_cloud->width : 0);
+    heights.push_back(point_cloud ? point_cloud->height : 0);
+    useParallel = useParallel && !it->second->displayFeatures && !it->second->useOgre;
   }
+
+  runParallelTasks(PreTrackingTask<pcl::PointCloud<pcl::PointXYZ>::ConstPtr>(trackers, images, point_clouds, widths,
+                                                                             heights),
+                   trackers.size(), useParallel, m_nbParallelTrackingThreads);
 }
 #endif
 
@@ -2257,12 +2460,49 @@ void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigne
                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
 {
+  // std::map::operator[] may insert elements, the inputs are gathered before the parallel section
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<const std::vector<vpColVector> *> point_clouds;
+  std::vector<unsigned int> widths, heights;
+  // Display and Ogre rendering cannot be done concurrently
+  bool useParallel = m_useParallelTracking;
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first], mapOfPointCloudWidths[it->first],
-                         mapOfPointCloudHeights[it->first]);
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    point_clouds.push_back(mapOfPointClouds[it->first]);
+    widths.push_back(mapOfPointCloudWidths[it->first]);
+    heights.push_back(mapOfPointCloudHeights[it->first]);
+    useParallel = useParallel && !it->second->displayFeatures && !it->second->useOgre;
   }
+
+  runParallelTasks(PreTrackingTask<std::vector<vpColVector> >(trackers, images, point_clouds, widths, heights),
+                   trackers.size(), useParallel, m_nbParallelTrackingThreads);
+}
+
+void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                     std::map<std::string, const vpMbtPointCloud *> &mapOfPointClouds)
+{
+  std::vector<TrackerWrapper *> trackers;
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<const vpMbtPointCloud *> point_clouds;
+  std::vector<unsigned int> widths, heights;
+  // Display and Ogre rendering cannot be done concurrently
+  bool useParallel = m_useParallelTracking;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    const vpMbtPointCloud *point_cloud = mapOfPointClouds[it->first];
+    trackers.push_back(it->second);
+    images.push_back(mapOfImages[it->first]);
+    point_clouds.push_back(point_cloud);
+    widths.push_back(point_cloud != NULL ? point_cloud->getWidth() : 0);
+    heights.push_back(point_cloud != NULL ? point_cloud->getHeight() : 0);
+    useParallel = useParallel && !it->second->displayFeatures && !it->second->useOgre;
+  }
+
+  runParallelTasks(PreTrackingTask<vpMbtPointCloud>(trackers, images, point_clouds, widths, heights), trackers.size(),
+                   useParallel, m_nbParallelTrackingThreads);
 }
 
 /*!
@@ -2627,6 +2867,25 @@ void vpMbGenericTracker::setAngleDisappear(const std::map<std::string, double> &
   }
 }
 
+/*!
+  Use a bounding volume hierarchy of the faces of the model for the
+  visibility test.
+
+  \param v : True to use it, False otherwise
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setBVHVisibilityTest(const bool &v)
+{
+  vpMbTracker::setBVHVisibilityTest(v);
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setBVHVisibilityTest(v);
+  }
+}
+
 /*!
   Set the camera parameters.
 
@@ -3141,7 +3400,6 @@ void vpMbGenericTracker::setGoodMovingEdgesRatioThreshold(const double threshold
   }
 }
 
-#ifdef VISP_HAVE_OGRE
 /*!
   Set the ratio of visibility attempts that has to be successful to consider a
   polygon as visible.
@@ -3181,7 +3439,6 @@ void vpMbGenericTracker::setNbRayCastingAttemptsForVisibility(const unsigned int
     tracker->setNbRayCastingAttemptsForVisibility(attempts);
   }
 }
-#endif
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
@@ -3394,6 +3651,28 @@ void vpMbGenericTracker::setMinPolygonAreaThresh(const double minPolygonAreaThre
   }
 }
 
+/*!
+  Set the directory of the binary cache of the models, used by loadModel().
+  The trackers of all the cameras share the same cache files.
+
+  \param directory : The directory, created if needed. An empty string
+  disables the cache, which is the default.
+
+  \sa vpMbTracker::setModelCacheDirectory()
+
+  \note This function will set the new parameter for all the cameras.
+*/
+void vpMbGenericTracker::setModelCacheDirectory(const std::string &directory)
+{
+  vpMbTracker::setModelCacheDirectory(directory);
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setModelCacheDirectory(directory);
+  }
+}
+
 /*!
   Set the moving edge parameters.
 
@@ -3520,6 +3799,26 @@ void vpMbGenericTracker::setNearClippingDistance(const std::map<std::string, dou
   }
 }
 
+/*!
+  Set the number of threads used by the parallel tracking mode.
+
+  \param nb : Number of threads. If 0, the number of threads is determined by
+  OpenMP.
+
+  \note The parallel tracking mode has to be enabled with
+  setUseParallelTracking().
+*/
+void vpMbGenericTracker::setNbParallelTrackingThreads(const int nb)
+{
+  m_nbParallelTrackingThreads = nb;
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->m_nbParallelTrackingThreads = nb;
+  }
+}
+
 /*!
   Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -3930,6 +4229,37 @@ void vpMbGenericTracker::setUseKltTracking(const std::string &name, const bool &
 }
 #endif
 
+/*!
+  Set if the cameras and the feature types (moving edges, KLT, depth normal
+  and depth dense) are processed in parallel. The moving edges and KLT
+  tracking, the point cloud segmentation and the computation of the
+  interaction matrix and of the residual are then done concurrently for each
+  camera and, for a single camera, for each feature type. The blocks are
+  always stacked in the same order, so the estimated pose does not depend on
+  the number of threads.
+
+  \param use : If true, enable the parallel tracking mode. By default, this
+  mode is disabled.
+
+  \note Need OpenMP, otherwise the tracking is sequential.
+
+  \warning Moving edges and features display, as well as Ogre visibility test,
+  cannot be done concurrently: in that case the update of the features after
+  the pose estimation remains sequential.
+
+  \sa setNbParallelTrackingThreads()
+*/
+void vpMbGenericTracker::setUseParallelTracking(const bool use)
+{
+  m_useParallelTracking = use;
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->m_useParallelTracking = use;
+  }
+}
+
 void vpMbGenericTracker::testTracking()
 {
   // Test tracking fails only if all testTracking have failed
@@ -4069,12 +4399,7 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   testTracking();
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
-
-    tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
-  }
+  postTracking(mapOfImages, mapOfPointClouds);
 
   computeProjectionError();
 }
@@ -4133,19 +4458,127 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   testTracking();
 
+  postTracking(mapOfImages, mapOfPointCloudWidths, mapOfPointCloudHeights);
+
+  computeProjectionError();
+}
+
+/*!
+  Realize the tracking of the object in the image.
+
+  Contrary to the overload using std::vector<vpColVector> pointclouds, each
+  pointcloud is stored as a contiguous array of float coordinates and the
+  depth features are extracted directly from it. A vpMbtPointCloud can wrap
+  the buffer of a depth sensor without any copy.
+
+  \throw vpException : if the tracking is supposed to have failed
+
+  \param mapOfImages : Map of images.
+  \param mapOfPointClouds : Map of pointclouds.
+*/
+void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                               std::map<std::string, const vpMbtPointCloud *> &mapOfPointClouds)
+{
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
 
-    tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first], mapOfPointCloudHeights[it->first]);
+    if ((tracker->m_trackerType & (EDGE_TRACKER |
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+                                   KLT_TRACKER |
+#endif
+                                   DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
+      throw vpException(vpException::fatalError, "Bad tracker type: %d", tracker->m_trackerType);
+    }
+
+    if (tracker->m_trackerType & (EDGE_TRACKER
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+                                  | KLT_TRACKER
+#endif
+                                  ) &&
+        mapOfImages[it->first] == NULL) {
+      throw vpException(vpException::fatalError, "Image pointer is NULL!");
+    }
+
+    if (tracker->m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER) &&
+        (mapOfPointClouds[it->first] == NULL)) {
+      throw vpException(vpException::fatalError, "Pointcloud is NULL!");
+    }
   }
 
+  preTracking(mapOfImages, mapOfPointClouds);
+
+  try {
+    computeVVS(mapOfImages);
+  } catch (...) {
+    covarianceMatrix = -1;
+    throw; // throw the original exception
+  }
+
+  testTracking();
+
+  std::map<std::string, unsigned int> mapOfPointCloudWidths, mapOfPointCloudHeights;
+  for (std::map<std::string, const vpMbtPointCloud *>::const_iterator it = mapOfPointClouds.begin();
+       it != mapOfPointClouds.end(); ++it) {
+    mapOfPointCloudWidths[it->first] = it->second != NULL ? it->second->getWidth() : 0;
+    mapOfPointCloudHeights[it->first] = it->second != NULL ? it->second->getHeight() : 0;
+  }
+  postTracking(mapOfImages, mapOfPointCloudWidths, mapOfPointCloudHeights);
+
   computeProjectionError();
 }
 
 /** TrackerWrapper **/
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class vpMbGenericTracker::TrackerWrapper::ComputeVVSFeatureInteractionMatrixAndResiduTask
+{
+public:
+  ComputeVVSFeatureInteractionMatrixAndResiduTask(TrackerWrapper *tracker, const std::vector<int> &featureTypes,
+                                                  const vpImage<unsigned char> *const ptr_I)
+    : m_tracker(tracker), m_featureTypes(featureTypes), m_ptr_I(ptr_I)
+  {
+  }
+
+  void operator()(const size_t i) const
+  {
+    m_tracker->computeVVSFeatureInteractionMatrixAndResidu(m_featureTypes[i], m_ptr_I);
+  }
+
+private:
+  TrackerWrapper *m_tracker;
+  const std::vector<int> &m_featureTypes;
+  const vpImage<unsigned char> *m_ptr_I;
+};
+
+template <class PointCloud> class vpMbGenericTracker::TrackerWrapper::PreTrackingFeatureTask
+{
+public:
+  PreTrackingFeatureTask(TrackerWrapper *tracker, const std::vector<int> &featureTypes,
+                         const vpImage<unsigned char> *const ptr_I, const PointCloud *const point_cloud,
+                         const unsigned int pointcloud_width, const unsigned int pointcloud_height)
+    : m_tracker(tracker), m_featureTypes(featureTypes), m_ptr_I(ptr_I), m_pointCloud(point_cloud),
+      m_pointCloudWidth(pointcloud_width), m_pointCloudHeight(pointcloud_height)
+  {
+  }
+
+  void operator()(const size_t i) const
+  {
+    m_tracker->preTrackingFeature(m_featureTypes[i], m_ptr_I, m_pointCloud, m_pointCloudWidth, m_pointCloudHeight);
+  }
+
+private:
+  TrackerWrapper *m_tracker;
+  const std::vector<int> &m_featureTypes;
+  const vpImage<unsigned char> *m_ptr_I;
+  const PointCloud *m_pointCloud;
+  unsigned int m_pointCloudWidth;
+  unsigned int m_pointCloudHeight;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
-  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError()
+  : m_error(), m_L(), m_nbParallelTrackingThreads(0), m_trackerType(EDGE_TRACKER), m_useParallelTracking(false), m_w(),
+    m_weightedError()
 {
   m_lambda = 1.0;
   m_maxIter = 30;
@@ -4158,7 +4591,8 @@ vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
 }
 
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper(const int trackerType)
-  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError()
+  : m_error(), m_L(), m_nbParallelTrackingThreads(0), m_trackerType(trackerType), m_useParallelTracking(false), m_w(),
+    m_weightedError()
 {
   if ((m_trackerType & (EDGE_TRACKER |
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4218,13 +4652,6 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   double normRes_1 = -1;
   unsigned int iter = 0;
 
-  double factorEdge = 1.0;
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  double factorKlt = 1.0;
-#endif
-  double factorDepth = 1.0;
-  double factorDepthDense = 1.0;
-
   vpMatrix LTL;
   vpColVector LTR, v;
   vpColVector error_prev;
@@ -4240,13 +4667,6 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
   vpColVector W_true(m_error.getRows());
   vpMatrix L_true, LVJ_true;
 
-  unsigned int nb_edge_features = m_error_edge.getRows();
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  unsigned int nb_klt_features = m_error_klt.getRows();
-#endif
-  unsigned int nb_depth_features = m_error_depthNormal.getRows();
-  unsigned int nb_depth_dense_features = m_error_depthDense.getRows();
-
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
     computeVVSInteractionMatrixAndResidu(ptr_I);
 
@@ -4304,79 +4724,9 @@ void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char>
       // Weighting
       double num = 0;
       double den = 0;
+      computeVVSWeightedNormalEquations(1.0, 1.0, 1.0, 1.0, W_true, LTL, LTR, num, den);
 
-      unsigned int start_index = 0;
-      if (m_trackerType & EDGE_TRACKER) {
-        for (unsigned int i = 0; i < nb_edge_features; i++) {
-          double wi = m_w_edge[i] * m_factor[i] * factorEdge;
-          W_true[i] = wi;
-          m_weightedError[i] = wi * m_error[i];
-
-          num += wi * vpMath::sqr(m_error[i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[i][j] *= wi;
-          }
-        }
-
-        start_index += nb_edge_features;
-      }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-      if (m_trackerType & KLT_TRACKER) {
-        for (unsigned int i = 0; i < nb_klt_features; i++) {
-          double wi = m_w_klt[i] * factorKlt;
-          W_true[start_index + i] = wi;
-          m_weightedError[start_index + i] = wi * m_error_klt[i];
-
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        start_index += nb_klt_features;
-      }
-#endif
-
-      if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-        for (unsigned int i = 0; i < nb_depth_features; i++) {
-          double wi = m_w_depthNormal[i] * factorDepth;
-          m_w[start_index + i] = m_w_depthNormal[i];
-          m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        start_index += nb_depth_features;
-      }
-
-      if (m_trackerType & DEPTH_DENSE_TRACKER) {
-        for (unsigned int i = 0; i < nb_depth_dense_features; i++) {
-          double wi = m_w_depthDense[i] * factorDepthDense;
-          m_w[start_index + i] = m_w_depthDense[i];
-          m_weightedError[start_index + i] = wi * m_error[start_index + i];
-
-          num += wi * vpMath::sqr(m_error[start_index + i]);
-          den += wi;
-
-          for (unsigned int j = 0; j < m_L.getCols(); j++) {
-            m_L[start_index + i][j] *= wi;
-          }
-        }
-
-        //        start_index += nb_depth_dense_features;
-      }
-
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+      computeVVSPoseEstimation(isoJoIdentity_, iter, LTL, LTR, m_error, error_prev, mu, v);
 
       cMo_prev = cMo;
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4479,54 +4829,153 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu()
 
 void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> *const ptr_I)
 {
+  const std::vector<int> featureTypes = getFeatureTypes();
+  runParallelTasks(ComputeVVSFeatureInteractionMatrixAndResiduTask(this, featureTypes, ptr_I), featureTypes.size(),
+                   m_useParallelTracking, m_nbParallelTrackingThreads);
+
+  // Stack the blocks in the same order whatever the execution order
+  unsigned int start_index = 0;
   if (m_trackerType & EDGE_TRACKER) {
-    vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(*ptr_I);
+    m_L.insert(m_L_edge, start_index, 0);
+    m_error.insert(start_index, m_error_edge);
+
+    start_index += m_error_edge.getRows();
   }
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
-    vpMbKltTracker::computeVVSInteractionMatrixAndResidu();
+    m_L.insert(m_L_klt, start_index, 0);
+    m_error.insert(start_index, m_error_klt);
+
+    start_index += m_error_klt.getRows();
   }
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    vpMbDepthNormalTracker::computeVVSInteractionMatrixAndResidu();
+    m_L.insert(m_L_depthNormal, start_index, 0);
+    m_error.insert(start_index, m_error_depthNormal);
+
+    start_index += m_error_depthNormal.getRows();
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
+    m_L.insert(m_L_depthDense, start_index, 0);
+    m_error.insert(start_index, m_error_depthDense);
+
+    //    start_index += m_error_depthDense.getRows();
+  }
+}
+
+/*!
+  Compute the interaction matrix and the residual of the feature types given
+  by \e featureType (a combination of vpTrackerType). Each feature type fills
+  its own block, so different feature types can be processed concurrently.
+*/
+void vpMbGenericTracker::TrackerWrapper::computeVVSFeatureInteractionMatrixAndResidu(
+    const int featureType, const vpImage<unsigned char> *const ptr_I)
+{
+  if (featureType & EDGE_TRACKER) {
+    vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(*ptr_I);
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (featureType & KLT_TRACKER) {
+    vpMbKltTracker::computeVVSInteractionMatrixAndResidu();
+  }
+#endif
+
+  if (featureType & DEPTH_NORMAL_TRACKER) {
+    vpMbDepthNormalTracker::computeVVSInteractionMatrixAndResidu();
+  }
+
+  if (featureType & DEPTH_DENSE_TRACKER) {
     vpMbDepthDenseTracker::computeVVSInteractionMatrixAndResidu();
   }
+}
+
+/*!
+  Compute the weights of the features, the weighted residual and the normal
+  equations \f$ L^T W^2 L \f$ and \f$ L^T W^2 e \f$ of this tracker,
+  expressed in its camera frame. The weighted interaction matrix is never
+  built.
+
+  \param factorEdge : Weight of the moving-edges features.
+  \param factorKlt : Weight of the KLT features.
+  \param factorDepth : Weight of the depth normal features.
+  \param factorDepthDense : Weight of the depth dense features.
+  \param w : Weights of the features (robust weights times the feature type
+  weight).
+  \param LTL : The resulting 6x6 matrix.
+  \param LTR : The resulting 6x1 column vector.
+  \param num : Weighted sum of the squared residuals, for the stopping criterion.
+  \param den : Sum of the weights, for the stopping criterion.
+*/
+void vpMbGenericTracker::TrackerWrapper::computeVVSWeightedNormalEquations(
+    const double factorEdge, const double factorKlt, const double factorDepth, const double factorDepthDense,
+    vpColVector &w, vpMatrix &LTL, vpColVector &LTR, double &num, double &den)
+{
+  w.resize(m_error.getRows(), false);
+  num = 0;
+  den = 0;
 
   unsigned int start_index = 0;
   if (m_trackerType & EDGE_TRACKER) {
-    m_L.insert(m_L_edge, start_index, 0);
-    m_error.insert(start_index, m_error_edge);
+    for (unsigned int i = 0; i < m_error_edge.getRows(); i++) {
+      double wi = m_w_edge[i] * m_factor[i] * factorEdge;
+      w[i] = wi;
+      m_weightedError[i] = wi * m_error[i];
+
+      num += wi * vpMath::sqr(m_error[i]);
+      den += wi;
+    }
 
     start_index += m_error_edge.getRows();
   }
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
-    m_L.insert(m_L_klt, start_index, 0);
-    m_error.insert(start_index, m_error_klt);
+    for (unsigned int i = 0; i < m_error_klt.getRows(); i++) {
+      double wi = m_w_klt[i] * factorKlt;
+      w[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
 
     start_index += m_error_klt.getRows();
   }
+#else
+  (void)factorKlt;
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    m_L.insert(m_L_depthNormal, start_index, 0);
-    m_error.insert(start_index, m_error_depthNormal);
+    for (unsigned int i = 0; i < m_error_depthNormal.getRows(); i++) {
+      double wi = m_w_depthNormal[i] * factorDepth;
+      w[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
 
     start_index += m_error_depthNormal.getRows();
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    m_L.insert(m_L_depthDense, start_index, 0);
-    m_error.insert(start_index, m_error_depthDense);
+    for (unsigned int i = 0; i < m_error_depthDense.getRows(); i++) {
+      double wi = m_w_depthDense[i] * factorDepthDense;
+      w[start_index + i] = wi;
+      m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+      num += wi * vpMath::sqr(m_error[start_index + i]);
+      den += wi;
+    }
 
     //    start_index += m_error_depthDense.getRows();
   }
+
+  computeVVSNormalEquations(m_L, w, m_error, LTL, LTR);
 }
 
 void vpMbGenericTracker::TrackerWrapper::computeVVSWeights()
@@ -4964,6 +5413,44 @@ void vpMbGenericTracker::TrackerWrapper::loadConfigFile(const std::string &confi
 #endif
 }
 
+/*!
+  Return the feature types used by this tracker, in the order used to stack
+  the interaction matrices.
+
+  \param groupDepthFeatures : If true, the depth normal and the depth dense
+  feature types are returned as a single element.
+*/
+std::vector<int> vpMbGenericTracker::TrackerWrapper::getFeatureTypes(const bool groupDepthFeatures) const
+{
+  std::vector<int> featureTypes;
+
+  if (m_trackerType & EDGE_TRACKER) {
+    featureTypes.push_back(EDGE_TRACKER);
+  }
+
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+  if (m_trackerType & KLT_TRACKER) {
+    featureTypes.push_back(KLT_TRACKER);
+  }
+#endif
+
+  if (groupDepthFeatures) {
+    if (m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) {
+      featureTypes.push_back(m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER));
+    }
+  } else {
+    if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+      featureTypes.push_back(DEPTH_NORMAL_TRACKER);
+    }
+
+    if (m_trackerType & DEPTH_DENSE_TRACKER) {
+      featureTypes.push_back(DEPTH_DENSE_TRACKER);
+    }
+  }
+
+  return featureTypes;
+}
+
 #ifdef VISP_HAVE_PCL
 void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned char> *const ptr_I,
                                                       const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
@@ -5019,43 +5506,7 @@ void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned cha
 void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
                                                      const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-  if (m_trackerType & EDGE_TRACKER) {
-    try {
-      vpMbEdgeTracker::trackMovingEdge(*ptr_I);
-    } catch (...) {
-      std::cerr << "Error in moving edge tracking" << std::endl;
-      throw;
-    }
-  }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  if (m_trackerType & KLT_TRACKER) {
-    try {
-      vpMbKltTracker::preTracking(*ptr_I);
-    } catch (const vpException &e) {
-      std::cerr << "Error in KLT tracking: " << e.what() << std::endl;
-      throw;
-    }
-  }
-#endif
-
-  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    try {
-      vpMbDepthNormalTracker::segmentPointCloud(point_cloud);
-    } catch (...) {
-      std::cerr << "Error in Depth normal tracking" << std::endl;
-      throw;
-    }
-  }
-
-  if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    try {
-      vpMbDepthDenseTracker::segmentPointCloud(point_cloud);
-    } catch (...) {
-      std::cerr << "Error in Depth dense tracking" << std::endl;
-      throw;
-    }
-  }
+  preTrackingImpl(ptr_I, &point_cloud, point_cloud ? point_cloud->width : 0, point_cloud ? point_cloud->height : 0);
 }
 #endif
 
@@ -5116,7 +5567,28 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
                                                      const unsigned int pointcloud_width,
                                                      const unsigned int pointcloud_height)
 {
-  if (m_trackerType & EDGE_TRACKER) {
+  preTrackingImpl(ptr_I, point_cloud, pointcloud_width, pointcloud_height);
+}
+
+void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
+                                                     const vpMbtPointCloud *const point_cloud)
+{
+  preTrackingImpl(ptr_I, point_cloud, point_cloud != NULL ? point_cloud->getWidth() : 0,
+                  point_cloud != NULL ? point_cloud->getHeight() : 0);
+}
+
+/*!
+  Track the feature types given by \e featureType (a combination of
+  vpTrackerType). The point cloud is only used by the depth feature types.
+*/
+template <class PointCloud>
+void vpMbGenericTracker::TrackerWrapper::preTrackingFeature(const int featureType,
+                                                            const vpImage<unsigned char> *const ptr_I,
+                                                            const PointCloud *const point_cloud,
+                                                            const unsigned int pointcloud_width,
+                                                            const unsigned int pointcloud_height)
+{
+  if (featureType & EDGE_TRACKER) {
     try {
       vpMbEdgeTracker::trackMovingEdge(*ptr_I);
     } catch (...) {
@@ -5126,7 +5598,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
   }
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  if (m_trackerType & KLT_TRACKER) {
+  if (featureType & KLT_TRACKER) {
     try {
       vpMbKltTracker::preTracking(*ptr_I);
     } catch (const vpException &e) {
@@ -5136,18 +5608,18 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
   }
 #endif
 
-  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
+  if (featureType & DEPTH_NORMAL_TRACKER) {
     try {
-      vpMbDepthNormalTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
+      vpMbDepthNormalTracker::segmentPointCloudImpl(*point_cloud, pointcloud_width, pointcloud_height);
     } catch (...) {
-      std::cerr << "Error in Depth tracking" << std::endl;
+      std::cerr << "Error in Depth normal tracking" << std::endl;
       throw;
     }
   }
 
-  if (m_trackerType & DEPTH_DENSE_TRACKER) {
+  if (featureType & DEPTH_DENSE_TRACKER) {
     try {
-      vpMbDepthDenseTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
+      vpMbDepthDenseTracker::segmentPointCloudImpl(*point_cloud, pointcloud_width, pointcloud_height);
     } catch (...) {
       std::cerr << "Error in Depth dense tracking" << std::endl;
       throw;
@@ -5155,6 +5627,21 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
   }
 }
 
+template <class PointCloud>
+void vpMbGenericTracker::TrackerWrapper::preTrackingImpl(const vpImage<unsigned char> *const ptr_I,
+                                                         const PointCloud *const point_cloud,
+                                                         const unsigned int pointcloud_width,
+                                                         const unsigned int pointcloud_height)
+{
+  // The depth features share the polygons of the model, which are modified when computing their clipped region of
+  // interest: the point cloud is segmented for both depth feature types by the same task. Display and Ogre rendering
+  // cannot be done concurrently.
+  const std::vector<int> featureTypes = getFeatureTypes(true);
+  runParallelTasks(
+      PreTrackingFeatureTask<PointCloud>(this, featureTypes, ptr_I, point_cloud, pointcloud_width, pointcloud_height),
+      featureTypes.size(), m_useParallelTracking && !displayFeatures && !useOgre, m_nbParallelTrackingThreads);
+}
+
 void vpMbGenericTracker::TrackerWrapper::reInitModel(const vpImage<unsigned char> &I, const std::string &cad_name,
                                                      const vpHomogeneousMatrix &cMo_, const bool verbose,
                                                      const vpHomogeneousMatrix &T)
@@ -5191,6 +5678,7 @@ void vpMbGenericTracker::TrackerWrapper::reInitModel(const vpImage<unsigned char
       }
 
       lines[i].clear();
+      m_linesIndex[i].clear();
       cylinders[i].clear();
       circles[i].clear();
     }
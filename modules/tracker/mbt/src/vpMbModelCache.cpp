@@ -0,0 +1,382 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Binary cache of the primitives of a 3D model.
+ *
+ *****************************************************************************/
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/mbt/vpMbModelCache.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Version of the file format, to increment when the layout changes
+const uint32_t cacheVersion = 1;
+const uint32_t byteOrderMark = 0x01020304;
+const char cacheMagic[8] = {'V', 'I', 'S', 'P', 'M', 'B', 'C', '\0'};
+
+// Header of the file, followed by the sources, the records, the points (3
+// doubles each) and the strings. All the sizes are multiples of 8 bytes, so
+// that the arrays can be used in place in the mapped file.
+struct vpHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t nbSources;
+  uint32_t nbRecords;
+  uint32_t nbPoints;
+  uint32_t keyLength;
+  uint32_t stringsSize;
+  int32_t firstIdFace;
+  uint32_t statistics[6];
+};
+
+// FNV-1a hash
+uint64_t hashData(const unsigned char *data, const size_t size)
+{
+  uint64_t hash = (static_cast<uint64_t>(0xcbf29ce4) << 32) | 0x84222325;
+  const uint64_t prime = (static_cast<uint64_t>(1) << 40) | 0x1b3;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= prime;
+  }
+  return hash;
+}
+
+void hashFile(const std::string &filename, uint64_t &size, uint64_t &hash)
+{
+  vpMemoryMappedFile file(filename);
+  size = file.getSize();
+  hash = hashData(file.getData(), file.getSize());
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The cache is empty.
+*/
+vpMbModelCache::vpMbModelCache()
+  : m_firstIdFace(0), m_records(), m_points(), m_strings(), m_sources(), m_file(), m_recordsData(NULL),
+    m_pointsData(NULL), m_stringsData(NULL), m_nbPrimitives(0)
+{
+  for (unsigned int i = 0; i < 6; i++)
+    m_statistics[i] = 0;
+}
+
+/*!
+  Add a primitive at the end of the model.
+
+  \param primitive : Primitive to add.
+*/
+void vpMbModelCache::addPrimitive(const vpPrimitive &primitive)
+{
+  vpRecord record;
+  record.type = (uint32_t)primitive.type;
+  record.idFace = primitive.idFace;
+  record.firstPoint = (uint32_t)(m_points.size() / 3);
+  record.nbPoints = (uint32_t)primitive.points.size();
+  record.nameOffset = (uint32_t)m_strings.size();
+  record.nameLength = (uint32_t)primitive.name.size();
+  record.useLod = primitive.useLod ? 1 : 0;
+  record.reserved = 0;
+  record.radius = primitive.radius;
+  record.minPolygonAreaThreshold = primitive.minPolygonAreaThreshold;
+  record.minLineLengthThreshold = primitive.minLineLengthThreshold;
+  m_records.push_back(record);
+
+  for (size_t i = 0; i < primitive.points.size(); i++) {
+    m_points.push_back(primitive.points[i].get_oX());
+    m_points.push_back(primitive.points[i].get_oY());
+    m_points.push_back(primitive.points[i].get_oZ());
+  }
+  m_strings.insert(m_strings.end(), primitive.name.begin(), primitive.name.end());
+
+  setPointers();
+}
+
+/*!
+  Add a source file of the model. Its size and its hash are computed now and
+  compared by load() to the ones of the file at that time.
+
+  \param filename : Path of the source file.
+
+  \exception vpException::ioError : If the file cannot be read.
+*/
+void vpMbModelCache::addSourceFile(const std::string &filename)
+{
+  vpSource source;
+  hashFile(filename, source.size, source.hash);
+  source.nameOffset = (uint32_t)m_strings.size();
+  source.nameLength = (uint32_t)filename.size();
+  m_sources.push_back(source);
+
+  m_strings.insert(m_strings.end(), filename.begin(), filename.end());
+  setPointers();
+}
+
+/*!
+  Remove all the primitives and the source files, and close the cache file
+  if one has been loaded.
+*/
+void vpMbModelCache::clear()
+{
+  m_file.close();
+  m_firstIdFace = 0;
+  for (unsigned int i = 0; i < 6; i++)
+    m_statistics[i] = 0;
+  m_records.clear();
+  m_points.clear();
+  m_strings.clear();
+  m_sources.clear();
+  setPointers();
+}
+
+/*!
+  Get the name of the cache file of a model, made of the name of the model
+  file and of the hash of the key.
+
+  \param directory : Directory of the cache files.
+  \param modelFile : Path of the model file.
+  \param key : Key describing the loading parameters of the model.
+
+  \return Path of the cache file.
+*/
+std::string vpMbModelCache::getCacheFilename(const std::string &directory, const std::string &modelFile,
+                                             const std::string &key)
+{
+  std::ostringstream name;
+  name << vpIoTools::getNameWE(modelFile) << "." << std::hex << std::setfill('0') << std::setw(16)
+       << hashData(reinterpret_cast<const unsigned char *>(key.c_str()), key.size()) << ".bin";
+
+  return vpIoTools::createFilePath(directory, name.str());
+}
+
+/*!
+  Get a primitive.
+
+  \param index : Index of the primitive, lower than getNbPrimitives().
+  \param primitive : The primitive.
+*/
+void vpMbModelCache::getPrimitive(const unsigned int index, vpPrimitive &primitive) const
+{
+  const vpRecord &record = m_recordsData[index];
+  primitive.type = (vpPrimitiveType)record.type;
+  primitive.idFace = record.idFace;
+  primitive.points.resize(record.nbPoints);
+  const double *points = m_pointsData + 3 * record.firstPoint;
+  for (unsigned int i = 0; i < record.nbPoints; i++)
+    primitive.points[i].setWorldCoordinates(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+  primitive.radius = record.radius;
+  primitive.name.assign(m_stringsData + record.nameOffset, record.nameLength);
+  primitive.useLod = record.useLod != 0;
+  primitive.minPolygonAreaThreshold = record.minPolygonAreaThreshold;
+  primitive.minLineLengthThreshold = record.minLineLengthThreshold;
+}
+
+/*!
+  Get the number of points, lines, polygon lines, polygon points, cylinders
+  and circles of the model.
+
+  \param statistics : The 6 numbers, in this order.
+*/
+void vpMbModelCache::getStatistics(unsigned int statistics[6]) const
+{
+  for (unsigned int i = 0; i < 6; i++)
+    statistics[i] = m_statistics[i];
+}
+
+/*!
+  Load a cache file, written by save(). The file is mapped in memory until
+  clear() is called or the cache is destroyed.
+
+  \param filename : Path of the cache file.
+  \param key : Key describing the loading parameters of the model, that must
+  be the one given to save().
+
+  \return True if the cache is valid. False if the file does not exist, is
+  not a valid cache file, was written with another key, or if one of the
+  source files has been modified. The cache is then empty.
+*/
+bool vpMbModelCache::load(const std::string &filename, const std::string &key)
+{
+  clear();
+  if (!vpIoTools::checkFilename(filename))
+    return false;
+
+  try {
+    m_file.open(filename);
+
+    vpHeader header;
+    if (m_file.getSize() < sizeof(vpHeader))
+      throw vpException(vpException::ioError, "Truncated model cache file");
+    const unsigned char *data = m_file.getData();
+    memcpy(&header, data, sizeof(vpHeader));
+    if (memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 || header.version != cacheVersion ||
+        header.byteOrder != byteOrderMark)
+      throw vpException(vpException::ioError, "Not a model cache file");
+
+    const uint64_t offsetRecords = sizeof(vpHeader) + (uint64_t)header.nbSources * sizeof(vpSource);
+    const uint64_t offsetPoints = offsetRecords + (uint64_t)header.nbRecords * sizeof(vpRecord);
+    const uint64_t offsetStrings = offsetPoints + (uint64_t)header.nbPoints * 3 * sizeof(double);
+    if (offsetStrings + header.stringsSize != (uint64_t)m_file.getSize() || header.keyLength > header.stringsSize)
+      throw vpException(vpException::ioError, "Wrong size of the model cache file");
+
+    const char *strings = reinterpret_cast<const char *>(data + offsetStrings);
+    if (header.keyLength != key.size() ||
+        memcmp(strings + header.stringsSize - header.keyLength, key.c_str(), key.size()) != 0)
+      throw vpException(vpException::ioError, "Model cache file written with another key");
+
+    const vpSource *sources = reinterpret_cast<const vpSource *>(data + sizeof(vpHeader));
+    for (unsigned int i = 0; i < header.nbSources; i++) {
+      if ((uint64_t)sources[i].nameOffset + sources[i].nameLength > header.stringsSize)
+        throw vpException(vpException::ioError, "Wrong source file in the model cache file");
+
+      uint64_t size, hash;
+      hashFile(std::string(strings + sources[i].nameOffset, sources[i].nameLength), size, hash);
+      if (size != sources[i].size || hash != sources[i].hash)
+        throw vpException(vpException::ioError, "Modified source file");
+    }
+
+    const vpRecord *records = reinterpret_cast<const vpRecord *>(data + offsetRecords);
+    for (unsigned int i = 0; i < header.nbRecords; i++) {
+      if (records[i].type > (uint32_t)CIRCLE ||
+          (uint64_t)records[i].firstPoint + records[i].nbPoints > header.nbPoints ||
+          (uint64_t)records[i].nameOffset + records[i].nameLength > header.stringsSize ||
+          (records[i].type == (uint32_t)CYLINDER && records[i].nbPoints != 2) ||
+          (records[i].type == (uint32_t)CIRCLE && records[i].nbPoints != 3))
+        throw vpException(vpException::ioError, "Wrong primitive in the model cache file");
+    }
+
+    m_recordsData = records;
+    m_pointsData = reinterpret_cast<const double *>(data + offsetPoints);
+    m_stringsData = strings;
+    m_nbPrimitives = header.nbRecords;
+    m_firstIdFace = header.firstIdFace;
+    for (unsigned int i = 0; i < 6; i++)
+      m_statistics[i] = header.statistics[i];
+  } catch (const vpException &) {
+    clear();
+    return false;
+  }
+
+  return true;
+}
+
+/*!
+  Write the primitives and the source files in a cache file. The file is
+  first written under a temporary name then renamed, so that other processes
+  never read a partially written file.
+
+  \param filename : Path of the cache file.
+  \param key : Key describing the loading parameters of the model.
+
+  \exception vpException::ioError : If the file cannot be written.
+*/
+void vpMbModelCache::save(const std::string &filename, const std::string &key) const
+{
+  vpHeader header;
+  memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+  header.version = cacheVersion;
+  header.byteOrder = byteOrderMark;
+  header.nbSources = (uint32_t)m_sources.size();
+  header.nbRecords = (uint32_t)m_records.size();
+  header.nbPoints = (uint32_t)(m_points.size() / 3);
+  header.keyLength = (uint32_t)key.size();
+  header.stringsSize = (uint32_t)(m_strings.size() + key.size());
+  header.firstIdFace = m_firstIdFace;
+  for (unsigned int i = 0; i < 6; i++)
+    header.statistics[i] = m_statistics[i];
+
+  std::ostringstream tmp;
+  tmp << filename << "." << std::fixed << std::setprecision(0) << vpTime::measureTimeMicros() << ".tmp";
+  const std::string tmpFilename = tmp.str();
+
+  std::ofstream file(tmpFilename.c_str(), std::ios::out | std::ios::binary);
+  if (!file.is_open())
+    throw vpException(vpException::ioError, "Cannot create the model cache file %s", tmpFilename.c_str());
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(vpHeader));
+  if (!m_sources.empty())
+    file.write(reinterpret_cast<const char *>(&m_sources[0]), (std::streamsize)(m_sources.size() * sizeof(vpSource)));
+  if (!m_records.empty())
+    file.write(reinterpret_cast<const char *>(&m_records[0]), (std::streamsize)(m_records.size() * sizeof(vpRecord)));
+  if (!m_points.empty())
+    file.write(reinterpret_cast<const char *>(&m_points[0]), (std::streamsize)(m_points.size() * sizeof(double)));
+  if (!m_strings.empty())
+    file.write(&m_strings[0], (std::streamsize)m_strings.size());
+  file.write(key.c_str(), (std::streamsize)key.size());
+  file.close();
+
+  if (file.fail()) {
+    vpIoTools::remove(tmpFilename);
+    throw vpException(vpException::ioError, "Cannot write the model cache file %s", tmpFilename.c_str());
+  }
+
+  // rename() does not replace an existing file on Windows
+  if (!vpIoTools::rename(tmpFilename, filename)) {
+    vpIoTools::remove(filename);
+    if (!vpIoTools::rename(tmpFilename, filename)) {
+      vpIoTools::remove(tmpFilename);
+      throw vpException(vpException::ioError, "Cannot rename the model cache file %s", tmpFilename.c_str());
+    }
+  }
+}
+
+/*!
+  Set the number of points, lines, polygon lines, polygon points, cylinders
+  and circles of the model.
+
+  \param statistics : The 6 numbers, in this order.
+*/
+void vpMbModelCache::setStatistics(const unsigned int statistics[6])
+{
+  for (unsigned int i = 0; i < 6; i++)
+    m_statistics[i] = statistics[i];
+}
+
+/*!
+  Make the views refer to the recorded data.
+*/
+void vpMbModelCache::setPointers()
+{
+  m_recordsData = m_records.empty() ? NULL : &m_records[0];
+  m_pointsData = m_points.empty() ? NULL : &m_points[0];
+  m_stringsData = m_strings.empty() ? NULL : &m_strings[0];
+  m_nbPrimitives = (unsigned int)m_records.size();
+}
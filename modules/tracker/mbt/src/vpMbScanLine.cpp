@@ -56,10 +56,50 @@
 #include <visp3/gui/vpDisplayX.h>
 #endif
 
+#if defined(VISP_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
+namespace
+{
+// Order the intersections by scanline, then along the scanline.
+struct vpMbScanLineSegmentScanLineComparator {
+  inline bool operator()(const vpMbScanLine::vpMbScanLineSegment &a, const vpMbScanLine::vpMbScanLineSegment &b) const
+  {
+    if (a.scanline != b.scanline)
+      return a.scanline < b.scanline;
+    return vpMbScanLine::vpMbScanLineSegmentComparator()(a, b);
+  }
+};
+
+bool isSameEdge(const vpMbScanLine::vpMbScanLineEdge &a, const vpMbScanLine::vpMbScanLineEdge &b)
+{
+  vpMbScanLine::vpMbScanLineEdgeComparator comparator;
+  return !comparator(a, b) && !comparator(b, a);
+}
+
+// Stable insertion sort of the polygons crossing the scanline by depth. The
+// stack is small and its order barely changes between two intersections.
+void sortStack(std::vector<std::pair<double, vpMbScanLine::vpMbScanLineSegment> > &stack)
+{
+  vpMbScanLine::vpMbScanLineSegmentComparator comparator;
+  for (size_t i = 1; i < stack.size(); ++i) {
+    if (comparator(stack[i], stack[i - 1])) {
+      std::pair<double, vpMbScanLine::vpMbScanLineSegment> tmp = stack[i];
+      size_t j = i;
+      for (; j > 0 && comparator(tmp, stack[j - 1]); --j)
+        stack[j] = stack[j - 1];
+      stack[j] = tmp;
+    }
+  }
+}
+}
+
 vpMbScanLine::vpMbScanLine()
-  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(), visibility_samples(), depthTreshold(1e-06)
+  : w(0), h(0), K(), maskBorder(0), mask(), primitive_ids(), projected_polygons(), projected_edges(), edges(),
+    visibility_offsets(), visibility_samples(), depthTreshold(1e-06), nbBands(0)
 #if defined(DEBUG_DISP)
     ,
     dispMaskDebug(NULL), dispLineDebug(NULL), linedebugImg()
@@ -83,216 +123,267 @@ vpMbScanLine::~vpMbScanLine()
     delete dispMaskDebug;
 #endif
 }
-/*!
-  Compute the intersections between Y-axis scanlines and a given line (two
-  points polygon).
 
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
-  \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+/*!
+  Compute the intersections between the scanlines of a band and a projected
+  edge.
+
+  \param b_axis_Y : True for the Y-axis scanlines (rows), false for the
+  X-axis scanlines (columns).
+  \param edge : Projected edge.
+  \param ID : Id of the polygon of the edge (has to be know when using
+  queries).
+  \param begin : First scanline of the band.
+  \param end : Scanline after the last one of the band.
+  \param segments : Resulting intersections, appended by increasing scanline.
 */
-void vpMbScanLine::drawLineY(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &edge, const int ID,
-                             std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawEdge(const bool b_axis_Y, const vpMbScanLineProjectedEdge &edge, const int ID,
+                            const unsigned int begin, const unsigned int end,
+                            std::vector<vpMbScanLineSegment> &segments) const
 {
-  double x0 = a[0] / a[2];
-  double y0 = a[1] / a[2];
-  double z0 = a[2];
-  double x1 = b[0] / b[2];
-  double y1 = b[1] / b[2];
-  double z1 = b[2];
-  if (y0 > y1) {
-    std::swap(x0, x1);
-    std::swap(y0, y1);
+  // Coordinates along the scanlines (u) and across the scanlines (v)
+  double u0 = b_axis_Y ? edge.x0 : edge.y0;
+  double v0 = b_axis_Y ? edge.y0 : edge.x0;
+  double z0 = edge.z0;
+  double u1 = b_axis_Y ? edge.x1 : edge.y1;
+  double v1 = b_axis_Y ? edge.y1 : edge.x1;
+  double z1 = edge.z1;
+  if (v0 > v1) {
+    std::swap(u0, u1);
+    std::swap(v0, v1);
     std::swap(z0, z1);
   }
 
-  // if (y0 >= h - 1 || y1 < 0 || y1 == y0)
-  if (y0 >= h - 1 || y1 < 0 || std::fabs(y1 - y0) <= std::numeric_limits<double>::epsilon())
+  const unsigned int size = b_axis_Y ? h : w;
+  // if (v0 >= size - 1 || v1 < 0 || v1 == v0)
+  if (v0 >= size - 1 || v1 < 0 || std::fabs(v1 - v0) <= std::numeric_limits<double>::epsilon())
     return;
 
-  const unsigned int _y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(y0)));
-  const double _y1 = (std::min)((double)h, (double)y1);
-
-  const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
+  const unsigned int _v0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(v0)));
+  const double _v1 = (std::min)((double)size, (double)v1);
 
-  for (unsigned int y = _y0; y < _y1; ++y) {
-    const double x = x0 + (x1 - x0) * (y - y0) / (y1 - y0);
-    const double alpha = getAlpha(y, y0 * z0, z0, y1 * z1, z1);
+  for (unsigned int v = (std::max)(_v0, begin); v < _v1 && v < end; ++v) {
+    const double u = u0 + (u1 - u0) * (v - v0) / (v1 - v0);
+    const double alpha = getAlpha(v, v0 * z0, z0, v1 * z1, z1);
     vpMbScanLineSegment s;
-    s.p = x;
+    s.p = u;
     s.type = POINT;
     s.Z2 = s.Z1 = mix(z0, z1, alpha);
     s.P2 = s.P1 = s.p * s.Z1;
     s.ID = ID;
-    s.edge = edge;
-    s.b_sample_Y = b_sample_Y;
-    scanlines[y].push_back(s);
+    s.edge = edge.edge;
+    s.scanline = v;
+    s.b_sample_Y = edge.b_sample_Y;
+    segments.push_back(s);
   }
 }
 
 /*!
-  Compute the intersections between X-axis scanlines and a given line (two
-  points polygon).
-
-  \param a : First point of the line.
-  \param b : Second point of the line.
-  \param edge : Pair with the two points of the line.
-  \param ID : Id of the given line (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  Compute the intersections between the scanlines of a band and all the
+  polygons. The intersections of a polygon on a scanline are marked as
+  starting or ending points.
+
+  \param b_axis_Y : True for the Y-axis scanlines (rows), false for the
+  X-axis scanlines (columns).
+  \param begin : First scanline of the band.
+  \param end : Scanline after the last one of the band.
+  \param segments : Resulting intersections, in the order of the polygons.
+  \param polygon_segments : Buffer for the intersections of one polygon.
 */
-void vpMbScanLine::drawLineX(const vpColVector &a, const vpColVector &b, const vpMbScanLineEdge &edge, const int ID,
-                             std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawBand(const bool b_axis_Y, const unsigned int begin, const unsigned int end,
+                            std::vector<vpMbScanLineSegment> &segments,
+                            std::vector<vpMbScanLineSegment> &polygon_segments) const
 {
-  double x0 = a[0] / a[2];
-  double y0 = a[1] / a[2];
-  double z0 = a[2];
-  double x1 = b[0] / b[2];
-  double y1 = b[1] / b[2];
-  double z1 = b[2];
-  if (x0 > x1) {
-    std::swap(x0, x1);
-    std::swap(y0, y1);
-    std::swap(z0, z1);
-  }
+  segments.clear();
+
+  for (size_t i = 0; i < projected_polygons.size(); ++i) {
+    const vpMbScanLinePolygon &polygon = projected_polygons[i];
+    const double vmin = b_axis_Y ? polygon.ymin : polygon.xmin;
+    const double vmax = b_axis_Y ? polygon.ymax : polygon.xmax;
+    if (vmax < begin || vmin >= end)
+      continue;
+
+    if (!polygon.b_closed) {
+      drawEdge(b_axis_Y, projected_edges[polygon.first_edge], polygon.ID, begin, end, segments);
+      continue;
+    }
 
-  // if (x0 >= w - 1 || x1 < 0 || x1 == x0)
-  if (x0 >= w - 1 || x1 < 0 || std::fabs(x1 - x0) <= std::numeric_limits<double>::epsilon())
-    return;
+    polygon_segments.clear();
+    for (unsigned int k = 0; k < polygon.nb_edges; ++k)
+      drawEdge(b_axis_Y, projected_edges[polygon.first_edge + k], polygon.ID, begin, end, polygon_segments);
 
-  const unsigned int _x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(x0)));
-  const double _x1 = (std::min)((double)w, (double)x1);
+    std::stable_sort(polygon_segments.begin(), polygon_segments.end(), vpMbScanLineSegmentScanLineComparator());
 
-  const bool b_sample_Y = (std::fabs(y0 - y1) > std::fabs(x0 - x1));
+    bool b_start = true;
+    size_t start = 0;
+    for (size_t k = 0; k < polygon_segments.size(); ++k) {
+      vpMbScanLineSegment s = polygon_segments[k];
+      if (k > 0 && s.scanline != polygon_segments[k - 1].scanline)
+        b_start = true;
 
-  for (unsigned int x = _x0; x < _x1; ++x) {
-    const double y = y0 + (y1 - y0) * (x - x0) / (x1 - x0);
-    const double alpha = getAlpha(x, x0 * z0, z0, x1 * z1, z1);
-    vpMbScanLineSegment s;
-    s.p = y;
-    s.type = POINT;
-    s.Z2 = s.Z1 = mix(z0, z1, alpha);
-    s.P2 = s.P1 = s.p * s.Z1;
-    s.ID = ID;
-    s.edge = edge;
-    s.b_sample_Y = b_sample_Y;
-    scanlines[x].push_back(s);
+      if (b_start) {
+        s.type = START;
+        s.P1 = s.p * s.Z1;
+        start = segments.size();
+        b_start = false;
+      } else {
+        vpMbScanLineSegment &prev = segments[start];
+        s.type = END;
+        s.P1 = prev.P1;
+        s.Z1 = prev.Z1;
+        s.P2 = s.p * s.Z2;
+        prev.P2 = s.P2;
+        prev.Z2 = s.Z2;
+        b_start = true;
+      }
+      segments.push_back(s);
+    }
   }
 }
 
 /*!
-  Compute the Y-axis scanlines intersections of a polygon.
-
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  Find the visible polygons along a scanline.
+
+  \param b_axis_Y : True for a Y-axis scanline (row), false for a X-axis
+  scanline (column).
+  \param scanline : Intersections with the scanline, sorted along it.
+  \param size : Number of intersections.
+  \param stack : Buffer for the polygons crossing the scanline.
+  \param samples : Visible samples of the edges, as (edge, scanline) pairs.
+  \param mask_axis : Mask of the axis, only used with a mask border.
 */
-void vpMbScanLine::drawPolygonY(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawScanLine(const bool b_axis_Y, const vpMbScanLineSegment *scanline, const size_t size,
+                                std::vector<std::pair<double, vpMbScanLineSegment> > &stack,
+                                std::vector<std::pair<unsigned int, int> > &samples,
+                                vpImage<unsigned char> &mask_axis)
 {
-  if (polygon.size() < 2)
-    return;
+  const unsigned int v = scanline[0].scanline;
+  int last_ID = -1;
+  vpMbScanLineSegment last_visible;
+  stack.clear();
 
-  if (polygon.size() == 2) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
+  for (size_t i = 0; i < size; ++i) {
+    const vpMbScanLineSegment &s = scanline[i];
 
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon.front().first, polygon.back().first), ID, scanlines);
-    return;
-  }
+    switch (s.type) {
+    case START:
+      stack.push_back(std::make_pair(s.Z1, s));
+      break;
+    case END:
+      for (size_t j = 0; j < stack.size(); ++j)
+        if (stack[j].second.ID == s.ID) {
+          if (j != stack.size() - 1)
+            stack[j] = stack.back();
+          stack.pop_back();
+          break;
+        }
+      break;
+    case POINT:
+      break;
+    }
 
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(h);
+    for (size_t j = 0; j < stack.size(); ++j) {
+      const vpMbScanLineSegment &s0 = stack[j].second;
+      stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
+    }
+    sortStack(stack);
+
+    int new_ID = stack.empty() ? -1 : stack.front().second.ID;
+
+    if (new_ID != last_ID || s.type == POINT) {
+      if (s.b_sample_Y == b_axis_Y)
+        switch (s.type) {
+        case POINT:
+          if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
+            samples.push_back(std::make_pair(s.edge, (int)v));
+          break;
+        case START:
+          if (new_ID == s.ID)
+            samples.push_back(std::make_pair(s.edge, (int)v));
+          break;
+        case END:
+          if (last_ID == s.ID)
+            samples.push_back(std::make_pair(s.edge, (int)v));
+          break;
+        }
 
-  for (size_t i = 0; i < polygon.size(); ++i) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
+      // This part will only be used for MbKltTracking
+      if (last_ID != -1) {
+        if (b_axis_Y) {
+          const unsigned int x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+          const double x1 = (std::min)((double)w, (double)s.p);
+          for (unsigned int x = x0 + maskBorder; x < x1 - maskBorder; ++x) {
+            primitive_ids[v][x] = last_visible.ID;
 
-    drawLineY(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID,
-              local_scanlines);
-  }
+            if (maskBorder != 0)
+              mask_axis[v][x] = 255;
+            else
+              mask[v][x] = 255;
+          }
+        } else if (maskBorder != 0) {
+          const unsigned int y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
+          const double y1 = (std::min)((double)h, (double)s.p);
+          for (unsigned int y = y0 + maskBorder; y < y1 - maskBorder; ++y)
+            mask_axis[y][v] = 255;
+        }
+      }
 
-  createScanLinesFromLocals(scanlines, local_scanlines, h);
+      last_ID = new_ID;
+      if (!stack.empty()) {
+        last_visible = stack.front().second;
+        last_visible.p = s.p;
+      }
+    }
+  }
 }
 
 /*!
-  Compute the X-axis scanlines intersections of a polygon.
-
-  \param polygon : Polygon composed by an array of lines.
-  \param ID : ID of the polygon (has to be know when using queries).
-  \param scanlines : Resulting intersections.
+  Compute the visible polygons along all the scanlines of an axis. The
+  scanlines are split in bands that are processed independently, in parallel
+  when OpenMP is available. The number of bands can be set with setNbBands().
+
+  \param b_axis_Y : True for the Y-axis scanlines (rows), false for the
+  X-axis scanlines (columns).
+  \param samples : Visible samples of the edges, as (edge, scanline) pairs.
+  \param mask_axis : Mask of the axis, only used with a mask border.
 */
-void vpMbScanLine::drawPolygonX(const std::vector<std::pair<vpPoint, unsigned int> > &polygon, const int ID,
-                                std::vector<std::vector<vpMbScanLineSegment> > &scanlines)
+void vpMbScanLine::drawScanLines(const bool b_axis_Y, std::vector<std::pair<unsigned int, int> > &samples,
+                                 vpImage<unsigned char> &mask_axis)
 {
-  if (polygon.size() < 2)
-    return;
-
-  if (polygon.size() == 2) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon.front().first, p1, K);
-    createVectorFromPoint(polygon.back().first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon.front().first, polygon.back().first), ID, scanlines);
-    return;
-  }
-
-  std::vector<std::vector<vpMbScanLineSegment> > local_scanlines;
-  local_scanlines.resize(w);
-
-  for (size_t i = 0; i < polygon.size(); ++i) {
-    vpColVector p1, p2;
-    createVectorFromPoint(polygon[i].first, p1, K);
-    createVectorFromPoint(polygon[(i + 1) % polygon.size()].first, p2, K);
-
-    drawLineX(p1, p2, makeMbScanLineEdge(polygon[i].first, polygon[(i + 1) % polygon.size()].first), ID,
-              local_scanlines);
-  }
+  const unsigned int size = b_axis_Y ? h : w;
+  int nbThreads = 1;
+#if defined(VISP_HAVE_OPENMP)
+  if (!omp_in_parallel())
+    nbThreads = omp_get_max_threads();
+#endif
+  // Several bands per thread to balance the load
+  const unsigned int nbBandsWanted = nbBands != 0 ? nbBands : (nbThreads > 1 ? 4 * (unsigned int)nbThreads : 1u);
+  const int nb_bands = (int)(std::min)(size, nbBandsWanted);
+  std::vector<std::vector<std::pair<unsigned int, int> > > band_samples((size_t)nb_bands);
 
-  createScanLinesFromLocals(scanlines, local_scanlines, w);
-}
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nbThreads) if (nbThreads > 1)
+#endif
+  for (int band = 0; band < nb_bands; band++) {
+    const unsigned int begin = (unsigned int)(((size_t)size * (size_t)band) / (size_t)nb_bands);
+    const unsigned int end = (unsigned int)(((size_t)size * (size_t)(band + 1)) / (size_t)nb_bands);
+    std::vector<vpMbScanLineSegment> segments, polygon_segments;
+    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
 
-/*!
-  Organise local scanlines in a global scanline vector.
-  It also marks the computed intersections as starting or ending points.
-  This function will only be called by the drawPolygons functions.
+    drawBand(b_axis_Y, begin, end, segments, polygon_segments);
+    std::stable_sort(segments.begin(), segments.end(), vpMbScanLineSegmentScanLineComparator());
 
-  \param scanlines : Global scanline vector.
-  \param localScanlines : Local scanline vector (X or Y-axis).
-  \param size : Corresponding size (typically the width or the height).
-*/
-void vpMbScanLine::createScanLinesFromLocals(std::vector<std::vector<vpMbScanLineSegment> > &scanlines,
-                                             std::vector<std::vector<vpMbScanLineSegment> > &localScanlines,
-                                             const unsigned int &size)
-{
-  for (unsigned int j = 0; j < size; ++j) {
-    std::vector<vpMbScanLineSegment> &scanline = localScanlines[j];
-    sort(scanline.begin(), scanline.end(),
-         vpMbScanLineSegmentComparator()); // Not sure its necessary
-
-    bool b_start = true;
-    for (size_t i = 0; i < scanline.size(); ++i) {
-      vpMbScanLineSegment s = scanline[i];
-      if (b_start) {
-        s.type = START;
-        s.P1 = s.p * s.Z1;
-        b_start = false;
-      } else {
-        vpMbScanLineSegment &prev = scanlines[j].back();
-        s.type = END;
-        s.P1 = prev.P1;
-        s.Z1 = prev.Z1;
-        s.P2 = s.p * s.Z2;
-        prev.P2 = s.P2;
-        prev.Z2 = s.Z2;
-        b_start = true;
-      }
-      scanlines[j].push_back(s);
+    for (size_t i = 0; i < segments.size();) {
+      size_t j = i + 1;
+      while (j < segments.size() && segments[j].scanline == segments[i].scanline)
+        ++j;
+      drawScanLine(b_axis_Y, &segments[i], j - i, stack, band_samples[(size_t)band], mask_axis);
+      i = j;
     }
   }
+
+  for (size_t band = 0; band < band_samples.size(); band++)
+    samples.insert(samples.end(), band_samples[band].begin(), band_samples[band].end());
 }
 
 /*!
@@ -312,172 +403,83 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
   this->h = height;
   this->K = cam;
 
-  visibility_samples.clear();
-
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesY;
-  scanlinesY.resize(h);
-  std::vector<std::vector<vpMbScanLineSegment> > scanlinesX;
-  scanlinesX.resize(w);
-
-  mask.resize(h, w, 0);
-
-  vpImage<unsigned char> maskY(h, w, 0);
-  vpImage<unsigned char> maskX(h, w, 0);
-
-  primitive_ids.resize(h, w, -1);
-
+  // Projection of the polygons in the image
+  projected_polygons.clear();
+  projected_edges.clear();
+  std::vector<vpMbScanLineEdge> polygon_edges;
   for (unsigned int ID = 0; ID < polygons.size(); ++ID) {
-    drawPolygonY(*(polygons[ID]), listPolyIndices[ID], scanlinesY);
-    drawPolygonX(*(polygons[ID]), listPolyIndices[ID], scanlinesX);
-  }
-
-  // Y
-  int last_ID = -1;
-  vpMbScanLineSegment last_visible;
-  for (unsigned int y = 0; y < scanlinesY.size(); ++y) {
-    std::vector<vpMbScanLineSegment> &scanline = scanlinesY[y];
-    sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
-
-    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-    for (size_t i = 0; i < scanline.size(); ++i) {
-      const vpMbScanLineSegment &s = scanline[i];
-
-      switch (s.type) {
-      case START:
-        stack.push_back(std::make_pair(s.Z1, s));
-        break;
-      case END:
-        for (size_t j = 0; j < stack.size(); ++j)
-          if (stack[j].second.ID == s.ID) {
-            if (j != stack.size() - 1)
-              stack[j] = stack.back();
-            stack.pop_back();
-            break;
-          }
-        break;
-      case POINT:
-        break;
-      }
-
-      for (size_t j = 0; j < stack.size(); ++j) {
-        const vpMbScanLineSegment &s0 = stack[j].second;
-        stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
-      }
-      sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
-
-      int new_ID = stack.empty() ? -1 : stack.front().second.ID;
-
-      if (new_ID != last_ID || s.type == POINT) {
-        if (s.b_sample_Y)
-          switch (s.type) {
-          case POINT:
-            if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-              visibility_samples[s.edge].insert((int)y);
-            break;
-          case START:
-            if (new_ID == s.ID)
-              visibility_samples[s.edge].insert((int)y);
-            break;
-          case END:
-            if (last_ID == s.ID)
-              visibility_samples[s.edge].insert((int)y);
-            break;
-          }
-
-        // This part will only be used for MbKltTracking
-        if (last_ID != -1) {
-          const unsigned int x0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
-          const double x1 = (std::min)((double)w, (double)s.p);
-          for (unsigned int x = x0 + maskBorder; x < x1 - maskBorder; ++x) {
-            primitive_ids[(unsigned int)y][(unsigned int)x] = last_visible.ID;
-
-            if (maskBorder != 0)
-              maskY[(unsigned int)y][(unsigned int)x] = 255;
-            else
-              mask[(unsigned int)y][(unsigned int)x] = 255;
-          }
-        }
-
-        last_ID = new_ID;
-        if (!stack.empty()) {
-          last_visible = stack.front().second;
-          last_visible.p = s.p;
-        }
-      }
+    const std::vector<std::pair<vpPoint, unsigned int> > &polygon = *(polygons[ID]);
+    if (polygon.size() < 2)
+      continue;
+
+    vpMbScanLinePolygon projected;
+    projected.ID = listPolyIndices[ID];
+    projected.first_edge = (unsigned int)projected_edges.size();
+    projected.nb_edges = polygon.size() == 2 ? 1 : (unsigned int)polygon.size();
+    projected.b_closed = polygon.size() > 2;
+    projected.xmin = projected.ymin = (std::numeric_limits<double>::max)();
+    projected.xmax = projected.ymax = -(std::numeric_limits<double>::max)();
+
+    for (unsigned int i = 0; i < projected.nb_edges; ++i) {
+      const vpPoint &a = polygon[i].first;
+      const vpPoint &b = polygon[(i + 1) % polygon.size()].first;
+      double p1[3], p2[3];
+      createVectorFromPoint(a, p1, K);
+      createVectorFromPoint(b, p2, K);
+
+      vpMbScanLineProjectedEdge edge;
+      edge.x0 = p1[0] / p1[2];
+      edge.y0 = p1[1] / p1[2];
+      edge.z0 = p1[2];
+      edge.x1 = p2[0] / p2[2];
+      edge.y1 = p2[1] / p2[2];
+      edge.z1 = p2[2];
+      edge.edge = 0;
+      edge.b_sample_Y = (std::fabs(edge.y0 - edge.y1) > std::fabs(edge.x0 - edge.x1));
+      projected_edges.push_back(edge);
+      polygon_edges.push_back(makeMbScanLineEdge(a, b));
+
+      projected.xmin = (std::min)(projected.xmin, (std::min)(edge.x0, edge.x1));
+      projected.xmax = (std::max)(projected.xmax, (std::max)(edge.x0, edge.x1));
+      projected.ymin = (std::min)(projected.ymin, (std::min)(edge.y0, edge.y1));
+      projected.ymax = (std::max)(projected.ymax, (std::max)(edge.y0, edge.y1));
     }
+    projected_polygons.push_back(projected);
   }
 
-  // X
-  last_ID = -1;
-  for (unsigned int x = 0; x < scanlinesX.size(); ++x) {
-    std::vector<vpMbScanLineSegment> &scanline = scanlinesX[x];
-    sort(scanline.begin(), scanline.end(), vpMbScanLineSegmentComparator());
+  // Table of the edges of the scene: an edge shared by several polygons has
+  // a single entry
+  edges = polygon_edges;
+  std::sort(edges.begin(), edges.end(), vpMbScanLineEdgeComparator());
+  edges.erase(std::unique(edges.begin(), edges.end(), isSameEdge), edges.end());
+  for (size_t i = 0; i < polygon_edges.size(); ++i)
+    findEdge(polygon_edges[i], projected_edges[i].edge);
 
-    std::vector<std::pair<double, vpMbScanLineSegment> > stack;
-    for (size_t i = 0; i < scanline.size(); ++i) {
-      const vpMbScanLineSegment &s = scanline[i];
-
-      switch (s.type) {
-      case START:
-        stack.push_back(std::make_pair(s.Z1, s));
-        break;
-      case END:
-        for (size_t j = 0; j < stack.size(); ++j)
-          if (stack[j].second.ID == s.ID) {
-            if (j != stack.size() - 1)
-              stack[j] = stack.back();
-            stack.pop_back();
-            break;
-          }
-        break;
-      case POINT:
-        break;
-      }
-
-      for (size_t j = 0; j < stack.size(); ++j) {
-        const vpMbScanLineSegment &s0 = stack[j].second;
-        stack[j].first = mix(s0.Z1, s0.Z2, getAlpha(s.type == POINT ? s.p : (s.p + 0.5), s0.P1, s0.Z1, s0.P2, s0.Z2));
-      }
-      sort(stack.begin(), stack.end(), vpMbScanLineSegmentComparator());
-
-      int new_ID = stack.empty() ? -1 : stack.front().second.ID;
-
-      if (new_ID != last_ID || s.type == POINT) {
-        if (!s.b_sample_Y)
-          switch (s.type) {
-          case POINT:
-            if (new_ID == -1 || s.Z1 - depthTreshold <= stack.front().first)
-              visibility_samples[s.edge].insert((int)x);
-            break;
-          case START:
-            if (new_ID == s.ID)
-              visibility_samples[s.edge].insert((int)x);
-            break;
-          case END:
-            if (last_ID == s.ID)
-              visibility_samples[s.edge].insert((int)x);
-            break;
-          }
+  mask.resize(h, w, 0);
+  primitive_ids.resize(h, w, -1);
 
-        // This part will only be used for MbKltTracking
-        if (maskBorder != 0 && last_ID != -1) {
-          const unsigned int y0 = (std::max)((unsigned int)0, (unsigned int)(std::ceil(last_visible.p)));
-          const double y1 = (std::min)((double)h, (double)s.p);
-          for (unsigned int y = y0 + maskBorder; y < y1 - maskBorder; ++y) {
-            // primitive_ids[(unsigned int)y][(unsigned int)x] =
-            // last_visible.ID;
-            maskX[(unsigned int)y][(unsigned int)x] = 255;
-          }
-        }
+  vpImage<unsigned char> maskY;
+  vpImage<unsigned char> maskX;
+  if (maskBorder != 0) {
+    maskY.resize(h, w, 0);
+    maskX.resize(h, w, 0);
+  }
 
-        last_ID = new_ID;
-        if (!stack.empty()) {
-          last_visible = stack.front().second;
-          last_visible.p = s.p;
-        }
-      }
-    }
+  std::vector<std::pair<unsigned int, int> > samples;
+  drawScanLines(true, samples, maskY);
+  drawScanLines(false, samples, maskX);
+
+  // Visible samples grouped by edge
+  std::sort(samples.begin(), samples.end());
+  samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+  visibility_offsets.assign(edges.size() + 1, 0);
+  visibility_samples.resize(samples.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    visibility_offsets[samples[i].first + 1]++;
+    visibility_samples[i] = samples[i].second;
   }
+  for (size_t i = 0; i < edges.size(); ++i)
+    visibility_offsets[i + 1] += visibility_offsets[i];
 
   if (maskBorder != 0)
     for (unsigned int i = 0; i < h; i++)
@@ -529,7 +531,7 @@ void vpMbScanLine::drawScene(const std::vector<std::vector<std::pair<vpPoint, un
 void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
                                        std::vector<std::pair<vpPoint, vpPoint> > &lines, const bool &displayResults)
 {
-  vpColVector _a, _b;
+  double _a[3], _b[3];
   createVectorFromPoint(a, _a, K);
   createVectorFromPoint(b, _b, K);
 
@@ -556,7 +558,8 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 #endif
   }
 
-  if (!visibility_samples.count(edge))
+  unsigned int index = 0;
+  if (!findEdge(edge, index) || visibility_offsets[index] == visibility_offsets[index + 1])
     return;
 
   // Initialized as the biggest difference between the two points is on the
@@ -597,13 +600,12 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
   const int _v0 = (std::max)(0, int(std::ceil(*v0)));
   const int _v1 = (std::min)((int)(size - 1), (int)(std::ceil(*v1) - 1));
 
-  const std::set<int> &visible_samples = visibility_samples[edge];
   int last = _v0;
   vpPoint line_start;
   vpPoint line_end;
   bool b_line_started = false;
-  for (std::set<int>::const_iterator it = visible_samples.begin(); it != visible_samples.end(); ++it) {
-    const int v = *it;
+  for (unsigned int k = visibility_offsets[index]; k < visibility_offsets[index + 1]; ++k) {
+    const int v = visibility_samples[k];
     const double alpha = getAlpha(v, (*v0) * (*w0), (*w0), (*v1) * (*w1), (*w1));
     // const vpPoint p = mix(a, b, alpha);
     const vpPoint p = mix(a_, b_, alpha);
@@ -660,8 +662,7 @@ void vpMbScanLine::queryLineVisibility(const vpPoint &a, const vpPoint &b,
 */
 vpMbScanLine::vpMbScanLineEdge vpMbScanLine::makeMbScanLineEdge(const vpPoint &a, const vpPoint &b)
 {
-  vpColVector _a(3);
-  vpColVector _b(3);
+  double _a[3], _b[3];
 
   _a[0] = std::ceil((a.get_X() * 1e8) * 1e-6);
   _a[1] = std::ceil((a.get_Y() * 1e8) * 1e-6);
@@ -679,23 +680,42 @@ vpMbScanLine::vpMbScanLineEdge vpMbScanLine::makeMbScanLineEdge(const vpPoint &a
     } else if (_a[i] > _b[i])
       break;
 
-  if (b_comp)
-    return std::make_pair(_a, _b);
+  vpMbScanLineEdge edge;
+  for (unsigned int i = 0; i < 3; ++i) {
+    edge.first[i] = b_comp ? _a[i] : _b[i];
+    edge.second[i] = b_comp ? _b[i] : _a[i];
+  }
+  return edge;
+}
+
+/*!
+  Find an edge in the table of the edges of the scene.
+
+  \param edge : Edge to find.
+  \param index : Index of the edge in the table, if found.
 
-  return std::make_pair(_b, _a);
+  \return True if the edge has been found.
+*/
+bool vpMbScanLine::findEdge(const vpMbScanLineEdge &edge, unsigned int &index) const
+{
+  std::vector<vpMbScanLineEdge>::const_iterator it =
+      std::lower_bound(edges.begin(), edges.end(), edge, vpMbScanLineEdgeComparator());
+  if (it == edges.end() || vpMbScanLineEdgeComparator()(edge, *it))
+    return false;
+
+  index = (unsigned int)(it - edges.begin());
+  return true;
 }
 
 /*!
-  Create a vpColVector of a projected point.
+  Compute the homogeneous pixel coordinates of a point, scaled by its depth.
 
   \param p : Point to project.
   \param v : Resulting vector.
   \param K : Camera parameters.
 */
-void vpMbScanLine::createVectorFromPoint(const vpPoint &p, vpColVector &v, const vpCameraParameters &K)
+void vpMbScanLine::createVectorFromPoint(const vpPoint &p, double v[3], const vpCameraParameters &K)
 {
-  v = vpColVector(3);
-
   v[0] = p.get_X() * K.get_px() + K.get_u0() * p.get_Z();
   v[1] = p.get_Y() * K.get_py() + K.get_v0() * p.get_Z();
   v[2] = p.get_Z();
@@ -78,10 +78,12 @@
 
 #ifdef VISP_HAVE_COIN3D
 // Inventor includes
+#include <Inventor/SoPath.h>
 #include <Inventor/VRMLnodes/SoVRMLCoordinate.h>
 #include <Inventor/VRMLnodes/SoVRMLGroup.h>
 #include <Inventor/VRMLnodes/SoVRMLIndexedFaceSet.h>
 #include <Inventor/VRMLnodes/SoVRMLIndexedLineSet.h>
+#include <Inventor/VRMLnodes/SoVRMLInline.h>
 #include <Inventor/VRMLnodes/SoVRMLShape.h>
 #include <Inventor/VRMLnodes/SoVRMLTransform.h>
 #include <Inventor/actions/SoGetMatrixAction.h>
@@ -90,6 +92,7 @@
 #include <Inventor/actions/SoToVRML2Action.h>
 #include <Inventor/actions/SoWriteAction.h>
 #include <Inventor/misc/SoChildList.h>
+#include <Inventor/nodes/SoFile.h>
 #include <Inventor/nodes/SoSeparator.h>
 #endif
 
@@ -147,11 +150,11 @@ vpMbTracker::vpMbTracker()
     nbPolygonPoints(0), nbCylinders(0), nbCircles(0), useLodGeneral(false), applyLodSettingInConfig(false),
     minLineLengthThresholdGeneral(50.0), minPolygonAreaThresholdGeneral(2500.0), mapOfParameterNames(),
     m_computeInteraction(true), m_lambda(1.0), m_maxIter(30), m_stopCriteriaEpsilon(1e-8), m_initialMu(0.01),
-    m_projectionErrorLines(), m_projectionErrorCylinders(), m_projectionErrorCircles(),
+    m_projectionErrorLines(), m_projectionErrorLinesIndex(), m_projectionErrorCylinders(), m_projectionErrorCircles(),
     m_projectionErrorFaces(), m_projectionErrorOgreShowConfigDialog(false),
     m_projectionErrorMe(), m_projectionErrorKernelSize(2), m_SobelX(5,5), m_SobelY(5,5),
     m_projectionErrorDisplay(false), m_projectionErrorDisplayLength(20), m_projectionErrorDisplayThickness(1),
-    m_projectionErrorCam(), m_mask(NULL)
+    m_projectionErrorCam(), m_mask(NULL), m_modelCacheDirectory(), m_modelCache(NULL)
 {
   oJo.eye();
   // Map used to parse additional information in CAO model files,
@@ -1052,6 +1055,142 @@ void vpMbTracker::addPolygon(const std::vector<std::vector<vpPoint> > &listFaces
   }
 }
 
+/*!
+  Add a face or a line of the model, parsed from a CAO or a VRML file. The
+  face is added to the faces used for the tracking and for the projection
+  error, and the features are initialised from it. If the model is being
+  recorded in a cache, the face is also added to the cache.
+
+  \param corners : Corners of the face, or extremities of the line.
+  \param idFace : Id of the face, incremented.
+  \param polygonName : Name of the face.
+  \param useLod : If true, the LOD is used for this face.
+  \param minPolygonAreaThreshold : Minimum polygon area threshold for the LOD.
+  \param minLineLengthThreshold : Minimum line length threshold for the LOD.
+  \param fromLines : If true, the features are initialised with
+  initFaceFromLines(), otherwise with initFaceFromCorners().
+*/
+void vpMbTracker::addModelFace(const std::vector<vpPoint> &corners, int &idFace, const std::string &polygonName,
+                               const bool useLod, const double minPolygonAreaThreshold,
+                               const double minLineLengthThreshold, const bool fromLines)
+{
+  if (m_modelCache != NULL) {
+    vpMbModelCache::vpPrimitive primitive;
+    primitive.type = fromLines ? vpMbModelCache::FACE_FROM_LINES : vpMbModelCache::FACE_FROM_CORNERS;
+    primitive.idFace = idFace;
+    primitive.points = corners;
+    primitive.radius = 0;
+    primitive.name = polygonName;
+    primitive.useLod = useLod;
+    primitive.minPolygonAreaThreshold = minPolygonAreaThreshold;
+    primitive.minLineLengthThreshold = minLineLengthThreshold;
+    m_modelCache->addPrimitive(primitive);
+  }
+
+  addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThreshold);
+  // Init from the last polygon that was added
+  if (fromLines)
+    initFaceFromLines(*(faces.getPolygon().back()));
+  else
+    initFaceFromCorners(*(faces.getPolygon().back()));
+
+  addProjectionErrorPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThreshold);
+  if (fromLines)
+    initProjectionErrorFaceFromLines(*(m_projectionErrorFaces.getPolygon().back()));
+  else
+    initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+}
+
+/*!
+  Add a cylinder of the model, parsed from a CAO or a VRML file. The axis of
+  the cylinder and the faces of its bounding box are added to the faces, and
+  the cylinder is initialised. If the model is being recorded in a cache,
+  the cylinder is also added to the cache.
+
+  \param p1 : First point on the axis.
+  \param p2 : Second point on the axis.
+  \param radius : Radius of the cylinder.
+  \param idFace : Id of the face of the axis, incremented by 5.
+  \param polygonName : Name of the cylinder.
+  \param useLod : If true, the LOD is used for this cylinder.
+  \param minLineLengthThreshold : Minimum line length threshold for the LOD.
+*/
+void vpMbTracker::addModelCylinder(const vpPoint &p1, const vpPoint &p2, const double radius, int &idFace,
+                                   const std::string &polygonName, const bool useLod,
+                                   const double minLineLengthThreshold)
+{
+  if (m_modelCache != NULL) {
+    vpMbModelCache::vpPrimitive primitive;
+    primitive.type = vpMbModelCache::CYLINDER;
+    primitive.idFace = idFace;
+    primitive.points.push_back(p1);
+    primitive.points.push_back(p2);
+    primitive.radius = radius;
+    primitive.name = polygonName;
+    primitive.useLod = useLod;
+    primitive.minPolygonAreaThreshold = 0;
+    primitive.minLineLengthThreshold = minLineLengthThreshold;
+    m_modelCache->addPrimitive(primitive);
+  }
+
+  int idRevolutionAxis = idFace;
+  addPolygon(p1, p2, idFace, polygonName, useLod, minLineLengthThreshold);
+
+  addProjectionErrorPolygon(p1, p2, idFace++, polygonName, useLod, minLineLengthThreshold);
+
+  std::vector<std::vector<vpPoint> > listFaces;
+  createCylinderBBox(p1, p2, radius, listFaces);
+  addPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
+
+  initCylinder(p1, p2, radius, idRevolutionAxis, polygonName);
+
+  addProjectionErrorPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
+  initProjectionErrorCylinder(p1, p2, radius, idRevolutionAxis, polygonName);
+
+  idFace += 4;
+}
+
+/*!
+  Add a circle of the model, parsed from a CAO file. The circle is added to
+  the faces and initialised. If the model is being recorded in a cache, the
+  circle is also added to the cache.
+
+  \param p1 : Center of the circle.
+  \param p2 : A point on the plane containing the circle.
+  \param p3 : An other point on the plane containing the circle.
+  \param radius : Radius of the circle.
+  \param idFace : Id of the face, incremented.
+  \param polygonName : Name of the circle.
+  \param useLod : If true, the LOD is used for this circle.
+  \param minPolygonAreaThreshold : Minimum polygon area threshold for the LOD.
+*/
+void vpMbTracker::addModelCircle(const vpPoint &p1, const vpPoint &p2, const vpPoint &p3, const double radius,
+                                 int &idFace, const std::string &polygonName, const bool useLod,
+                                 const double minPolygonAreaThreshold)
+{
+  if (m_modelCache != NULL) {
+    vpMbModelCache::vpPrimitive primitive;
+    primitive.type = vpMbModelCache::CIRCLE;
+    primitive.idFace = idFace;
+    primitive.points.push_back(p1);
+    primitive.points.push_back(p2);
+    primitive.points.push_back(p3);
+    primitive.radius = radius;
+    primitive.name = polygonName;
+    primitive.useLod = useLod;
+    primitive.minPolygonAreaThreshold = minPolygonAreaThreshold;
+    primitive.minLineLengthThreshold = 0;
+    m_modelCache->addPrimitive(primitive);
+  }
+
+  addPolygon(p1, p2, p3, radius, idFace, polygonName, useLod, minPolygonAreaThreshold);
+
+  initCircle(p1, p2, p3, radius, idFace, polygonName);
+
+  addProjectionErrorPolygon(p1, p2, p3, radius, idFace, polygonName, useLod, minPolygonAreaThreshold);
+  initProjectionErrorCircle(p1, p2, p3, radius, idFace++, polygonName);
+}
+
 /*!
   Load a 3D model from the file in parameter. This file must either be a vrml
   file (.wrl) or a CAO file (.cao). CAO format is described in the
@@ -1069,6 +1208,11 @@ int main()
 }
   \endcode
 
+  If a cache directory has been set with setModelCacheDirectory(), the
+  primitives of the model are read from its binary cache file when the model
+  files have not been modified since the cache file has been written.
+  Otherwise the model is parsed and the cache file is written.
+
   \throw vpException::ioError if the file cannot be open, or if its extension
 is not wrl or cao.
 
@@ -1085,31 +1229,146 @@ void vpMbTracker::loadModel(const std::string &modelFile, const bool verbose, co
 
   if (vpIoTools::checkFilename(modelFile)) {
     it = modelFile.end();
-    if ((*(it - 1) == 'o' && *(it - 2) == 'a' && *(it - 3) == 'c' && *(it - 4) == '.') ||
-        (*(it - 1) == 'O' && *(it - 2) == 'A' && *(it - 3) == 'C' && *(it - 4) == '.')) {
+    bool isCao = (*(it - 1) == 'o' && *(it - 2) == 'a' && *(it - 3) == 'c' && *(it - 4) == '.') ||
+                 (*(it - 1) == 'O' && *(it - 2) == 'A' && *(it - 3) == 'C' && *(it - 4) == '.');
+    bool isVrml = (*(it - 1) == 'l' && *(it - 2) == 'r' && *(it - 3) == 'w' && *(it - 4) == '.') ||
+                  (*(it - 1) == 'L' && *(it - 2) == 'R' && *(it - 3) == 'W' && *(it - 4) == '.');
+    if (!isCao && !isVrml) {
+      throw vpException(vpException::ioError, "Error: File %s doesn't contain a cao or wrl model", modelFile.c_str());
+    }
+
+    // The cache file depends on the parameters used to parse the model
+    vpMbModelCache cache;
+    std::string cacheKey, cacheFilename;
+    if (!m_modelCacheDirectory.empty()) {
+      std::ostringstream key;
+      key.precision(std::numeric_limits<double>::digits10 + 2);
+      key << vpIoTools::getAbsolutePathname(modelFile) << std::endl;
+      for (unsigned int i = 0; i < 4; i++)
+        for (unsigned int j = 0; j < 4; j++)
+          key << T[i][j] << " ";
+      key << std::endl
+          << applyLodSettingInConfig << " " << useLodGeneral << " " << minLineLengthThresholdGeneral << " "
+          << minPolygonAreaThresholdGeneral;
+      cacheKey = key.str();
+      cacheFilename = vpMbModelCache::getCacheFilename(m_modelCacheDirectory, modelFile, cacheKey);
+    }
+
+    if (!cacheFilename.empty() && cache.load(cacheFilename, cacheKey)) {
+      if (verbose) {
+        std::cout << "Model cache file : " << cacheFilename << std::endl;
+      }
+      initModelFromCache(cache, isCao);
+    } else {
       std::vector<std::string> vectorOfModelFilename;
       int startIdFace = (int)faces.size();
-      nbPoints = 0;
-      nbLines = 0;
-      nbPolygonLines = 0;
-      nbPolygonPoints = 0;
-      nbCylinders = 0;
-      nbCircles = 0;
-      loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true, T);
-    } else if ((*(it - 1) == 'l' && *(it - 2) == 'r' && *(it - 3) == 'w' && *(it - 4) == '.') ||
-               (*(it - 1) == 'L' && *(it - 2) == 'R' && *(it - 3) == 'W' && *(it - 4) == '.')) {
-      loadVRMLModel(modelFile);
-    } else {
-      throw vpException(vpException::ioError, "Error: File %s doesn't contain a cao or wrl model", modelFile.c_str());
+      if (!cacheFilename.empty()) {
+        cache.setFirstIdFace(startIdFace);
+        m_modelCache = &cache;
+      }
+
+      try {
+        if (isCao) {
+          nbPoints = 0;
+          nbLines = 0;
+          nbPolygonLines = 0;
+          nbPolygonPoints = 0;
+          nbCylinders = 0;
+          nbCircles = 0;
+          loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, true, T);
+        } else {
+          loadVRMLModel(modelFile, vectorOfModelFilename);
+        }
+      } catch (...) {
+        m_modelCache = NULL;
+        throw;
+      }
+      m_modelCache = NULL;
+
+      if (!cacheFilename.empty()) {
+        // The model is usable even if the cache cannot be written
+        try {
+          for (size_t i = 0; i < vectorOfModelFilename.size(); i++)
+            cache.addSourceFile(vpIoTools::getAbsolutePathname(vectorOfModelFilename[i]));
+          unsigned int statistics[6] = {nbPoints, nbLines, nbPolygonLines, nbPolygonPoints, nbCylinders, nbCircles};
+          cache.setStatistics(statistics);
+
+          if (!vpIoTools::checkDirectory(m_modelCacheDirectory))
+            vpIoTools::makeDirectory(m_modelCacheDirectory);
+          cache.save(cacheFilename, cacheKey);
+        } catch (const vpException &e) {
+          std::cerr << "Cannot write the model cache file " << cacheFilename << ": " << e.getStringMessage()
+                    << std::endl;
+        }
+      }
     }
   } else {
     throw vpException(vpException::ioError, "Error: File %s doesn't exist", modelFile.c_str());
   }
 
+  if (faces.getBVHVisibilityTest())
+    faces.initBVH();
+
   this->modelInitialised = true;
   this->modelFileName = modelFile;
 }
 
+/*!
+  Initialise the faces and the features from the primitives of a model read
+  from its cache file, as loadCAOModel() or loadVRMLModel() would do from
+  the model files.
+
+  \param cache : The cache of the model.
+  \param isCao : True if the model has been read from a CAO file, in which
+  case the number of points, lines, polygons, cylinders and circles of the
+  model are restored and printed.
+*/
+void vpMbTracker::initModelFromCache(const vpMbModelCache &cache, const bool isCao)
+{
+  // The ids are given from the first face of the tracker
+  const int offsetIdFace = (int)faces.size() - cache.getFirstIdFace();
+
+  vpMbModelCache::vpPrimitive primitive;
+  for (unsigned int i = 0; i < cache.getNbPrimitives(); i++) {
+    cache.getPrimitive(i, primitive);
+    int idFace = primitive.idFace + offsetIdFace;
+
+    switch (primitive.type) {
+    case vpMbModelCache::FACE_FROM_CORNERS:
+    case vpMbModelCache::FACE_FROM_LINES:
+      addModelFace(primitive.points, idFace, primitive.name, primitive.useLod, primitive.minPolygonAreaThreshold,
+                   primitive.minLineLengthThreshold, primitive.type == vpMbModelCache::FACE_FROM_LINES);
+      break;
+    case vpMbModelCache::CYLINDER:
+      addModelCylinder(primitive.points[0], primitive.points[1], primitive.radius, idFace, primitive.name,
+                       primitive.useLod, primitive.minLineLengthThreshold);
+      break;
+    case vpMbModelCache::CIRCLE:
+      addModelCircle(primitive.points[0], primitive.points[1], primitive.points[2], primitive.radius, idFace,
+                     primitive.name, primitive.useLod, primitive.minPolygonAreaThreshold);
+      break;
+    }
+  }
+
+  if (isCao) {
+    unsigned int statistics[6];
+    cache.getStatistics(statistics);
+    nbPoints = statistics[0];
+    nbLines = statistics[1];
+    nbPolygonLines = statistics[2];
+    nbPolygonPoints = statistics[3];
+    nbCylinders = statistics[4];
+    nbCircles = statistics[5];
+
+    std::cout << "> " << nbPoints << " points" << std::endl;
+    std::cout << "> " << nbLines << " lines" << std::endl;
+    std::cout << "> " << nbPolygonLines << " polygon lines" << std::endl;
+    std::cout << "> " << nbPolygonPoints << " polygon points" << std::endl;
+    std::cout << "> " << nbCylinders << " cylinders" << std::endl;
+    std::cout << "> " << nbCircles << " circles" << std::endl;
+  }
+}
+
 /*!
   Load the 3D model of the object from a vrml file. Only LineSet and FaceSet
 are extracted from the vrml file.
@@ -1139,8 +1398,10 @@ geometry DEF cyl_cylinder1 IndexedFaceSet
   \throw vpException::fatalError if the file cannot be open.
 
   \param modelFile : The full name of the file containing the 3D model.
+  \param vectorOfModelFilename : The file and the files it includes with
+  Inline (VRML 2) or File (Inventor) nodes are appended to this vector.
 */
-void vpMbTracker::loadVRMLModel(const std::string &modelFile)
+void vpMbTracker::loadVRMLModel(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename)
 {
 #ifdef VISP_HAVE_COIN3D
   SoDB::init(); // Call SoDB::finish() before ending the program.
@@ -1154,12 +1415,23 @@ void vpMbTracker::loadVRMLModel(const std::string &modelFile)
     throw vpException(vpException::fatalError, "can't open file to load model");
   }
 
+  vectorOfModelFilename.push_back(modelFile);
   if (!in.isFileVRML2()) {
     SoSeparator *sceneGraph = SoDB::readAll(&in);
     if (sceneGraph == NULL) { /*return -1;*/
     }
     sceneGraph->ref();
 
+    SoSearchAction searchFiles;
+    searchFiles.setType(SoFile::getClassTypeId());
+    searchFiles.setInterest(SoSearchAction::ALL);
+    searchFiles.setSearchingAll(TRUE);
+    searchFiles.apply(sceneGraph);
+    for (int i = 0; i < searchFiles.getPaths().getLength(); i++) {
+      SoFile *file = static_cast<SoFile *>(searchFiles.getPaths()[i]->getTail());
+      addVRMLSourceFile(file->getFullName().getString(), vectorOfModelFilename);
+    }
+
     SoToVRML2Action tovrml2;
     tovrml2.apply(sceneGraph);
 
@@ -1171,6 +1443,16 @@ void vpMbTracker::loadVRMLModel(const std::string &modelFile)
     if (sceneGraphVRML2 == NULL) { /*return -1;*/
     }
     sceneGraphVRML2->ref();
+
+    SoSearchAction searchInlines;
+    searchInlines.setType(SoVRMLInline::getClassTypeId());
+    searchInlines.setInterest(SoSearchAction::ALL);
+    searchInlines.setSearchingAll(TRUE);
+    searchInlines.apply(sceneGraphVRML2);
+    for (int i = 0; i < searchInlines.getPaths().getLength(); i++) {
+      SoVRMLInline *inlineNode = static_cast<SoVRMLInline *>(searchInlines.getPaths()[i]->getTail());
+      addVRMLSourceFile(inlineNode->getFullURLName().getString(), vectorOfModelFilename);
+    }
   }
 
   in.closeFile();
@@ -1181,11 +1463,28 @@ void vpMbTracker::loadVRMLModel(const std::string &modelFile)
 
   sceneGraphVRML2->unref();
 #else
+  (void)vectorOfModelFilename;
   vpERROR_TRACE("coin not detected with ViSP, cannot load model : %s", modelFile.c_str());
   throw vpException(vpException::fatalError, "coin not detected with ViSP, cannot load model");
 #endif
 }
 
+#ifdef VISP_HAVE_COIN3D
+/*!
+  Add a file included by a VRML model to the files of the model, once.
+
+  \param filename : The name of the included file.
+  \param vectorOfModelFilename : The files of the model.
+*/
+void vpMbTracker::addVRMLSourceFile(const std::string &filename, std::vector<std::string> &vectorOfModelFilename)
+{
+  if (!filename.empty() &&
+      std::find(vectorOfModelFilename.begin(), vectorOfModelFilename.end(), filename) == vectorOfModelFilename.end()) {
+    vectorOfModelFilename.push_back(filename);
+  }
+}
+#endif
+
 void vpMbTracker::removeComment(std::ifstream &fileId)
 {
   char c;
@@ -1583,11 +1882,7 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         useLod = parseBoolean(mapOfParams["useLod"]);
       }
 
-      addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initFaceFromLines(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-      addProjectionErrorPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initProjectionErrorFaceFromLines(*(m_projectionErrorFaces.getPolygon().back()));
+      addModelFace(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral, true);
     }
 
     // Add the segments which were not already added in the face segment case
@@ -1595,13 +1890,8 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
          it != segmentTemporaryMap.end(); ++it) {
       if (std::find(faceSegmentKeyVector.begin(), faceSegmentKeyVector.end(), it->first) ==
           faceSegmentKeyVector.end()) {
-        addPolygon(it->second.extremities, idFace, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
-                   it->second.minLineLengthThresh);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-        addProjectionErrorPolygon(it->second.extremities, idFace++, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
-                                  it->second.minLineLengthThresh);
-        initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+        addModelFace(it->second.extremities, idFace, it->second.name, it->second.useLod, minPolygonAreaThresholdGeneral,
+                     it->second.minLineLengthThresh);
       }
     }
 
@@ -1659,11 +1949,7 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
         useLod = parseBoolean(mapOfParams["useLod"]);
       }
 
-      addPolygon(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-      addProjectionErrorPolygon(corners, idFace++, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
-      initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+      addModelFace(corners, idFace, polygonName, useLod, minPolygonAreaThreshold, minLineLengthThresholdGeneral);
     }
 
     //////////////////////////Read the cylinder declaration part//////////////////////////
@@ -1720,21 +2006,8 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
           useLod = parseBoolean(mapOfParams["useLod"]);
         }
 
-        int idRevolutionAxis = idFace;
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace, polygonName, useLod, minLineLengthThreshold);
-
-        addProjectionErrorPolygon(caoPoints[indexP1], caoPoints[indexP2], idFace++, polygonName, useLod, minLineLengthThreshold);
-
-        std::vector<std::vector<vpPoint> > listFaces;
-        createCylinderBBox(caoPoints[indexP1], caoPoints[indexP2], radius, listFaces);
-        addPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
-
-        initCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idRevolutionAxis, polygonName);
-
-        addProjectionErrorPolygon(listFaces, idFace, polygonName, useLod, minLineLengthThreshold);
-        initProjectionErrorCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idRevolutionAxis, polygonName);
-
-        idFace += 4;
+        addModelCylinder(caoPoints[indexP1], caoPoints[indexP2], radius, idFace, polygonName, useLod,
+                         minLineLengthThreshold);
       }
 
     } catch (...) {
@@ -1797,14 +2070,8 @@ void vpMbTracker::loadCAOModel(const std::string &modelFile, std::vector<std::st
           useLod = parseBoolean(mapOfParams["useLod"]);
         }
 
-        addPolygon(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
-                   minPolygonAreaThreshold);
-
-        initCircle(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName);
-
-        addProjectionErrorPolygon(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
-                                  minPolygonAreaThreshold);
-        initProjectionErrorCircle(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace++, polygonName);
+        addModelCircle(caoPoints[indexP1], caoPoints[indexP2], caoPoints[indexP3], radius, idFace, polygonName, useLod,
+                       minPolygonAreaThreshold);
       }
 
     } catch (...) {
@@ -1954,11 +2221,7 @@ void vpMbTracker::extractFaces(SoVRMLIndexedFaceSet *face_set, vpHomogeneousMatr
   for (int i = 0; i < indexListSize; i++) {
     if (face_set->coordIndex[i] == -1) {
       if (corners.size() > 1) {
-        addPolygon(corners, idFace, polygonName);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-        addProjectionErrorPolygon(corners, idFace++, polygonName);
-        initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+        addModelFace(corners, idFace, polygonName);
         corners.resize(0);
       }
     } else {
@@ -2048,24 +2311,7 @@ void vpMbTracker::extractCylinders(SoVRMLIndexedFaceSet *face_set, vpHomogeneous
     throw vpException(vpException::badValue, "Radius from the two circles of the cylinders are different.");
   }
 
-  // addPolygon(p1, p2, idFace, polygonName);
-  // initCylinder(p1, p2, radius_c1, idFace++);
-
-  int idRevolutionAxis = idFace;
-  addPolygon(p1, p2, idFace, polygonName);
-
-  addProjectionErrorPolygon(p1, p2, idFace++, polygonName);
-
-  std::vector<std::vector<vpPoint> > listFaces;
-  createCylinderBBox(p1, p2, radius_c1, listFaces);
-  addPolygon(listFaces, idFace, polygonName);
-
-  initCylinder(p1, p2, radius_c1, idRevolutionAxis, polygonName);
-
-  addProjectionErrorPolygon(listFaces, idFace, polygonName);
-  initProjectionErrorCylinder(p1, p2, radius_c1, idRevolutionAxis, polygonName);
-
-  idFace += 4;
+  addModelCylinder(p1, p2, radius_c1, idFace, polygonName);
 }
 
 /*!
@@ -2090,11 +2336,7 @@ void vpMbTracker::extractLines(SoVRMLIndexedLineSet *line_set, int &idFace, cons
   for (int i = 0; i < indexListSize; i++) {
     if (line_set->coordIndex[i] == -1) {
       if (corners.size() > 1) {
-        addPolygon(corners, idFace, polygonName);
-        initFaceFromCorners(*(faces.getPolygon().back())); // Init from the last polygon that was added
-
-        addProjectionErrorPolygon(corners, idFace++, polygonName);
-        initProjectionErrorFaceFromCorners(*(m_projectionErrorFaces.getPolygon().back()));
+        addModelFace(corners, idFace, polygonName);
         corners.resize(0);
       }
     } else {
@@ -2456,6 +2698,69 @@ void vpMbTracker::computeJTR(const vpMatrix &interaction, const vpColVector &err
   }
 }
 
+/*!
+  Compute the normal equations \f$ L^T W^2 L \f$ and \f$ L^T W^2 e \f$ of
+  the weighted least squares problem, with \f$ W = diag(w) \f$, without
+  building the weighted interaction matrix. Since only a 6x6 matrix and a 6x1
+  vector are accumulated row after row, the cost is linear in the number of
+  features and no memory is allocated for the weighted rows.
+
+  \throw vpMatrixException::incorrectMatrixSizeError if the sizes of the
+  matrices do not allow the computation.
+
+  \warning The LTL matrix and the LTR vector are resized.
+
+  \param L : The interaction matrix (size Nx6), not weighted.
+  \param w : The weights, <tt>w[start_index + i]</tt> is the weight of the
+  i-th row of \e L.
+  \param error : The residu vector, indexed like \e w.
+  \param LTL : The resulting 6x6 matrix.
+  \param LTR : The resulting 6x1 column vector.
+  \param start_index : Index in \e w and \e error of the first row of \e L.
+*/
+void vpMbTracker::computeVVSNormalEquations(const vpMatrix &L, const vpColVector &w, const vpColVector &error,
+                                            vpMatrix &LTL, vpColVector &LTR, const unsigned int start_index) const
+{
+  const unsigned int N = L.getRows();
+  if ((N > 0 && L.getCols() != 6) || w.getRows() < start_index + N || error.getRows() < start_index + N) {
+    throw vpMatrixException(vpMatrixException::incorrectMatrixSizeError,
+                            "Incorrect matrices size in computeVVSNormalEquations.");
+  }
+
+  // Upper triangular part of LTL stored row after row
+  double ltl[21], ltr[6];
+  for (unsigned int k = 0; k < 21; k++)
+    ltl[k] = 0.0;
+  for (unsigned int k = 0; k < 6; k++)
+    ltr[k] = 0.0;
+
+  for (unsigned int i = 0; i < N; i++) {
+    const double *const Li = L[i];
+    const double w2 = w[start_index + i] * w[start_index + i];
+    const double w2e = w2 * error[start_index + i];
+
+    for (unsigned int j = 0, k = 0; j < 6; j++) {
+      const double w2Lij = w2 * Li[j];
+      ltr[j] += w2e * Li[j];
+
+      for (unsigned int l = j; l < 6; l++, k++) {
+        ltl[k] += w2Lij * Li[l];
+      }
+    }
+  }
+
+  LTL.resize(6, 6, false, false);
+  LTR.resize(6, false);
+  for (unsigned int j = 0, k = 0; j < 6; j++) {
+    LTR[j] = ltr[j];
+
+    for (unsigned int l = j; l < 6; l++, k++) {
+      LTL[j][l] = ltl[k];
+      LTL[l][j] = ltl[k];
+    }
+  }
+}
+
 void vpMbTracker::computeVVSCheckLevenbergMarquardt(const unsigned int iter, vpColVector &error,
                                                     const vpColVector &m_error_prev, const vpHomogeneousMatrix &cMoPrev,
                                                     double &mu, bool &reStartFromLastIncrement, vpColVector *const w,
@@ -2541,6 +2846,73 @@ void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, const unsi
   }
 }
 
+/*!
+  Compute the pose increment from the normal equations of the weighted
+  interaction matrix, see computeVVSNormalEquations(). Same as the other
+  computeVVSPoseEstimation() but the weighted interaction matrix is never
+  built.
+
+  \param isoJoIdentity_ : If false, the estimated degrees of freedom given by
+  oJo are taken into account.
+  \param iter : Current iteration.
+  \param LTL : \f$ L^T W^2 L \f$ matrix (size 6x6).
+  \param LTR : \f$ L^T W^2 e \f$ vector (size 6x1).
+  \param error : Residu vector, copied in \e error_prev with the
+  Levenberg-Marquardt method.
+  \param error_prev : Residu vector of the previous iteration.
+  \param mu : Levenberg-Marquardt damping factor.
+  \param v : Computed velocity.
+  \param w : Weights copied in \e m_w_prev with the Levenberg-Marquardt
+  method.
+  \param m_w_prev : Weights of the previous iteration.
+*/
+void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, const unsigned int iter, const vpMatrix &LTL,
+                                           const vpColVector &LTR, const vpColVector &error, vpColVector &error_prev,
+                                           double &mu, vpColVector &v, const vpColVector *const w,
+                                           vpColVector *const m_w_prev)
+{
+  vpVelocityTwistMatrix cVo;
+  vpMatrix LVJTLVJ;
+  vpColVector LVJTR;
+
+  if (isoJoIdentity_) {
+    LVJTLVJ = LTL;
+    LVJTR = LTR;
+  } else {
+    // (L V J)^T (L V J) = (V J)^T L^T L (V J), with only 6x6 products
+    cVo.buildFrom(cMo);
+    vpMatrix VJ = cVo * oJo;
+    vpMatrix VJT = VJ.t();
+    LVJTLVJ = VJT * LTL * VJ;
+    LVJTR = VJT * LTR;
+  }
+
+  switch (m_optimizationMethod) {
+  case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
+    vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
+    LMA.eye();
+    vpMatrix LTLmuI = LVJTLVJ + (LMA * mu);
+    v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
+
+    if (iter != 0)
+      mu /= 10.0;
+
+    error_prev = error;
+    if (w != NULL && m_w_prev != NULL)
+      *m_w_prev = *w;
+    break;
+  }
+
+  case vpMbTracker::GAUSS_NEWTON_OPT:
+  default:
+    v = -m_lambda * LVJTLVJ.pseudoInverse(LVJTLVJ.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
+    break;
+  }
+
+  if (!isoJoIdentity_)
+    v = cVo * v;
+}
+
 void vpMbTracker::computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w)
 {
   if (error.getRows() > 0)
@@ -2709,6 +3081,58 @@ bool vpMbTracker::samePoint(const vpPoint &P1, const vpPoint &P2) const
     return false;
 }
 
+/*!
+  Compute the key used to sort the lines of a model. The key does not depend
+  on the order of the extremities, and the keys of two lines whose extremities
+  are similar (see samePoint()) differ by less than \e tolerance.
+
+  \param P1 : The first extremity of the line.
+  \param P2 : The second extremity of the line.
+  \param tolerance : Maximal difference between the keys of two similar lines.
+
+  \return The key of the line.
+*/
+double vpMbTracker::getLineKey(const vpPoint &P1, const vpPoint &P2, double &tolerance)
+{
+  // The weights of the coordinates avoid that the lines of a regular grid
+  // share the same key
+  const double wy = 0.7548776662466927, wz = 0.5698402909980532;
+  const double k1 = P1.get_oX() + wy * P1.get_oY() + wz * P1.get_oZ();
+  const double k2 = P2.get_oX() + wy * P2.get_oY() + wz * P2.get_oZ();
+  const double magnitude = fabs(P1.get_oX()) + fabs(P1.get_oY()) + fabs(P1.get_oZ()) + fabs(P2.get_oX()) +
+                           fabs(P2.get_oY()) + fabs(P2.get_oZ());
+
+  // Difference of the coordinates and rounding errors
+  tolerance = 8 * std::numeric_limits<double>::epsilon() * (1 + magnitude);
+  return k1 + k2;
+}
+
+/*!
+  Find the lines whose extremities are similar to \e P1 and \e P2, in any
+  order, without testing all the lines of the model.
+
+  \param linesIndex : The lines of the model sorted by getLineKey().
+  \param P1 : The first extremity of the line.
+  \param P2 : The second extremity of the line.
+  \param sameLines : The lines of \e linesIndex similar to the line (P1, P2).
+*/
+void vpMbTracker::findSameLines(const std::multimap<double, vpMbtDistanceLine *> &linesIndex, const vpPoint &P1,
+                                const vpPoint &P2, std::vector<vpMbtDistanceLine *> &sameLines) const
+{
+  sameLines.clear();
+
+  double tolerance = 0;
+  const double key = getLineKey(P1, P2, tolerance);
+  for (std::multimap<double, vpMbtDistanceLine *>::const_iterator it = linesIndex.lower_bound(key - tolerance);
+       it != linesIndex.end() && it->first <= key + tolerance; ++it) {
+    vpMbtDistanceLine *l = it->second;
+    if ((samePoint(*(l->p1), P1) && samePoint(*(l->p2), P2)) ||
+        (samePoint(*(l->p1), P2) && samePoint(*(l->p2), P1))) {
+      sameLines.push_back(l);
+    }
+  }
+}
+
 void vpMbTracker::addProjectionErrorPolygon(const std::vector<vpPoint> &corners, const int idFace, const std::string &polygonName,
                                             const bool useLod, const double minPolygonAreaThreshold,
                                             const double minLineLengthThreshold)
@@ -2896,14 +3320,13 @@ void vpMbTracker::addProjectionErrorLine(vpPoint &P1, vpPoint &P2, int polygon,
   bool already_here = false;
   vpMbtDistanceLine *l;
 
-  for (std::vector<vpMbtDistanceLine *>::const_iterator it = m_projectionErrorLines.begin(); it != m_projectionErrorLines.end(); ++it) {
+  std::vector<vpMbtDistanceLine *> sameLines;
+  findSameLines(m_projectionErrorLinesIndex, P1, P2, sameLines);
+  for (std::vector<vpMbtDistanceLine *>::const_iterator it = sameLines.begin(); it != sameLines.end(); ++it) {
     l = *it;
-    if ((samePoint(*(l->p1), P1) && samePoint(*(l->p2), P2)) ||
-        (samePoint(*(l->p1), P2) && samePoint(*(l->p2), P1))) {
-      already_here = true;
-      l->addPolygon(polygon);
-      l->hiddenface = &m_projectionErrorFaces;
-    }
+    already_here = true;
+    l->addPolygon(polygon);
+    l->hiddenface = &m_projectionErrorFaces;
   }
 
   if (!already_here) {
@@ -2929,6 +3352,8 @@ void vpMbTracker::addProjectionErrorLine(vpPoint &P1, vpPoint &P2, int polygon,
       l->getPolygon().setFarClippingDistance(distFarClip);
 
     m_projectionErrorLines.push_back(l);
+    double tolerance = 0;
+    m_projectionErrorLinesIndex.insert(std::make_pair(getLineKey(P1, P2, tolerance), l));
   }
 }
 
@@ -169,16 +169,13 @@ bool vpMbtPolygon::isVisible(const vpHomogeneousMatrix &cMo, const double alpha,
   }
   faceNormal.normalize();
 
+  // Direction from the centroid of the polygon to the camera
   vpColVector e4(3);
-  vpPoint pt;
   for (unsigned int i = 0; i < nbpt; i += 1) {
-    pt.set_X(pt.get_X() + p[i].get_X());
-    pt.set_Y(pt.get_Y() + p[i].get_Y());
-    pt.set_Z(pt.get_Z() + p[i].get_Z());
+    e4[0] -= p[i].get_X();
+    e4[1] -= p[i].get_Y();
+    e4[2] -= p[i].get_Z();
   }
-  e4[0] = -pt.get_X() / (double)nbpt;
-  e4[1] = -pt.get_Y() / (double)nbpt;
-  e4[2] = -pt.get_Z() / (double)nbpt;
   e4.normalize();
 
   double angle = acos(vpColVector::dotProd(e4, faceNormal));
@@ -55,7 +55,7 @@
 #include <visp3/gui/vpDisplayGTK.h>
 #include <visp3/mbt/vpMbGenericTracker.h>
 
-#define GETOPTARGS "i:dcle:mh"
+#define GETOPTARGS "i:dcle:mph"
 
 namespace
 {
@@ -66,7 +66,7 @@ namespace
     \n\
     SYNOPSIS\n\
       %s [-i <test image path>] [-c] [-d] [-h] [-l] \n\
-     [-e <last frame index>] [-m]\n", name);
+     [-e <last frame index>] [-m] [-p]\n", name);
 
     fprintf(stdout, "\n\
     OPTIONS:                                               \n\
@@ -93,6 +93,9 @@ namespace
     \n\
       -m \n\
          Set a tracking mask.\n\
+    \n\
+      -p \n\
+         Track with pointclouds wrapped in vpMbtPointCloud.\n\
     \n\
       -h \n\
          Print the help.\n\n");
@@ -102,7 +105,7 @@ namespace
   }
 
   bool getOptions(int argc, const char **argv, std::string &ipath, bool &click_allowed, bool &display,
-                  bool &useScanline, int &lastFrame, bool &use_mask)
+                  bool &useScanline, int &lastFrame, bool &use_mask, bool &use_packed_pointcloud)
   {
     const char *optarg_;
     int c;
@@ -127,6 +130,9 @@ namespace
       case 'm':
         use_mask = true;
         break;
+      case 'p':
+        use_packed_pointcloud = true;
+        break;
       case 'h':
         usage(argv[0], NULL);
         return false;
@@ -224,6 +230,7 @@ int main(int argc, const char *argv[])
     int opt_lastFrame = -1;
 #endif
     bool use_mask = false;
+    bool use_packed_pointcloud = false;
 
     // Get the visp-images-data package path or VISP_INPUT_IMAGE_PATH
     // environment variable value
@@ -231,12 +238,13 @@ int main(int argc, const char *argv[])
 
     // Read the command line options
     if (!getOptions(argc, argv, opt_ipath, opt_click_allowed, opt_display,
-                    useScanline, opt_lastFrame, use_mask)) {
+                    useScanline, opt_lastFrame, use_mask, use_packed_pointcloud)) {
       return EXIT_FAILURE;
     }
 
     std::cout << "useScanline: " << useScanline << std::endl;
     std::cout << "use_mask: " << use_mask << std::endl;
+    std::cout << "use_packed_pointcloud: " << use_packed_pointcloud << std::endl;
 
     // Test if an input path is set
     if (opt_ipath.empty() && env_ipath.empty()) {
@@ -356,6 +364,7 @@ int main(int argc, const char *argv[])
     bool click = false, quit = false;
     std::vector<double> vec_err_t, vec_err_tu;
     std::vector<double> time_vec;
+    std::vector<float> pointcloud_packed;
     while (read_data(input_directory, cpt_frame, cam_depth, I, I_depth_raw, pointcloud, cMo_truth) && !quit
            && (opt_lastFrame > 0 ? (int)cpt_frame <= opt_lastFrame : true)) {
       vpImageConvert::createDepthHistogram(I_depth_raw, I_depth);
@@ -373,7 +382,22 @@ int main(int argc, const char *argv[])
       mapOfWidths["Camera"] = I_depth.getWidth();
       mapOfHeights["Camera"] = I_depth.getHeight();
 
-      tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      if (use_packed_pointcloud) {
+        // Padded XYZ points as provided by most depth sensors, wrapped without copy
+        pointcloud_packed.resize(4 * pointcloud.size());
+        for (size_t i = 0; i < pointcloud.size(); i++) {
+          for (unsigned int k = 0; k < 4; k++) {
+            pointcloud_packed[4 * i + k] = (float)pointcloud[i][k];
+          }
+        }
+
+        vpMbtPointCloud pointcloud_wrapper(&pointcloud_packed[0], I_depth.getHeight(), I_depth.getWidth(), 4);
+        std::map<std::string, const vpMbtPointCloud *> mapOfPointcloudWrappers;
+        mapOfPointcloudWrappers["Camera"] = &pointcloud_wrapper;
+        tracker.track(mapOfImages, mapOfPointcloudWrappers);
+      } else {
+        tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      }
       vpHomogeneousMatrix cMo = tracker.getPose();
       t = vpTime::measureTimeMs() - t;
       time_vec.push_back(t);
@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the bounding volume hierarchy used for the visibility of the faces.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbBoundingVolumeHierarchy.cpp
+
+  \brief Test the bounding volume hierarchy used for the visibility of the
+  faces: ray queries against a brute force search, frustum culling against
+  the visibility test of every face, and occlusion by ray casting.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/mbt/vpMbBoundingVolumeHierarchy.h>
+#include <visp3/mbt/vpMbHiddenFaces.h>
+
+namespace
+{
+double uniform(vpUniRand &rng, double a, double b) { return a + (b - a) * rng(); }
+
+// Add the 6 faces of a box, oriented outward
+void addBox(std::vector<std::vector<vpPoint> > &polygons, double x, double y, double z, double size)
+{
+  // The first face is the one at the lowest z
+  const int faces[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+  vpPoint corners[8];
+  for (int i = 0; i < 8; i++)
+    corners[i] = vpPoint(x + size * (i & 1), y + size * ((i >> 1) & 1), z + size * ((i >> 2) & 1));
+  for (int f = 0; f < 6; f++) {
+    std::vector<vpPoint> polygon;
+    for (int k = 0; k < 4; k++)
+      polygon.push_back(corners[faces[f][k]]);
+    polygons.push_back(polygon);
+  }
+}
+
+void fillHiddenFaces(const std::vector<std::vector<vpPoint> > &polygons, vpMbHiddenFaces<vpMbtPolygon> &faces)
+{
+  for (size_t i = 0; i < polygons.size(); i++) {
+    vpMbtPolygon polygon;
+    polygon.setNbPoint((unsigned int)polygons[i].size());
+    for (unsigned int k = 0; k < polygons[i].size(); k++)
+      polygon.addPoint(k, polygons[i][k]);
+    polygon.setIndex((int)i);
+    faces.addPolygon(&polygon);
+  }
+}
+
+// True if a vertex of the polygon is seen in the image
+bool isInImage(const std::vector<vpPoint> &polygon, const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam,
+               unsigned int width, unsigned int height)
+{
+  for (size_t k = 0; k < polygon.size(); k++) {
+    vpPoint p = polygon[k];
+    p.project(cMo);
+    if (p.get_Z() <= 0)
+      continue;
+    double u = 0, v = 0;
+    vpMeterPixelConversion::convertPoint(cam, p.get_x(), p.get_y(), u, v);
+    if (u >= 0 && u < width && v >= 0 && v < height)
+      return true;
+  }
+  return false;
+}
+}
+
+int main()
+{
+  vpUniRand rng(42);
+  const unsigned int width = 640, height = 480;
+  vpCameraParameters cam(600, 600, width / 2, height / 2);
+
+  // Scene made of boxes and of a few lines
+  std::vector<std::vector<vpPoint> > polygons;
+  for (int i = 0; i < 500; i++)
+    addBox(polygons, uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0),
+           uniform(rng, 0.05, 0.3));
+  for (int i = 0; i < 20; i++) {
+    std::vector<vpPoint> line;
+    line.push_back(vpPoint(uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0)));
+    line.push_back(vpPoint(uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0), uniform(rng, -2.0, 2.0)));
+    polygons.push_back(line);
+  }
+
+  vpMbBoundingVolumeHierarchy bvh;
+  std::vector<vpMbBoundingVolumeHierarchy> single(polygons.size());
+  for (size_t i = 0; i < polygons.size(); i++) {
+    bvh.addPolygon(&polygons[i][0], (unsigned int)polygons[i].size());
+    single[i].addPolygon(&polygons[i][0], (unsigned int)polygons[i].size());
+    single[i].build();
+  }
+  bvh.build();
+  std::cout << polygons.size() << " polygons, " << bvh.getNbNodes() << " nodes" << std::endl;
+
+  // Ray queries against a brute force search
+  for (int i = 0; i < 2000; i++) {
+    double origin[3] = {uniform(rng, -4.0, 4.0), uniform(rng, -4.0, 4.0), uniform(rng, -4.0, 4.0)};
+    double direction[3] = {uniform(rng, -1.0, 1.0), uniform(rng, -1.0, 1.0), uniform(rng, -1.0, 1.0)};
+    const double norm = sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    for (int k = 0; k < 3; k++)
+      direction[k] /= norm;
+
+    double distance = 0, best = 100;
+    unsigned int index = 0, best_index = 0;
+    bool b_hit = bvh.intersectRay(origin, direction, 100, distance, index);
+    bool b_best_hit = false;
+    for (size_t j = 0; j < single.size(); j++) {
+      double d;
+      unsigned int id;
+      if (single[j].intersectRay(origin, direction, best, d, id)) {
+        best = d;
+        best_index = (unsigned int)j;
+        b_best_hit = true;
+      }
+    }
+    if (b_hit != b_best_hit || (b_hit && (index != best_index || std::fabs(distance - best) > 1e-12))) {
+      std::cerr << "Wrong ray intersection " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Visibility with and without the hierarchy
+  vpMbHiddenFaces<vpMbtPolygon> faces, faces_bvh;
+  fillHiddenFaces(polygons, faces);
+  fillHiddenFaces(polygons, faces_bvh);
+  faces_bvh.setBVHVisibilityTest(true);
+  faces_bvh.setNbRayCastingAttemptsForVisibility(0);
+
+  vpImage<unsigned char> I(height, width);
+  const double angle = vpMath::rad(75);
+  double t = 0, t_bvh = 0;
+  for (int i = 0; i < 50; i++) {
+    vpHomogeneousMatrix cMo(uniform(rng, -0.5, 0.5), uniform(rng, -0.5, 0.5), uniform(rng, 4.0, 8.0),
+                            uniform(rng, -0.5, 0.5), uniform(rng, -0.5, 0.5), uniform(rng, -M_PI, M_PI));
+    bool changed = false, changed_bvh = false;
+    double t0 = vpTime::measureTimeMs();
+    faces.setVisible(I, cam, cMo, angle, angle, changed);
+    double t1 = vpTime::measureTimeMs();
+    faces_bvh.setVisible(I, cam, cMo, angle, angle, changed_bvh);
+    t_bvh += vpTime::measureTimeMs() - t1;
+    t += t1 - t0;
+
+    for (unsigned int j = 0; j < faces.size(); j++) {
+      // The hierarchy only discards faces outside the image
+      if (faces_bvh.isVisible(j) != faces.isVisible(j) &&
+          (faces_bvh.isVisible(j) || isInImage(polygons[j], cMo, cam, width, height))) {
+        std::cerr << "Wrong visibility of the face " << j << " for the pose " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (faces_bvh.isAppearing(j) && !faces.isAppearing(j)) {
+        std::cerr << "Wrong appearance of the face " << j << " for the pose " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  std::cout << "setVisible(): " << t / 50 << " ms, with the hierarchy: " << t_bvh / 50 << " ms" << std::endl;
+
+  // Occlusion by ray casting: the front face of the second box is hidden by
+  // the first one
+  std::vector<std::vector<vpPoint> > boxes;
+  addBox(boxes, -0.1, -0.1, -0.1, 0.2);
+  addBox(boxes, -0.05, -0.05, 0.5, 0.1);
+  vpMbHiddenFaces<vpMbtPolygon> occlusion;
+  fillHiddenFaces(boxes, occlusion);
+  occlusion.setBVHVisibilityTest(true);
+  bool changed = false;
+  unsigned int nbVisible = occlusion.setVisible(I, cam, vpHomogeneousMatrix(0, 0, 2, 0, 0, 0), angle, angle, changed);
+  if (nbVisible != 1 || !occlusion.isVisible(0)) {
+    std::cerr << "Wrong occlusion test: " << nbVisible << " visible faces" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "vpMbBoundingVolumeHierarchy is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
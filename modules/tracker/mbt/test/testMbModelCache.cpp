@@ -0,0 +1,240 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the binary cache of the CAD models.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbModelCache.cpp
+
+  \brief Test that a CAO model loaded from its binary cache gives the same
+  faces and features as the parsed model, and that the cache is rejected when
+  a model file or the loading parameters are modified.
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+
+namespace
+{
+// Edge tracker counting the CAO files that are parsed
+class vpMbEdgeTrackerCount : public vpMbEdgeTracker
+{
+public:
+  vpMbEdgeTrackerCount() : vpMbEdgeTracker(), nbParsedFiles(0) {}
+
+  unsigned int nbParsedFiles;
+
+protected:
+  virtual void loadCAOModel(const std::string &modelFile, std::vector<std::string> &vectorOfModelFilename,
+                            int &startIdFace, const bool verbose, const bool parent, const vpHomogeneousMatrix &T)
+  {
+    nbParsedFiles++;
+    vpMbEdgeTracker::loadCAOModel(modelFile, vectorOfModelFilename, startIdFace, verbose, parent, T);
+  }
+};
+
+void writeModel(const std::string &directory, const bool comment)
+{
+  std::ofstream part(vpIoTools::createFilePath(directory, "part.cao").c_str());
+  part << "V1\n"
+       << "# Points\n4\n0 0 0\n0.1 0 0\n0.1 0.1 0\n0 0.1 0\n"
+       << "# Lines\n0\n# Faces from lines\n0\n"
+       << "# Faces from points\n1\n4 0 1 2 3 name=part useLod=true minPolygonAreaThreshold=100\n"
+       << "# Cylinders\n0\n# Circles\n0\n";
+  if (comment)
+    part << "# Modified\n";
+
+  std::ofstream model(vpIoTools::createFilePath(directory, "model.cao").c_str());
+  model << "V1\n"
+        << "load(\"part.cao\")\n"
+        << "# Points\n8\n0 0 0.2\n0.2 0 0.2\n0.2 0.2 0.2\n0 0.2 0.2\n0 0 0.4\n0.2 0 0.4\n0.1 0.1 0.5\n0.1 0.1 0.6\n"
+        << "# Lines\n5\n0 1\n1 2\n2 3\n3 0\n4 5 name=segment useLod=true minLineLengthThreshold=20\n"
+        << "# Faces from lines\n1\n4 0 1 2 3 name=top\n"
+        << "# Faces from points\n1\n3 0 4 5\n"
+        << "# Cylinders\n1\n6 7 0.05 name=cylinder\n"
+        << "# Circles\n1\n0.05 6 7 4 name=circle\n";
+}
+
+bool compare(vpMbEdgeTracker &tracker, vpMbEdgeTracker &reference, const std::string &name)
+{
+  vpMbHiddenFaces<vpMbtPolygon> &faces = tracker.getFaces(), &facesRef = reference.getFaces();
+  if (faces.size() != facesRef.size()) {
+    std::cerr << name << ": " << faces.size() << " faces instead of " << facesRef.size() << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < faces.size(); i++) {
+    const vpMbtPolygon &polygon = *faces[i], &polygonRef = *facesRef[i];
+    bool equal = polygon.getNbPoint() == polygonRef.getNbPoint() && polygon.getIndex() == polygonRef.getIndex() &&
+                 polygon.getName() == polygonRef.getName() && polygon.useLod == polygonRef.useLod &&
+                 polygon.minLineLengthThresh == polygonRef.minLineLengthThresh &&
+                 polygon.minPolygonAreaThresh == polygonRef.minPolygonAreaThresh;
+    for (unsigned int k = 0; k < polygon.getNbPoint() && equal; k++) {
+      equal = polygon.p[k].get_oX() == polygonRef.p[k].get_oX() && polygon.p[k].get_oY() == polygonRef.p[k].get_oY() &&
+              polygon.p[k].get_oZ() == polygonRef.p[k].get_oZ();
+    }
+    if (!equal) {
+      std::cerr << name << ": wrong face " << i << std::endl;
+      return false;
+    }
+  }
+
+  std::list<vpMbtDistanceLine *> lines, linesRef;
+  std::list<vpMbtDistanceCylinder *> cylinders, cylindersRef;
+  std::list<vpMbtDistanceCircle *> circles, circlesRef;
+  tracker.getLline(lines);
+  reference.getLline(linesRef);
+  tracker.getLcylinder(cylinders);
+  reference.getLcylinder(cylindersRef);
+  tracker.getLcircle(circles);
+  reference.getLcircle(circlesRef);
+  if (lines.size() != linesRef.size() || cylinders.size() != cylindersRef.size() ||
+      circles.size() != circlesRef.size()) {
+    std::cerr << name << ": wrong number of features" << std::endl;
+    return false;
+  }
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines.begin(), itRef = linesRef.begin();
+       it != lines.end(); ++it, ++itRef) {
+    if ((*it)->getName() != (*itRef)->getName() || (*it)->Lindex_polygon != (*itRef)->Lindex_polygon) {
+      std::cerr << name << ": wrong line " << (*it)->getName() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool check(vpMbEdgeTrackerCount &tracker, vpMbEdgeTracker &reference, const unsigned int nbParsedFiles,
+           const std::string &name)
+{
+  if (tracker.nbParsedFiles != nbParsedFiles) {
+    std::cerr << name << ": " << tracker.nbParsedFiles << " parsed files instead of " << nbParsedFiles << std::endl;
+    return false;
+  }
+  return compare(tracker, reference, name);
+}
+}
+
+int main()
+{
+  try {
+    std::string username;
+    vpIoTools::getUserName(username);
+#if defined(_WIN32)
+    std::string tmp_dir = "C:/temp/" + username + "/testMbModelCache";
+#else
+    std::string tmp_dir = "/tmp/" + username + "/testMbModelCache";
+#endif
+    const std::string cache_dir = vpIoTools::createFilePath(tmp_dir, "cache");
+    if (vpIoTools::checkDirectory(cache_dir))
+      vpIoTools::remove(cache_dir);
+    vpIoTools::makeDirectory(tmp_dir);
+    writeModel(tmp_dir, false);
+    const std::string modelFile = vpIoTools::createFilePath(tmp_dir, "model.cao");
+
+    vpMbEdgeTracker reference;
+    reference.loadModel(modelFile);
+
+    // Cold start: the model is parsed and the cache is written
+    {
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile);
+      if (!check(tracker, reference, 2, "Cold start"))
+        return EXIT_FAILURE;
+    }
+
+    // Warm start: nothing is parsed
+    {
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile);
+      if (!check(tracker, reference, 0, "Warm start"))
+        return EXIT_FAILURE;
+    }
+
+    // Model loaded twice, the ids of the faces of the second one follow the
+    // ones of the first one
+    {
+      vpMbEdgeTracker reference2;
+      reference2.loadModel(modelFile);
+      reference2.loadModel(modelFile);
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile);
+      tracker.loadModel(modelFile);
+      if (!check(tracker, reference2, 0, "Model loaded twice"))
+        return EXIT_FAILURE;
+    }
+
+    // Modified included file: the cache is rejected then written again
+    writeModel(tmp_dir, true);
+    {
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile);
+      if (!check(tracker, reference, 2, "Modified file"))
+        return EXIT_FAILURE;
+    }
+    {
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile);
+      if (!check(tracker, reference, 0, "Warm start after modification"))
+        return EXIT_FAILURE;
+    }
+
+    // Other loading parameters: another cache file
+    {
+      vpHomogeneousMatrix T(0.1, 0, 0, 0, 0, 0);
+      vpMbEdgeTracker referenceT;
+      referenceT.loadModel(modelFile, false, T);
+      vpMbEdgeTrackerCount tracker;
+      tracker.setModelCacheDirectory(cache_dir);
+      tracker.loadModel(modelFile, false, T);
+      if (!check(tracker, referenceT, 2, "Other transformation"))
+        return EXIT_FAILURE;
+    }
+
+    vpIoTools::remove(tmp_dir);
+
+    std::cout << "vpMbModelCache is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
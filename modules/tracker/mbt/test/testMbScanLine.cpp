@@ -0,0 +1,199 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the scan-line visibility rendering by bands of scanlines.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbScanLine.cpp
+
+  \brief Test that the scan-line rendering gives the same masks and the same
+  visible parts of the edges whatever the number of bands of scanlines, on a
+  scene where a face hides a part of the edges of another one.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/mbt/vpMbScanLine.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+namespace
+{
+typedef std::vector<std::pair<vpPoint, unsigned int> > vpScanLinePolygon;
+
+double uniform(vpUniRand &rng, double a, double b) { return a + (b - a) * rng(); }
+
+// Point given in the camera frame
+vpPoint cameraPoint(double X, double Y, double Z)
+{
+  vpPoint p(X, Y, Z);
+  p.changeFrame(vpHomogeneousMatrix());
+  return p;
+}
+
+void addQuad(std::vector<vpScanLinePolygon> &scene, const vpPoint corners[4])
+{
+  vpScanLinePolygon polygon;
+  for (unsigned int i = 0; i < 4; i++)
+    polygon.push_back(std::make_pair(corners[i], i));
+  scene.push_back(polygon);
+}
+
+typedef std::vector<std::vector<std::pair<vpPoint, vpPoint> > > vpVisibleEdges;
+
+// Visible parts of all the edges of the scene
+void render(vpMbScanLine &scanline, std::vector<vpScanLinePolygon> &scene, const vpCameraParameters &cam,
+            unsigned int width, unsigned int height, vpVisibleEdges &visibleEdges)
+{
+  std::vector<vpScanLinePolygon *> polygons;
+  std::vector<int> indices;
+  for (size_t i = 0; i < scene.size(); i++) {
+    polygons.push_back(&scene[i]);
+    indices.push_back((int)i);
+  }
+  scanline.drawScene(polygons, indices, cam, width, height);
+
+  visibleEdges.clear();
+  for (size_t i = 0; i < scene.size(); i++) {
+    const size_t nbEdges = scene[i].size() == 2 ? 1 : scene[i].size();
+    for (size_t k = 0; k < nbEdges; k++) {
+      std::vector<std::pair<vpPoint, vpPoint> > lines;
+      scanline.queryLineVisibility(scene[i][k].first, scene[i][(k + 1) % scene[i].size()].first, lines);
+      visibleEdges.push_back(lines);
+    }
+  }
+}
+
+bool samePoint(const vpPoint &a, const vpPoint &b)
+{
+  return a.get_X() == b.get_X() && a.get_Y() == b.get_Y() && a.get_Z() == b.get_Z();
+}
+
+bool sameEdges(const vpVisibleEdges &edges, const vpVisibleEdges &reference)
+{
+  if (edges.size() != reference.size())
+    return false;
+  for (size_t i = 0; i < edges.size(); i++) {
+    if (edges[i].size() != reference[i].size())
+      return false;
+    for (size_t k = 0; k < edges[i].size(); k++) {
+      if (!samePoint(edges[i][k].first, reference[i][k].first) ||
+          !samePoint(edges[i][k].second, reference[i][k].second))
+        return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int width = 640, height = 480;
+    vpCameraParameters cam(600, 600, width / 2, height / 2);
+    vpUniRand rng(42);
+
+    // A face at 2 m whose left edge is partly hidden by a face at 1 m
+    std::vector<vpScanLinePolygon> scene;
+    vpPoint back[4] = {cameraPoint(-0.5, -0.5, 2), cameraPoint(0.5, -0.5, 2), cameraPoint(0.5, 0.5, 2),
+                       cameraPoint(-0.5, 0.5, 2)};
+    vpPoint front[4] = {cameraPoint(-0.4, -0.1, 1), cameraPoint(0, -0.1, 1), cameraPoint(0, 0.1, 1),
+                        cameraPoint(-0.4, 0.1, 1)};
+    addQuad(scene, back);
+    addQuad(scene, front);
+    {
+      vpMbScanLine scanline;
+      vpVisibleEdges edges;
+      render(scanline, scene, cam, width, height, edges);
+      if (edges[3].size() != 2 || edges[7].size() != 1) {
+        std::cerr << "The left edge of the back face has " << edges[3].size() << " visible parts instead of 2"
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Random tilted faces and lines around them
+    for (int i = 0; i < 30; i++) {
+      const double X = uniform(rng, -1.0, 1.0), Y = uniform(rng, -0.8, 0.8), Z = uniform(rng, 1.0, 3.0);
+      const double size = uniform(rng, 0.05, 0.4), slope = uniform(rng, -0.5, 0.5);
+      vpPoint corners[4] = {cameraPoint(X, Y, Z), cameraPoint(X + size, Y, Z + slope * size),
+                            cameraPoint(X + size, Y + size, Z + slope * size), cameraPoint(X, Y + size, Z)};
+      addQuad(scene, corners);
+    }
+    for (int i = 0; i < 10; i++) {
+      vpScanLinePolygon line;
+      line.push_back(std::make_pair(cameraPoint(uniform(rng, -1.0, 1.0), uniform(rng, -0.8, 0.8), 1.5), 0u));
+      line.push_back(std::make_pair(cameraPoint(uniform(rng, -1.0, 1.0), uniform(rng, -0.8, 0.8), 2.5), 1u));
+      scene.push_back(line);
+    }
+
+    for (unsigned int maskBorder = 0; maskBorder <= 5; maskBorder += 5) {
+      // Reference rendering with a single band
+      vpMbScanLine reference;
+      reference.setMaskBorder(maskBorder);
+      reference.setNbBands(1);
+      vpVisibleEdges referenceEdges;
+      render(reference, scene, cam, width, height, referenceEdges);
+
+      const unsigned int nbBands[] = {2, 3, 7, 64, 0};
+      for (unsigned int b = 0; b < sizeof(nbBands) / sizeof(nbBands[0]); b++) {
+        vpMbScanLine scanline;
+        scanline.setMaskBorder(maskBorder);
+        scanline.setNbBands(nbBands[b]);
+        vpVisibleEdges edges;
+        render(scanline, scene, cam, width, height, edges);
+
+        vpImage<unsigned char> mask = scanline.getMask();
+        vpImage<int> ids = scanline.getPrimitiveIDs();
+        if (mask != reference.getMask() || ids != reference.getPrimitiveIDs() || !sameEdges(edges, referenceEdges)) {
+          std::cerr << "Different rendering with " << nbBands[b] << " bands and a mask border of " << maskBorder
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    std::cout << "vpMbScanLine gives the same results whatever the number of bands." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main() { return EXIT_SUCCESS; }
+#endif
@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the visibility test of the faces.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbtPolygon.cpp
+
+  \brief Test that the visibility test of vpMbtPolygon compares the angle
+  between the normal of the face and the direction from the centroid of the
+  face to the camera with the given threshold.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/mbt/vpMbtPolygon.h>
+
+namespace
+{
+double uniform(vpUniRand &rng, double a, double b) { return a + (b - a) * rng(); }
+}
+
+int main()
+{
+  vpUniRand rng(42);
+  const double alpha = vpMath::rad(80);
+
+  // Square face whose normal is the z axis of the object frame
+  const double size = 0.2;
+  vpPoint corners[4] = {vpPoint(-size, -size, 0), vpPoint(size, -size, 0), vpPoint(size, size, 0),
+                        vpPoint(-size, size, 0)};
+  vpMbtPolygon polygon;
+  polygon.setNbPoint(4);
+  for (unsigned int i = 0; i < 4; i++) {
+    polygon.addPoint(i, corners[i]);
+  }
+
+  unsigned int nbVisible = 0, nbHidden = 0;
+  for (int i = 0; i < 2000; i++) {
+    vpHomogeneousMatrix cMo(uniform(rng, -1.0, 1.0), uniform(rng, -1.0, 1.0), uniform(rng, 0.5, 3.0),
+                            uniform(rng, -M_PI, M_PI), uniform(rng, -M_PI, M_PI), uniform(rng, -M_PI, M_PI));
+
+    // Geometric angle between the normal and the direction from the centroid to the camera
+    vpColVector centroid(3);
+    for (unsigned int k = 0; k < 4; k++) {
+      vpPoint p = corners[k];
+      p.changeFrame(cMo);
+      centroid[0] += p.get_X() / 4;
+      centroid[1] += p.get_Y() / 4;
+      centroid[2] += p.get_Z() / 4;
+    }
+    vpColVector normal(3);
+    for (unsigned int k = 0; k < 3; k++) {
+      normal[k] = cMo[k][2];
+    }
+    const double angle = acos(vpColVector::dotProd(-centroid.normalize(), normal));
+    if (std::fabs(angle - alpha) < 1e-9) {
+      continue;
+    }
+
+    const bool visible = polygon.isVisible(cMo, alpha);
+    if (visible != (angle < alpha)) {
+      std::cerr << "Wrong visibility for the pose " << i << ": angle=" << vpMath::deg(angle) << " deg" << std::endl;
+      return EXIT_FAILURE;
+    }
+    visible ? nbVisible++ : nbHidden++;
+  }
+
+  if (nbVisible == 0 || nbHidden == 0) {
+    std::cerr << "The poses do not cover both cases" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << nbVisible << " visible and " << nbHidden << " hidden faces" << std::endl;
+  std::cout << "vpMbtPolygon visibility test is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
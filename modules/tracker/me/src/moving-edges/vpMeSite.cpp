@@ -46,10 +46,16 @@
 #include <cmath>  // std::fabs
 #include <limits> // numeric_limits
 #include <stdlib.h>
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/me/vpMe.h>
 #include <visp3/me/vpMeSite.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static bool horsImage(int i, int j, int half, int rows, int cols)
 {
@@ -61,6 +67,69 @@ static bool horsImage(int i, int j, int half, int rows, int cols)
   // > (cols - half - 3) )) ;
   return ((0 < (half_1 - i)) || ((i - rows + half_3) > 0) || (0 < (half_1 - j)) || ((j - cols + half_3) > 0));
 }
+
+// Index of the mask to apply for a site whose normal angle is alpha
+static unsigned int getMaskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta = alpha + M_PI / 2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta < 0)
+    theta += M_PI;
+  while (theta > M_PI)
+    theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+
+  if (abs(thetadeg) == 180) {
+    thetadeg = 0;
+  }
+
+  return (unsigned int)(thetadeg / (double)me->getAngleStep());
+}
+
+// Unsigned convolution of the msize x msize mask with the image patch whose
+// top left corner is (ihalf, jhalf). The mask coefficients are read from the
+// contiguous storage of the vpMatrix.
+static double convolve(const vpImage<unsigned char> &I, const double *mask, unsigned int msize, unsigned int ihalf,
+                       unsigned int jhalf)
+{
+  double conv = 0.0;
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row = I[ihalf + a] + jhalf;
+    const double *mask_row = mask + a * msize;
+    for (unsigned int b = 0; b < msize; b++) {
+      conv += mask_row[b] * row[b];
+    }
+  }
+
+  return conv;
+}
+
+#if VISP_HAVE_SSE2
+// Same as convolve() for two patches at once. Each lane accumulates the
+// products in the same order as convolve() so that the results are identical.
+static void convolve2(const vpImage<unsigned char> &I, const double *mask, unsigned int msize, unsigned int ihalf1,
+                      unsigned int jhalf1, unsigned int ihalf2, unsigned int jhalf2, double &conv1, double &conv2)
+{
+  __m128d vconv = _mm_setzero_pd();
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row1 = I[ihalf1 + a] + jhalf1;
+    const unsigned char *row2 = I[ihalf2 + a] + jhalf2;
+    const double *mask_row = mask + a * msize;
+    for (unsigned int b = 0; b < msize; b++) {
+      vconv = _mm_add_pd(vconv, _mm_mul_pd(_mm_set1_pd(mask_row[b]), _mm_set_pd(row2[b], row1[b])));
+    }
+  }
+
+  double res[2];
+  _mm_storeu_pd(res, vconv);
+  conv1 = res[0];
+  conv2 = res[1];
+}
+#endif
 #endif
 
 void vpMeSite::init()
@@ -293,254 +362,158 @@ void vpMeSite::getSign(const vpImage<unsigned char> &I, const int range)
 // Specific function for ME
 double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
 {
-  int half;
   int height_ = static_cast<int>(I.getHeight());
   int width_ = static_cast<int>(I.getWidth());
 
-  double conv = 0.0;
   unsigned int msize = me->getMaskSize();
-  half = (static_cast<int>(msize) - 1) >> 1;
+  int half = (static_cast<int>(msize) - 1) >> 1;
 
   if (horsImage(i, j, half + me->getStrip(), height_, width_)) {
-    conv = 0.0;
     i = 0;
     j = 0;
-  } else {
-    // Calculate tangent angle from normal
-    double theta = alpha + M_PI / 2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta < 0)
-      theta += M_PI;
-    while (theta > M_PI)
-      theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI);
-
-    if (abs(thetadeg) == 180) {
-      thetadeg = 0;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg / (double)me->getAngleStep());
-
-    unsigned int i_ = static_cast<unsigned int>(i);
-    unsigned int j_ = static_cast<unsigned int>(j);
-    unsigned int half_ = static_cast<unsigned int>(half);
-
-    unsigned int ihalf = i_ - half_;
-    unsigned int jhalf = j_ - half_;
-
-    for (unsigned int a = 0; a < msize; a++) {
-      unsigned int ihalfa = ihalf + a;
-      for (unsigned int b = 0; b < msize; b++) {
-        conv += mask_sign * me->getMask()[index_mask][a][b] *
-                //	  I(i-half+a,j-half+b) ;
-                I(ihalfa, jhalf + b);
-      }
-    }
+    return 0.0;
   }
 
-  return (conv);
+  // Since IEEE rounding is symmetric, applying the sign of the mask after the
+  // accumulation gives the same result than applying it to each product
+  const double *mask = me->getMask()[getMaskIndex(alpha, me)].data;
+  return mask_sign * convolve(I, mask, msize, static_cast<unsigned int>(i - half), static_cast<unsigned int>(j - half));
 }
 
 /*!
 
   Specific function for ME.
 
+  Search along the normal to the contour, within the range given by
+  vpMe::getRange(), the pixel that best matches the site. The candidates are
+  generated and scored on the fly, so that no memory is allocated. When SSE2
+  is available, two candidates are convolved at once. The result is the same
+  as the one obtained by scoring each site of getQueryList() with
+  convolution().
+
   \warning To display the moving edges graphics a call to vpDisplay::flush()
   is needed.
 
 */
 void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool test_contraste)
 {
-  //   vpMeSite  *list_query_pixels ;
-  //   int  max_rank =0 ;
-  //   int max_rank1=0 ;
-  //   int max_rank2 = 0;
-  //   double  convolution = 0 ;
-  //   double  max_convolution = 0 ;
-  //   double max = 0 ;
-  //   double contraste = 0;
-  //   //  vpDisplay::display(I) ;
-  //   //  vpERROR_TRACE("getclcik %d",me->getRange()) ;
-  //   //  vpDisplay::getClick(I) ;
-  //
-  //   // range = +/- range of pixels within which the correspondent
-  //   // of the current pixel will be sought
-  //   int range  = me->getRange() ;
-  //
-  //   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
-  //   std::endl ; list_query_pixels = getQueryList(I, range) ;
-  //
-  //   double  contraste_max = 1 + me->getMu2();
-  //   double  contraste_min = 1 - me->getMu1();
-  //
-  //   // array in which likelihood ratios will be stored
-  //   double  *likelihood= new double[ 2 * range + 1 ] ;
-  //
-  //   int ii_1 = i ;
-  //   int jj_1 = j ;
-  //   i_1 = i ;
-  //   j_1 = j ;
-  //   double threshold;
-  //   threshold = me->getThreshold();
-  //
-  //   //    std::cout <<"---------------------"<<std::endl ;
-  //   for(int n = 0 ; n < 2 * range + 1 ; n++)
-  //     {
-  //
-  //       //   convolution results
-  //       convolution = list_query_pixels[n].convolution(I, me) ;
-  //
-  //       // luminance ratio of reference pixel to potential correspondent
-  //       pixel
-  //       // the luminance must be similar, hence the ratio value should
-  //       // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-  //       if( test_contraste )
-  // 	{
-  // 	  // Include this to eliminate temporal calculation
-  // 	  if (convlt==0)
-  // 	    {
-  // 	      std::cout << "vpMeSite::track : Division by zero  convlt = 0" <<
-  // std::endl ; 	      delete []list_query_pixels ; 	      delete
-  // []likelihood;
-  // 	      throw(vpTrackingException(vpTrackingException::initializationError,
-  // 					"Division by zero")) ;
-  // 	    }
-  //
-  // // 	  contraste = fabs(convolution / convlt) ;
-  // 	  contraste = convolution / convlt ;
-  // 	  // likelihood ratios
-  // 	  if((contraste > contraste_min) && (contraste < contraste_max))
-  // 	    likelihood[n] = fabs(convolution + convlt ) ;
-  // 	  else
-  // 	    likelihood[n] = 0 ;
-  // 	}
-  //       else
-  // 	likelihood[n] = fabs(2*convolution) ;
-  //
-  //
-  //       // establishment of the maximal likelihood ratios's  rank
-  //       // in the array, the value of the likelihood ratio can now be
-  //     // referenced by its rank in the array
-  //     if (likelihood[n] > max)
-  //     {
-  //       max_convolution= convolution;
-  //       max = likelihood[n] ;
-  //       max_rank = n ;
-  //       max_rank2 = max_rank1;
-  //       max_rank1 = max_rank;
-  //     }
-  //
-  //   }
-  //
-  //   // test on the likelihood threshold if threshold==-1 then
-  //   // the me->threshold is  selected
-  //
-  //   vpImagePoint ip;
-  //
-  //   //  if (test_contrast)
-  //   if(max > threshold)
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::red);
-  // 	}
-  //
-  //       *this = list_query_pixels[max_rank] ;//The vpMeSite is replaced by
-  //       the vpMeSite of max likelihood normGradient =
-  //       vpMath::sqr(max_convolution);
-  //
-  //       convlt = max_convolution;
-  //       i_1 = ii_1; //list_query_pixels[max_rank].i ;
-  //       j_1 = jj_1; //list_query_pixels[max_rank].j ;
-  //       delete []list_query_pixels ;
-  //       delete []likelihood;
-  //     }
-  //   else //none of the query sites is better than the threshold
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::green);
-  // 	}
-  //       normGradient = 0 ;
-  //       if(max == 0)
-  // 	suppress = 1; // contrast suppression
-  //       else
-  // 	suppress = 2; // threshold suppression
-  //
-  //       delete []list_query_pixels ;
-  //       delete []likelihood; // modif portage
-  //     }
-
   int max_rank = -1;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
   double max_convolution = 0;
   double max = 0;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range = me->getRange();
-
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
-  //  std::endl ;
-  vpMeSite *list_query_pixels = getQueryList(I, (int)range);
+  int range = static_cast<int>(me->getRange());
 
   double contraste_max = 1 + me->getMu2();
   double contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double *likelihood = new double[2 * range + 1];
-
   int ii_1 = i;
   int jj_1 = j;
   i_1 = i;
   j_1 = j;
-  double threshold;
-  threshold = me->getThreshold();
+  double threshold = me->getThreshold();
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for (unsigned int n = 0; n < 2 * range + 1; n++) {
-    //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me);
-
-    // luminance ratio of reference pixel to potential correspondent pixel
-    // the luminance must be similar, hence the ratio value should
-    // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-    if (test_contraste) {
-      likelihood[n] = fabs(convolution_ + convlt);
-      if (likelihood[n] > threshold) {
-        contraste = convolution_ / convlt;
-        if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
-          diff = fabs(1 - contraste);
-          max_convolution = convolution_;
-          max = likelihood[n];
-          max_rank = (int)n;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+
+  int height_ = static_cast<int>(I.getHeight());
+  int width_ = static_cast<int>(I.getWidth());
+  unsigned int msize = me->getMaskSize();
+  int half = (static_cast<int>(msize) - 1) >> 1;
+  int half_strip = half + me->getStrip();
+  const double *mask = me->getMask()[getMaskIndex(alpha, me)].data;
+
+#if VISP_HAVE_SSE2
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+
+  // Position of the first and of the best query sites
+  int i_first = 0, j_first = 0, i_best = 0, j_best = 0;
+  double ifloat_best = 0.0, jfloat_best = 0.0;
+
+  vpImagePoint ip;
+  for (int k = -range; k <= range; k += 2) {
+    // Process the query sites two by two
+    int nb = (k < range) ? 2 : 1;
+    double ii[2], jj[2], conv[2] = {0.0, 0.0};
+    int iq[2], jq[2];
+    bool inside[2];
+    for (int l = 0; l < nb; l++) {
+      ii[l] = (ifloat + (k + l) * salpha);
+      jj[l] = (jfloat + (k + l) * calpha);
+
+      // Display
+      if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RANGE)) {
+        ip.set_i(ii[l]);
+        ip.set_j(jj[l]);
+        vpDisplay::displayCross(I, ip, 1, vpColor::yellow);
+      }
+
+      iq[l] = (int)ii[l];
+      jq[l] = (int)jj[l];
+      inside[l] = !horsImage(iq[l], jq[l], half_strip, height_, width_);
+      if (!inside[l]) {
+        iq[l] = 0;
+        jq[l] = 0;
+      }
+    }
+
+#if VISP_HAVE_SSE2
+    if (checkSSE2 && nb == 2 && inside[0] && inside[1]) {
+      convolve2(I, mask, msize, static_cast<unsigned int>(iq[0] - half), static_cast<unsigned int>(jq[0] - half),
+                static_cast<unsigned int>(iq[1] - half), static_cast<unsigned int>(jq[1] - half), conv[0], conv[1]);
+    } else
+#endif
+    {
+      for (int l = 0; l < nb; l++) {
+        if (inside[l]) {
+          conv[l] = convolve(I, mask, msize, static_cast<unsigned int>(iq[l] - half),
+                             static_cast<unsigned int>(jq[l] - half));
         }
       }
     }
 
-    else {
-      likelihood[n] = fabs(2 * convolution_);
-      if (likelihood[n] > max && likelihood[n] > threshold) {
+    for (int l = 0; l < nb; l++) {
+      if (k + l == -range) {
+        i_first = iq[l];
+        j_first = jq[l];
+      }
+
+      //   convolution results
+      double convolution_ = inside[l] ? mask_sign * conv[l] : 0.0;
+
+      // luminance ratio of reference pixel to potential correspondent pixel
+      // the luminance must be similar, hence the ratio value should
+      // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
+      bool best = false;
+      if (test_contraste) {
+        double likelihood = fabs(convolution_ + convlt);
+        if (likelihood > threshold) {
+          contraste = convolution_ / convlt;
+          if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
+            diff = fabs(1 - contraste);
+            max = likelihood;
+            best = true;
+          }
+        }
+      } else {
+        double likelihood = fabs(2 * convolution_);
+        if (likelihood > max && likelihood > threshold) {
+          max = likelihood;
+          best = true;
+        }
+      }
+
+      if (best) {
         max_convolution = convolution_;
-        max = likelihood[n];
-        max_rank = (int)n;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
+        max_rank = k + l + range;
+        i_best = iq[l];
+        j_best = jq[l];
+        ifloat_best = ii[l];
+        jfloat_best = jj[l];
       }
     }
   }
@@ -548,30 +521,32 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
-  vpImagePoint ip;
-
   //  if (test_contrast)
   if (max_rank >= 0) {
     if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[max_rank].i);
-      ip.set_j(list_query_pixels[max_rank].j);
+      ip.set_i(i_best);
+      ip.set_j(j_best);
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
 
-    *this = list_query_pixels[max_rank]; // The vpMeSite2 is replaced by the
-                                         // vpMeSite2 of max likelihood
+    // The site is replaced by the query site of max likelihood
+    i = i_best;
+    j = j_best;
+    ifloat = ifloat_best;
+    jfloat = jfloat_best;
+    v = 0;
+    weight = 1;
+    setState(NO_SUPPRESSION);
     normGradient = vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
-    i_1 = ii_1; // list_query_pixels[max_rank].i ;
-    j_1 = jj_1; // list_query_pixels[max_rank].j ;
-    delete[] list_query_pixels;
-    delete[] likelihood;
+    i_1 = ii_1;
+    j_1 = jj_1;
   } else // none of the query sites is better than the threshold
   {
     if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[0].i);
-      ip.set_j(list_query_pixels[0].j);
+      ip.set_i(i_first);
+      ip.set_j(j_first);
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0;
@@ -580,9 +555,6 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete[] list_query_pixels;
-    delete[] likelihood; // modif portage
   }
 }
 
@@ -0,0 +1,216 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test moving edge site tracking.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeSite.cpp
+
+  \brief Test that vpMeSite::track() gives the same results than the search
+  along the query list built by vpMeSite::getQueryList().
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeSite.h>
+
+namespace
+{
+// Scalar convolution of a query site, as done per product in the original implementation
+double referenceConvolution(const vpImage<unsigned char> &I, const vpMe &me, vpMeSite &site)
+{
+  int msize = (int)me.getMaskSize();
+  int half = (msize - 1) >> 1;
+  int half_strip = half + me.getStrip();
+  int rows = (int)I.getHeight(), cols = (int)I.getWidth();
+
+  if (site.i < half_strip + 1 || site.i > rows - half_strip - 3 || site.j < half_strip + 1 ||
+      site.j > cols - half_strip - 3) {
+    site.i = 0;
+    site.j = 0;
+    return 0.0;
+  }
+
+  double theta = site.alpha + M_PI / 2;
+  while (theta < 0)
+    theta += M_PI;
+  while (theta > M_PI)
+    theta -= M_PI;
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+  if (abs(thetadeg) == 180) {
+    thetadeg = 0;
+  }
+  unsigned int index_mask = (unsigned int)(thetadeg / (double)me.getAngleStep());
+
+  double conv = 0.0;
+  for (int a = 0; a < msize; a++) {
+    for (int b = 0; b < msize; b++) {
+      conv += site.mask_sign * me.getMask()[index_mask][a][b] * I[site.i - half + a][site.j - half + b];
+    }
+  }
+
+  return conv;
+}
+
+// Original search along the normal using the query list
+void referenceTrack(const vpImage<unsigned char> &I, const vpMe &me, vpMeSite &site, bool test_contraste)
+{
+  unsigned int range = me.getRange();
+  vpMeSite *list_query_pixels = site.getQueryList(I, (int)range);
+
+  double contraste_max = 1 + me.getMu2();
+  double contraste_min = 1 - me.getMu1();
+  double max_convolution = 0, max = 0, contraste = 0, diff = 1e6;
+  int max_rank = -1;
+  int ii_1 = site.i, jj_1 = site.j;
+  site.i_1 = site.i;
+  site.j_1 = site.j;
+
+  for (unsigned int n = 0; n < 2 * range + 1; n++) {
+    double convolution_ = referenceConvolution(I, me, list_query_pixels[n]);
+    if (test_contraste) {
+      double likelihood = fabs(convolution_ + site.convlt);
+      if (likelihood > me.getThreshold()) {
+        contraste = convolution_ / site.convlt;
+        if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
+          diff = fabs(1 - contraste);
+          max_convolution = convolution_;
+          max = likelihood;
+          max_rank = (int)n;
+        }
+      }
+    } else {
+      double likelihood = fabs(2 * convolution_);
+      if (likelihood > max && likelihood > me.getThreshold()) {
+        max_convolution = convolution_;
+        max = likelihood;
+        max_rank = (int)n;
+      }
+    }
+  }
+
+  if (max_rank >= 0) {
+    site = list_query_pixels[max_rank];
+    site.normGradient = vpMath::sqr(max_convolution);
+    site.convlt = max_convolution;
+    site.i_1 = ii_1;
+    site.j_1 = jj_1;
+  } else {
+    site.normGradient = 0;
+    if (std::fabs(contraste) > std::numeric_limits<double>::epsilon())
+      site.setState(vpMeSite::CONSTRAST);
+    else
+      site.setState(vpMeSite::THRESHOLD);
+  }
+
+  delete[] list_query_pixels;
+}
+
+// Results must be strictly identical, hence the exact comparison of the floating point values
+bool isEqual(const vpMeSite &s1, const vpMeSite &s2)
+{
+  return s1.i == s2.i && s1.j == s2.j && s1.i_1 == s2.i_1 && s1.j_1 == s2.j_1 && s1.ifloat == s2.ifloat &&
+         s1.jfloat == s2.jfloat && s1.convlt == s2.convlt && s1.normGradient == s2.normGradient &&
+         s1.weight == s2.weight && s1.getState() == s2.getState();
+}
+}
+
+int main()
+{
+  try {
+    // Image with random blocks to get edges in all directions
+    vpUniRand rand(42);
+    vpImage<unsigned char> I(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = (unsigned char)(((i / 16 + j / 24) % 2) * 150 + (i * j) % 37 + 20 * rand());
+      }
+    }
+
+    vpMe me;
+    me.setRange(7);
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setThreshold(1000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+
+    const unsigned int nb_sites = 20000;
+    double t_reference = 0.0, t_track = 0.0;
+    for (unsigned int n = 0; n < nb_sites; n++) {
+      // Some sites are close to the border to test the out of image case
+      double ip = -10 + (I.getHeight() + 20) * rand();
+      double jp = -10 + (I.getWidth() + 20) * rand();
+      vpMeSite site(ip, jp);
+      site.alpha = M_PI * (2 * rand() - 1);
+      site.mask_sign = rand() > 0.5 ? 1 : -1;
+      site.convlt = 20000 * (2 * rand() - 1);
+      bool test_contraste = (n % 2) == 0;
+
+      vpMeSite site_reference = site;
+      double t = vpTime::measureTimeMs();
+      referenceTrack(I, me, site_reference, test_contraste);
+      t_reference += vpTime::measureTimeMs() - t;
+
+      t = vpTime::measureTimeMs();
+      site.track(I, &me, test_contraste);
+      t_track += vpTime::measureTimeMs() - t;
+
+      if (!isEqual(site, site_reference)) {
+        std::cerr << "Difference between vpMeSite::track() and the query list search for site " << n << "!"
+                  << std::endl;
+        std::cerr << "track: " << site.i << " " << site.j << " " << site.convlt << " " << site.getState()
+                  << std::endl;
+        std::cerr << "reference: " << site_reference.i << " " << site_reference.j << " " << site_reference.convlt
+                  << " " << site_reference.getState() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "t_reference=" << t_reference << " ms ; t_track=" << t_track << " ms ; ratio="
+              << t_reference / t_track << std::endl;
+    std::cout << "vpMeSite::track() returns the same sites than the query list search." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
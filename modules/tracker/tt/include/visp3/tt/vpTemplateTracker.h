@@ -48,6 +48,7 @@
 #include <math.h>
 
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/tt/vpTemplateTrackerZone.h>
@@ -138,6 +139,8 @@ protected:
   vpImage<double> dIx;
   vpImage<double> dIy;
   vpTemplateTrackerZone zoneRef_; // Reference zone
+  // Pyramid of the tracked image, its levels are reused from one frame to the other
+  vpImagePyramid m_imagePyramid;
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -182,7 +185,7 @@ public:
       useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(0), mod_j(0),
       nbParam(), lambdaDep(0), iterationMax(0), iterationGlobale(0), diverge(false), nbIteration(0),
       useCompositionnal(false), useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(),
-      zoneRef_()
+      zoneRef_(), m_imagePyramid(vpImagePyramid::GAUSSIAN_PYRAMID)
   {
   }
   explicit vpTemplateTracker(vpTemplateTrackerWarp *_warp);
@@ -282,6 +285,7 @@ public:
   void setUseBrent(bool b) { useBrent = b; }
 
   void track(const vpImage<unsigned char> &I);
+  void track(const vpImagePyramid &pyramid);
   void trackRobust(const vpImage<unsigned char> &I);
 
 protected:
@@ -296,5 +300,6 @@ protected:
   virtual void initTrackingPyr(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void trackNoPyr(const vpImage<unsigned char> &I) = 0;
   virtual void trackPyr(const vpImage<unsigned char> &I);
+  void trackPyr(const vpImagePyramid &pyramid);
 };
 #endif
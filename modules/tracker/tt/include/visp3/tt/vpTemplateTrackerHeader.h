@@ -46,6 +46,7 @@
 #define vpTemplateTrackerHeader_hh
 
 #include <stdio.h>
+#include <vector>
 
 /*!
   \struct vpTemplateTrackerZPoint
@@ -78,6 +79,25 @@ struct vpTemplateTrackerPoint {
 
   vpTemplateTrackerPoint() : x(0), y(0), dx(0), dy(0), val(0), dW(NULL), HiG(NULL) {}
 };
+/*!
+  \struct vpTemplateTrackerPointArray
+  \ingroup group_tt_tools
+  Template points stored as a structure of arrays, so that the tracking loops
+  process contiguous data.
+*/
+struct vpTemplateTrackerPointArray {
+  //! Coordinates (along the columns) of the points.
+  std::vector<double> x;
+  //! Coordinates (along the rows) of the points.
+  std::vector<double> y;
+  //! Intensities of the points.
+  std::vector<double> val;
+  //! Steepest descent images multiplied by the inverse of the Hessian: the
+  //! k-th parameter of all the points is stored in HiG[k * x.size() ...].
+  std::vector<double> HiG;
+
+  vpTemplateTrackerPointArray() : x(), y(), val(), HiG() {}
+};
 /*!
   \struct vpTemplateTrackerPointCompo
   \ingroup group_tt_tools
@@ -66,10 +66,16 @@ protected:
   std::vector<double> x_pos;
   std::vector<double> y_pos;
   double threshold_RMS;
+  // template points of each pyramid level as structures of arrays
+  std::vector<vpTemplateTrackerPointArray> ptTemplateArrayPyr;
+  std::vector<double> x_warped;
+  std::vector<double> y_warped;
+  std::vector<double> errors;
 
 protected:
   void initHessienDesired(const vpImage<unsigned char> &I);
   void initCompInverse(const vpImage<unsigned char> &I);
+  void initTemplatePointArray();
   void trackNoPyr(const vpImage<unsigned char> &I);
   void deletePosEvalRMS();
   void computeEvalRMS(const vpColVector &p);
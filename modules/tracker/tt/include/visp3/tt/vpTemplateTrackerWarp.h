@@ -202,7 +202,7 @@ public:
     \param u : Resulting u coordinates.
     \param v : resulting v coordinates.
   */
-  void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
+  virtual void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
 
   /*!
     Warp a point.
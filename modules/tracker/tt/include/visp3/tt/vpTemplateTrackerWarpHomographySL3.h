@@ -203,6 +203,19 @@ public:
   */
   void pRondp(const vpColVector &p1, const vpColVector &p2, vpColVector &pres) const;
 
+  /*!
+    Warp a list of points. The homography is computed once from \e p with
+    computeCoeff().
+
+    \param ut0 : List of u coordinates of the points.
+    \param vt0 : List of v coordinates of the points.
+    \param nb_pt : Number of points to consider.
+    \param p : Parameters of the warp.
+    \param u : Resulting u coordinates.
+    \param v : resulting v coordinates.
+  */
+  void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
+
   /*!
     Warp a point.
 
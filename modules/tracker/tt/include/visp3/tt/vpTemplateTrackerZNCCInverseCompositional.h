@@ -65,6 +65,14 @@ protected:
   std::vector<double> y_pos;
   double threshold_RMS;
   vpColVector moydIrefdp;
+  // template points warped at once, intensities of the points warped inside
+  // the image and their indexes
+  std::vector<double> x_template;
+  std::vector<double> y_template;
+  std::vector<double> x_warped;
+  std::vector<double> y_warped;
+  std::vector<double> Ic_warped;
+  std::vector<unsigned int> inside_points;
 
 protected:
   void initCompInverse(const vpImage<unsigned char> &I);
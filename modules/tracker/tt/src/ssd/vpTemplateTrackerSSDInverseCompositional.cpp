@@ -40,9 +40,51 @@
 #include <visp3/core/vpImageTools.h>
 #include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Index of the pyramid level of the current template points
+unsigned int getTemplateLevel(const vpTemplateTrackerPoint *ptTemplate, vpTemplateTrackerPoint *const *ptTemplatePyr,
+                              unsigned int nbLvlPyr)
+{
+  for (unsigned int i = 0; ptTemplatePyr != NULL && i < nbLvlPyr; i++) {
+    if (ptTemplatePyr[i] == ptTemplate) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+double dotProduct(const double *a, const double *b, unsigned int n)
+{
+  unsigned int i = 0;
+  double sum = 0;
+#if VISP_HAVE_SSE2
+  __m128d vsum0 = _mm_setzero_pd(), vsum1 = _mm_setzero_pd();
+  for (; i + 4 <= n; i += 4) {
+    vsum0 = _mm_add_pd(vsum0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    vsum1 = _mm_add_pd(vsum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+  double res[2];
+  _mm_storeu_pd(res, _mm_add_pd(vsum0, vsum1));
+  sum = res[0] + res[1];
+#endif
+  for (; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerSSDInverseCompositional::vpTemplateTrackerSSDInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerSSD(warp), compoInitialised(false), HInv(), HCompInverse(), useTemplateSelect(false), evolRMS(0),
-    x_pos(), y_pos(), threshold_RMS(1e-8)
+    x_pos(), y_pos(), threshold_RMS(1e-8), ptTemplateArrayPyr(), x_warped(), y_warped(), errors()
 {
   useInverse = true;
   HInv.resize(nbParam, nbParam);
@@ -95,9 +137,46 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
         ptTemplate[point].HiG[it] = HiGtemp[it];
     }
   }
+  initTemplatePointArray();
   compoInitialised = true;
 }
 
+/*!
+  Copy the selected template points of the current pyramid level in a
+  structure of arrays used by trackNoPyr().
+*/
+void vpTemplateTrackerSSDInverseCompositional::initTemplatePointArray()
+{
+  unsigned int level = getTemplateLevel(ptTemplate, ptTemplatePyr, nbLvlPyr);
+  if (level >= ptTemplateArrayPyr.size()) {
+    ptTemplateArrayPyr.resize(level + 1);
+  }
+
+  vpTemplateTrackerPointArray &points = ptTemplateArrayPyr[level];
+  points.x.clear();
+  points.y.clear();
+  points.val.clear();
+  for (unsigned int point = 0; point < templateSize; point++) {
+    if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
+      points.x.push_back(ptTemplate[point].x);
+      points.y.push_back(ptTemplate[point].y);
+      points.val.push_back(ptTemplate[point].val);
+    }
+  }
+
+  // Parameter-major storage of HiG
+  size_t nbPoints = points.x.size();
+  points.HiG.resize(nbPoints * nbParam);
+  for (unsigned int point = 0, cpt = 0; point < templateSize; point++) {
+    if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
+      for (unsigned int it = 0; it < nbParam; it++) {
+        points.HiG[it * nbPoints + cpt] = ptTemplate[point].HiG[it];
+      }
+      cpt++;
+    }
+  }
+}
+
 void vpTemplateTrackerSSDInverseCompositional::initHessienDesired(const vpImage<unsigned char> &I)
 {
   initCompInverse(I);
@@ -112,45 +191,49 @@ void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned
   double IW;
   double Tij;
   unsigned int iteration = 0;
-  int i, j;
   double i2, j2;
   double alpha = 2.;
   // vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
 
-  vpTemplateTrackerPoint *pt;
+  unsigned int level = getTemplateLevel(ptTemplate, ptTemplatePyr, nbLvlPyr);
+  if (level >= ptTemplateArrayPyr.size()) {
+    initTemplatePointArray();
+  }
+  const vpTemplateTrackerPointArray &points = ptTemplateArrayPyr[level];
+  const unsigned int nbPoints = (unsigned int)points.x.size();
+  x_warped.resize(nbPoints);
+  y_warped.resize(nbPoints);
+  errors.resize(nbPoints);
+  const double height = I.getHeight() - 1, width = I.getWidth() - 1;
+
   do {
     unsigned int Nbpoint = 0;
     double erreur = 0;
-    dp = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
-        // pt=&ptTemplatetest[point];
-        pt = &ptTemplate[point];
-        i = pt->y;
-        j = pt->x;
-        X1[0] = j;
-        X1[1] = i;
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-        j2 = X2[0];
-        i2 = X2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Tij = pt->val;
+    if (nbPoints > 0) {
+      // Warp all the template points at once, then accumulate dp as the
+      // product of HiG by the errors
+      Warp->warp(&points.x[0], &points.y[0], (int)nbPoints, p, &x_warped[0], &y_warped[0]);
+      for (unsigned int point = 0; point < nbPoints; point++) {
+        j2 = x_warped[point];
+        i2 = y_warped[point];
+
+        if ((i2 >= 0) && (j2 >= 0) && (i2 < height) && (j2 < width)) {
+          Tij = points.val[point];
           if (!blur)
             IW = I.getValue(i2, j2);
           else
             IW = BI.getValue(i2, j2);
           Nbpoint++;
           double er = (Tij - IW);
-          for (unsigned int it = 0; it < nbParam; it++)
-            dp[it] += er * pt->HiG[it];
-
+          errors[point] = er;
           erreur += er * er;
+        } else {
+          errors[point] = 0;
         }
       }
+      for (unsigned int it = 0; it < nbParam; it++)
+        dp[it] = dotProduct(&points.HiG[it * nbPoints], &errors[0], nbPoints);
     }
     // std::cout << "npoint: " << Nbpoint << std::endl;
     if (Nbpoint == 0) {
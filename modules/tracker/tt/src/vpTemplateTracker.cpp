@@ -50,7 +50,8 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
     gain(1.), thresholdGradient(40), costFunctionVerification(false), blur(true), useBrent(false), nbIterBrent(3),
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0), lambdaDep(0.001),
     iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(true), useInverse(false),
-    Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+    Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_(),
+    m_imagePyramid(vpImagePyramid::GAUSSIAN_PYRAMID)
 {
   nbParam = Warp->getNbParam();
   p.resize(nbParam);
@@ -799,13 +800,42 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+   Track the template using an image pyramid that may be shared with other
+   trackers. Level 0 is the image to process.
+
+   \param pyramid: Gaussian image pyramid with at least as many levels as
+   the tracker (see setPyramidal()).
+
+   \exception vpException::badValue : If the pyramid is not of type
+   vpImagePyramid::GAUSSIAN_PYRAMID.
+   \exception vpException::dimensionError : If the pyramid has not enough
+   levels.
+ */
+void vpTemplateTracker::track(const vpImagePyramid &pyramid)
+{
+  if (nbLvlPyr > 1)
+    trackPyr(pyramid);
+  else
+    trackNoPyr(pyramid[0]);
+}
+
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 {
-  // vpTRACE("trackPyr");
-  vpImage<unsigned char> *pyr_I;
-  //  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
-  pyr_I = new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0] = I;
+  m_imagePyramid.build(I, nbLvlPyr);
+  trackPyr(m_imagePyramid);
+}
+
+void vpTemplateTracker::trackPyr(const vpImagePyramid &pyramid)
+{
+  if (pyramid.getType() != vpImagePyramid::GAUSSIAN_PYRAMID) {
+    throw(vpException(vpException::badValue, "The template tracker needs a Gaussian image pyramid"));
+  }
+  if (pyramid.getNbLevels() < nbLvlPyr) {
+    throw(vpException(vpException::dimensionError, "The image pyramid has %d levels while the tracker uses %d",
+                      pyramid.getNbLevels(), nbLvlPyr));
+  }
+  const vpImage<unsigned char> &I = pyramid[0];
 
   try {
     vpColVector ptemp(nbParam);
@@ -815,7 +845,6 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 
       //    p_sauv[0]=p;
       for (unsigned int i = 1; i < nbLvlPyr; i++) {
-        vpImageFilter::getGaussPyramidal(pyr_I[i - 1], pyr_I[i]);
         // test getParamPyramidDown
         /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
         vpColVector vX_test2(2);
@@ -851,7 +880,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           HLM = HLMdesirePyr[i];
           HLMdesireInverse = HLMdesireInversePyr[i];
           //        zoneTracked=&zoneTrackedPyr[i];
-          trackRobust(pyr_I[i]);
+          trackRobust(pyramid[i]);
         }
         // std::cout<<"get p up"<<std::endl;
         //      ptemp=p_sauv[i-1];
@@ -873,7 +902,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           HLM=HLMdesirePyr[0];
           HLMdesireInverse=HLMdesireInversePyr[0];
           zoneTracked=&zoneTrackedPyr[0];
-          trackRobust(pyr_I[0]);
+          trackRobust(pyramid[0]);
         }
 
         if (l0Pyr > 0) {
@@ -889,9 +918,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
       // std::cout<<"reviens a tracker de base"<<std::endl;
       trackRobust(I);
     }
-    delete[] pyr_I;
   } catch (const vpException &e) {
-    delete[] pyr_I;
     throw(vpTrackingException(vpTrackingException::badValue, e.getMessage()));
   }
 }
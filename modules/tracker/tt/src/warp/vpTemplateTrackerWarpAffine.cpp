@@ -95,6 +95,17 @@ void vpTemplateTrackerWarpAffine::warpX(const int &i, const int &j, double &i2,
   i2 = ParamM[1] * j + (1 + ParamM[3]) * i + ParamM[5];
 }
 
+void vpTemplateTrackerWarpAffine::warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p,
+                                       double *u, double *v)
+{
+  const double a00 = 1.0 + p[0], a01 = p[2], a02 = p[4];
+  const double a10 = p[1], a11 = 1.0 + p[3], a12 = p[5];
+  for (int i = 0; i < nb_pt; i++) {
+    u[i] = a00 * ut0[i] + a01 * vt0[i] + a02;
+    v[i] = a10 * ut0[i] + a11 * vt0[i] + a12;
+  }
+}
+
 void vpTemplateTrackerWarpAffine::warpX(const vpColVector &vX, vpColVector &vXres, const vpColVector &ParamM)
 {
   vXres[0] = (1.0 + ParamM[0]) * vX[0] + ParamM[2] * vX[1] + ParamM[4];
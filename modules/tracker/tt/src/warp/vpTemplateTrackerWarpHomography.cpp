@@ -111,6 +111,23 @@ void vpTemplateTrackerWarpHomography::warpX(const int &i, const int &j, double &
   i2 = (ParamM[1] * j + (1. + ParamM[4]) * i + ParamM[7]) * denom;
 }
 
+void vpTemplateTrackerWarpHomography::warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p,
+                                           double *u, double *v)
+{
+  const double a00 = 1. + p[0], a01 = p[3], a02 = p[6];
+  const double a10 = p[1], a11 = 1. + p[4], a12 = p[7];
+  const double a20 = p[2], a21 = p[5];
+  for (int i = 0; i < nb_pt; i++) {
+    double denom_ = (1. / (a20 * ut0[i] + a21 * vt0[i] + 1.));
+    if (denom_ > 0) {
+      u[i] = (a00 * ut0[i] + a01 * vt0[i] + a02) * denom_;
+      v[i] = (a10 * ut0[i] + a11 * vt0[i] + a12) * denom_;
+    } else
+      throw(vpTrackingException(vpTrackingException::fatalError,
+                                "Division by zero in vpTemplateTrackerWarpHomography::warp()"));
+  }
+}
+
 void vpTemplateTrackerWarpHomography::warpX(const vpColVector &vX, vpColVector &vXres, const vpColVector &ParamM)
 {
   // if((ParamM[2]*vX[0]+ParamM[5]*vX[1]+1)>0)//si dans le plan image reel
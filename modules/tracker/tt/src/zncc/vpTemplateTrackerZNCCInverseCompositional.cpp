@@ -44,7 +44,7 @@
 
 vpTemplateTrackerZNCCInverseCompositional::vpTemplateTrackerZNCCInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerZNCC(warp), compoInitialised(false), evolRMS(0), x_pos(), y_pos(), threshold_RMS(1e-8),
-    moydIrefdp()
+    moydIrefdp(), x_template(), y_template(), x_warped(), y_warped(), Ic_warped(), inside_points()
 {
   useInverse = true;
 }
@@ -253,28 +253,36 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
   double Ic;
   double Iref;
   unsigned int iteration = 0;
-  int i, j;
   double i2, j2;
   initPosEvalRMS(p);
+
+  x_template.resize(templateSize);
+  y_template.resize(templateSize);
+  for (unsigned int point = 0; point < templateSize; point++) {
+    x_template[point] = ptTemplate[point].x;
+    y_template[point] = ptTemplate[point].y;
+  }
+  x_warped.resize(templateSize);
+  y_warped.resize(templateSize);
+  Ic_warped.resize(templateSize);
+  inside_points.resize(templateSize);
+  const double height = I.getHeight() - 1, width = I.getWidth() - 1;
+
   do {
     unsigned int Nbpoint = 0;
     // erreur=0;
     G = 0;
-    Warp->computeCoeff(p);
     double moyIref = 0;
     double moyIc = 0;
+    // The template points are warped once, the intensities are reused by the
+    // second pass
+    if (templateSize > 0) {
+      Warp->warp(&x_template[0], &y_template[0], (int)templateSize, p, &x_warped[0], &y_warped[0]);
+    }
     for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+      j2 = x_warped[point];
+      i2 = y_warped[point];
+      if ((i2 >= 0) && (j2 >= 0) && (i2 < height) && (j2 < width)) {
         Iref = ptTemplate[point].val;
 
         if (!blur)
@@ -282,6 +290,8 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
         else
           Ic = BI.getValue(i2, j2);
 
+        Ic_warped[Nbpoint] = Ic;
+        inside_points[Nbpoint] = point;
         Nbpoint++;
         moyIref += Iref;
         moyIc += Ic;
@@ -297,38 +307,23 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
       vpColVector sIrefdIref(nbParam);
       sIrefdIref = 0;
 
-      for (unsigned int point = 0; point < templateSize; point++) {
-        i = ptTemplate[point].y;
-        j = ptTemplate[point].x;
-        X1[0] = j;
-        X1[1] = i;
-
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-
-        j2 = X2[0];
-        i2 = X2[1];
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Iref = ptTemplate[point].val;
-
-          if (!blur)
-            Ic = I.getValue(i2, j2);
-          else
-            Ic = BI.getValue(i2, j2);
-
-          double prod = (Ic - moyIc);
-          for (unsigned int it = 0; it < nbParam; it++)
-            sIcdIref[it] += prod * (ptTemplate[point].dW[it] - moydIrefdp[it]);
-          for (unsigned int it = 0; it < nbParam; it++)
-            sIrefdIref[it] += (Iref - moyIref) * (ptTemplate[point].dW[it] - moydIrefdp[it]);
-
-          // double er=(Iref-Ic);
-          // erreur+=(er*er);
-          // denom+=(Iref-moyIref)*(Iref-moyIref)*(Ic-moyIc)*(Ic-moyIc);
-          covarIref += (Iref - moyIref) * (Iref - moyIref);
-          covarIc += (Ic - moyIc) * (Ic - moyIc);
-          sIcIref += (Iref - moyIref) * (Ic - moyIc);
-        }
+      for (unsigned int cpt = 0; cpt < Nbpoint; cpt++) {
+        unsigned int point = inside_points[cpt];
+        Iref = ptTemplate[point].val;
+        Ic = Ic_warped[cpt];
+
+        double prod = (Ic - moyIc);
+        for (unsigned int it = 0; it < nbParam; it++)
+          sIcdIref[it] += prod * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+        for (unsigned int it = 0; it < nbParam; it++)
+          sIrefdIref[it] += (Iref - moyIref) * (ptTemplate[point].dW[it] - moydIrefdp[it]);
+
+        // double er=(Iref-Ic);
+        // erreur+=(er*er);
+        // denom+=(Iref-moyIref)*(Iref-moyIref)*(Ic-moyIc)*(Ic-moyIc);
+        covarIref += (Iref - moyIref) * (Iref - moyIref);
+        covarIc += (Ic - moyIc) * (Ic - moyIc);
+        sIcIref += (Iref - moyIref) * (Ic - moyIc);
       }
       covarIref = sqrt(covarIref);
       covarIc = sqrt(covarIc);
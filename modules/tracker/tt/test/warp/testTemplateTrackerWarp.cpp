@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the warp of an array of points by the template tracker warps.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerWarp.cpp
+
+  \brief Test that the warp of an array of points gives the same points as
+  warpX() called for each point, for all the warps of the template trackers.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt/vpTemplateTrackerWarpRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
+
+namespace
+{
+/*
+  Warp random points with random parameters whose values are in [-scale,
+  scale], and compare the batched warp with warpX().
+*/
+bool testWarp(const std::string &name, vpTemplateTrackerWarp &warp, double scale, vpUniRand &rng)
+{
+  const int nbPoints = 1001;
+  std::vector<double> u0(nbPoints), v0(nbPoints), u(nbPoints), v(nbPoints);
+  for (int i = 0; i < nbPoints; i++) {
+    u0[i] = 640 * rng();
+    v0[i] = 480 * rng();
+  }
+
+  for (int k = 0; k < 10; k++) {
+    vpColVector p(warp.getNbParam());
+    for (unsigned int i = 0; i < p.getRows(); i++)
+      p[i] = scale * (2 * rng() - 1);
+
+    warp.warp(&u0[0], &v0[0], nbPoints, p, &u[0], &v[0]);
+
+    vpColVector X1(2), X2(2);
+    warp.computeCoeff(p);
+    for (int i = 0; i < nbPoints; i++) {
+      X1[0] = u0[i];
+      X1[1] = v0[i];
+      warp.computeDenom(X1, p);
+      warp.warpX(X1, X2, p);
+      if (std::fabs(u[i] - X2[0]) > 1e-9 * (1 + std::fabs(X2[0])) ||
+          std::fabs(v[i] - X2[1]) > 1e-9 * (1 + std::fabs(X2[1]))) {
+        std::cerr << name << ": point (" << u0[i] << ", " << v0[i] << ") warped in (" << u[i] << ", " << v[i]
+                  << ") instead of (" << X2[0] << ", " << X2[1] << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  std::cout << name << " is ok" << std::endl;
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rng(42);
+    vpTemplateTrackerWarpAffine affine;
+    vpTemplateTrackerWarpHomography homography;
+    vpTemplateTrackerWarpHomographySL3 homographySL3;
+    vpTemplateTrackerWarpRT rt;
+    vpTemplateTrackerWarpSRT srt;
+    vpTemplateTrackerWarpTranslation translation;
+
+    // The parameters of the homographies are small enough to keep the
+    // points in front of the camera
+    bool ok = testWarp("vpTemplateTrackerWarpAffine", affine, 0.5, rng) &&
+              testWarp("vpTemplateTrackerWarpHomography", homography, 1e-4, rng) &&
+              testWarp("vpTemplateTrackerWarpHomographySL3", homographySL3, 1e-4, rng) &&
+              testWarp("vpTemplateTrackerWarpRT", rt, 0.5, rng) &&
+              testWarp("vpTemplateTrackerWarpSRT", srt, 0.5, rng) &&
+              testWarp("vpTemplateTrackerWarpTranslation", translation, 10, rng);
+    if (!ok)
+      return EXIT_FAILURE;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "The warps of arrays of points are ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Hamming distance matcher for binary descriptors.
+ *
+ *****************************************************************************/
+
+#ifndef vpBinaryDescriptorMatcher_h
+#define vpBinaryDescriptorMatcher_h
+
+#include <stddef.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpBinaryDescriptorMatcher
+  \ingroup group_vision_keypoints
+
+  \brief Nearest neighbour matcher for binary descriptors (ORB, BRISK, FREAK,
+  BRIEF, ...) based on the Hamming distance.
+
+  The train descriptors are copied once in a padded buffer so that the
+  Hamming distance can be computed with SSSE3 instructions when available
+  (with a 64-bit population count otherwise). For each query descriptor, the
+  two nearest train descriptors are searched. The ratio test and the cross
+  check are applied during the search, so that only the matches that pass
+  them are returned.
+
+  For large train sets, a multi-index hash table can be built when the train
+  descriptors are set (see setMultiIndexHashing()). The descriptors are split
+  in \f$ m \f$ disjoint substrings, each one indexing a hash table. Since two
+  descriptors at a Hamming distance \f$ d \f$ have at least one substring at
+  a distance lower or equal to \f$ \lfloor d / m \rfloor \f$, probing the
+  buckets at a substring radius \f$ r \f$ retrieves all the train descriptors
+  at a distance lower than \f$ m (r + 1) \f$. The probing radius is increased
+  up to 2, so the search is exact for the neighbours at a distance lower
+  than \f$ 3 m \f$, which is far above the distance of the good matches for
+  the usual descriptors. The probing stops as soon as the nearest neighbour
+  is exact and the ratio test cannot fail anymore: the distance to the second
+  nearest neighbour is then only a lower bound.
+
+  The matcher is used by vpKeyPoint with the matcher names "BuiltIn-Hamming"
+  and "BuiltIn-Hamming-MultiIndex", but it does not depend on OpenCV:
+
+  \code
+#include <visp3/vision/vpBinaryDescriptorMatcher.h>
+
+int main()
+{
+  // 32 bytes ORB descriptors stored row by row
+  std::vector<unsigned char> trainDescriptors(1000 * 32), queryDescriptors(500 * 32);
+  // ...
+
+  vpBinaryDescriptorMatcher matcher;
+  matcher.setRatioThreshold(0.8);
+  matcher.setCrossCheck(true);
+  matcher.train(&trainDescriptors[0], 1000, 32);
+
+  std::vector<vpBinaryDescriptorMatcher::vpMatch> matches;
+  matcher.match(&queryDescriptors[0], 500, matches);
+}
+  \endcode
+*/
+class VISP_EXPORT vpBinaryDescriptorMatcher
+{
+public:
+  /*!
+    Match between a query descriptor and its nearest train descriptor.
+  */
+  struct vpMatch {
+    //! Index of the query descriptor.
+    int queryIdx;
+    //! Index of the nearest train descriptor.
+    int trainIdx;
+    //! Hamming distance to the nearest train descriptor.
+    unsigned int distance;
+    //! Index of the second nearest train descriptor, -1 if it is unknown.
+    int secondTrainIdx;
+    //! Hamming distance to the second nearest train descriptor. When
+    //! secondTrainIdx is -1, it is a lower bound of this distance, or
+    //! UINT_MAX if there is no second train descriptor.
+    unsigned int secondDistance;
+  };
+
+  vpBinaryDescriptorMatcher();
+
+  void clear();
+
+  /*!
+    Get the cross check flag.
+
+    \return True if only the matches where the query descriptor is also the
+    nearest one to the train descriptor are kept.
+  */
+  inline bool getCrossCheck() const { return m_crossCheck; }
+  /*!
+    Get the descriptor size.
+
+    \return The size in bytes of the train descriptors.
+  */
+  inline unsigned int getDescriptorSize() const { return m_descriptorSize; }
+  /*!
+    Get the number of train descriptors.
+
+    \return The number of train descriptors.
+  */
+  inline unsigned int getNbTrainDescriptors() const { return m_nbTrainDescriptors; }
+  /*!
+    Get the number of hash tables of the multi-index hash table.
+
+    \return The number of hash tables, 0 if it is not built.
+  */
+  inline unsigned int getNbTables() const { return (unsigned int)m_tables.size(); }
+  /*!
+    Get the ratio test threshold.
+
+    \return The threshold, 0 if the ratio test is disabled.
+  */
+  inline double getRatioThreshold() const { return m_ratioThreshold; }
+
+  static unsigned int hammingDistance(const unsigned char *descriptor1, const unsigned char *descriptor2,
+                                      unsigned int descriptorSize);
+
+  /*!
+    Check if the multi-index hash table is built.
+
+    \return True if the searches use the multi-index hash table.
+  */
+  inline bool hasMultiIndex() const { return !m_tables.empty(); }
+
+  void match(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors,
+             std::vector<vpMatch> &matches, size_t step = 0) const;
+
+  /*!
+    Set the cross check flag. When enabled, a match is kept only if the
+    query descriptor is also the nearest query descriptor to the matched
+    train descriptor.
+
+    \param crossCheck : True to enable the cross check.
+  */
+  inline void setCrossCheck(bool crossCheck) { m_crossCheck = crossCheck; }
+  void setMultiIndexHashing(bool useMultiIndex, unsigned int nbTables = 0);
+  /*!
+    Set the ratio test threshold. A match is kept only if the distance to the
+    nearest train descriptor is lower than the threshold times the distance
+    to the second nearest one.
+
+    \param ratio : Threshold in ]0, 1[, 0 to disable the ratio test.
+  */
+  inline void setRatioThreshold(double ratio) { m_ratioThreshold = ratio; }
+
+  void train(const unsigned char *trainDescriptors, unsigned int nbTrainDescriptors, unsigned int descriptorSize,
+             size_t step = 0);
+
+private:
+  void buildMultiIndex();
+  void searchBruteForce(const unsigned char *query, vpMatch &match) const;
+  void searchMultiIndex(const unsigned char *query, std::vector<unsigned int> &stamps, unsigned int stamp,
+                        vpMatch &match) const;
+  unsigned int substring(const unsigned char *descriptor, unsigned int table) const;
+  unsigned int substringLength(unsigned int table) const;
+
+  //! Keep only the matches that agree in both directions.
+  bool m_crossCheck;
+  //! Size in bytes of a descriptor.
+  unsigned int m_descriptorSize;
+  //! Flip masks to probe the buckets at a given radius.
+  std::vector<std::vector<unsigned int> > m_flipMasks;
+  //! Number of train descriptors.
+  unsigned int m_nbTrainDescriptors;
+  //! Number of hash tables requested, 0 for an automatic choice.
+  unsigned int m_nbTablesRequested;
+  //! Ratio test threshold, 0 if disabled.
+  double m_ratioThreshold;
+  //! Number of bytes between two descriptors in m_trainDescriptors.
+  unsigned int m_stride;
+  //! Largest number of bits of the substrings indexing the hash tables.
+  unsigned int m_substringBits;
+  //! Bucket offsets of each hash table (compressed row storage).
+  std::vector<std::vector<unsigned int> > m_tableOffsets;
+  //! Train indexes sorted by bucket for each hash table.
+  std::vector<std::vector<unsigned int> > m_tables;
+  //! Padded copy of the train descriptors.
+  std::vector<unsigned char> m_trainDescriptors;
+  //! Build the multi-index hash table when the train descriptors are set.
+  bool m_useMultiIndex;
+};
+
+#endif
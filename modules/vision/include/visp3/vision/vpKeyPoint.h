@@ -51,10 +51,12 @@
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpMemoryMappedFile.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/core/vpPoint.h>
 #include <visp3/vision/vpBasicKeyPoint.h>
+#include <visp3/vision/vpBinaryDescriptorMatcher.h>
 #include <visp3/vision/vpPose.h>
 #ifdef VISP_HAVE_MODULE_IO
 #  include <visp3/io/vpImageIo.h>
@@ -670,6 +672,7 @@ public:
 #endif
 
   void loadLearningData(const std::string &filename, const bool binaryMode = false, const bool append = false);
+  void loadLearningDatabase(const std::string &filename, const bool append = false);
 
   void match(const cv::Mat &trainDescriptors, const cv::Mat &queryDescriptors, std::vector<cv::DMatch> &matches,
              double &elapsedTime);
@@ -698,6 +701,7 @@ public:
 
   void saveLearningData(const std::string &filename, const bool binaryMode = false,
                         const bool saveTrainingImages = true);
+  void saveLearningDatabase(const std::string &filename, const bool saveTrainingImages = true);
 
   /*!
     Set if the covariance matrix has to be computed in the Virtual Visual
@@ -858,11 +862,19 @@ public:
        - BruteForce-Hamming
        - BruteForce-Hamming(2)
        - FlannBased
+       - BuiltIn-Hamming (vpBinaryDescriptorMatcher)
+       - BuiltIn-Hamming-MultiIndex (vpBinaryDescriptorMatcher with a
+     multi-index hash table built when the reference is learned)
 
      L1 and L2 norms are preferable choices for SIFT and SURF descriptors,
      NORM_HAMMING should be used with ORB, BRISK and BRIEF, NORM_HAMMING2
      should be used with ORB when WTA_K==3 or 4.
 
+     The built-in matchers only accept binary descriptors. They apply the
+     ratio test (with the ratioDistanceThreshold filtering method) and the
+     cross check (see setUseBuiltInMatcherCrossCheck()) during the search,
+     which is much faster than an OpenCV matcher for large learning data.
+
      \param matcherName : Name of the matcher.
    */
   inline void setMatcher(const std::string &matcherName)
@@ -1052,6 +1064,19 @@ public:
   }
 #endif
 
+  /*!
+    Set if cross check method must be used to eliminate some false matches
+    with the built-in matchers (BuiltIn-Hamming or BuiltIn-Hamming-MultiIndex).
+    Contrary to the OpenCV brute-force matcher, it can be combined with the
+    ratioDistanceThreshold filtering method.
+
+    \param useCrossCheck : True to use cross check, false otherwise
+  */
+  inline void setUseBuiltInMatcherCrossCheck(const bool useCrossCheck)
+  {
+    m_builtInMatcher.setCrossCheck(useCrossCheck);
+  }
+
   /*!
     Set if we want to match the train keypoints to the query keypoints.
 
@@ -1090,6 +1115,8 @@ public:
   inline void setUseSingleMatchFilter(const bool singleMatchFilter) { m_useSingleMatchFilter = singleMatchFilter; }
 
 private:
+  //! Built-in matcher for binary descriptors.
+  vpBinaryDescriptorMatcher m_builtInMatcher;
   //! If true, compute covariance matrix if the user select the pose
   //! estimation method using ViSP
   bool m_computeCovariance;
@@ -1130,6 +1157,9 @@ private:
   //! List of k-nearest neighbors for each detected keypoints (if the method
   //! chosen is based upon on knn).
   std::vector<std::vector<cv::DMatch> > m_knnMatches;
+  //! Learning database mapped in memory (see loadLearningDatabase()), kept
+  //! alive while m_trainDescriptors points to its content.
+  cv::Ptr<vpMemoryMappedFile> m_learningDatabase;
   //! Map descriptor enum type to string.
   std::map<vpFeatureDescriptorType, std::string> m_mapOfDescriptorNames;
   //! Map detector enum type to string.
@@ -1199,6 +1229,9 @@ private:
   //! If true, use multiple affine transformations to cober the 6 affine
   //! parameters
   bool m_useAffineDetection;
+  //! If true, match the descriptors with m_builtInMatcher instead of
+  //! m_matcher.
+  bool m_useBuiltInMatcher;
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   //! If true, some false matches will be eliminate by keeping only pairs
   //! (i,j) such that for i-th query descriptor the j-th descriptor in the
@@ -1237,6 +1270,11 @@ private:
 
   void initFeatureNames();
 
+  void initLearningData(const bool append, int &startClassId, int &startImageId);
+
+  void matchBuiltIn(const cv::Mat &trainDescriptors, const cv::Mat &queryDescriptors,
+                    std::vector<cv::DMatch> &matches);
+
   inline size_t myKeypointHash(const cv::KeyPoint &kp)
   {
     size_t _Val = 2166136261U, scale = 16777619U;
@@ -1258,6 +1296,10 @@ private:
     return _Val;
   }
 
+  void trainBuiltInMatcher();
+
+  void writeTrainingImages(const std::string &parent, std::map<int, std::string> &mapOfImgPath);
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
   /*
    * Adapts a detector to detect points over multiple levels of a Gaussian
@@ -111,6 +111,15 @@ public:
     CHECK_DEGENERATE_POINTS = 0x8            /*!< Check for degenerate points during the RANSAC. */
   };
 
+  //! Solvers used to compute the pose hypotheses of the RANSAC.
+  typedef enum {
+    RANSAC_LAGRANGE_DEMENTHON, /*!< Lagrange and Dementhon linear approaches on 4 points, the best one
+                                  being kept (default). */
+    RANSAC_P3P                 /*!< Closed-form P3P solver on 3 points disambiguated by a 4th one. The
+                                  points are stored in flat arrays and the number of trials is adapted
+                                  to the inlier ratio of the best hypothesis. */
+  } vpRansacSolverType;
+
   unsigned int npt;         //!< Number of point used in pose computation
   std::list<vpPoint> listP; //!< Array of point (use here class vpPoint)
 
@@ -154,6 +163,8 @@ private:
   //! Stop the optimization loop when the residual change (|r-r_prec|) <=
   //! epsilon
   double vvsEpsilon;
+  //! Solver used to compute the RANSAC pose hypotheses
+  vpRansacSolverType ransacSolver;
 
   // For parallel RANSAC
   class RansacFunctor
@@ -208,6 +219,10 @@ private:
   static vpThread::Return poseRansacImplThread(vpThread::Args arg);
 #endif
 
+  bool poseRansacP3P(const std::vector<vpPoint> &listOfUniquePoints, bool checkDegeneratePoints,
+                     bool (*func)(vpHomogeneousMatrix *), std::vector<unsigned int> &best_consensus,
+                     vpHomogeneousMatrix &cMo_best);
+
 protected:
   double computeResidualDementhon(const vpHomogeneousMatrix &cMo);
 
@@ -324,10 +339,38 @@ public:
   /*!
     Set if parallel RANSAC version should be used or not.
 
-    \note Need Pthread.
+    \note Need Pthread, or OpenMP with the vpPose::RANSAC_P3P solver. In
+    that case the estimated pose does not depend on the number of threads.
   */
   inline void setUseParallelRansac(const bool use) { useParallelRansac = use; }
 
+  /*!
+    Get the solver used to compute the RANSAC pose hypotheses.
+
+    \sa setRansacSolver
+  */
+  inline vpRansacSolverType getRansacSolver() const { return ransacSolver; }
+
+  /*!
+    Set the solver used to compute the RANSAC pose hypotheses.
+
+    With vpPose::RANSAC_P3P, each hypothesis is computed in closed form from
+    3 points and a 4th one, and is scored on all the points without building
+    any vpPoint. The RANSAC stops as soon as the number of trials needed to
+    get an outlier free sample with a 0.99 probability is reached, given the
+    inlier ratio of the best hypothesis. Thousands of hypotheses can thus be
+    evaluated in the time the default solver takes for a few hundreds.
+
+    The sample of a trial only depends on the trial index, the trials are
+    evaluated by batches and the scoring of a hypothesis stops as soon as it
+    cannot beat the best one. The parallel version (see
+    setUseParallelRansac()) thus gives the same pose whatever the number of
+    threads.
+
+    \sa getRansacSolver, setRansacMaxTrials
+  */
+  inline void setRansacSolver(const vpRansacSolverType &solver) { ransacSolver = solver; }
+
   /*!
     Get the vector of points.
 
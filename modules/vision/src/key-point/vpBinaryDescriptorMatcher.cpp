@@ -0,0 +1,504 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Hamming distance matcher for binary descriptors.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdint.h>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/vision/vpBinaryDescriptorMatcher.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+
+#if defined __SSSE3__ || (defined _MSC_VER && _MSC_VER >= 1500)
+#include <tmmintrin.h>
+#define VISP_HAVE_SSSE3 1
+#endif
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Largest substring radius probed in the multi-index hash tables
+const unsigned int maxProbeRadius = 2;
+// Largest number of bits of a substring (65536 buckets per hash table)
+const unsigned int maxSubstringBits = 16;
+// Minimum number of distance computations to run the search in parallel
+const unsigned int nbDistancesMinParallel = 1 << 16;
+
+typedef unsigned int (*vpHammingFunction)(const unsigned char *, const unsigned char *, unsigned int);
+
+inline unsigned int popcount64(uint64_t x)
+{
+#if defined __GNUC__
+  return (unsigned int)__builtin_popcountll(x);
+#else
+  x = x - ((x >> 1) & (uint64_t)0x5555555555555555ULL);
+  x = (x & (uint64_t)0x3333333333333333ULL) + ((x >> 2) & (uint64_t)0x3333333333333333ULL);
+  x = (x + (x >> 4)) & (uint64_t)0x0f0f0f0f0f0f0f0fULL;
+  return (unsigned int)((x * (uint64_t)0x0101010101010101ULL) >> 56);
+#endif
+}
+
+unsigned int hammingScalar(const unsigned char *a, const unsigned char *b, unsigned int size)
+{
+  unsigned int dist = 0, i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t wa, wb;
+    memcpy(&wa, a + i, sizeof(uint64_t));
+    memcpy(&wb, b + i, sizeof(uint64_t));
+    dist += popcount64(wa ^ wb);
+  }
+  for (; i < size; i++) {
+    dist += popcount64((uint64_t)(a[i] ^ b[i]));
+  }
+  return dist;
+}
+
+#if VISP_HAVE_SSSE3
+unsigned int hammingSSSE3(const unsigned char *a, const unsigned char *b, unsigned int size)
+{
+  // Nibble population count with a byte shuffle, accumulated with sum of
+  // absolute differences
+  const __m128i lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i x =
+        _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i)));
+    const __m128i cnt = _mm_add_epi8(_mm_shuffle_epi8(lut, _mm_and_si128(x, mask)),
+                                     _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(x, 4), mask)));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(cnt, zero));
+  }
+  const unsigned int dist = (unsigned int)(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+  return dist + hammingScalar(a + i, b + i, size - i);
+}
+#endif
+
+vpHammingFunction selectHamming()
+{
+  bool checkSSSE3 = vpCPUFeatures::checkSSSE3();
+#if !VISP_HAVE_SSSE3
+  checkSSSE3 = false;
+#endif
+
+#if VISP_HAVE_SSSE3
+  if (checkSSSE3) {
+    return hammingSSSE3;
+  }
+#endif
+  return hammingScalar;
+}
+
+// Insert a candidate in the two nearest neighbours, ordered by distance and
+// then by index to give the same result whatever the visiting order
+inline void insertCandidate(int idx, unsigned int dist, vpBinaryDescriptorMatcher::vpMatch &match)
+{
+  if (dist < match.distance || (dist == match.distance && idx < match.trainIdx)) {
+    match.secondTrainIdx = match.trainIdx;
+    match.secondDistance = match.distance;
+    match.trainIdx = idx;
+    match.distance = dist;
+  } else if (dist < match.secondDistance || (dist == match.secondDistance && idx < match.secondTrainIdx)) {
+    match.secondTrainIdx = idx;
+    match.secondDistance = dist;
+  }
+}
+
+inline void initMatch(int queryIdx, vpBinaryDescriptorMatcher::vpMatch &match)
+{
+  match.queryIdx = queryIdx;
+  match.trainIdx = -1;
+  match.distance = UINT_MAX;
+  match.secondTrainIdx = -1;
+  match.secondDistance = UINT_MAX;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. The ratio test, the cross check and the multi-index
+  hashing are disabled.
+*/
+vpBinaryDescriptorMatcher::vpBinaryDescriptorMatcher()
+  : m_crossCheck(false), m_descriptorSize(0), m_flipMasks(), m_nbTrainDescriptors(0), m_nbTablesRequested(0),
+    m_ratioThreshold(0.0), m_stride(0), m_substringBits(0), m_tableOffsets(), m_tables(), m_trainDescriptors(),
+    m_useMultiIndex(false)
+{
+}
+
+/*!
+  Build the multi-index hash table from the train descriptors.
+*/
+void vpBinaryDescriptorMatcher::buildMultiIndex()
+{
+  const unsigned int nbBits = 8 * m_descriptorSize;
+  unsigned int nbTables = m_nbTablesRequested;
+  if (nbTables == 0) {
+    // One bit per substring for each doubling of the train set size, so that
+    // the buckets contain a few descriptors
+    unsigned int log2N = 0;
+    while ((1u << (log2N + 1)) <= m_nbTrainDescriptors && log2N < maxSubstringBits) {
+      log2N++;
+    }
+    nbTables = (nbBits + std::max(log2N, 8u) - 1) / std::max(log2N, 8u);
+  }
+  // Substrings of almost equal lengths, limited to maxSubstringBits
+  nbTables = std::max((nbBits + maxSubstringBits - 1) / maxSubstringBits, std::min(nbTables, nbBits));
+  m_substringBits = (nbBits + nbTables - 1) / nbTables;
+
+  m_flipMasks.clear();
+  m_flipMasks.resize(std::min(maxProbeRadius, m_substringBits) + 1);
+  m_flipMasks[0].push_back(0);
+  for (unsigned int i = 0; i < m_substringBits; i++) {
+    m_flipMasks[1].push_back(1u << i);
+    for (unsigned int j = i + 1; j < m_substringBits && m_flipMasks.size() > 2; j++) {
+      m_flipMasks[2].push_back((1u << i) | (1u << j));
+    }
+  }
+
+  m_tables.assign(nbTables, std::vector<unsigned int>(m_nbTrainDescriptors));
+  m_tableOffsets.resize(nbTables);
+
+#if defined VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for (int t = 0; t < (int)nbTables; t++) {
+    // Counting sort of the train indexes by bucket
+    const unsigned int length = substringLength((unsigned int)t);
+    std::vector<unsigned int> &offsets = m_tableOffsets[(size_t)t];
+    offsets.assign((1u << length) + 1, 0);
+    std::vector<unsigned int> keys(m_nbTrainDescriptors);
+    for (unsigned int i = 0; i < m_nbTrainDescriptors; i++) {
+      keys[i] = substring(&m_trainDescriptors[(size_t)i * m_stride], (unsigned int)t);
+      offsets[keys[i] + 1]++;
+    }
+    for (size_t k = 1; k < offsets.size(); k++) {
+      offsets[k] += offsets[k - 1];
+    }
+    std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned int i = 0; i < m_nbTrainDescriptors; i++) {
+      m_tables[(size_t)t][next[keys[i]]++] = i;
+    }
+  }
+}
+
+/*!
+  Remove the train descriptors and the multi-index hash table.
+*/
+void vpBinaryDescriptorMatcher::clear()
+{
+  m_descriptorSize = 0;
+  m_nbTrainDescriptors = 0;
+  m_stride = 0;
+  m_trainDescriptors.clear();
+  m_tables.clear();
+  m_tableOffsets.clear();
+  m_flipMasks.clear();
+}
+
+/*!
+  Compute the Hamming distance between two binary descriptors.
+
+  \param descriptor1 : First descriptor.
+  \param descriptor2 : Second descriptor.
+  \param descriptorSize : Size in bytes of the descriptors.
+  \return The number of bits that differ.
+*/
+unsigned int vpBinaryDescriptorMatcher::hammingDistance(const unsigned char *descriptor1,
+                                                        const unsigned char *descriptor2, unsigned int descriptorSize)
+{
+  return selectHamming()(descriptor1, descriptor2, descriptorSize);
+}
+
+/*!
+  Search the nearest train descriptor of each query descriptor. The matches
+  that do not pass the ratio test or the cross check, when enabled, are not
+  returned.
+
+  \param queryDescriptors : Query descriptors stored row by row, with the
+  same size than the train descriptors.
+  \param nbQueryDescriptors : Number of query descriptors.
+  \param matches : Matches sorted by query index.
+  \param step : Number of bytes between two query descriptors, 0 if the
+  descriptors are contiguous.
+*/
+void vpBinaryDescriptorMatcher::match(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors,
+                                      std::vector<vpMatch> &matches, size_t step) const
+{
+  matches.clear();
+  if (m_nbTrainDescriptors == 0 || nbQueryDescriptors == 0) {
+    return;
+  }
+  if (step == 0) {
+    step = m_descriptorSize;
+  }
+
+  // Padded copy so that the distance kernel has no tail to process
+  std::vector<unsigned char> queries((size_t)nbQueryDescriptors * m_stride, 0);
+  for (unsigned int i = 0; i < nbQueryDescriptors; i++) {
+    memcpy(&queries[(size_t)i * m_stride], queryDescriptors + (size_t)i * step, m_descriptorSize);
+  }
+
+  std::vector<vpMatch> candidates(nbQueryDescriptors);
+  const bool useMultiIndex = !m_tables.empty();
+  const uint64_t nbDistances = (uint64_t)nbQueryDescriptors * (useMultiIndex ? 64 : m_nbTrainDescriptors);
+  (void)nbDistances;
+
+#if defined VISP_HAVE_OPENMP
+#pragma omp parallel if (nbDistances >= nbDistancesMinParallel)
+#endif
+  {
+    std::vector<unsigned int> stamps(useMultiIndex ? m_nbTrainDescriptors : 0, 0);
+#if defined VISP_HAVE_OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+    for (int i = 0; i < (int)nbQueryDescriptors; i++) {
+      vpMatch &match = candidates[(size_t)i];
+      initMatch(i, match);
+      if (useMultiIndex) {
+        searchMultiIndex(&queries[(size_t)i * m_stride], stamps, (unsigned int)i + 1, match);
+      } else {
+        searchBruteForce(&queries[(size_t)i * m_stride], match);
+      }
+    }
+  }
+
+  // Ratio test
+  std::vector<int> trainIdx;
+  for (unsigned int i = 0; i < nbQueryDescriptors; i++) {
+    const vpMatch &match = candidates[i];
+    bool keep = match.trainIdx >= 0;
+    if (keep && m_ratioThreshold > 0) {
+      keep = match.secondDistance != UINT_MAX && match.distance < m_ratioThreshold * match.secondDistance;
+    }
+    if (keep) {
+      matches.push_back(match);
+      trainIdx.push_back(match.trainIdx);
+    }
+  }
+
+  if (m_crossCheck && !matches.empty()) {
+    // Nearest query descriptor of each matched train descriptor
+    std::sort(trainIdx.begin(), trainIdx.end());
+    trainIdx.erase(std::unique(trainIdx.begin(), trainIdx.end()), trainIdx.end());
+    std::vector<int> nearestQuery(trainIdx.size());
+    const vpHammingFunction hamming = selectHamming();
+
+#if defined VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static) if (trainIdx.size() * nbQueryDescriptors >= nbDistancesMinParallel)
+#endif
+    for (int k = 0; k < (int)trainIdx.size(); k++) {
+      const unsigned char *train = &m_trainDescriptors[(size_t)trainIdx[(size_t)k] * m_stride];
+      unsigned int best = UINT_MAX;
+      for (unsigned int i = 0; i < nbQueryDescriptors; i++) {
+        const unsigned int dist = hamming(train, &queries[(size_t)i * m_stride], m_stride);
+        if (dist < best) {
+          best = dist;
+          nearestQuery[(size_t)k] = (int)i;
+        }
+      }
+    }
+
+    size_t nbKept = 0;
+    for (size_t i = 0; i < matches.size(); i++) {
+      const size_t k =
+          (size_t)(std::lower_bound(trainIdx.begin(), trainIdx.end(), matches[i].trainIdx) - trainIdx.begin());
+      if (nearestQuery[k] == matches[i].queryIdx) {
+        matches[nbKept++] = matches[i];
+      }
+    }
+    matches.resize(nbKept);
+  }
+}
+
+/*!
+  Search the two nearest train descriptors by computing all the distances.
+*/
+void vpBinaryDescriptorMatcher::searchBruteForce(const unsigned char *query, vpMatch &match) const
+{
+  const vpHammingFunction hamming = selectHamming();
+  for (unsigned int i = 0; i < m_nbTrainDescriptors; i++) {
+    const unsigned int dist = hamming(query, &m_trainDescriptors[(size_t)i * m_stride], m_stride);
+    if (dist < match.secondDistance) {
+      insertCandidate((int)i, dist, match);
+    }
+  }
+}
+
+/*!
+  Search the two nearest train descriptors by probing the multi-index hash
+  table with an increasing substring radius.
+
+  \param query : Padded query descriptor.
+  \param stamps : Per train descriptor stamp to compute the distances once.
+  \param stamp : Unique non null stamp of the query.
+  \param match : Nearest neighbours.
+*/
+void vpBinaryDescriptorMatcher::searchMultiIndex(const unsigned char *query, std::vector<unsigned int> &stamps,
+                                                 unsigned int stamp, vpMatch &match) const
+{
+  const vpHammingFunction hamming = selectHamming();
+  const unsigned int nbTables = (unsigned int)m_tables.size();
+  unsigned int nbVisited = 0, bound = 0;
+
+  for (size_t r = 0; r < m_flipMasks.size(); r++) {
+    for (unsigned int t = 0; t < nbTables; t++) {
+      const unsigned int length = substringLength(t);
+      const unsigned int key = substring(query, t);
+      const std::vector<unsigned int> &offsets = m_tableOffsets[t];
+      const std::vector<unsigned int> &table = m_tables[t];
+
+      for (size_t k = 0; k < m_flipMasks[r].size(); k++) {
+        const unsigned int mask = m_flipMasks[r][k];
+        if ((mask >> length) != 0) {
+          continue;
+        }
+        const unsigned int bucket = key ^ mask;
+        for (unsigned int j = offsets[bucket]; j < offsets[bucket + 1]; j++) {
+          const unsigned int idx = table[j];
+          if (stamps[idx] != stamp) {
+            stamps[idx] = stamp;
+            nbVisited++;
+            insertCandidate((int)idx, hamming(query, &m_trainDescriptors[(size_t)idx * m_stride], m_stride), match);
+          }
+        }
+      }
+    }
+
+    // All the train descriptors not visited are at a distance of at least
+    // nbTables * (r + 1)
+    bound = nbTables * ((unsigned int)r + 1);
+    if (match.secondDistance < bound || nbVisited == m_nbTrainDescriptors) {
+      return;
+    }
+    // The nearest neighbour is exact and the ratio test cannot fail whatever
+    // the distance of the second nearest neighbour
+    if (match.distance < bound && (m_ratioThreshold <= 0 || match.distance < m_ratioThreshold * bound)) {
+      break;
+    }
+  }
+
+  // The second nearest neighbour may not have been visited: keep a lower
+  // bound of its distance for the ratio test
+  if (m_nbTrainDescriptors > 1 && match.secondDistance > bound) {
+    match.secondTrainIdx = -1;
+    match.secondDistance = bound;
+  }
+}
+
+/*!
+  Enable or disable the multi-index hash table. If train descriptors are
+  already set, the hash table is built or released.
+
+  \param useMultiIndex : True to build the multi-index hash table.
+  \param nbTables : Number of hash tables, 0 to choose it from the number of
+  train descriptors. The substrings are limited to 16 bits, so the number of
+  tables is at least the number of descriptor bits divided by 16.
+*/
+void vpBinaryDescriptorMatcher::setMultiIndexHashing(bool useMultiIndex, unsigned int nbTables)
+{
+  m_useMultiIndex = useMultiIndex;
+  m_nbTablesRequested = nbTables;
+  m_tables.clear();
+  m_tableOffsets.clear();
+  m_flipMasks.clear();
+  if (m_useMultiIndex && m_nbTrainDescriptors > 0) {
+    buildMultiIndex();
+  }
+}
+
+/*!
+  Extract the substring of a descriptor used as key in a hash table.
+*/
+unsigned int vpBinaryDescriptorMatcher::substring(const unsigned char *descriptor, unsigned int table) const
+{
+  const unsigned int offset = table * 8 * m_descriptorSize / (unsigned int)m_tables.size();
+  const unsigned int length = substringLength(table);
+  unsigned int value = 0;
+  for (unsigned int k = 0, byte = offset / 8; k < 3 && byte < m_descriptorSize; k++, byte++) {
+    value |= (unsigned int)descriptor[byte] << (8 * k);
+  }
+  return (value >> (offset % 8)) & ((1u << length) - 1);
+}
+
+/*!
+  Number of bits of the substring used as key in a hash table.
+*/
+unsigned int vpBinaryDescriptorMatcher::substringLength(unsigned int table) const
+{
+  const unsigned int nbBits = 8 * m_descriptorSize, nbTables = (unsigned int)m_tables.size();
+  return (table + 1) * nbBits / nbTables - table * nbBits / nbTables;
+}
+
+/*!
+  Set the train descriptors. They are copied, so the input buffer can be
+  released afterwards. The multi-index hash table is built if enabled.
+
+  \param trainDescriptors : Train descriptors stored row by row.
+  \param nbTrainDescriptors : Number of train descriptors.
+  \param descriptorSize : Size in bytes of a descriptor.
+  \param step : Number of bytes between two train descriptors, 0 if the
+  descriptors are contiguous.
+*/
+void vpBinaryDescriptorMatcher::train(const unsigned char *trainDescriptors, unsigned int nbTrainDescriptors,
+                                      unsigned int descriptorSize, size_t step)
+{
+  if (descriptorSize == 0) {
+    throw vpException(vpException::badValue, "The descriptor size must be positive");
+  }
+  clear();
+  if (step == 0) {
+    step = descriptorSize;
+  }
+
+  m_descriptorSize = descriptorSize;
+  m_nbTrainDescriptors = nbTrainDescriptors;
+  m_stride = (descriptorSize + 15) / 16 * 16;
+  m_trainDescriptors.assign((size_t)nbTrainDescriptors * m_stride, 0);
+  for (unsigned int i = 0; i < nbTrainDescriptors; i++) {
+    memcpy(&m_trainDescriptors[(size_t)i * m_stride], trainDescriptors + (size_t)i * step, descriptorSize);
+  }
+
+  if (m_useMultiIndex && nbTrainDescriptors > 0) {
+    buildMultiIndex();
+  }
+}
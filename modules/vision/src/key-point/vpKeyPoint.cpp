@@ -36,8 +36,11 @@
  *
  *****************************************************************************/
 
+#include <climits>
+#include <cstring>
 #include <iomanip>
 #include <limits>
+#include <stdint.h>
 
 #include <visp3/core/vpIoTools.h>
 #include <visp3/vision/vpKeyPoint.h>
@@ -78,6 +81,62 @@ inline vpImagePoint matchRansacToVpImage(const std::pair<cv::KeyPoint, cv::Point
   return vpImagePoint(pair.first.pt.y, pair.first.pt.x);
 }
 
+// Header of the learning database saved by vpKeyPoint::saveLearningDatabase().
+// The sections are stored at offsets multiple of 64 bytes, in the byte order
+// of the platform that saved the file.
+struct vpLearningDatabaseHeader {
+  char magic[8];
+  uint32_t version;
+  // 0x01020304 written with the byte order of the platform
+  uint32_t byteOrder;
+  int32_t nbImages;
+  int32_t have3DInfo;
+  int32_t nbKeyPoints;
+  int32_t descriptorCols;
+  int32_t descriptorType;
+  int32_t descriptorStep;
+  uint64_t imagesOffset;
+  uint64_t keyPointsOffset;
+  uint64_t pointsOffset;
+  uint64_t descriptorsOffset;
+  uint64_t fileSize;
+  char reserved[48];
+};
+
+// Keypoint record of the learning database
+struct vpLearningDatabaseKeyPoint {
+  float u, v, size, angle, response;
+  int32_t octave, class_id, image_id;
+};
+
+const char learningDatabaseMagic[8] = {'V', 'I', 'S', 'P', 'K', 'P', 'D', 'B'};
+const uint32_t learningDatabaseVersion = 1;
+const uint32_t learningDatabaseByteOrder = 0x01020304;
+const size_t learningDatabaseAlignment = 64;
+
+inline size_t alignSize(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+// True if count elements of elementSize bytes stored at offset fit in a file
+// of the given size, written so that hostile offsets cannot wrap around
+inline bool fitsInFile(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t size)
+{
+  return offset <= size && (elementSize == 0 || count <= (size - offset) / elementSize);
+}
+
+bool isLearningDatabase(const std::string &filename)
+{
+  std::ifstream file(filename.c_str(), std::ifstream::binary);
+  char magic[sizeof(learningDatabaseMagic)];
+  return file.read(magic, sizeof(magic)) && memcmp(magic, learningDatabaseMagic, sizeof(magic)) == 0;
+}
+
+void writePadding(std::ofstream &file, size_t &offset, size_t alignedOffset)
+{
+  for (; offset < alignedOffset; offset++) {
+    file.put('\0');
+  }
+}
+
 // Keep this function to know how to detect big endian with code
 // bool isBigEndian() {
 //  union {
@@ -109,7 +168,7 @@ vpKeyPoint::vpKeyPoint(const vpFeatureDetectorType &detectorType, const vpFeatur
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacInliers(), m_ransacOutliers(), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
-    m_useAffineDetection(false),
+    m_useAffineDetection(false), m_useBuiltInMatcher(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
@@ -144,7 +203,7 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacInliers(), m_ransacOutliers(), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
-    m_useAffineDetection(false),
+    m_useAffineDetection(false), m_useBuiltInMatcher(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
@@ -179,7 +238,8 @@ vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std:
     m_nbRansacMinInlierCount(100), m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(),
     m_queryFilteredKeyPoints(), m_queryKeyPoints(), m_ransacConsensusPercentage(20.0), m_ransacInliers(),
     m_ransacOutliers(), m_ransacReprojectionError(6.0), m_ransacThreshold(0.01), m_trainDescriptors(),
-    m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(), m_useAffineDetection(false),
+    m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
+    m_useAffineDetection(false), m_useBuiltInMatcher(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
@@ -333,6 +393,9 @@ unsigned int vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const v
   // Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  if (m_useBuiltInMatcher) {
+    trainBuiltInMatcher();
+  }
 
   return static_cast<unsigned int>(m_trainKeyPoints.size());
 }
@@ -442,6 +505,9 @@ void vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const std::vect
   // Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  if (m_useBuiltInMatcher) {
+    trainBuiltInMatcher();
+  }
 
   _reference_computed = true;
 }
@@ -1145,14 +1211,14 @@ void vpKeyPoint::detect(const vpImage<unsigned char> &I, std::vector<cv::KeyPoin
 {
   cv::Mat matImg;
   vpImageConvert::convert(I, matImg, false);
-  cv::Mat mask = cv::Mat::zeros(matImg.rows, matImg.cols, CV_8U);
+  // An empty mask lets the detectors use the whole image
+  cv::Mat mask;
 
   if (rectangle.getWidth() > 0 && rectangle.getHeight() > 0) {
+    mask = cv::Mat::zeros(matImg.rows, matImg.cols, CV_8U);
     cv::Point leftTop((int)rectangle.getLeft(), (int)rectangle.getTop()),
         rightBottom((int)rectangle.getRight(), (int)rectangle.getBottom());
     cv::rectangle(mask, leftTop, rightBottom, cv::Scalar(255), CV_FILLED);
-  } else {
-    mask = cv::Mat::ones(matImg.rows, matImg.cols, CV_8U) * 255;
   }
 
   detect(matImg, keyPoints, elapsedTime, mask);
@@ -2182,6 +2248,42 @@ void vpKeyPoint::initFeatureNames()
 #endif
 }
 
+/*!
+   Prepare the loading of learning data: reset the learning data, or in
+   append case get the max keypoint class id and the max image id from which
+   the appended learning data are numbered.
+
+   \param append : If true, the learning data are kept.
+   \param startClassId : Offset to add to the class id of the loaded keypoints.
+   \param startImageId : Offset to add to the id of the loaded images.
+ */
+void vpKeyPoint::initLearningData(const bool append, int &startClassId, int &startImageId)
+{
+  startClassId = 0;
+  startImageId = 0;
+  if (!append) {
+    m_trainKeyPoints.clear();
+    m_trainPoints.clear();
+    m_mapOfImageId.clear();
+    m_mapOfImages.clear();
+  } else {
+    // In append case, find the max index of keypoint class Id
+    for (std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
+      if (startClassId < it->first) {
+        startClassId = it->first;
+      }
+    }
+
+    // In append case, find the max index of images Id
+    for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
+         ++it) {
+      if (startImageId < it->first) {
+        startImageId = it->first;
+      }
+    }
+  }
+}
+
 /*!
    Initialize a matcher based on its name.
 
@@ -2224,10 +2326,27 @@ void vpKeyPoint::initMatcher(const std::string &matcherName)
       m_matcher = new cv::FlannBasedMatcher(new cv::flann::KDTreeIndexParams());
 #endif
     }
+  } else if (matcherName == "BuiltIn-Hamming" || matcherName == "BuiltIn-Hamming-MultiIndex") {
+    if (!m_extractors.empty() && descriptorType != CV_8U) {
+      throw vpException(vpException::badValue, "The built-in matchers require binary descriptors (CV_8U) !");
+    }
+
+    // The OpenCV matcher is kept up to date with the train descriptors for
+    // the code that accesses it directly
+    m_matcher = cv::DescriptorMatcher::create("BruteForce-Hamming");
   } else {
     m_matcher = cv::DescriptorMatcher::create(matcherName);
   }
 
+  m_useBuiltInMatcher = matcherName == "BuiltIn-Hamming" || matcherName == "BuiltIn-Hamming-MultiIndex";
+  m_builtInMatcher.clear();
+  if (m_useBuiltInMatcher) {
+    m_builtInMatcher.setMultiIndexHashing(matcherName == "BuiltIn-Hamming-MultiIndex");
+    if (!m_trainDescriptors.empty()) {
+      trainBuiltInMatcher();
+    }
+  }
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   if (m_matcher != NULL && !m_useKnn && matcherName == "BruteForce") {
     m_matcher->set("crossCheck", m_useBruteForceCrossCheck);
@@ -2409,34 +2528,21 @@ void vpKeyPoint::loadConfigFile(const std::string &configFile)
 
    \param filename : Path of the learning file.
    \param binaryMode : If true, the learning file is in a binary mode,
-   otherwise it is in XML mode. \param append : If true, concatenate the
-   learning data, otherwise reset the variables.
+   otherwise it is in XML mode. A learning database saved with
+   saveLearningDatabase() is detected and loaded with loadLearningDatabase().
+   \param append : If true, concatenate the learning data, otherwise reset
+   the variables.
  */
 void vpKeyPoint::loadLearningData(const std::string &filename, const bool binaryMode, const bool append)
 {
+  if (binaryMode && isLearningDatabase(filename)) {
+    loadLearningDatabase(filename, append);
+    return;
+  }
+
   int startClassId = 0;
   int startImageId = 0;
-  if (!append) {
-    m_trainKeyPoints.clear();
-    m_trainPoints.clear();
-    m_mapOfImageId.clear();
-    m_mapOfImages.clear();
-  } else {
-    // In append case, find the max index of keypoint class Id
-    for (std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
-      if (startClassId < it->first) {
-        startClassId = it->first;
-      }
-    }
-
-    // In append case, find the max index of images Id
-    for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
-         ++it) {
-      if (startImageId < it->first) {
-        startImageId = it->first;
-      }
-    }
-  }
+  initLearningData(append, startClassId, startImageId);
 
   // Get parent directory
   std::string parent = vpIoTools::getParent(filename);
@@ -2825,6 +2931,170 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
   // Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  if (m_useBuiltInMatcher) {
+    trainBuiltInMatcher();
+  }
+
+  // Set _reference_computed to true as we load a learning file
+  _reference_computed = true;
+
+  // Set m_currentImageId
+  m_currentImageId = (int)m_mapOfImages.size();
+}
+
+/*!
+   Load a learning database saved with saveLearningDatabase().
+
+   The file is mapped in memory: the descriptors are used in place (they are
+   not copied, except in append case when train descriptors are already
+   loaded) and the keypoints and the 3D points are copied without any
+   parsing. Opening a database is then almost immediate, whatever its size,
+   and the pages of the file are shared through the page cache between all
+   the processes that load the same database.
+
+   \warning The matrix returned by getTrainDescriptors() may point to the
+   mapped file, it is valid until the learning data are reloaded or reset().
+
+   \param filename : Path of the learning database.
+   \param append : If true, concatenate the learning data, otherwise reset
+   the variables.
+
+   \exception vpException::ioError : If the file cannot be mapped or is not a
+   valid learning database.
+ */
+void vpKeyPoint::loadLearningDatabase(const std::string &filename, const bool append)
+{
+  cv::Ptr<vpMemoryMappedFile> database(new vpMemoryMappedFile(filename));
+  unsigned char *data = database->getData();
+  const size_t fileSize = database->getSize();
+
+  vpLearningDatabaseHeader header;
+  if (fileSize < sizeof(header)) {
+    throw vpException(vpException::ioError, "The file %s is not a learning database", filename.c_str());
+  }
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, learningDatabaseMagic, sizeof(learningDatabaseMagic)) != 0) {
+    throw vpException(vpException::ioError, "The file %s is not a learning database", filename.c_str());
+  }
+  if (header.byteOrder != learningDatabaseByteOrder) {
+    throw vpException(vpException::ioError, "The learning database %s was saved with a different byte order",
+                      filename.c_str());
+  }
+  if (header.version != learningDatabaseVersion) {
+    throw vpException(vpException::ioError, "Unsupported version %u of the learning database %s", header.version,
+                      filename.c_str());
+  }
+
+  // Descriptors are single channel matrices
+  if (header.descriptorType < CV_8U || header.descriptorType > CV_64F) {
+    throw vpException(vpException::ioError, "Unsupported descriptor type %d in the learning database %s",
+                      header.descriptorType, filename.c_str());
+  }
+
+  const size_t nbKeyPoints = (size_t)std::max(header.nbKeyPoints, 0);
+  const uint64_t descriptorRowSize =
+      (uint64_t)std::max(header.descriptorCols, 0) * (uint64_t)CV_ELEM_SIZE(header.descriptorType);
+  if (header.fileSize != fileSize || header.nbImages < 0 || header.nbKeyPoints < 0 || header.descriptorCols < 0 ||
+      header.descriptorStep < 0 || (uint64_t)header.descriptorStep < descriptorRowSize ||
+      header.imagesOffset < sizeof(header) || header.imagesOffset > header.keyPointsOffset ||
+      !fitsInFile(header.keyPointsOffset, nbKeyPoints, sizeof(vpLearningDatabaseKeyPoint), fileSize) ||
+      (header.have3DInfo && !fitsInFile(header.pointsOffset, nbKeyPoints, 3 * sizeof(float), fileSize)) ||
+      !fitsInFile(header.descriptorsOffset, nbKeyPoints, (uint64_t)header.descriptorStep, fileSize) ||
+      header.keyPointsOffset % learningDatabaseAlignment != 0 || header.pointsOffset % learningDatabaseAlignment != 0 ||
+      header.descriptorsOffset % learningDatabaseAlignment != 0) {
+    throw vpException(vpException::ioError, "The learning database %s is corrupted", filename.c_str());
+  }
+
+  int startClassId = 0;
+  int startImageId = 0;
+  initLearningData(append, startClassId, startImageId);
+
+  // Get parent directory
+  std::string parent = vpIoTools::getParent(filename);
+  if (!parent.empty()) {
+    parent += "/";
+  }
+
+  // Read info about training images: {image_id, length, path} records
+#if !defined(VISP_HAVE_MODULE_IO)
+  if (header.nbImages > 0) {
+    std::cout << "Warning: The learning file contains image data that will "
+                 "not be loaded as visp_io module "
+                 "is not available !"
+              << std::endl;
+  }
+#else
+  size_t offset = (size_t)header.imagesOffset;
+  for (int i = 0; i < header.nbImages; i++) {
+    int32_t record[2];
+    if (offset + sizeof(record) > header.keyPointsOffset) {
+      throw vpException(vpException::ioError, "The learning database %s is corrupted", filename.c_str());
+    }
+    memcpy(record, data + offset, sizeof(record));
+    offset += sizeof(record);
+    if (record[1] < 0 || offset + (size_t)record[1] > header.keyPointsOffset) {
+      throw vpException(vpException::ioError, "The learning database %s is corrupted", filename.c_str());
+    }
+    std::string path(reinterpret_cast<const char *>(data + offset), (size_t)record[1]);
+    offset += (size_t)record[1];
+
+    vpImage<unsigned char> I;
+    if (vpIoTools::isAbsolutePathname(path)) {
+      vpImageIo::read(I, path);
+    } else {
+      vpImageIo::read(I, parent + path);
+    }
+    m_mapOfImages[record[0] + startImageId] = I;
+  }
+#endif
+
+  const vpLearningDatabaseKeyPoint *keyPoints =
+      reinterpret_cast<const vpLearningDatabaseKeyPoint *>(data + header.keyPointsOffset);
+  m_trainKeyPoints.reserve(m_trainKeyPoints.size() + nbKeyPoints);
+  for (size_t i = 0; i < nbKeyPoints; i++) {
+    const vpLearningDatabaseKeyPoint &kp = keyPoints[i];
+    m_trainKeyPoints.push_back(
+        cv::KeyPoint(cv::Point2f(kp.u, kp.v), kp.size, kp.angle, kp.response, kp.octave, kp.class_id + startClassId));
+#ifdef VISP_HAVE_MODULE_IO
+    // No training images if image_id == -1
+    if (kp.image_id != -1) {
+      m_mapOfImageId[m_trainKeyPoints.back().class_id] = kp.image_id + startImageId;
+    }
+#endif
+  }
+
+  if (header.have3DInfo) {
+    const float *points = reinterpret_cast<const float *>(data + header.pointsOffset);
+    m_trainPoints.reserve(m_trainPoints.size() + nbKeyPoints);
+    for (size_t i = 0; i < nbKeyPoints; i++, points += 3) {
+      m_trainPoints.push_back(cv::Point3f(points[0], points[1], points[2]));
+    }
+  }
+
+  // Descriptors are used in place
+  cv::Mat trainDescriptorsTmp((int)nbKeyPoints, header.descriptorCols, header.descriptorType,
+                              data + header.descriptorsOffset, (size_t)header.descriptorStep);
+  bool inPlace = !append || m_trainDescriptors.empty();
+  if (inPlace) {
+    m_trainDescriptors = trainDescriptorsTmp;
+  } else {
+    cv::vconcat(m_trainDescriptors, trainDescriptorsTmp, m_trainDescriptors);
+  }
+
+  // Convert OpenCV type to ViSP type for compatibility
+  vpConvert::convertFromOpenCV(m_trainKeyPoints, referenceImagePointsList);
+  vpConvert::convertFromOpenCV(this->m_trainPoints, m_trainVpPoints);
+
+  // Add train descriptors in matcher object
+  m_matcher->clear();
+  m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  if (m_useBuiltInMatcher) {
+    trainBuiltInMatcher();
+  }
+
+  // The previous mapping is released as m_trainDescriptors no longer points
+  // to it
+  m_learningDatabase = inPlace ? database : cv::Ptr<vpMemoryMappedFile>();
 
   // Set _reference_computed to true as we load a learning file
   _reference_computed = true;
@@ -2846,7 +3116,9 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
 {
   double t = vpTime::measureTimeMs();
 
-  if (m_useKnn) {
+  if (m_useBuiltInMatcher) {
+    matchBuiltIn(trainDescriptors, queryDescriptors, matches);
+  } else if (m_useKnn) {
     m_knnMatches.clear();
 
     if (m_useMatchTrainToQuery) {
@@ -2893,6 +3165,69 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
   elapsedTime = vpTime::measureTimeMs() - t;
 }
 
+/*!
+   Match binary descriptors with the built-in matcher. The ratio test (when
+   it is the only filtering criterion) and the cross check are applied during
+   the search.
+
+   \param trainDescriptors : Train descriptors (or reference descriptors).
+   \param queryDescriptors : Query descriptors.
+   \param matches : Output list of matches.
+ */
+void vpKeyPoint::matchBuiltIn(const cv::Mat &trainDescriptors, const cv::Mat &queryDescriptors,
+                              std::vector<cv::DMatch> &matches)
+{
+  if (queryDescriptors.type() != CV_8U || trainDescriptors.type() != CV_8U ||
+      queryDescriptors.cols != trainDescriptors.cols) {
+    throw vpException(vpException::badValue,
+                      "The built-in matchers require binary descriptors (CV_8U) of the same size !");
+  }
+
+  // With stdAndRatioDistanceThreshold, a match that fails the ratio test can
+  // still be kept by filterMatches()
+  const double ratio = m_useKnn && m_filterType == ratioDistanceThreshold ? m_matchingRatioThreshold : 0.0;
+  std::vector<vpBinaryDescriptorMatcher::vpMatch> builtInMatches;
+
+  if (m_useMatchTrainToQuery) {
+    // Match train descriptors to query descriptors
+    vpBinaryDescriptorMatcher matcherTmp;
+    matcherTmp.setRatioThreshold(ratio);
+    matcherTmp.setCrossCheck(m_builtInMatcher.getCrossCheck());
+    matcherTmp.train(queryDescriptors.data, (unsigned int)queryDescriptors.rows, (unsigned int)queryDescriptors.cols,
+                     queryDescriptors.step[0]);
+    matcherTmp.match(trainDescriptors.data, (unsigned int)trainDescriptors.rows, builtInMatches,
+                     trainDescriptors.step[0]);
+  } else {
+    // Match query descriptors to train descriptors
+    m_builtInMatcher.setRatioThreshold(ratio);
+    m_builtInMatcher.match(queryDescriptors.data, (unsigned int)queryDescriptors.rows, builtInMatches,
+                           queryDescriptors.step[0]);
+  }
+
+  matches.clear();
+  m_knnMatches.clear();
+  for (std::vector<vpBinaryDescriptorMatcher::vpMatch>::const_iterator it = builtInMatches.begin();
+       it != builtInMatches.end(); ++it) {
+    cv::DMatch best(it->queryIdx, it->trainIdx, (float)it->distance);
+    cv::DMatch second(it->queryIdx, it->secondTrainIdx, (float)it->secondDistance);
+    if (m_useMatchTrainToQuery) {
+      best = cv::DMatch(it->trainIdx, it->queryIdx, (float)it->distance);
+      second = cv::DMatch(it->secondTrainIdx, it->queryIdx, (float)it->secondDistance);
+    }
+
+    matches.push_back(best);
+    if (m_useKnn) {
+      std::vector<cv::DMatch> knn(1, best);
+      // The second distance may be a lower bound with the multi-index
+      // hashing, the ratio test is then conservative
+      if (it->secondDistance != UINT_MAX) {
+        knn.push_back(second);
+      }
+      m_knnMatches.push_back(knn);
+    }
+  }
+}
+
 /*!
    Match keypoints detected in the image with those built in the reference
    list.
@@ -2976,8 +3311,9 @@ unsigned int vpKeyPoint::matchPoint(const vpImage<unsigned char> &I, const vpRec
 
     filterMatches();
   } else {
-    if (m_useMatchTrainToQuery) {
-      // Add only query keypoints matched with a train keypoints
+    if (m_useMatchTrainToQuery || m_useBuiltInMatcher) {
+      // Add only query keypoints matched with a train keypoints (the cross
+      // check of the built-in matchers can discard query keypoints)
       m_queryFilteredKeyPoints.clear();
       m_filteredMatches.clear();
       for (std::vector<cv::DMatch>::const_iterator it = m_matches.begin(); it != m_matches.end(); ++it) {
@@ -3099,8 +3435,9 @@ bool vpKeyPoint::matchPoint(const vpImage<unsigned char> &I, const vpCameraParam
 
     filterMatches();
   } else {
-    if (m_useMatchTrainToQuery) {
-      // Add only query keypoints matched with a train keypoints
+    if (m_useMatchTrainToQuery || m_useBuiltInMatcher) {
+      // Add only query keypoints matched with a train keypoints (the cross
+      // check of the built-in matchers can discard query keypoints)
       m_queryFilteredKeyPoints.clear();
       m_filteredMatches.clear();
       for (std::vector<cv::DMatch>::const_iterator it = m_matches.begin(); it != m_matches.end(); ++it) {
@@ -3488,7 +3825,8 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,
 
 #else
   cv::Mat img;
-  vpImageConvert::convert(I, img);
+  // The image is only read: each affine transformation works on its own copy
+  vpImageConvert::convert(I, img, false);
 
   // Create a vector for storing the affine skew parameters
   std::vector<std::pair<double, int> > listOfAffineParams;
@@ -3586,6 +3924,7 @@ void vpKeyPoint::reset()
   m_knnMatches.clear();
   m_mapOfImageId.clear();
   m_mapOfImages.clear();
+  m_builtInMatcher = vpBinaryDescriptorMatcher();
   m_matcher = cv::Ptr<cv::DescriptorMatcher>();
   m_matcherName = "BruteForce-Hamming";
   m_matches.clear();
@@ -3606,10 +3945,12 @@ void vpKeyPoint::reset()
   m_ransacReprojectionError = 6.0;
   m_ransacThreshold = 0.01;
   m_trainDescriptors = cv::Mat();
+  m_learningDatabase = cv::Ptr<vpMemoryMappedFile>();
   m_trainKeyPoints.clear();
   m_trainPoints.clear();
   m_trainVpPoints.clear();
   m_useAffineDetection = false;
+  m_useBuiltInMatcher = false;
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   m_useBruteForceCrossCheck = true;
 #endif
@@ -3642,51 +3983,7 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
 
   std::map<int, std::string> mapOfImgPath;
   if (saveTrainingImages) {
-#ifdef VISP_HAVE_MODULE_IO
-    // Save the training image files in the same directory
-    unsigned int cpt = 0;
-
-    for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
-         ++it, cpt++) {
-      if (cpt > 999) {
-        throw vpException(vpException::fatalError, "The number of training images to save is too big !");
-      }
-
-      std::stringstream ss;
-      ss << "train_image_" << std::setfill('0') << std::setw(3) << cpt;
-
-      switch (m_imageFormat) {
-      case jpgImageFormat:
-        ss << ".jpg";
-        break;
-
-      case pngImageFormat:
-        ss << ".png";
-        break;
-
-      case ppmImageFormat:
-        ss << ".ppm";
-        break;
-
-      case pgmImageFormat:
-        ss << ".pgm";
-        break;
-
-      default:
-        ss << ".png";
-        break;
-      }
-
-      std::string imgFilename = ss.str();
-      mapOfImgPath[it->first] = imgFilename;
-      vpImageIo::write(it->second, parent + (!parent.empty() ? "/" : "") + imgFilename);
-    }
-#else
-    std::cout << "Warning: in vpKeyPoint::saveLearningData() training images "
-                 "are not saved because "
-                 "visp_io module is not available !"
-              << std::endl;
-#endif
+    writeTrainingImages(parent, mapOfImgPath);
   }
 
   bool have3DInfo = m_trainPoints.size() > 0;
@@ -4021,6 +4318,203 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
   }
 }
 
+/*!
+   Save the learning data in a learning database that can be mapped in
+   memory by loadLearningDatabase().
+
+   The file starts with a versioned header followed by the training image
+   paths, the keypoints, the 3D points and the descriptors. Each section
+   starts at an offset multiple of 64 bytes and each descriptor row at an
+   offset multiple of 16 bytes, so that the content can be used in place.
+   The data are stored with the byte order of the platform.
+
+   \param filename : Path of the learning database.
+   \param saveTrainingImages : If true, save also the training images on
+   disk.
+ */
+void vpKeyPoint::saveLearningDatabase(const std::string &filename, const bool saveTrainingImages)
+{
+  std::string parent = vpIoTools::getParent(filename);
+  if (!parent.empty()) {
+    vpIoTools::makeDirectory(parent);
+  }
+
+  std::map<int, std::string> mapOfImgPath;
+  if (saveTrainingImages) {
+    writeTrainingImages(parent, mapOfImgPath);
+  }
+
+  const size_t nbKeyPoints = (size_t)m_trainDescriptors.rows;
+  bool have3DInfo = m_trainPoints.size() > 0;
+  if (have3DInfo && m_trainPoints.size() != m_trainKeyPoints.size()) {
+    throw vpException(vpException::fatalError, "List of keypoints and list of 3D points have different size !");
+  }
+  if (m_trainKeyPoints.size() != nbKeyPoints) {
+    throw vpException(vpException::fatalError, "List of keypoints and descriptors have different size !");
+  }
+
+  const size_t descriptorRowSize = (size_t)m_trainDescriptors.cols * m_trainDescriptors.elemSize();
+  const size_t descriptorStep = alignSize(descriptorRowSize, 16);
+
+  vpLearningDatabaseHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, learningDatabaseMagic, sizeof(learningDatabaseMagic));
+  header.version = learningDatabaseVersion;
+  header.byteOrder = learningDatabaseByteOrder;
+  header.nbImages = (int32_t)mapOfImgPath.size();
+  header.have3DInfo = have3DInfo ? 1 : 0;
+  header.nbKeyPoints = (int32_t)nbKeyPoints;
+  header.descriptorCols = m_trainDescriptors.cols;
+  header.descriptorType = m_trainDescriptors.type();
+  header.descriptorStep = (int32_t)descriptorStep;
+
+  size_t imagesSize = 0;
+  for (std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    imagesSize += 2 * sizeof(int32_t) + it->second.length();
+  }
+  header.imagesOffset = alignSize(sizeof(header), learningDatabaseAlignment);
+  header.keyPointsOffset = alignSize(header.imagesOffset + imagesSize, learningDatabaseAlignment);
+  header.pointsOffset = alignSize(header.keyPointsOffset + nbKeyPoints * sizeof(vpLearningDatabaseKeyPoint),
+                                  learningDatabaseAlignment);
+  header.descriptorsOffset = alignSize(header.pointsOffset + (have3DInfo ? nbKeyPoints * 3 * sizeof(float) : 0),
+                                       learningDatabaseAlignment);
+  header.fileSize = header.descriptorsOffset + nbKeyPoints * descriptorStep;
+
+  std::ofstream file(filename.c_str(), std::ofstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot create the file.");
+  }
+
+  size_t offset = sizeof(header);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  // Write info about training images
+  writePadding(file, offset, (size_t)header.imagesOffset);
+  for (std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    int32_t record[2] = {it->first, (int32_t)it->second.length()};
+    file.write(reinterpret_cast<const char *>(record), sizeof(record));
+    file.write(it->second.c_str(), (std::streamsize)it->second.length());
+    offset += sizeof(record) + it->second.length();
+  }
+
+  writePadding(file, offset, (size_t)header.keyPointsOffset);
+  for (size_t i = 0; i < nbKeyPoints; i++) {
+    const cv::KeyPoint &keyPoint = m_trainKeyPoints[i];
+    vpLearningDatabaseKeyPoint kp;
+    kp.u = keyPoint.pt.x;
+    kp.v = keyPoint.pt.y;
+    kp.size = keyPoint.size;
+    kp.angle = keyPoint.angle;
+    kp.response = keyPoint.response;
+    kp.octave = keyPoint.octave;
+    kp.class_id = keyPoint.class_id;
+    kp.image_id = -1;
+#ifdef VISP_HAVE_MODULE_IO
+    std::map<int, int>::const_iterator it_findImgId = m_mapOfImageId.find(keyPoint.class_id);
+    if (saveTrainingImages && it_findImgId != m_mapOfImageId.end()) {
+      kp.image_id = it_findImgId->second;
+    }
+#endif
+    file.write(reinterpret_cast<const char *>(&kp), sizeof(kp));
+  }
+  offset += nbKeyPoints * sizeof(vpLearningDatabaseKeyPoint);
+
+  if (have3DInfo) {
+    writePadding(file, offset, (size_t)header.pointsOffset);
+    for (size_t i = 0; i < nbKeyPoints; i++) {
+      float point[3] = {m_trainPoints[i].x, m_trainPoints[i].y, m_trainPoints[i].z};
+      file.write(reinterpret_cast<const char *>(point), sizeof(point));
+    }
+    offset += nbKeyPoints * sizeof(float) * 3;
+  }
+
+  writePadding(file, offset, (size_t)header.descriptorsOffset);
+  for (size_t i = 0; i < nbKeyPoints; i++) {
+    file.write(reinterpret_cast<const char *>(m_trainDescriptors.ptr((int)i)), (std::streamsize)descriptorRowSize);
+    offset += descriptorRowSize;
+    writePadding(file, offset, (size_t)header.descriptorsOffset + (i + 1) * descriptorStep);
+  }
+
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot write the learning database %s", filename.c_str());
+  }
+  file.close();
+}
+
+/*!
+   Copy the train descriptors in the built-in matcher (and build its
+   multi-index hash table if enabled).
+ */
+void vpKeyPoint::trainBuiltInMatcher()
+{
+  if (m_trainDescriptors.empty()) {
+    m_builtInMatcher.clear();
+    return;
+  }
+
+  if (m_trainDescriptors.type() != CV_8U) {
+    throw vpException(vpException::badValue, "The built-in matchers require binary descriptors (CV_8U) !");
+  }
+  m_builtInMatcher.train(m_trainDescriptors.data, (unsigned int)m_trainDescriptors.rows,
+                         (unsigned int)m_trainDescriptors.cols, m_trainDescriptors.step[0]);
+}
+
+/*!
+   Save the training images in the directory of the learning file.
+
+   \param parent : Directory of the learning file.
+   \param mapOfImgPath : Map of image id to the path of the saved image,
+   relative to \e parent.
+ */
+void vpKeyPoint::writeTrainingImages(const std::string &parent, std::map<int, std::string> &mapOfImgPath)
+{
+#ifdef VISP_HAVE_MODULE_IO
+  // Save the training image files in the same directory
+  unsigned int cpt = 0;
+
+  for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
+       ++it, cpt++) {
+    if (cpt > 999) {
+      throw vpException(vpException::fatalError, "The number of training images to save is too big !");
+    }
+
+    std::stringstream ss;
+    ss << "train_image_" << std::setfill('0') << std::setw(3) << cpt;
+
+    switch (m_imageFormat) {
+    case jpgImageFormat:
+      ss << ".jpg";
+      break;
+
+    case pngImageFormat:
+      ss << ".png";
+      break;
+
+    case ppmImageFormat:
+      ss << ".ppm";
+      break;
+
+    case pgmImageFormat:
+      ss << ".pgm";
+      break;
+
+    default:
+      ss << ".png";
+      break;
+    }
+
+    std::string imgFilename = ss.str();
+    mapOfImgPath[it->first] = imgFilename;
+    vpImageIo::write(it->second, parent + (!parent.empty() ? "/" : "") + imgFilename);
+  }
+#else
+  std::cout << "Warning: in vpKeyPoint::writeTrainingImages() training images "
+               "are not saved because "
+               "visp_io module is not available !"
+            << std::endl;
+#endif
+}
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x030000)
 // From OpenCV 2.4.11 source code.
 struct KeypointResponseGreaterThanThreshold {
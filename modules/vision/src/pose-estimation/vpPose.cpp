@@ -84,6 +84,7 @@ void vpPose::init()
   useParallelRansac = false;
   nbParallelRansacThreads = 0;
   vvsEpsilon = 1e-8;
+  ransacSolver = RANSAC_LAGRANGE_DEMENTHON;
 
 #if (DEBUG_LEVEL1)
   std::cout << "end vpPose::Init() " << std::endl;
@@ -97,7 +98,7 @@ vpPose::vpPose()
     distanceToPlaneForCoplanarityTest(0.001), ransacFlags(PREFILTER_DUPLICATE_POINTS), listOfPoints(),
     useParallelRansac(false),
     nbParallelRansacThreads(0), // 0 means that OpenMP is used to get the number of CPU threads
-    vvsEpsilon(1e-8)
+    vvsEpsilon(1e-8), ransacSolver(RANSAC_LAGRANGE_DEMENTHON)
 {
 }
 
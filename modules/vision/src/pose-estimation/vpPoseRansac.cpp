@@ -45,12 +45,15 @@
 
 #include <algorithm> // std::count
 #include <cmath>     // std::fabs
-#include <float.h>   // DBL_MAX
+#include <complex>
+#include <float.h> // DBL_MAX
 #include <iostream>
 #include <limits> // numeric_limits
 #include <map>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRansac.h>
@@ -65,6 +68,15 @@
 #include <omp.h>
 #endif
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 #define eps 1e-6
 
 namespace
@@ -221,6 +233,435 @@ struct ComparePointDuplicateUnorderedMap {
   }
 };
 #endif
+
+// Pseudo random sampling of the P3P RANSAC, where the k-th draw of a trial only
+// depends on the trial index (SplitMix64 hashing of a counter)
+class TrialSampler
+{
+public:
+  explicit TrialSampler(uint64_t trial) : m_state(trial * 0x9E3779B97F4A7C15ULL) {}
+
+  unsigned int operator()(unsigned int size)
+  {
+    m_state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = m_state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return (unsigned int)((z >> 32) % size);
+  }
+
+private:
+  uint64_t m_state;
+};
+
+// 2D/3D correspondences of the P3P RANSAC stored as flat arrays
+struct FlatPoints {
+  explicit FlatPoints(const std::vector<vpPoint> &points)
+    : oX(points.size()), oY(points.size()), oZ(points.size()), x(points.size()), y(points.size())
+  {
+    for (size_t i = 0; i < points.size(); i++) {
+      oX[i] = points[i].get_oX();
+      oY[i] = points[i].get_oY();
+      oZ[i] = points[i].get_oZ();
+      x[i] = points[i].get_x();
+      y[i] = points[i].get_y();
+    }
+  }
+
+  // Same test than FindDegeneratePoint
+  bool isDegenerate(unsigned int i, unsigned int j) const
+  {
+    return ((std::fabs(oX[i] - oX[j]) < eps && std::fabs(oY[i] - oY[j]) < eps && std::fabs(oZ[i] - oZ[j]) < eps) ||
+            (std::fabs(x[i] - x[j]) < eps && std::fabs(y[i] - y[j]) < eps));
+  }
+
+  std::vector<double> oX, oY, oZ, x, y;
+};
+
+// Pose hypothesis without any allocation, R being stored row after row
+struct PoseHypothesis {
+  double R[9];
+  double t[3];
+};
+
+// Squared reprojection error of a point, or DBL_MAX if it is behind the camera
+double reprojectionError2(const PoseHypothesis &h, const FlatPoints &pts, unsigned int i)
+{
+  const double X = h.R[0] * pts.oX[i] + h.R[1] * pts.oY[i] + h.R[2] * pts.oZ[i] + h.t[0];
+  const double Y = h.R[3] * pts.oX[i] + h.R[4] * pts.oY[i] + h.R[5] * pts.oZ[i] + h.t[1];
+  const double Z = h.R[6] * pts.oX[i] + h.R[7] * pts.oY[i] + h.R[8] * pts.oZ[i] + h.t[2];
+  if (Z <= 0) {
+    return DBL_MAX;
+  }
+  return vpMath::sqr(X / Z - pts.x[i]) + vpMath::sqr(Y / Z - pts.y[i]);
+}
+
+// Product of the polynomials a (degree na) and b (degree nb), coefficients by increasing degree
+void polyMult(const double *a, unsigned int na, const double *b, unsigned int nb, double *c)
+{
+  for (unsigned int i = 0; i <= na + nb; i++) {
+    c[i] = 0;
+  }
+  for (unsigned int i = 0; i <= na; i++) {
+    for (unsigned int j = 0; j <= nb; j++) {
+      c[i + j] += a[i] * b[j];
+    }
+  }
+}
+
+double polyEval4(const double *q, double v) { return (((q[4] * v + q[3]) * v + q[2]) * v + q[1]) * v + q[0]; }
+
+/*
+  Real parts of the roots of q[4] v^4 + ... + q[0] with Ferrari's method, polished
+  by Newton iterations. Roots of complex pairs are also returned and must be
+  rejected by the caller.
+*/
+unsigned int solveQuartic(const double *q, double *roots)
+{
+  if (std::fabs(q[4]) < std::numeric_limits<double>::epsilon() * (std::fabs(q[3]) + std::fabs(q[2]) + 1.)) {
+    return 0;
+  }
+  const double A = q[4], B = q[3], C = q[2], D = q[1], E = q[0];
+  const double A2 = A * A, B2 = B * B, A3 = A2 * A, B3 = B2 * B, A4 = A3 * A, B4 = B3 * B;
+
+  const double alpha = -3 * B2 / (8 * A2) + C / A;
+  const double beta = B3 / (8 * A3) - B * C / (2 * A2) + D / A;
+  const double gamma = -3 * B4 / (256 * A4) + B2 * C / (16 * A3) - B * D / (4 * A2) + E / A;
+
+  const double alpha2 = alpha * alpha, alpha3 = alpha2 * alpha;
+  const std::complex<double> P(-alpha2 / 12 - gamma, 0);
+  const std::complex<double> Q(-alpha3 / 108 + alpha * gamma / 3 - beta * beta / 8, 0);
+  const std::complex<double> R = -Q / 2. + std::sqrt(Q * Q / 4. + P * P * P / 27.);
+  const std::complex<double> U = std::pow(R, 1. / 3);
+
+  std::complex<double> y;
+  if (std::abs(U) < std::numeric_limits<double>::epsilon()) {
+    y = -5 * alpha / 6 - std::pow(Q, 1. / 3);
+  } else {
+    y = -5 * alpha / 6 - P / (3. * U) + U;
+  }
+  const std::complex<double> w = std::sqrt(alpha + 2. * y);
+  if (std::abs(w) < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+  const std::complex<double> t1 = std::sqrt(-(3 * alpha + 2. * y + 2 * beta / w));
+  const std::complex<double> t2 = std::sqrt(-(3 * alpha + 2. * y - 2 * beta / w));
+  const double shift = -B / (4 * A);
+  const std::complex<double> candidates[4] = {shift + 0.5 * (w + t1), shift + 0.5 * (w - t1),
+                                              shift + 0.5 * (-w + t2), shift + 0.5 * (-w - t2)};
+
+  unsigned int nbRoots = 0;
+  for (unsigned int i = 0; i < 4; i++) {
+    double v = candidates[i].real();
+    for (unsigned int k = 0; k < 2; k++) {
+      const double dq = ((4 * q[4] * v + 3 * q[3]) * v + 2 * q[2]) * v + q[1];
+      if (std::fabs(dq) > std::numeric_limits<double>::epsilon()) {
+        v -= polyEval4(q, v) / dq;
+      }
+    }
+    if (!vpMath::isNaN(v) && !vpMath::isInf(v)) {
+      roots[nbRoots++] = v;
+    }
+  }
+  return nbRoots;
+}
+
+// Orthonormal frame of the triangle (P1, P2, P3), the axes being the columns of F
+bool triangleFrame(const double *P1, const double *P2, const double *P3, double *F)
+{
+  double e1[3] = {P2[0] - P1[0], P2[1] - P1[1], P2[2] - P1[2]};
+  const double d[3] = {P3[0] - P1[0], P3[1] - P1[1], P3[2] - P1[2]};
+  double e3[3] = {e1[1] * d[2] - e1[2] * d[1], e1[2] * d[0] - e1[0] * d[2], e1[0] * d[1] - e1[1] * d[0]};
+  const double n1 = sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+  const double n3 = sqrt(e3[0] * e3[0] + e3[1] * e3[1] + e3[2] * e3[2]);
+  if (n1 < eps || n3 < eps * n1) {
+    // Collinear points
+    return false;
+  }
+  for (unsigned int i = 0; i < 3; i++) {
+    e1[i] /= n1;
+    e3[i] /= n3;
+  }
+  const double e2[3] = {e3[1] * e1[2] - e3[2] * e1[1], e3[2] * e1[0] - e3[0] * e1[2], e3[0] * e1[1] - e3[1] * e1[0]};
+  for (unsigned int i = 0; i < 3; i++) {
+    F[3 * i] = e1[i];
+    F[3 * i + 1] = e2[i];
+    F[3 * i + 2] = e3[i];
+  }
+  return true;
+}
+
+/*
+  Closed-form P3P (Grunert's formulation): computes the depths s1, s2, s3 of
+  the 3 points along their viewing rays from the law of cosines, that reduces
+  to a quartic, then the rigid transformation that aligns the object triangle
+  with the camera one. The 4th point selects the right solution.
+
+  Returns the squared reprojection error of the 4th point, or DBL_MAX if no
+  valid solution is found.
+*/
+double solveP3P(const FlatPoints &pts, const unsigned int *sample, PoseHypothesis &best)
+{
+  double j[3][3], Po[3][3];
+  for (unsigned int i = 0; i < 3; i++) {
+    const unsigned int k = sample[i];
+    const double n = sqrt(pts.x[k] * pts.x[k] + pts.y[k] * pts.y[k] + 1.);
+    j[i][0] = pts.x[k] / n;
+    j[i][1] = pts.y[k] / n;
+    j[i][2] = 1. / n;
+    Po[i][0] = pts.oX[k];
+    Po[i][1] = pts.oY[k];
+    Po[i][2] = pts.oZ[k];
+  }
+
+  double Fo[9];
+  if (!triangleFrame(Po[0], Po[1], Po[2], Fo)) {
+    return DBL_MAX;
+  }
+
+  const double a2 = vpMath::sqr(Po[1][0] - Po[2][0]) + vpMath::sqr(Po[1][1] - Po[2][1]) + vpMath::sqr(Po[1][2] - Po[2][2]);
+  const double b2 = vpMath::sqr(Po[0][0] - Po[2][0]) + vpMath::sqr(Po[0][1] - Po[2][1]) + vpMath::sqr(Po[0][2] - Po[2][2]);
+  const double c2 = vpMath::sqr(Po[0][0] - Po[1][0]) + vpMath::sqr(Po[0][1] - Po[1][1]) + vpMath::sqr(Po[0][2] - Po[1][2]);
+  const double cosAlpha = j[1][0] * j[2][0] + j[1][1] * j[2][1] + j[1][2] * j[2][2];
+  const double cosBeta = j[0][0] * j[2][0] + j[0][1] * j[2][1] + j[0][2] * j[2][2];
+  const double cosGamma = j[0][0] * j[1][0] + j[0][1] * j[1][1] + j[0][2] * j[1][2];
+
+  // With s2 = u s1 and s3 = v s1, u = N(v) / D(v) and the quartic is N^2 - 2 cos(gamma) N D + D^2 E = 0
+  const double K = (a2 - c2) / b2, Cb = c2 / b2;
+  const double N[3] = {-(1 + K), 2 * K * cosBeta, 1 - K};
+  const double D[2] = {-2 * cosGamma, 2 * cosAlpha};
+  const double E[3] = {1 - Cb, 2 * Cb * cosBeta, -Cb};
+  double N2[5], ND[4], D2[3], D2E[5];
+  polyMult(N, 2, N, 2, N2);
+  polyMult(N, 2, D, 1, ND);
+  polyMult(D, 1, D, 1, D2);
+  polyMult(D2, 2, E, 2, D2E);
+  double quartic[5];
+  for (unsigned int i = 0; i < 5; i++) {
+    quartic[i] = N2[i] + D2E[i] - (i < 4 ? 2 * cosGamma * ND[i] : 0.);
+  }
+
+  double roots[4];
+  const unsigned int nbRoots = solveQuartic(quartic, roots);
+  double best_error = DBL_MAX;
+  for (unsigned int r = 0; r < nbRoots; r++) {
+    const double v = roots[r];
+    const double den = D[0] + D[1] * v;
+    if (v <= 0 || std::fabs(den) < std::numeric_limits<double>::epsilon()) {
+      continue;
+    }
+    const double u = (N[0] + (N[1] + N[2] * v) * v) / den;
+    const double s1_2 = b2 / (1 + v * v - 2 * v * cosBeta);
+    if (u <= 0 || !(s1_2 > 0)) {
+      continue;
+    }
+    const double s[3] = {sqrt(s1_2), u * sqrt(s1_2), v * sqrt(s1_2)};
+    // Reject the real parts of complex roots, that do not satisfy the distance between P2 and P3
+    if (std::fabs(s[1] * s[1] + s[2] * s[2] - 2 * s[1] * s[2] * cosAlpha - a2) > 1e-3 * a2) {
+      continue;
+    }
+
+    double Pc[3][3];
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        Pc[i][k] = s[i] * j[i][k];
+      }
+    }
+    double Fc[9];
+    if (!triangleFrame(Pc[0], Pc[1], Pc[2], Fc)) {
+      continue;
+    }
+
+    // R = Fc Fo^T and t = Pc1 - R Po1
+    PoseHypothesis h;
+    for (unsigned int row = 0; row < 3; row++) {
+      for (unsigned int col = 0; col < 3; col++) {
+        h.R[3 * row + col] =
+            Fc[3 * row] * Fo[3 * col] + Fc[3 * row + 1] * Fo[3 * col + 1] + Fc[3 * row + 2] * Fo[3 * col + 2];
+      }
+      h.t[row] = Pc[0][row] - (h.R[3 * row] * Po[0][0] + h.R[3 * row + 1] * Po[0][1] + h.R[3 * row + 2] * Po[0][2]);
+    }
+
+    const double error = reprojectionError2(h, pts, sample[3]);
+    if (error < best_error) {
+      best_error = error;
+      best = h;
+    }
+  }
+
+  return best_error;
+}
+
+// Number of trials evaluated between two updates of the best hypothesis and of the stopping criteria
+const int nbTrialsPerBatch = 32;
+// Number of points scored between two checks of the preemption
+const unsigned int nbPointsPerCheck = 64;
+
+/*
+  Key of a scored hypothesis such that the best one has the largest key: the
+  largest number of inliers wins, then the smallest trial index.
+*/
+inline uint64_t hypothesisKey(unsigned int score, int trial)
+{
+  return ((uint64_t)score << 32) | (uint64_t)(0xFFFFFFFFu - (unsigned int)trial);
+}
+
+inline int hypothesisTrial(uint64_t key) { return (int)(0xFFFFFFFFu - (unsigned int)(key & 0xFFFFFFFFu)); }
+
+inline unsigned int hypothesisScore(uint64_t key) { return (unsigned int)(key >> 32); }
+
+// Lock-free read and maximum of a key shared by the threads of the parallel RANSAC
+uint64_t atomicLoad(volatile uint64_t *key)
+{
+#if defined(_MSC_VER)
+  return (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)key, 0, 0);
+#elif defined(__GNUC__)
+  return __sync_val_compare_and_swap(key, 0, 0);
+#else
+  return *key;
+#endif
+}
+
+void atomicMax(volatile uint64_t *key, uint64_t value)
+{
+#if defined(_MSC_VER) || defined(__GNUC__)
+  uint64_t current = atomicLoad(key);
+  while (value > current) {
+#if defined(_MSC_VER)
+    const uint64_t previous =
+        (uint64_t)_InterlockedCompareExchange64((volatile __int64 *)key, (__int64)value, (__int64)current);
+#else
+    const uint64_t previous = __sync_val_compare_and_swap(key, current, value);
+#endif
+    if (previous == current) {
+      break;
+    }
+    current = previous;
+  }
+#else
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp critical(vpPoseRansacP3PBestKey)
+#endif
+  {
+    if (value > *key) {
+      *key = value;
+    }
+  }
+#endif
+}
+
+/*
+  Number of points in [begin, end) whose reprojection error is below the
+  threshold. The test (X - x Z)^2 + (Y - y Z)^2 < threshold^2 Z^2 with Z > 0
+  avoids the divisions.
+*/
+unsigned int countInliers(const PoseHypothesis &h, const FlatPoints &pts, unsigned int begin, unsigned int end,
+                          double threshold2, bool useSSE2)
+{
+  unsigned int nbInliers = 0, i = begin;
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    __m128d R[9], t[3];
+    for (unsigned int k = 0; k < 9; k++) {
+      R[k] = _mm_set1_pd(h.R[k]);
+    }
+    for (unsigned int k = 0; k < 3; k++) {
+      t[k] = _mm_set1_pd(h.t[k]);
+    }
+    const __m128d th2 = _mm_set1_pd(threshold2), zero = _mm_setzero_pd();
+    for (; i + 2 <= end; i += 2) {
+      const __m128d oX = _mm_loadu_pd(&pts.oX[i]), oY = _mm_loadu_pd(&pts.oY[i]), oZ = _mm_loadu_pd(&pts.oZ[i]);
+      const __m128d X = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(R[0], oX), _mm_mul_pd(R[1], oY)), _mm_add_pd(_mm_mul_pd(R[2], oZ), t[0]));
+      const __m128d Y = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(R[3], oX), _mm_mul_pd(R[4], oY)), _mm_add_pd(_mm_mul_pd(R[5], oZ), t[1]));
+      const __m128d Z = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(R[6], oX), _mm_mul_pd(R[7], oY)), _mm_add_pd(_mm_mul_pd(R[8], oZ), t[2]));
+      const __m128d ex = _mm_sub_pd(X, _mm_mul_pd(_mm_loadu_pd(&pts.x[i]), Z));
+      const __m128d ey = _mm_sub_pd(Y, _mm_mul_pd(_mm_loadu_pd(&pts.y[i]), Z));
+      const __m128d e2 = _mm_add_pd(_mm_mul_pd(ex, ex), _mm_mul_pd(ey, ey));
+      const __m128d inlier =
+          _mm_and_pd(_mm_cmplt_pd(e2, _mm_mul_pd(th2, _mm_mul_pd(Z, Z))), _mm_cmpgt_pd(Z, zero));
+      const int mask = _mm_movemask_pd(inlier);
+      nbInliers += (mask & 1) + (mask >> 1);
+    }
+  }
+#else
+  (void)useSSE2;
+#endif
+  for (; i < end; i++) {
+    if (reprojectionError2(h, pts, i) < threshold2) {
+      nbInliers++;
+    }
+  }
+  return nbInliers;
+}
+
+/*
+  Preemptive scoring: the points are scored by blocks and the scoring stops as
+  soon as the hypothesis cannot get more inliers than the current best one.
+  Returns false in that case.
+*/
+bool scoreHypothesis(const PoseHypothesis &h, const FlatPoints &pts, double threshold2, bool useSSE2,
+                     volatile uint64_t *best_key, unsigned int &score)
+{
+  const unsigned int size = (unsigned int)pts.x.size();
+  score = 0;
+  for (unsigned int begin = 0; begin < size; begin += nbPointsPerCheck) {
+    const unsigned int end = (std::min)(begin + nbPointsPerCheck, size);
+    score += countInliers(h, pts, begin, end, threshold2, useSSE2);
+    // A tie is scored until the end, the smallest trial index winning
+    if (score + (size - end) < hypothesisScore(atomicLoad(best_key))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+  Minimal sample and P3P pose of a trial. Returns false if the sample is
+  degenerate, if the 4th point is not an inlier or if the pose is rejected by
+  the validation function.
+*/
+bool computeHypothesis(const FlatPoints &pts, int trial, bool checkDegeneratePoints, double threshold2,
+                       bool (*func)(vpHomogeneousMatrix *), PoseHypothesis &h)
+{
+  const unsigned int size = (unsigned int)pts.x.size();
+  TrialSampler sampler((uint64_t)trial);
+  unsigned int sample[4];
+  for (unsigned int i = 0; i < 4; i++) {
+    // Bounded number of draws, a sample that cannot be completed is skipped
+    bool picked = false;
+    for (unsigned int n = 0; n < 16 && !picked; n++) {
+      sample[i] = sampler(size);
+      picked = true;
+      for (unsigned int k = 0; k < i && picked; k++) {
+        picked = sample[k] != sample[i] && (!checkDegeneratePoints || !pts.isDegenerate(sample[k], sample[i]));
+      }
+    }
+    if (!picked) {
+      return false;
+    }
+  }
+
+  // The 4th point must be an inlier to score the hypothesis
+  if (!(solveP3P(pts, sample, h) < threshold2)) {
+    return false;
+  }
+
+  if (func != NULL) {
+    vpHomogeneousMatrix cMo;
+    for (unsigned int row = 0; row < 3; row++) {
+      for (unsigned int col = 0; col < 3; col++) {
+        cMo[row][col] = h.R[3 * row + col];
+      }
+      cMo[row][3] = h.t[row];
+    }
+    return func(&cMo);
+  }
+  return true;
+}
 }
 
 bool vpPose::RansacFunctor::poseRansacImpl()
@@ -428,6 +869,99 @@ vpThread::Return vpPose::poseRansacImplThread(vpThread::Args arg)
 }
 #endif
 
+/*!
+  RANSAC on flat arrays with the closed-form P3P solver (see
+  vpPose::RANSAC_P3P).
+
+  \param listOfUniquePoints : Points after the prefiltering.
+  \param checkDegeneratePoints : If true, reject minimal samples with
+  degenerate points and remove the degenerate points of the consensus set.
+  \param func : Optional pose validation function.
+  \param best_consensus : Index of the inliers of the best hypothesis.
+  \param cMo_best : Best hypothesis.
+  \return True if at least one hypothesis was scored.
+*/
+bool vpPose::poseRansacP3P(const std::vector<vpPoint> &listOfUniquePoints, bool checkDegeneratePoints,
+                           bool (*func)(vpHomogeneousMatrix *), std::vector<unsigned int> &best_consensus,
+                           vpHomogeneousMatrix &cMo_best)
+{
+  const FlatPoints pts(listOfUniquePoints);
+  const unsigned int size = (unsigned int)listOfUniquePoints.size();
+  const double threshold2 = ransacThreshold * ransacThreshold;
+#if VISP_HAVE_SSE2
+  const bool useSSE2 = vpCPUFeatures::checkSSE2();
+#else
+  const bool useSSE2 = false;
+#endif
+
+  int nbThreads = 1;
+#if defined(VISP_HAVE_OPENMP)
+  if (useParallelRansac) {
+    nbThreads = nbParallelRansacThreads > 0 ? nbParallelRansacThreads : omp_get_max_threads();
+  }
+#endif
+
+  // The trials are evaluated by batches, in parallel or not, and the best
+  // hypothesis of a batch is the one with the largest key. Since the sample of
+  // a trial only depends on its index, the result does not depend on the
+  // number of threads.
+  std::vector<PoseHypothesis> hypotheses(nbTrialsPerBatch);
+  volatile uint64_t best_key = 0;
+  PoseHypothesis best_hypothesis;
+  int nbTrialsMax = ransacMaxTrials;
+  for (int batch = 0; batch < nbTrialsMax && best_consensus.size() < ransacNbInlierConsensus;
+       batch += nbTrialsPerBatch) {
+    const int batch_end = (std::min)(batch + nbTrialsPerBatch, nbTrialsMax);
+    const uint64_t previous_key = best_key;
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(dynamic) num_threads(nbThreads) if (nbThreads > 1)
+#endif
+    for (int trial = batch; trial < batch_end; trial++) {
+      PoseHypothesis &h = hypotheses[(size_t)(trial - batch)];
+      unsigned int score = 0;
+      if (computeHypothesis(pts, trial, checkDegeneratePoints, threshold2, func, h) &&
+          scoreHypothesis(h, pts, threshold2, useSSE2, &best_key, score) && score > 0) {
+        atomicMax(&best_key, hypothesisKey(score, trial));
+      }
+    }
+
+    if (best_key == previous_key) {
+      continue;
+    }
+    best_hypothesis = hypotheses[(size_t)(hypothesisTrial(best_key) - batch)];
+
+    best_consensus.clear();
+    for (unsigned int i = 0; i < size; i++) {
+      if (reprojectionError2(best_hypothesis, pts, i) < threshold2) {
+        bool degenerate = false;
+        for (size_t k = 0; k < best_consensus.size() && checkDegeneratePoints && !degenerate; k++) {
+          degenerate = pts.isDegenerate(best_consensus[k], i);
+        }
+        if (!degenerate) {
+          best_consensus.push_back(i);
+        }
+      }
+    }
+
+    // Adaptive number of trials for an outlier free sample with a 0.99 probability
+    const double outlierRatio = 1. - (double)best_consensus.size() / (double)size;
+    nbTrialsMax = (std::min)(ransacMaxTrials, computeRansacIterations(0.99, outlierRatio, 4, ransacMaxTrials));
+  }
+
+  if (best_key == 0) {
+    return false;
+  }
+
+  for (unsigned int row = 0; row < 3; row++) {
+    for (unsigned int col = 0; col < 3; col++) {
+      cMo_best[row][col] = best_hypothesis.R[3 * row + col];
+    }
+    cMo_best[row][3] = best_hypothesis.t[row];
+  }
+  return true;
+}
+
 /*!
   Compute the pose using the Ransac approach.
 
@@ -588,8 +1122,13 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
   }
 
   bool foundSolution = false;
+  // Best hypothesis of the P3P solver, also considered to initialize the final VVS
+  vpHomogeneousMatrix cMo_hypothesis;
 
-  if (executeParallelVersion) {
+  if (ransacSolver == RANSAC_P3P) {
+    foundSolution = poseRansacP3P(listOfUniquePoints, checkDegeneratePoints, func, best_consensus, cMo_hypothesis);
+    nbInliers = (unsigned int)best_consensus.size();
+  } else if (executeParallelVersion) {
 #if defined(PARALLEL_RANSAC_OPEN_MP)
 // List of points picked randomly (minimal sample set, MSS)
 // std::vector<unsigned int> best_randoms; // never used
@@ -936,8 +1475,18 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
         r_dementhon = DBL_MAX;
       }
 
-      if (is_valid_lagrange || is_valid_dementhon) {
-        if (r_lagrange < r_dementhon) {
+      double r_hypothesis = DBL_MAX;
+      if (ransacSolver == RANSAC_P3P) {
+        r_hypothesis = pose.computeResidual(cMo_hypothesis);
+        if (vpMath::isNaN(r_hypothesis)) {
+          r_hypothesis = DBL_MAX;
+        }
+      }
+
+      if (is_valid_lagrange || is_valid_dementhon || r_hypothesis < DBL_MAX) {
+        if (r_hypothesis < (std::min)(r_lagrange, r_dementhon)) {
+          cMo = cMo_hypothesis;
+        } else if (r_lagrange < r_dementhon) {
           cMo = cMo_lagrange;
         } else {
           cMo = cMo_dementhon;
@@ -979,7 +1528,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
   \return The number of RANSAC iterations to ensure with a probability \e p
   that at least one of the random samples of \e s points is free from outliers
   or \p maxIterations if it exceeds the desired upper bound or \e INT_MAX if
-  maxIterations=-1.
+  maxIterations=-1. The returned number of iterations is at least 1.
 */
 int vpPose::computeRansacIterations(double probability, double epsilon, const int sampleSize, int maxIterations)
 {
@@ -1005,15 +1554,15 @@ int vpPose::computeRansacIterations(double probability, double epsilon, const in
   logval = log(1.0 + logarg);
 #endif
   if (vpMath::nul(logval, std::numeric_limits<double>::epsilon())) {
-    std::cerr << "vpMath::nul(log(1.0 - std::pow(1.0 - epsilon, "
-                 "sampleSize)), std::numeric_limits<double>::epsilon())"
-              << std::endl;
-    return 0;
+    // Almost no sample is free from outliers: the number of iterations is
+    // only bounded by maxIterations
+    return maxIterations;
   }
 
   N = log((std::max)(1.0 - probability, std::numeric_limits<double>::epsilon())) / logval;
   if (logval < 0.0 && N < maxIterations) {
-    return (int)ceil(N);
+    // At least one sample is drawn
+    return (std::max)(1, (int)ceil(N));
   }
 
   return maxIterations;
@@ -0,0 +1,286 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the Hamming distance matcher for binary descriptors.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testBinaryDescriptorMatcher.cpp
+
+  \brief Test that vpBinaryDescriptorMatcher gives the same matches than an
+  exhaustive search, with and without the multi-index hash table, and compare
+  their computation times.
+*/
+
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpBinaryDescriptorMatcher.h>
+
+namespace
+{
+unsigned int referenceDistance(const unsigned char *a, const unsigned char *b, unsigned int size)
+{
+  unsigned int dist = 0;
+  for (unsigned int i = 0; i < 8 * size; i++) {
+    dist += ((a[i / 8] ^ b[i / 8]) >> (i % 8)) & 1;
+  }
+  return dist;
+}
+
+// Exhaustive search of the two nearest neighbours, the ratio test and the
+// cross check
+void referenceMatch(const std::vector<unsigned char> &train, const std::vector<unsigned char> &query,
+                    unsigned int size, double ratio, bool crossCheck,
+                    std::vector<vpBinaryDescriptorMatcher::vpMatch> &matches)
+{
+  const unsigned int nbTrain = (unsigned int)train.size() / size, nbQuery = (unsigned int)query.size() / size;
+  std::vector<unsigned int> distances((size_t)nbTrain * nbQuery);
+  for (unsigned int i = 0; i < nbQuery; i++) {
+    for (unsigned int j = 0; j < nbTrain; j++) {
+      distances[i * nbTrain + j] = referenceDistance(&query[i * size], &train[j * size], size);
+    }
+  }
+
+  matches.clear();
+  for (unsigned int i = 0; i < nbQuery; i++) {
+    vpBinaryDescriptorMatcher::vpMatch m;
+    m.queryIdx = (int)i;
+    m.trainIdx = m.secondTrainIdx = -1;
+    m.distance = m.secondDistance = UINT_MAX;
+    for (unsigned int j = 0; j < nbTrain; j++) {
+      const unsigned int d = distances[i * nbTrain + j];
+      if (d < m.distance) {
+        m.secondDistance = m.distance;
+        m.secondTrainIdx = m.trainIdx;
+        m.distance = d;
+        m.trainIdx = (int)j;
+      } else if (d < m.secondDistance) {
+        m.secondDistance = d;
+        m.secondTrainIdx = (int)j;
+      }
+    }
+
+    if (ratio > 0 && !(m.secondDistance != UINT_MAX && m.distance < ratio * m.secondDistance)) {
+      continue;
+    }
+    if (crossCheck) {
+      unsigned int best = UINT_MAX, bestQuery = 0;
+      for (unsigned int k = 0; k < nbQuery; k++) {
+        if (distances[k * nbTrain + (unsigned int)m.trainIdx] < best) {
+          best = distances[k * nbTrain + (unsigned int)m.trainIdx];
+          bestQuery = k;
+        }
+      }
+      if (bestQuery != i) {
+        continue;
+      }
+    }
+    matches.push_back(m);
+  }
+}
+
+bool compare(const std::vector<vpBinaryDescriptorMatcher::vpMatch> &matches,
+             const std::vector<vpBinaryDescriptorMatcher::vpMatch> &ref, bool checkSecond, const std::string &name)
+{
+  if (matches.size() != ref.size()) {
+    std::cerr << name << ": " << matches.size() << " matches instead of " << ref.size() << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (matches[i].queryIdx != ref[i].queryIdx || matches[i].trainIdx != ref[i].trainIdx ||
+        matches[i].distance != ref[i].distance ||
+        (checkSecond && (matches[i].secondTrainIdx != ref[i].secondTrainIdx ||
+                         matches[i].secondDistance != ref[i].secondDistance))) {
+      std::cerr << name << ": difference for the match " << i << " (query " << ref[i].queryIdx << ")" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Train descriptors are random, query descriptors are noisy copies of train
+// descriptors or random descriptors
+void generate(unsigned int nbTrain, unsigned int nbQuery, unsigned int size, vpUniRand &rand,
+              std::vector<unsigned char> &train, std::vector<unsigned char> &query)
+{
+  train.resize((size_t)nbTrain * size);
+  for (size_t i = 0; i < train.size(); i++) {
+    train[i] = (unsigned char)(256 * rand());
+  }
+  query.resize((size_t)nbQuery * size);
+  for (unsigned int i = 0; i < nbQuery; i++) {
+    if (i % 4 == 3) {
+      for (unsigned int k = 0; k < size; k++) {
+        query[i * size + k] = (unsigned char)(256 * rand());
+      }
+    } else {
+      const unsigned int j = (unsigned int)(nbTrain * rand());
+      for (unsigned int k = 0; k < size; k++) {
+        query[i * size + k] = train[j * size + k];
+      }
+      const unsigned int nbFlips = (unsigned int)(size * rand());
+      for (unsigned int n = 0; n < nbFlips; n++) {
+        const unsigned int bit = (unsigned int)(8 * size * rand());
+        query[i * size + bit / 8] ^= (unsigned char)(1 << (bit % 8));
+      }
+    }
+  }
+}
+
+bool testMatcher(unsigned int nbTrain, unsigned int nbQuery, unsigned int size, vpUniRand &rand)
+{
+  std::vector<unsigned char> train, query;
+  generate(nbTrain, nbQuery, size, rand, train, query);
+
+  for (unsigned int k = 0; k < nbQuery; k++) {
+    const unsigned int j = k % nbTrain;
+    if (vpBinaryDescriptorMatcher::hammingDistance(&query[k * size], &train[j * size], size) !=
+        referenceDistance(&query[k * size], &train[j * size], size)) {
+      std::cerr << "Difference between hammingDistance() and the reference for size " << size << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<vpBinaryDescriptorMatcher::vpMatch> refAll;
+  referenceMatch(train, query, size, 0.0, false, refAll);
+
+  const double ratios[] = {0.0, 0.8};
+  for (unsigned int r = 0; r < 2; r++) {
+    for (unsigned int c = 0; c < 2; c++) {
+      std::vector<vpBinaryDescriptorMatcher::vpMatch> ref, matches;
+      referenceMatch(train, query, size, ratios[r], c == 1, ref);
+
+      vpBinaryDescriptorMatcher matcher;
+      matcher.setRatioThreshold(ratios[r]);
+      matcher.setCrossCheck(c == 1);
+      matcher.train(&train[0], nbTrain, size);
+      matcher.match(&query[0], nbQuery, matches);
+      if (!compare(matches, ref, true, "Brute force")) {
+        return false;
+      }
+
+      // The multi-index search is exact for the nearest neighbours closer
+      // than 3 times the number of tables, the second nearest neighbour may
+      // be replaced by a lower bound of its distance
+      matcher.setMultiIndexHashing(true);
+      matcher.match(&query[0], nbQuery, matches);
+      const unsigned int bound = 3 * matcher.getNbTables();
+      for (size_t i = 0; i < matches.size(); i++) {
+        const vpBinaryDescriptorMatcher::vpMatch &m = matches[i], &mRef = refAll[(size_t)m.queryIdx];
+        if (mRef.distance >= bound) {
+          continue;
+        }
+        if (m.trainIdx != mRef.trainIdx || m.distance != mRef.distance ||
+            (m.secondTrainIdx >= 0 &&
+             (m.secondTrainIdx != mRef.secondTrainIdx || m.secondDistance != mRef.secondDistance)) ||
+            m.secondDistance > mRef.secondDistance) {
+          std::cerr << "Multi-index: wrong nearest neighbours for the query " << m.queryIdx << std::endl;
+          return false;
+        }
+      }
+
+      // The close matches may only disappear when the ratio test fails with
+      // the lower bound of the second distance
+      for (size_t i = 0, j = 0; i < ref.size(); i++) {
+        if (ref[i].distance >= bound) {
+          continue;
+        }
+        while (j < matches.size() && matches[j].queryIdx < ref[i].queryIdx) {
+          j++;
+        }
+        const bool missing = j == matches.size() || matches[j].queryIdx != ref[i].queryIdx;
+        if (missing && (ratios[r] <= 0 || ref[i].distance < ratios[r] * bound)) {
+          std::cerr << "Multi-index: missing match for the query " << ref[i].queryIdx << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+    // Descriptor sizes of BRIEF-16, ORB, BRISK and FREAK, and an odd size
+    const unsigned int sizes[] = {16, 32, 64, 13};
+    for (unsigned int k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+      if (!testMatcher(2000, 200, sizes[k], rand)) {
+        std::cerr << "Failed for descriptor size " << sizes[k] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    const unsigned int nbTrain = 50000, nbQuery = 1000, size = 32, nbIterations = 3;
+    std::vector<unsigned char> train, query;
+    generate(nbTrain, nbQuery, size, rand, train, query);
+    std::vector<vpBinaryDescriptorMatcher::vpMatch> matches;
+
+    vpBinaryDescriptorMatcher matcher;
+    matcher.setRatioThreshold(0.8);
+    matcher.setCrossCheck(true);
+    matcher.train(&train[0], nbTrain, size);
+    double t_brute_force = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      matcher.match(&query[0], nbQuery, matches);
+    }
+    t_brute_force = (vpTime::measureTimeMs() - t_brute_force) / nbIterations;
+    const size_t nbMatchesBruteForce = matches.size();
+
+    double t_build = vpTime::measureTimeMs();
+    matcher.setMultiIndexHashing(true);
+    t_build = vpTime::measureTimeMs() - t_build;
+    double t_multi_index = vpTime::measureTimeMs();
+    for (unsigned int n = 0; n < nbIterations; n++) {
+      matcher.match(&query[0], nbQuery, matches);
+    }
+    t_multi_index = (vpTime::measureTimeMs() - t_multi_index) / nbIterations;
+
+    std::cout << nbQuery << " queries, " << nbTrain << " train descriptors: brute force=" << t_brute_force
+              << " ms (" << nbMatchesBruteForce << " matches) ; multi-index=" << t_multi_index << " ms ("
+              << matches.size() << " matches, built in " << t_build << " ms)" << std::endl;
+
+    std::cout << "vpBinaryDescriptorMatcher gives the same matches than the exhaustive search." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
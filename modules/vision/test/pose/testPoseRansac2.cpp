@@ -1886,6 +1886,9 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
 #endif
   pose_ransac.setRansacFilterFlags(vpPose::PREFILTER_DUPLICATE_POINTS + vpPose::CHECK_DEGENERATE_POINTS);
   pose_ransac2.setRansacFilterFlags(vpPose::PREFILTER_DUPLICATE_POINTS + vpPose::CHECK_DEGENERATE_POINTS);
+  vpPose pose_ransac_p3p;
+  pose_ransac_p3p.setRansacSolver(vpPose::RANSAC_P3P);
+  pose_ransac_p3p.setRansacFilterFlags(vpPose::PREFILTER_DUPLICATE_POINTS + vpPose::CHECK_DEGENERATE_POINTS);
   for (std::vector<vpPoint>::const_iterator it = bunnyModelPoints_noisy.begin(); it != bunnyModelPoints_noisy.end();
        ++it) {
     pose.addPoint(*it);
@@ -1893,6 +1896,7 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   // Test addPoints
   pose_ransac.addPoints(bunnyModelPoints_noisy);
   pose_ransac2.addPoints(bunnyModelPoints_noisy);
+  pose_ransac_p3p.addPoints(bunnyModelPoints_noisy);
 #ifdef TEST_PARALLEL_RANSAC
   if (use_threading == "true") {
     pose_ransac_parallel.addPoints(bunnyModelPoints_noisy);
@@ -1954,6 +1958,21 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   double r_RANSAC_estimated_2 = ground_truth_pose.computeResidual(cMo_estimated_RANSAC_2);
   std::cout << "Corresponding residual (" << ransac_iterations << " iterations): " << r_RANSAC_estimated_2 << std::endl;
 
+  // RANSAC with the P3P solver, up to 1000 iterations
+  pose_ransac_p3p.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
+  pose_ransac_p3p.setRansacThreshold(threshold);
+  pose_ransac_p3p.setRansacMaxTrials(1000);
+  vpHomogeneousMatrix cMo_estimated_RANSAC_p3p;
+  t_RANSAC = vpTime::measureTimeMs();
+  pose_ransac_p3p.computePose(vpPose::RANSAC, cMo_estimated_RANSAC_p3p);
+  t_RANSAC = vpTime::measureTimeMs() - t_RANSAC;
+
+  std::cout << "\ncMo estimated with RANSAC and the P3P solver on noisy data:\n" << cMo_estimated_RANSAC_p3p << std::endl;
+  std::cout << "Computation time: " << t_RANSAC << " ms" << std::endl;
+
+  double r_RANSAC_estimated_p3p = ground_truth_pose.computeResidual(cMo_estimated_RANSAC_p3p);
+  std::cout << "Corresponding residual (P3P solver): " << r_RANSAC_estimated_p3p << std::endl;
+
   pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
   pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
   r_dementhon = pose.computeResidual(cMo_dementhon);
@@ -2044,6 +2063,46 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
     return false;
   }
 
+  // Check for RANSAC with the P3P solver
+  std::cout << "\nCheck for RANSAC with the P3P solver" << std::endl;
+  std::vector<unsigned int> vectorOfFoundInlierIndex_p3p = pose_ransac_p3p.getRansacInlierIndex();
+  nbInlierIndexOk = checkInlierIndex(vectorOfFoundInlierIndex_p3p, vectorOfOutlierFlags);
+
+  std::cout << "There are " << nbInlierIndexOk << " true inliers found, " << vectorOfFoundInlierIndex_p3p.size()
+            << " inliers returned and " << nbTrueInlierIndex << " true inliers." << std::endl;
+
+  std::vector<vpPoint> vectorOfFoundInlierPoints_p3p = pose_ransac_p3p.getRansacInliers();
+  if (vectorOfFoundInlierPoints_p3p.size() != vectorOfFoundInlierIndex_p3p.size()) {
+    std::cerr << "The number of inlier index is different with the number of "
+                 "inlier points !"
+              << std::endl;
+    return false;
+  }
+  if (!checkInlierPoints(vectorOfFoundInlierPoints_p3p, vectorOfFoundInlierIndex_p3p, bunnyModelPoints_noisy)) {
+    return false;
+  }
+
+  // The parallel RANSAC with the P3P solver must give the same result whatever the number of threads
+  for (int nbThreads = 2; nbThreads <= 3; nbThreads++) {
+    vpPose pose_ransac_p3p_parallel;
+    pose_ransac_p3p_parallel.setRansacSolver(vpPose::RANSAC_P3P);
+    pose_ransac_p3p_parallel.setUseParallelRansac(true);
+    pose_ransac_p3p_parallel.setNbParallelRansacThreads(nbThreads);
+    pose_ransac_p3p_parallel.setRansacFilterFlags(vpPose::PREFILTER_DUPLICATE_POINTS +
+                                                  vpPose::CHECK_DEGENERATE_POINTS);
+    pose_ransac_p3p_parallel.addPoints(bunnyModelPoints_noisy);
+    pose_ransac_p3p_parallel.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
+    pose_ransac_p3p_parallel.setRansacThreshold(threshold);
+    pose_ransac_p3p_parallel.setRansacMaxTrials(1000);
+    vpHomogeneousMatrix cMo_estimated_RANSAC_p3p_parallel;
+    pose_ransac_p3p_parallel.computePose(vpPose::RANSAC, cMo_estimated_RANSAC_p3p_parallel);
+    if (pose_ransac_p3p_parallel.getRansacInlierIndex() != vectorOfFoundInlierIndex_p3p) {
+      std::cerr << "The parallel RANSAC with the P3P solver and " << nbThreads
+                << " threads does not give the same inliers than the sequential one!" << std::endl;
+      return false;
+    }
+  }
+
 #ifdef TEST_PARALLEL_RANSAC
   if (use_threading == "true") {
     // Check for parallel RANSAC
@@ -2097,6 +2156,11 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
     std::cerr << "r_RANSAC_estimated=" << r_RANSAC_estimated << std::endl;
     std::cerr << "threshold=" << threshold << std::endl;
     return false;
+  } else if (r_RANSAC_estimated_p3p > threshold) {
+    std::cerr << "The pose estimated with the RANSAC method and the P3P solver is badly estimated!" << std::endl;
+    std::cerr << "r_RANSAC_estimated_p3p=" << r_RANSAC_estimated_p3p << std::endl;
+    std::cerr << "threshold=" << threshold << std::endl;
+    return false;
   } else {
 #ifdef TEST_PARALLEL_RANSAC
     if (use_threading == "true") {
@@ -120,6 +120,8 @@ public:
   void init(unsigned int _nbr, unsigned int _nbc, double _Z);
   vpMatrix interaction(const unsigned int select = FEATURE_ALL);
   void interaction(vpMatrix &L);
+  void interactionAtA(vpMatrix &LtL) const;
+  void interactionAtb(const vpColVector &b, vpColVector &Ltb) const;
 
   vpFeatureLuminance &operator=(const vpFeatureLuminance &f);
 
@@ -36,6 +36,9 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+#include <vector>
+
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
@@ -46,6 +49,11 @@
 
 #include <visp3/visual_features/vpFeatureLuminance.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 /*!
   \file vpFeatureLuminance.cpp
   \brief Class that defines the image luminance visual feature
@@ -53,6 +61,160 @@
   For more details see \cite Collewet08c.
 */
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of pixels of a block in computeNormalEquations(). The blocks do not
+// depend on the number of threads, so that the sums do not either.
+const unsigned int blockSize = 4096;
+
+// Row of the interaction matrix related to a pixel
+inline void computeInteractionRow(const vpLuminance &pix, double *Li)
+{
+  double Ix = pix.Ix;
+  double Iy = pix.Iy;
+
+  double x = pix.x;
+  double y = pix.y;
+  double Zinv = 1 / pix.Z;
+
+  Li[0] = Ix * Zinv;
+  Li[1] = Iy * Zinv;
+  Li[2] = -(x * Ix + y * Iy) * Zinv;
+  Li[3] = -Ix * x * y - (1 + y * y) * Iy;
+  Li[4] = (1 + x * x) * Ix + Iy * x * y;
+  Li[5] = Iy * x - Ix * y;
+}
+
+// Sums L^T L (36 values) and L^T b (6 values) over the pixels [begin, end).
+// Since L^T L is symmetric, only the elements (i, j) with j >= 2 (i / 2) are
+// accumulated; the lower part is copied afterwards.
+template <bool withLtL, bool withLtb>
+void accumulateNormalEquations(const vpLuminance *pixInfo, const double *b, unsigned int begin, unsigned int end,
+                               double *LtL, double *Ltb)
+{
+  double Li[6];
+#if VISP_HAVE_SSE2
+  // Pairs of columns (0, 1), (2, 3) and (4, 5) of the rows 0 to 5
+  __m128d LtL00 = _mm_setzero_pd(), LtL01 = _mm_setzero_pd(), LtL02 = _mm_setzero_pd();
+  __m128d LtL10 = _mm_setzero_pd(), LtL11 = _mm_setzero_pd(), LtL12 = _mm_setzero_pd();
+  __m128d LtL21 = _mm_setzero_pd(), LtL22 = _mm_setzero_pd();
+  __m128d LtL31 = _mm_setzero_pd(), LtL32 = _mm_setzero_pd();
+  __m128d LtL42 = _mm_setzero_pd(), LtL52 = _mm_setzero_pd();
+  __m128d Ltb0 = _mm_setzero_pd(), Ltb1 = _mm_setzero_pd(), Ltb2 = _mm_setzero_pd();
+
+  for (unsigned int m = begin; m < end; m++) {
+    computeInteractionRow(pixInfo[m], Li);
+    // Built from the scalars to avoid a store-to-load forwarding stall
+    __m128d L01 = _mm_set_pd(Li[1], Li[0]);
+    __m128d L23 = _mm_set_pd(Li[3], Li[2]);
+    __m128d L45 = _mm_set_pd(Li[5], Li[4]);
+    if (withLtL) {
+      __m128d Lii = _mm_set1_pd(Li[0]);
+      LtL00 = _mm_add_pd(LtL00, _mm_mul_pd(Lii, L01));
+      LtL01 = _mm_add_pd(LtL01, _mm_mul_pd(Lii, L23));
+      LtL02 = _mm_add_pd(LtL02, _mm_mul_pd(Lii, L45));
+      Lii = _mm_set1_pd(Li[1]);
+      LtL10 = _mm_add_pd(LtL10, _mm_mul_pd(Lii, L01));
+      LtL11 = _mm_add_pd(LtL11, _mm_mul_pd(Lii, L23));
+      LtL12 = _mm_add_pd(LtL12, _mm_mul_pd(Lii, L45));
+      Lii = _mm_set1_pd(Li[2]);
+      LtL21 = _mm_add_pd(LtL21, _mm_mul_pd(Lii, L23));
+      LtL22 = _mm_add_pd(LtL22, _mm_mul_pd(Lii, L45));
+      Lii = _mm_set1_pd(Li[3]);
+      LtL31 = _mm_add_pd(LtL31, _mm_mul_pd(Lii, L23));
+      LtL32 = _mm_add_pd(LtL32, _mm_mul_pd(Lii, L45));
+      LtL42 = _mm_add_pd(LtL42, _mm_mul_pd(_mm_set1_pd(Li[4]), L45));
+      LtL52 = _mm_add_pd(LtL52, _mm_mul_pd(_mm_set1_pd(Li[5]), L45));
+    }
+    if (withLtb) {
+      __m128d bm = _mm_set1_pd(b[m]);
+      Ltb0 = _mm_add_pd(Ltb0, _mm_mul_pd(L01, bm));
+      Ltb1 = _mm_add_pd(Ltb1, _mm_mul_pd(L23, bm));
+      Ltb2 = _mm_add_pd(Ltb2, _mm_mul_pd(L45, bm));
+    }
+  }
+
+  _mm_storeu_pd(LtL, LtL00);
+  _mm_storeu_pd(LtL + 2, LtL01);
+  _mm_storeu_pd(LtL + 4, LtL02);
+  _mm_storeu_pd(LtL + 6, LtL10);
+  _mm_storeu_pd(LtL + 8, LtL11);
+  _mm_storeu_pd(LtL + 10, LtL12);
+  _mm_storeu_pd(LtL + 14, LtL21);
+  _mm_storeu_pd(LtL + 16, LtL22);
+  _mm_storeu_pd(LtL + 20, LtL31);
+  _mm_storeu_pd(LtL + 22, LtL32);
+  _mm_storeu_pd(LtL + 28, LtL42);
+  _mm_storeu_pd(LtL + 34, LtL52);
+  _mm_storeu_pd(Ltb, Ltb0);
+  _mm_storeu_pd(Ltb + 2, Ltb1);
+  _mm_storeu_pd(Ltb + 4, Ltb2);
+#else
+  for (unsigned int i = 0; i < 36; i++)
+    LtL[i] = 0;
+  for (unsigned int i = 0; i < 6; i++)
+    Ltb[i] = 0;
+
+  for (unsigned int m = begin; m < end; m++) {
+    computeInteractionRow(pixInfo[m], Li);
+    if (withLtL) {
+      for (unsigned int i = 0; i < 6; i++)
+        for (unsigned int j = 2 * (i / 2); j < 6; j++)
+          LtL[6 * i + j] += Li[i] * Li[j];
+    }
+    if (withLtb) {
+      for (unsigned int i = 0; i < 6; i++)
+        Ltb[i] += Li[i] * b[m];
+    }
+  }
+#endif
+
+  for (unsigned int i = 1; i < 6; i++)
+    for (unsigned int j = 0; j < 2 * (i / 2); j++)
+      LtL[6 * i + j] = LtL[6 * j + i];
+}
+
+// Computes L^T L and/or L^T b without building the interaction matrix L
+void computeNormalEquations(const vpLuminance *pixInfo, unsigned int dim_s, const double *b, vpMatrix *LtL,
+                            vpColVector *Ltb)
+{
+  int nbBlocks = (int)((dim_s + blockSize - 1) / blockSize);
+  std::vector<double> partialSums((size_t)nbBlocks * 42);
+
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int k = 0; k < nbBlocks; k++) {
+    unsigned int begin = (unsigned int)k * blockSize;
+    unsigned int end = (std::min)(begin + blockSize, dim_s);
+    double *LtL_k = &partialSums[(size_t)k * 42];
+    double *Ltb_k = LtL_k + 36;
+    if (LtL != NULL && Ltb != NULL)
+      accumulateNormalEquations<true, true>(pixInfo, b, begin, end, LtL_k, Ltb_k);
+    else if (LtL != NULL)
+      accumulateNormalEquations<true, false>(pixInfo, b, begin, end, LtL_k, Ltb_k);
+    else
+      accumulateNormalEquations<false, true>(pixInfo, b, begin, end, LtL_k, Ltb_k);
+  }
+
+  // Sum of the blocks in a fixed order
+  if (LtL != NULL) {
+    LtL->resize(6, 6);
+    for (int k = 0; k < nbBlocks; k++)
+      for (unsigned int i = 0; i < 36; i++)
+        LtL->data[i] += partialSums[(size_t)k * 42 + i];
+  }
+  if (Ltb != NULL) {
+    Ltb->resize(6);
+    for (int k = 0; k < nbBlocks; k++)
+      for (unsigned int i = 0; i < 6; i++)
+        Ltb->data[i] += partialSums[(size_t)k * 42 + 36 + i];
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Initialize the memory space requested for vpFeatureLuminance visual feature.
 */
@@ -198,9 +360,13 @@ void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
     }
   }
 
-  l = 0;
-  for (unsigned int i = bord; i < nbr - bord; i++) {
-    //   cout << i << endl ;
+  // The rows are processed in parallel
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for private(l, Ix, Iy)
+#endif
+  for (int i_ = (int)bord; i_ < (int)(nbr - bord); i_++) {
+    unsigned int i = (unsigned int)i_;
+    l = (i - bord) * (nbc - 2 * bord);
     for (unsigned int j = bord; j < nbc - bord; j++) {
       // cout << dim_s <<" " <<l <<"  " <<i << "  " << j <<endl ;
       Ix = px * vpImageFilter::derivativeFilterX(I, i, j);
@@ -227,23 +393,53 @@ void vpFeatureLuminance::interaction(vpMatrix &L)
 {
   L.resize(dim_s, 6);
 
-  for (unsigned int m = 0; m < L.getRows(); m++) {
-    double Ix = pixInfo[m].Ix;
-    double Iy = pixInfo[m].Iy;
-
-    double x = pixInfo[m].x;
-    double y = pixInfo[m].y;
-    double Zinv = 1 / pixInfo[m].Z;
-
-    {
-      L[m][0] = Ix * Zinv;
-      L[m][1] = Iy * Zinv;
-      L[m][2] = -(x * Ix + y * Iy) * Zinv;
-      L[m][3] = -Ix * x * y - (1 + y * y) * Iy;
-      L[m][4] = (1 + x * x) * Ix + Iy * x * y;
-      L[m][5] = Iy * x - Ix * y;
-    }
+#if defined(VISP_HAVE_OPENMP)
+#pragma omp parallel for
+#endif
+  for (int m = 0; m < (int)L.getRows(); m++) {
+    computeInteractionRow(pixInfo[m], L[(unsigned int)m]);
+  }
+}
+
+/*!
+  Compute the 6-by-6 matrix \f$ L_I^\top L_I \f$ without building the
+  interaction matrix \f$ L_I \f$, that has as many rows as pixels.
+
+  With the error \f$ e = I - I^* \f$, it allows to compute the Gauss-Newton
+  (or Levenberg-Marquardt) control law \f$ v = -\lambda (L_I^\top
+  L_I)^{-1} L_I^\top e \f$ together with interactionAtb(). When OpenMP is
+  available, the pixels are processed in parallel; the result does not
+  depend on the number of threads.
+
+  \param LtL : Matrix \f$ L_I^\top L_I \f$.
+
+  \sa interactionAtb(), interaction(vpMatrix &)
+*/
+void vpFeatureLuminance::interactionAtA(vpMatrix &LtL) const
+{
+  computeNormalEquations(pixInfo, dim_s, NULL, &LtL, NULL);
+}
+
+/*!
+  Compute the 6-dimension vector \f$ L_I^\top b \f$ without building the
+  interaction matrix \f$ L_I \f$.
+
+  \param b : Vector with one element per pixel, typically the error
+  \f$ I - I^* \f$ computed with error().
+  \param Ltb : Vector \f$ L_I^\top b \f$.
+
+  \exception vpException::dimensionError : If the size of b is not the
+  dimension of the feature.
+
+  \sa interactionAtA()
+*/
+void vpFeatureLuminance::interactionAtb(const vpColVector &b, vpColVector &Ltb) const
+{
+  if (b.getRows() != dim_s) {
+    throw vpException(vpException::dimensionError, "Cannot multiply the (%dx6) interaction matrix by a (%d) vector",
+                      dim_s, b.getRows());
   }
+  computeNormalEquations(pixInfo, dim_s, b.data, NULL, &Ltb);
 }
 
 /*!
@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the luminance visual feature.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFeatureLuminance.cpp
+
+  \brief Test that the matrices computed by vpFeatureLuminance without
+  building the interaction matrix are the same as with the interaction matrix.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+
+namespace
+{
+void buildImage(vpImage<unsigned char> &I, double phase)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double v = 128 + 60 * sin(0.11 * j + phase) * cos(0.07 * i) + 40 * sin(0.013 * i * j);
+      I[i][j] = (unsigned char)v;
+    }
+  }
+}
+
+bool checkMatrix(const vpArray2D<double> &A, const vpArray2D<double> &B, const std::string &name)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    std::cerr << name << ": wrong size" << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < A.size(); i++) {
+    double tol = 1e-9 * (std::max)(1.0, fabs(B.data[i]));
+    if (fabs(A.data[i] - B.data[i]) > tol) {
+      std::cerr << name << ": " << A.data[i] << " instead of " << B.data[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpCameraParameters cam(600, 600, 160, 120);
+    // The size is not a multiple of the blocks of pixels
+    vpImage<unsigned char> I(240, 320), Id(240, 320);
+    buildImage(I, 0.);
+    buildImage(Id, 0.3);
+
+    vpFeatureLuminance s, sd;
+    s.init(I.getHeight(), I.getWidth(), 1.2);
+    s.setCameraParameters(cam);
+    s.buildFrom(I);
+    sd.init(Id.getHeight(), Id.getWidth(), 1.2);
+    sd.setCameraParameters(cam);
+    sd.buildFrom(Id);
+
+    vpMatrix L;
+    vpColVector e;
+    s.interaction(L);
+    s.error(sd, e);
+
+    vpMatrix LtL;
+    vpColVector Lte;
+    s.interactionAtA(LtL);
+    s.interactionAtb(e, Lte);
+
+    if (!checkMatrix(LtL, L.AtA(), "L^T L") || !checkMatrix(Lte, L.t() * e, "L^T e")) {
+      return EXIT_FAILURE;
+    }
+
+    bool exceptionThrown = false;
+    try {
+      s.interactionAtb(vpColVector(3), Lte);
+    } catch (const vpException &) {
+      exceptionThrown = true;
+    }
+    if (!exceptionThrown) {
+      std::cerr << "No exception for a vector with a wrong size" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "vpFeatureLuminance is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -440,6 +440,20 @@ error vector is updated after a call of computeError() or computeControlLaw().
     A recommended value is 4.
   */
   void setMu(double mu_) { this->mu = mu_; }
+  /*!
+    Set the damping factor \f$\mu_d\f$ of the inverse of the task Jacobian
+    used when the inversion type is vpServo::PSEUDO_INVERSE (see
+    setInteractionMatrixType()).
+
+    When the damping factor is not null, the damped least-squares inverse
+    \f${\bf J_1}^\top ({\bf J_1} {\bf J_1}^\top + \mu_d^2 {\bf I})^{-1}\f$ is
+    used in the control law instead of the pseudo inverse. It bounds the
+    velocities when the task Jacobian is close to a singularity, at the
+    expense of a slower convergence. By default the damping factor is 0.
+
+    \param damping : Damping factor \f$\mu_d\f$.
+  */
+  void setPseudoInverseDamping(double damping) { this->pseudoInverseDamping = damping; }
   //  Choice of the visual servoing control law
   void setServo(const vpServoType &servo_type);
 
@@ -539,6 +553,14 @@ protected:
    */
   void computeProjectionOperators();
 
+  /*!
+    Compute the inverse of the task Jacobian, its rank, the projection
+    operator \f$\bf WpW\f$ and the primary task \f$e_1\f$.
+   */
+  void computePrimaryTask();
+
+  unsigned int computeTaskJacobianPseudoInverse(vpMatrix &J1p_);
+
 public:
   //! Interaction matrix
   vpMatrix L;
@@ -674,6 +696,27 @@ protected:
   //! A diag matrix used to determine which are the degrees of freedom that
   //! are controlled in the camera frame
   vpMatrix cJc;
+
+  //! Damping factor of the inverse of the task Jacobian.
+  double pseudoInverseDamping;
+
+  /*
+    Workspace of the control law, reused from one iteration to the next
+  */
+
+  //! Product of the twist transformation matrix and of the robot Jacobian.
+  vpMatrix cVaJe;
+  //! Columns of the task Jacobian orthogonalized by the SVD.
+  vpMatrix svdW;
+  //! Right singular vectors of the task Jacobian.
+  vpMatrix svdV;
+  //! Singular values of the task Jacobian.
+  vpColVector svdSv;
+  //! Inverse of the task Jacobian computed when its transpose is used.
+  vpMatrix J1pImage;
+  //! Product of the inverse or of the transpose of the task Jacobian by the
+  //! error.
+  vpColVector J1pe;
 };
 
 #endif
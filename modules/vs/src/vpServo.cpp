@@ -40,6 +40,9 @@
 
 #include <visp3/vs/vpServo.h>
 
+#include <algorithm> // std::min, std::swap
+#include <cmath>
+#include <limits>
 #include <sstream>
 
 // Exception
@@ -72,7 +75,8 @@ vpServo::vpServo()
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false),
     fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false), errorComputed(false),
     interactionMatrixComputed(false), dim_task(0), taskWasKilled(false), forceInteractionMatrixComputation(false),
-    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6)
+    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6), pseudoInverseDamping(0.),
+    cVaJe(), svdW(), svdV(), svdSv(), J1pImage(), J1pe()
 {
   cJc.eye();
 }
@@ -97,7 +101,7 @@ vpServo::vpServo(vpServoType servo_type)
     inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(),
     init_eJe(false), fJe(), init_fJe(false), errorComputed(false), interactionMatrixComputed(false), dim_task(0),
     taskWasKilled(false), forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
-    iscJcIdentity(true), cJc(6, 6)
+    iscJcIdentity(true), cJc(6, 6), pseudoInverseDamping(0.), cVaJe(), svdW(), svdV(), svdSv(), J1pImage(), J1pe()
 {
   cJc.eye();
 }
@@ -906,6 +910,207 @@ bool vpServo::testUpdated()
 
   return false;
 }
+/*
+  Compute C = A * B where A is a twist transformation matrix or cJc, without
+  temporary matrix.
+*/
+static void multTwistMatrix(const vpArray2D<double> &A, const vpMatrix &B, vpMatrix &C)
+{
+  if (A.getCols() != B.getRows()) {
+    throw(vpException(vpException::dimensionError, "Cannot multiply (%dx%d) matrix by (%dx%d) matrix", A.getRows(),
+                      A.getCols(), B.getRows(), B.getCols()));
+  }
+  if ((C.getRows() != A.getRows()) || (C.getCols() != B.getCols()))
+    C.resize(A.getRows(), B.getCols(), false, false);
+
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    for (unsigned int j = 0; j < B.getCols(); j++) {
+      double sum = 0;
+      for (unsigned int k = 0; k < A.getCols(); k++)
+        sum += A[i][k] * B[k][j];
+      C[i][j] = sum;
+    }
+  }
+}
+
+/*
+  Singular value decomposition A = U diag(sv) V^T of a matrix with a few
+  columns like the task Jacobian, using one-sided Jacobi rotations (Hestenes
+  method). The rotations are applied to the columns of W = A V until they are
+  orthogonal, so that sv[j] = ||W_j|| and U_j = W_j / sv[j].
+
+  The singular values are sorted in decreasing order. Once the dimensions of
+  the matrices are stable, there is no memory allocation.
+*/
+static void svdJacobi(const vpMatrix &A, vpMatrix &W, vpMatrix &V, vpColVector &sv)
+{
+  const unsigned int nrows = A.getRows();
+  const unsigned int ncols = A.getCols();
+  const unsigned int max_sweeps = 60;
+
+  W = A;
+  V.eye(ncols);
+  if (sv.getRows() != ncols)
+    sv.resize(ncols, false);
+
+  for (unsigned int sweep = 0; sweep < max_sweeps; sweep++) {
+    bool rotated = false;
+    for (unsigned int p = 0; p + 1 < ncols; p++) {
+      for (unsigned int q = p + 1; q < ncols; q++) {
+        double alpha = 0, beta = 0, gamma = 0;
+        for (unsigned int i = 0; i < nrows; i++) {
+          alpha += W[i][p] * W[i][p];
+          beta += W[i][q] * W[i][q];
+          gamma += W[i][p] * W[i][q];
+        }
+        if (std::fabs(gamma) <= std::numeric_limits<double>::epsilon() * sqrt(alpha * beta))
+          continue;
+
+        rotated = true;
+        double zeta = (beta - alpha) / (2 * gamma);
+        double t = (zeta >= 0 ? 1. : -1.) / (std::fabs(zeta) + sqrt(1 + zeta * zeta));
+        double c = 1 / sqrt(1 + t * t);
+        double sn = c * t;
+        for (unsigned int i = 0; i < nrows; i++) {
+          double wp = W[i][p];
+          W[i][p] = c * wp - sn * W[i][q];
+          W[i][q] = sn * wp + c * W[i][q];
+        }
+        for (unsigned int i = 0; i < ncols; i++) {
+          double vp = V[i][p];
+          V[i][p] = c * vp - sn * V[i][q];
+          V[i][q] = sn * vp + c * V[i][q];
+        }
+      }
+    }
+    if (!rotated)
+      break;
+  }
+
+  for (unsigned int j = 0; j < ncols; j++) {
+    double norm = 0;
+    for (unsigned int i = 0; i < nrows; i++)
+      norm += W[i][j] * W[i][j];
+    sv[j] = sqrt(norm);
+  }
+
+  // Sort the singular values in decreasing order
+  for (unsigned int j = 0; j + 1 < ncols; j++) {
+    unsigned int jmax = j;
+    for (unsigned int k = j + 1; k < ncols; k++) {
+      if (sv[k] > sv[jmax])
+        jmax = k;
+    }
+    if (jmax != j) {
+      std::swap(sv[j], sv[jmax]);
+      for (unsigned int i = 0; i < nrows; i++)
+        std::swap(W[i][j], W[i][jmax]);
+      for (unsigned int i = 0; i < ncols; i++)
+        std::swap(V[i][j], V[i][jmax]);
+    }
+  }
+}
+
+/*!
+  Compute the inverse of the task Jacobian \f${\bf J_1}\f$ from its singular
+  value decomposition. The singular values lower than \f$10^{-6}\f$ times the
+  highest one are considered as null, like in vpMatrix::pseudoInverse().
+
+  If a damping factor is set with setPseudoInverseDamping(), the damped
+  least-squares inverse is computed instead of the pseudo inverse.
+
+  \param J1p_ : Inverse of the task Jacobian.
+  \return The rank of the task Jacobian.
+*/
+unsigned int vpServo::computeTaskJacobianPseudoInverse(vpMatrix &J1p_)
+{
+  const unsigned int nrows = J1.getRows();
+  const unsigned int ncols = J1.getCols();
+
+  svdJacobi(J1, svdW, svdV, svdSv);
+
+  unsigned int rank = 0;
+  while (rank < ncols && svdSv[rank] > 1e-6 * svdSv[0])
+    rank++;
+
+  // J1p = sum_j V_j U_j^T sv_j / (sv_j^2 + damping^2) with U_j = W_j / sv_j
+  if ((J1p_.getRows() != ncols) || (J1p_.getCols() != nrows))
+    J1p_.resize(ncols, nrows, false, false);
+  J1p_ = 0;
+  double damping2 = pseudoInverseDamping * pseudoInverseDamping;
+  for (unsigned int j = 0; j < rank; j++) {
+    double inv_sv2 = 1 / (svdSv[j] * svdSv[j] + damping2);
+    for (unsigned int i = 0; i < ncols; i++) {
+      double vij = svdV[i][j] * inv_sv2;
+      for (unsigned int k = 0; k < nrows; k++)
+        J1p_[i][k] += vij * svdW[k][j];
+    }
+  }
+
+  // Like vpMatrix::pseudoInverse(), keep the min(nrows, ncols) singular values
+  unsigned int nsv = std::min(nrows, ncols);
+  if (sv.getRows() != nsv)
+    sv.resize(nsv, false);
+  for (unsigned int j = 0; j < nsv; j++)
+    sv[j] = svdSv[j];
+
+  return rank;
+}
+
+void vpServo::computePrimaryTask()
+{
+  // pseudo inverse of the task Jacobian
+  // and rank of the task Jacobian
+  // the image of J1 is also computed to allows the computation
+  // of the projection operator
+  bool imageComputed = false;
+  unsigned int n = J1.getCols();
+
+  if (inversionType == PSEUDO_INVERSE) {
+    rankJ1 = computeTaskJacobianPseudoInverse(J1p);
+
+    imageComputed = true;
+  } else
+    J1.transpose(J1p);
+
+  vpMatrix::multMatrixVector(J1p, error, J1pe);
+
+  if (rankJ1 == n) {
+    /* if no degrees of freedom remains (rank J1 = ndof)
+     WpW = I, multiply by WpW is useless
+    */
+    e1 = J1pe; // primary task
+
+    WpW.eye(n, n);
+  } else {
+    if (imageComputed != true) {
+      // image of J1 is computed to allows the computation
+      // of the projection operator
+      rankJ1 = computeTaskJacobianPseudoInverse(J1pImage);
+    }
+    // WpW = imJ1t * imJ1t^T, where the columns of imJ1t are the right
+    // singular vectors of J1 associated to the non null singular values
+    if ((WpW.getRows() != n) || (WpW.getCols() != n))
+      WpW.resize(n, n, false, false);
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = 0; j < n; j++) {
+        double sum = 0;
+        for (unsigned int k = 0; k < rankJ1; k++)
+          sum += svdV[i][k] * svdV[j][k];
+        WpW[i][j] = sum;
+      }
+    }
+
+#ifdef DEBUG
+    std::cout << "rank J1: " << rankJ1 << std::endl;
+    WpW.print(std::cout, 10, "WpW");
+    J1.print(std::cout, 10, "J1");
+    J1p.print(std::cout, 10, "J1p");
+#endif
+    vpMatrix::multMatrixVector(WpW, J1pe, e1);
+  }
+}
+
 /*!
 
   Compute the control law specified using setServo(). See vpServo::vpServoType
@@ -937,9 +1142,6 @@ vpColVector vpServo::computeControlLaw()
   static int iteration = 0;
 
   try {
-    vpVelocityTwistMatrix cVa; // Twist transformation matrix
-    vpMatrix aJe;              // Jacobian
-
     if (iteration == 0) {
       if (testInitialization() == false) {
         vpERROR_TRACE("All the matrices are not correctly initialized");
@@ -962,21 +1164,20 @@ vpColVector vpServo::computeControlLaw()
     case EYEINHAND_L_cVe_eJe:
     case EYETOHAND_L_cVe_eJe:
 
-      cVa = cVe;
-      aJe = eJe;
+      multTwistMatrix(cVe, eJe, cVaJe);
 
       init_cVe = false;
       init_eJe = false;
       break;
     case EYETOHAND_L_cVf_fVe_eJe:
-      cVa = cVf * fVe;
-      aJe = eJe;
+      // J1 is used as a temporary matrix
+      multTwistMatrix(fVe, eJe, J1);
+      multTwistMatrix(cVf, J1, cVaJe);
       init_fVe = false;
       init_eJe = false;
       break;
     case EYETOHAND_L_cVf_fJe:
-      cVa = cVf;
-      aJe = fJe;
+      multTwistMatrix(cVf, fJe, cVaJe);
       init_fJe = false;
       break;
     }
@@ -985,60 +1186,21 @@ vpColVector vpServo::computeControlLaw()
     computeError();
 
     // compute  task Jacobian
-    if (iscJcIdentity)
-      J1 = L * cVa * aJe;
-    else
-      J1 = L * cJc * cVa * aJe;
+    if (!iscJcIdentity) {
+      multTwistMatrix(cJc, cVaJe, J1);
+      cVaJe = J1;
+    }
+    vpMatrix::mult2Matrices(L, cVaJe, J1);
 
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1: " << rankJ1 << std::endl;
-      imJ1t.print(std::cout, 10, "imJ1t");
-      imJ1.print(std::cout, 10, "imJ1");
-
-      WpW.print(std::cout, 10, "WpW");
-      J1.print(std::cout, 10, "J1");
-      J1p.print(std::cout, 10, "J1p");
-#endif
-      e1 = WpW * J1p * error;
-    }
-    e = -lambda(e1) * e1;
-
-    vpMatrix I;
-
-    I.eye(J1.getCols(), J1.getCols());
+    computePrimaryTask();
+    const double gain = lambda(e1);
+    if (e.getRows() != e1.getRows())
+      e.resize(e1.getRows(), false);
+    for (unsigned int i = 0; i < e1.getRows(); i++)
+      e[i] = -gain * e1[i];
 
     computeProjectionOperators();
 
@@ -1143,47 +1305,7 @@ vpColVector vpServo::computeControlLaw(double t)
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
-
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
-#endif
-      e1 = WpW * J1p * error;
-    }
+    computePrimaryTask();
 
     // memorize the initial e1 value if the function is called the first time
     // or if the time given as parameter is equal to 0.
@@ -1197,10 +1319,6 @@ vpColVector vpServo::computeControlLaw(double t)
 
     e = -lambda(e1) * e1 + lambda(e1) * e1_initial * exp(-mu * t);
 
-    vpMatrix I;
-
-    I.eye(J1.getCols(), J1.getCols());
-
     computeProjectionOperators();
   } catch (...) {
     throw;
@@ -1303,47 +1421,7 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
     // handle the eye-in-hand eye-to-hand case
     J1 *= signInteractionMatrix;
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
-
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
-#endif
-      e1 = WpW * J1p * error;
-    }
+    computePrimaryTask();
 
     // memorize the initial e1 value if the function is called the first time
     // or if the time given as parameter is equal to 0.
@@ -1357,10 +1435,6 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
 
     e = -lambda(e1) * e1 + (e_dot_init + lambda(e1) * e1_initial) * exp(-mu * t);
 
-    vpMatrix I;
-
-    I.eye(J1.getCols(), J1.getCols());
-
     computeProjectionOperators();
   } catch (...) {
     throw;
@@ -1374,13 +1448,10 @@ void vpServo::computeProjectionOperators()
 {
   // Initialization
   unsigned int n = J1.getCols();
-  P.resize(n, n);
-
-  vpMatrix I;
-  I.eye(n);
-
-  // Compute classical projection operator
-  I_WpW = (I - WpW);
+  if ((P.getRows() != n) || (P.getCols() != n))
+    P.resize(n, n, false, false);
+  if ((I_WpW.getRows() != n) || (I_WpW.getCols() != n))
+    I_WpW.resize(n, n, false, false);
 
   // Compute gain depending by the task error to ensure a smooth change
   // between the operators.
@@ -1396,17 +1467,27 @@ void vpServo::computeProjectionOperators()
   else
     sig = 0.0;
 
-  vpMatrix J1t = J1.transpose();
-
-  double pp = (error.t() * (J1 * J1t) * error);
-
-  vpMatrix ee_t(n, n);
-  ee_t = error * error.t();
+  // J1^T e, so that J1^T e e^T J1 = (J1^T e) (J1^T e)^T
+  if (J1pe.getRows() != n)
+    J1pe.resize(n, false);
+  for (unsigned int j = 0; j < n; j++) {
+    double sum = 0;
+    for (unsigned int i = 0; i < J1.getRows(); i++)
+      sum += J1[i][j] * error[i];
+    J1pe[j] = sum;
+  }
 
-  vpMatrix P_norm_e(n, n);
-  P_norm_e = I - (1.0 / pp) * J1t * ee_t * J1;
+  double pp = J1pe.sumSquare(); // e^T J1 J1^T e
 
-  P = sig * P_norm_e + (1 - sig) * I_WpW;
+  // Compute classical projection operator I - WpW and the large projection
+  // operator P = sig * (I - J1^T e e^T J1 / pp) + (1 - sig) * (I - WpW)
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      double Iij = (i == j) ? 1.0 : 0.0;
+      I_WpW[i][j] = Iij - WpW[i][j];
+      P[i][j] = sig * (Iij - J1pe[i] * J1pe[j] / pp) + (1 - sig) * I_WpW[i][j];
+    }
+  }
 
   return;
 }
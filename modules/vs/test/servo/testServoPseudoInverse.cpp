@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the inverse of the task Jacobian computed by vpServo.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testServoPseudoInverse.cpp
+
+  \brief Test that the pseudo inverse, the rank and the projection operators
+  of the task Jacobian computed by vpServo are the ones given by
+  vpMatrix::pseudoInverse(), and that the damped inverse is
+  \f$(J^T J + \lambda^2 I)^{-1} J^T\f$.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/visual_features/vpGenericFeature.h>
+#include <visp3/vs/vpServo.h>
+
+namespace
+{
+vpMatrix randomMatrix(vpUniRand &rng, unsigned int rows, unsigned int cols)
+{
+  vpMatrix M(rows, cols);
+  for (unsigned int i = 0; i < rows; i++)
+    for (unsigned int j = 0; j < cols; j++)
+      M[i][j] = 2 * rng() - 1;
+  return M;
+}
+
+double maxDifference(const vpMatrix &A, const vpMatrix &B)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols())
+    return std::numeric_limits<double>::max();
+  double diff = 0;
+  for (unsigned int i = 0; i < A.getRows(); i++)
+    for (unsigned int j = 0; j < A.getCols(); j++)
+      diff = std::max(diff, std::fabs(A[i][j] - B[i][j]));
+  return diff;
+}
+
+/*
+  Compute the control law of a task whose Jacobian is L eJe, and compare the
+  inverse of the Jacobian, its rank and the projection operators with the
+  ones given by vpMatrix::pseudoInverse().
+*/
+bool testTask(const std::string &name, const vpMatrix &L, const vpMatrix &eJe, double damping)
+{
+  const unsigned int m = L.getRows();
+  const unsigned int n = eJe.getCols();
+  const double threshold = 1e-9;
+
+  vpGenericFeature s(m), s_star(m);
+  vpColVector s_vec(m);
+  for (unsigned int i = 0; i < m; i++)
+    s_vec[i] = 0.1 * (i + 1);
+  s.set_s(s_vec);
+  s.setInteractionMatrix(L);
+
+  vpServo task;
+  task.setServo(vpServo::EYEINHAND_L_cVe_eJe);
+  task.setInteractionMatrixType(vpServo::CURRENT);
+  task.setLambda(1.);
+  task.set_cVe(vpVelocityTwistMatrix());
+  task.set_eJe(eJe);
+  task.setPseudoInverseDamping(damping);
+  task.addFeature(s, s_star);
+  task.computeControlLaw();
+
+  const vpMatrix J = L * eJe;
+  vpMatrix Jp, imJ, imJt;
+  vpColVector sv;
+  const unsigned int rank = J.pseudoInverse(Jp, sv, 1e-6, imJ, imJt);
+  const vpMatrix WpW = imJt * imJt.t();
+  vpMatrix I;
+  I.eye(n);
+
+  if (task.getTaskRank() != rank) {
+    std::cerr << name << ": rank " << task.getTaskRank() << " instead of " << rank << std::endl;
+    return false;
+  }
+  if (damping == 0 && maxDifference(task.getTaskJacobianPseudoInverse(), Jp) > threshold) {
+    std::cerr << name << ": wrong pseudo inverse\n" << task.getTaskJacobianPseudoInverse() << "\ninstead of\n" << Jp
+              << std::endl;
+    return false;
+  }
+  if (damping > 0) {
+    const vpMatrix Jd = (J.t() * J + damping * damping * I).inverseByLU() * J.t();
+    if (maxDifference(task.getTaskJacobianPseudoInverse(), Jd) > threshold) {
+      std::cerr << name << ": wrong damped inverse\n" << task.getTaskJacobianPseudoInverse() << "\ninstead of\n" << Jd
+                << std::endl;
+      return false;
+    }
+  }
+  if (maxDifference(task.getWpW(), WpW) > threshold || maxDifference(task.getI_WpW(), I - WpW) > threshold) {
+    std::cerr << name << ": wrong projection operator\n" << task.getWpW() << "\ninstead of\n" << WpW << std::endl;
+    return false;
+  }
+
+  std::cout << name << ": rank " << rank << " is ok" << std::endl;
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rng(42);
+    vpMatrix I6;
+    I6.eye(6);
+
+    bool ok = true;
+    for (int k = 0; k < 2; k++) {
+      const double damping = k == 0 ? 0 : 0.1;
+      const std::string suffix = k == 0 ? "" : " (damped)";
+
+      ok = ok && testTask("full rank 6x6" + suffix, randomMatrix(rng, 6, 6), I6, damping);
+      // Rank 3 Jacobian
+      ok = ok && testTask("rank deficient 6x6" + suffix, randomMatrix(rng, 6, 3) * randomMatrix(rng, 3, 6), I6,
+                          damping);
+      ok = ok && testTask("tall 8x6" + suffix, randomMatrix(rng, 8, 6), I6, damping);
+      ok = ok && testTask("wide 3x6" + suffix, randomMatrix(rng, 3, 6), I6, damping);
+      // Redundant robot with 7 joints
+      ok = ok && testTask("6x7" + suffix, randomMatrix(rng, 6, 6), randomMatrix(rng, 6, 7), damping);
+    }
+
+    if (!ok)
+      return EXIT_FAILURE;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "vpServo pseudo inverse is ok." << std::endl;
+  return EXIT_SUCCESS;
+}